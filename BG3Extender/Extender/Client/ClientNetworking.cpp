@@ -4,6 +4,12 @@
 
 BEGIN_NS(ecl)
 
+net::ProtocolResult ExtenderProtocol::PostUpdate(GameTime const& time)
+{
+	gExtender->GetClient().GetNetworkManager().Update();
+	return ExtenderProtocolBase::PostUpdate(time);
+}
+
 void ExtenderProtocol::ProcessExtenderMessage(net::MessageContext& context, net::MessageWrapper& msg)
 {
 	switch (msg.msg_case()) {
@@ -66,6 +72,11 @@ void ExtenderProtocol::ProcessExtenderMessage(net::MessageContext& context, net:
 void NetworkManager::Reset()
 {
 	extenderSupport_ = false;
+	hostVersion_ = 0;
+	outgoingQueue_.Clear();
+	if (protocol_ != nullptr) {
+		protocol_->ClearReassemblers();
+	}
 }
 
 bool NetworkManager::CanSendExtenderMessages() const
@@ -88,7 +99,7 @@ void NetworkManager::ExtendNetworking()
 		return;
 	}
 
-	protocol_ = new ExtenderProtocol();
+	protocol_ = new ExtenderProtocol(compressor_);
 	client->ProtocolList.insert_at(0, protocol_);
 	client->ProtocolMap.set(ExtenderProtocol::ProtocolId, protocol_);
 
@@ -108,6 +119,12 @@ net::Client * NetworkManager::GetClient() const
 	}
 }
 
+void NetworkManager::Update()
+{
+	outgoingQueue_.BeginTick();
+	FlushQueuedMessages();
+}
+
 void NetworkManager::OnClientConnectMessage(net::ClientConnectMessage* msg)
 {
 	DEBUG("Appending extender signature to ClientConnect");
@@ -118,6 +135,7 @@ void NetworkManager::OnExtenderHello(net::MsgC2SExtenderHello const& hello)
 {
 	DEBUG("Got extender support notification from host (version %d)", hello.version());
 	AllowExtenderMessages();
+	hostVersion_ = hello.version();
 
 	auto helloMsg = GetFreeMessage();
 	if (helloMsg != nullptr) {
@@ -151,6 +169,47 @@ void NetworkManager::Send(net::ExtenderMessage* msg)
 {
 	auto client = GetClient();
 	if (client != nullptr) {
+		// Make sure that previously queued messages arrive first
+		FlushQueuedMessages();
+		client->SendMessageSinglePeer((TPeerId)client->HostPeerId, msg);
+	}
+}
+
+void NetworkManager::Send(net::MessageWrapper const& msg)
+{
+	if (hostVersion_ >= net::ExtenderMessage::VerBatching) {
+		if (extenderSupport_) {
+			outgoingQueue_.Push(msg, hostVersion_ >= net::ExtenderMessage::VerFragmentation, &compressor_);
+		} else {
+			ERR("Attempted to send extender message to a host that does not understand extender protocol!");
+		}
+	} else {
+		// Host doesn't understand batched messages, send immediately
+		auto extMsg = GetFreeMessage();
+		if (extMsg != nullptr) {
+			extMsg->GetMessage().CopyFrom(msg);
+			Send(extMsg);
+		}
+	}
+}
+
+void NetworkManager::FlushQueuedMessages()
+{
+	auto client = GetClient();
+	if (client == nullptr) {
+		outgoingQueue_.Clear();
+		return;
+	}
+
+	while (outgoingQueue_.HasPacket()) {
+		auto msg = GetFreeMessage();
+		if (msg == nullptr) {
+			OsiErrorS("Could not get free message!");
+			outgoingQueue_.Clear();
+			break;
+		}
+
+		outgoingQueue_.PopPacket(msg->GetMessage(), &compressor_);
 		client->SendMessageSinglePeer((TPeerId)client->HostPeerId, msg);
 	}
 }
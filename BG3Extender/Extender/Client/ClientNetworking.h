@@ -7,8 +7,12 @@ BEGIN_NS(ecl)
 class ExtenderProtocol : public net::ExtenderProtocolBase
 {
 public:
+	using ExtenderProtocolBase::ExtenderProtocolBase;
+
 	static constexpr uint32_t ProtocolId = 100;
 
+	net::ProtocolResult PostUpdate(GameTime const& time) override;
+
 protected:
 	void ProcessExtenderMessage(net::MessageContext& context, net::MessageWrapper& msg) override;
 };
@@ -19,19 +23,34 @@ public:
 	void Reset();
 
 	bool CanSendExtenderMessages() const;
+
+	inline uint32_t GetHostVersion() const
+	{
+		return hostVersion_;
+	}
+
 	void AllowExtenderMessages();
 	void ExtendNetworking();
 	net::ExtenderMessage* GetFreeMessage();
 	void Send(net::ExtenderMessage* msg);
+	// Queued variant; messages are coalesced and sent at the end of the tick
+	void Send(net::MessageWrapper const& msg);
+	void FlushQueuedMessages();
+	void Update();
 	void OnClientConnectMessage(net::ClientConnectMessage* msg);
 	void OnExtenderHello(net::MsgC2SExtenderHello const& hello);
 
 private:
 	ExtenderProtocol* protocol_{ nullptr };
+	net::MessageCompressor compressor_;
 
 	// Indicates that the client can support extender messages to the server
 	// (i.e. the server supports the message ID and won't crash)
 	bool extenderSupport_{ false };
+	// Protocol version of the host
+	uint32_t hostVersion_{ 0 };
+	// Messages waiting to be sent at the end of the tick
+	net::OutgoingMessageQueue outgoingQueue_;
 
 	net::Client* GetClient() const;
 };
@@ -156,6 +156,7 @@ void ScriptExtender::Shutdown()
 	server_.Shutdown();
 	client_.Shutdown();
 	engineHooks_.UnhookAll();
+	gCoreLibPlatformInterface.GlobalConsole->Flush();
 }
 
 void ScriptExtender::LogLuaError(std::string_view msg)
@@ -268,6 +269,7 @@ void ScriptExtender::OnECSUpdate(ecs::EntityWorld::UpdateProc* wrapped, ecs::Ent
 		esv::LuaServerPin lua(GetServer().GetExtensionState());
 		if (lua) {
 			lua->GetReplicationEventHooks()->OnEntityReplication(*entityWorld);
+			lua->GetSpatialIndex().OnEntityReplication(*entityWorld);
 		}
 	}
 }
@@ -486,6 +488,13 @@ void ScriptExtender::PostStartup()
 			ERR("Failed to load Lua builtin resource bundle!");
 		}
 
+		if (config_.EnableLuaChunkCache && config_.PersistLuaChunkCache) {
+			auto cachePath = GetCacheFilePath(L"LuaChunkCache.bin");
+			if (!cachePath.empty()) {
+				luaChunkCache_.EnablePersistence(cachePath);
+			}
+		}
+
 		engineHooks_.FileReader__ctor.SetWrapper(&ScriptExtender::OnFileReaderCreate, this);
 		engineHooks_.ls__VirtualTextureResource__Load.SetWrapper(&VirtualTextureHelpers::OnTextureLoad, &virtualTextures_);
 		engineHooks_.ls__VirtualTextureResource__Unload.SetWrapper(&VirtualTextureHelpers::OnTextureUnload, &virtualTextures_);
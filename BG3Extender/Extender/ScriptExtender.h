@@ -16,6 +16,7 @@
 #include <Lua/Debugger/LuaDebugMessages.h>
 #endif
 #include <Lua/Shared/LuaBundle.h>
+#include <Lua/Shared/LuaChunkCache.h>
 #include <Lua/Shared/Proxies/LuaCppClass.h>
 #include <GameHooks/OsirisWrappers.h>
 #include <GameHooks/DataLibraries.h>
@@ -110,6 +111,11 @@ public:
 		return luaBuiltinBundle_;
 	}
 
+	inline lua::LuaChunkCache& GetLuaChunkCache()
+	{
+		return luaChunkCache_;
+	}
+
 	inline lua::CppPropertyMapManager& GetPropertyMapManager()
 	{
 		return propertyMapManager_;
@@ -150,6 +156,7 @@ private:
 	std::unordered_map<STDString, STDString> pathOverrides_;
 	stats::StatLoadOrderHelper statLoadOrderHelper_;
 	lua::LuaBundle luaBuiltinBundle_;
+	lua::LuaChunkCache luaChunkCache_;
 	lua::CppPropertyMapManager propertyMapManager_;
 	VirtualTextureHelpers virtualTextures_;
 #if defined(ENABLE_IMGUI)
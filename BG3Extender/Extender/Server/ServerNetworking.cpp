@@ -14,6 +14,12 @@ net::ProtocolResult ExtenderProtocol::ProcessMsg(void* unused, net::MessageConte
 	return base;
 }
 
+net::ProtocolResult ExtenderProtocol::PostUpdate(GameTime const& time)
+{
+	gExtender->GetServer().GetNetworkManager().Update();
+	return ExtenderProtocolBase::PostUpdate(time);
+}
+
 void ExtenderProtocol::ProcessExtenderMessage(net::MessageContext& context, net::MessageWrapper & msg)
 {
 	switch (msg.msg_case()) {
@@ -49,6 +55,10 @@ void ExtenderProtocol::ProcessExtenderMessage(net::MessageContext& context, net:
 void NetworkManager::Reset()
 {
 	peerVersions_.clear();
+	outgoingQueues_.clear();
+	if (protocol_ != nullptr) {
+		protocol_->ClearReassemblers();
+	}
 }
 
 bool NetworkManager::CanSendExtenderMessages(PeerId peerId) const
@@ -66,6 +76,16 @@ std::optional<uint32_t> NetworkManager::GetPeerVersion(PeerId peerId) const
 	}
 }
 
+uint32_t NetworkManager::GetMinPeerVersion() const
+{
+	uint32_t version = net::ExtenderMessage::ProtoVersion;
+	for (auto const& peer : peerVersions_) {
+		version = std::min(version, peer.second);
+	}
+
+	return version;
+}
+
 void NetworkManager::AllowExtenderMessages(PeerId peerId, uint32_t version)
 {
 	peerVersions_.insert_or_assign(peerId, version);
@@ -101,7 +121,7 @@ void NetworkManager::ExtendNetworking()
 		return;
 	}
 
-	protocol_ = new ExtenderProtocol();
+	protocol_ = new ExtenderProtocol(compressor_);
 	server->ProtocolList.insert_at(0, protocol_);
 	server->ProtocolMap.set(ExtenderProtocol::ProtocolId, protocol_);
 
@@ -145,6 +165,8 @@ void NetworkManager::Send(net::ExtenderMessage * msg, UserId userId)
 {
 	auto server = GetServer();
 	if (server != nullptr) {
+		// Make sure that previously queued messages arrive first
+		FlushQueue(userId.GetPeerId());
 		server->SendMessageSinglePeer((TPeerId)userId.GetPeerId(), msg);
 	}
 }
@@ -154,6 +176,8 @@ void NetworkManager::Broadcast(net::ExtenderMessage * msg, UserId excludeUserId,
 	auto server = GetServer();
 	if (server == nullptr) return;
 
+	FlushQueuedMessages();
+
 	Array<PeerId> peerIds;
 	for (auto peerId : server->ActivePeerIds) {
 		if (CanSendExtenderMessages(peerId)) {
@@ -173,6 +197,8 @@ void NetworkManager::BroadcastToConnectedPeers(net::ExtenderMessage* msg, UserId
 	auto server = GetServer();
 	if (server == nullptr) return;
 
+	FlushQueuedMessages();
+
 	Array<PeerId> peerIds;
 	for (auto peerId : server->ConnectedPeerIds) {
 		if (CanSendExtenderMessages(peerId)) {
@@ -187,4 +213,139 @@ void NetworkManager::BroadcastToConnectedPeers(net::ExtenderMessage* msg, UserId
 	server->SendMessageMultiPeerMoveIds(peerIds, msg, (TPeerId)excludeUserId.GetPeerId());
 }
 
+void NetworkManager::QueueOrSend(net::MessageWrapper const& msg, PeerId peerId)
+{
+	auto version = GetPeerVersion(peerId);
+	if (version && *version >= net::ExtenderMessage::VerBatching) {
+		outgoingQueues_[peerId].Push(msg, *version >= net::ExtenderMessage::VerFragmentation, GetCompressor(peerId));
+	} else {
+		// Peer doesn't understand batched messages, send immediately
+		auto server = GetServer();
+		auto extMsg = GetFreeMessage();
+		if (server != nullptr && extMsg != nullptr) {
+			extMsg->GetMessage().CopyFrom(msg);
+			server->SendMessageSinglePeer((TPeerId)peerId, extMsg);
+		}
+	}
+}
+
+net::MessageCompressor* NetworkManager::GetCompressor(PeerId peerId)
+{
+	// Messages to the local client are passed in memory, compression would be pure overhead
+	if (peerId == PeerId(1)) {
+		return nullptr;
+	} else {
+		return &compressor_;
+	}
+}
+
+void NetworkManager::FlushQueue(PeerId peerId)
+{
+	auto it = outgoingQueues_.find(peerId);
+	if (it == outgoingQueues_.end()) return;
+
+	auto server = GetServer();
+	auto& queue = it->second;
+	while (server != nullptr && queue.HasPacket()) {
+		auto msg = GetFreeMessage();
+		if (msg == nullptr) {
+			OsiErrorS("Could not get free message!");
+			queue.Clear();
+			break;
+		}
+
+		queue.PopPacket(msg->GetMessage(), GetCompressor(peerId));
+		server->SendMessageSinglePeer((TPeerId)peerId, msg);
+	}
+
+	// Keep queues with fragments that are waiting for the next tick
+	if (server == nullptr || queue.IsEmpty() || !CanSendExtenderMessages(peerId)) {
+		outgoingQueues_.erase(it);
+	}
+}
+
+void NetworkManager::FlushQueuedMessages()
+{
+	std::vector<PeerId> peerIds;
+	for (auto const& queue : outgoingQueues_) {
+		peerIds.push_back(queue.first);
+	}
+
+	for (auto peerId : peerIds) {
+		FlushQueue(peerId);
+	}
+}
+
+void NetworkManager::Update()
+{
+	RemoveDisconnectedPeers();
+
+	for (auto& queue : outgoingQueues_) {
+		queue.second.BeginTick();
+	}
+
+	FlushQueuedMessages();
+}
+
+void NetworkManager::RemoveDisconnectedPeers()
+{
+	auto server = GetServer();
+	if (server == nullptr) return;
+
+	for (auto it = peerVersions_.begin(); it != peerVersions_.end(); ) {
+		auto peerId = it->first;
+		if (server->ConnectedPeerIds.find(peerId) != server->ConnectedPeerIds.end()) {
+			it++;
+			continue;
+		}
+
+		DEBUG("Peer %d disconnected; dropping extender state", peerId);
+		outgoingQueues_.erase(peerId);
+		if (protocol_ != nullptr) {
+			protocol_->ClearReassembler(peerId);
+		}
+		it = peerVersions_.erase(it);
+	}
+}
+
+void NetworkManager::QueueToPeers(net::MessageWrapper const& msg, Array<PeerId> const& peerIds, UserId excludeUserId, bool excludeLocalPeer)
+{
+	for (auto peerId : peerIds) {
+		if (peerId == excludeUserId.GetPeerId() || (peerId == PeerId(1) && excludeLocalPeer)) {
+			continue;
+		}
+
+		if (CanSendExtenderMessages(peerId)) {
+			QueueOrSend(msg, peerId);
+		} else {
+			WARN("Not sending extender message to peer %d as it does not understand extender protocol!", peerId);
+		}
+	}
+}
+
+void NetworkManager::Send(net::MessageWrapper const& msg, UserId userId)
+{
+	if (CanSendExtenderMessages(userId.GetPeerId())) {
+		QueueOrSend(msg, userId.GetPeerId());
+	} else {
+		ERR("Attempted to send extender message to user %d that does not understand extender protocol!", userId.Id);
+	}
+}
+
+void NetworkManager::Broadcast(net::MessageWrapper const& msg, UserId excludeUserId, bool excludeLocalPeer)
+{
+	auto server = GetServer();
+	if (server != nullptr) {
+		QueueToPeers(msg, server->ActivePeerIds, excludeUserId, excludeLocalPeer);
+	}
+}
+
+void NetworkManager::BroadcastToConnectedPeers(net::MessageWrapper const& msg, UserId excludeUserId, bool excludeLocalPeer)
+{
+	auto server = GetServer();
+	if (server != nullptr) {
+		QueueToPeers(msg, server->ConnectedPeerIds, excludeUserId, excludeLocalPeer);
+	}
+}
+
 END_NS()
@@ -7,9 +7,12 @@ BEGIN_NS(esv)
 class ExtenderProtocol : public net::ExtenderProtocolBase
 {
 public:
+	using ExtenderProtocolBase::ExtenderProtocolBase;
+
 	static constexpr uint32_t ProtocolId = 101;
 
 	net::ProtocolResult ProcessMsg(void* unused, net::MessageContext* unknown, net::Message* usg) override;
+	net::ProtocolResult PostUpdate(GameTime const& time) override;
 
 protected:
 	void ProcessExtenderMessage(net::MessageContext& context, net::MessageWrapper& msg) override;
@@ -22,6 +25,8 @@ public:
 
 	bool CanSendExtenderMessages(PeerId peerId) const;
 	std::optional<uint32_t> GetPeerVersion(PeerId peerId) const;
+	// Lowest protocol version of all peers that support extender messages
+	uint32_t GetMinPeerVersion() const;
 	void AllowExtenderMessages(PeerId peerId, uint32_t version);
 	void OnClientConnectMessage(net::MessageContext* context, net::ClientConnectMessage* msg);
 
@@ -35,10 +40,26 @@ public:
 	void Broadcast(net::ExtenderMessage * msg, UserId excludeUserId, bool excludeLocalPeer = false);
 	void BroadcastToConnectedPeers(net::ExtenderMessage* msg, UserId excludeUserId, bool excludeLocalPeer = false);
 
+	// Queued variants; messages are coalesced per peer and sent at the end of the tick
+	void Send(net::MessageWrapper const& msg, UserId userId);
+	void Broadcast(net::MessageWrapper const& msg, UserId excludeUserId, bool excludeLocalPeer = false);
+	void BroadcastToConnectedPeers(net::MessageWrapper const& msg, UserId excludeUserId, bool excludeLocalPeer = false);
+	void FlushQueuedMessages();
+	void Update();
+
 private:
 	ExtenderProtocol * protocol_{ nullptr };
+	net::MessageCompressor compressor_;
 	// List of clients that support the extender protocol
 	std::unordered_map<PeerId, uint32_t> peerVersions_;
+	// Messages waiting to be sent at the end of the tick
+	std::unordered_map<PeerId, net::OutgoingMessageQueue> outgoingQueues_;
+
+	void QueueOrSend(net::MessageWrapper const& msg, PeerId peerId);
+	void RemoveDisconnectedPeers();
+	net::MessageCompressor* GetCompressor(PeerId peerId);
+	void FlushQueue(PeerId peerId);
+	void QueueToPeers(net::MessageWrapper const& msg, Array<PeerId> const& peerIds, UserId excludeUserId, bool excludeLocalPeer);
 };
 
 END_NS()
\ No newline at end of file
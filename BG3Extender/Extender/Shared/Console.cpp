@@ -195,6 +195,8 @@ void DebugConsole::ConsoleThread()
 		DEBUG("Entering server Lua console.");
 
 		while (consoleRunning_) {
+			// Make sure that pending output doesn't end up after the prompt
+			Flush();
 			inputEnabled_ = true;
 			if (serverContext_) {
 				std::cout << "S";
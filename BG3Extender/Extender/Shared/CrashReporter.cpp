@@ -629,8 +629,16 @@ public:
 		SuspendThread(GetCurrentThread());
 	}
 
+	static void FlushLogs()
+	{
+		if (gCoreLibPlatformInterface.GlobalConsole) {
+			gCoreLibPlatformInterface.GlobalConsole->Flush(Console::CrashFlushTimeoutMs);
+		}
+	}
+
 	static LONG OnUnhandledException(_EXCEPTION_POINTERS * exceptionInfo)
 	{
+		FlushLogs();
 		if (IsExtensionRelatedCrash(exceptionInfo)) {
 			LaunchCrashReporterThread(exceptionInfo);
 			return EXCEPTION_EXECUTE_HANDLER;
@@ -649,6 +657,7 @@ public:
 
 	static void OnTerminate()
 	{
+		FlushLogs();
 		if (IsExtensionRelatedCrash(nullptr)) {
 			LaunchCrashReporterThread(nullptr);
 		} else {
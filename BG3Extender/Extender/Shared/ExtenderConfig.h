@@ -31,6 +31,12 @@ struct ExtenderConfig
 	bool DisableStoryMerge{ true };
 	bool DisableStoryPatching{ false };
 	bool DisableStoryCompilation{ true };
+	bool EnableSymbolCache{ true };
+	// Checks the single-pass symbol scan against per-pattern scans on startup (slow)
+	bool VerifySymbolScan{ false };
+	bool EnableLuaChunkCache{ true };
+	bool PersistLuaChunkCache{ false };
+	bool AsyncLogging{ true };
 
 #if defined(OSI_EXTENSION_BUILD)
 	bool DisableModValidation{ true };
@@ -49,6 +55,13 @@ struct ExtenderConfig
 	uint32_t DebuggerPort{ 9999 };
 	uint32_t LuaDebuggerPort{ 9998 };
 	uint32_t DebugFlags{ 0 };
+	// Max. number of messages of the same type a thread can log per second; 0 = unlimited
+	uint32_t LogRateLimit{ 0 };
+	// Time budget of Lua GC steps per tick, in microseconds
+	uint32_t LuaGCBudget{ 1000 };
+	// Lua collector pause and step multiplier (see collectgarbage()); 0 keeps the Lua defaults
+	uint32_t LuaGCPause{ 0 };
+	uint32_t LuaGCStepMul{ 0 };
 	std::wstring LogDirectory;
 	std::wstring LuaBuiltinResourceDirectory;
 	std::string CustomProfile;
@@ -1,5 +1,6 @@
 #include <stdafx.h>
 #include <Extender/Shared/ExtenderNet.h>
+#include <compressapi.h>
 
 BEGIN_NS(net)
 
@@ -58,6 +59,10 @@ Message* MessagePool::GetFreeMessage()
 }
 
 
+ExtenderProtocolBase::ExtenderProtocolBase(MessageCompressor& compressor)
+	: compressor_(compressor)
+{}
+
 ExtenderProtocolBase::~ExtenderProtocolBase() {}
 
 ProtocolResult ExtenderProtocolBase::ProcessMsg(void * Unused, net::MessageContext * Context, net::Message * Msg)
@@ -65,7 +70,7 @@ ProtocolResult ExtenderProtocolBase::ProcessMsg(void * Unused, net::MessageConte
 	if (Msg->MsgId == ExtenderMessage::MessageId) {
 		auto msg = static_cast<ExtenderMessage*>(Msg);
 		if (msg->IsValid()) {
-			ProcessExtenderMessage(*Context, msg->GetMessage());
+			DispatchExtenderMessage(*Context, msg->GetMessage());
 		}
 		return ProtocolResult::Handled;
 	}
@@ -73,6 +78,51 @@ ProtocolResult ExtenderProtocolBase::ProcessMsg(void * Unused, net::MessageConte
 	return ProtocolResult::Unhandled;
 }
 
+void ExtenderProtocolBase::DispatchExtenderMessage(net::MessageContext& context, MessageWrapper& msg)
+{
+	UnpackMessage(msg, reassemblers_[context.UserID.GetPeerId()], compressor_, [this, &context](MessageWrapper& unpacked) {
+		ProcessExtenderMessage(context, unpacked);
+	});
+}
+
+void UnpackMessage(MessageWrapper& msg, FragmentReassembler& reassembler, MessageCompressor& compressor,
+	std::function<void (MessageWrapper&)> const& handler)
+{
+	switch (msg.msg_case()) {
+	case MessageWrapper::kBatch:
+	{
+		for (auto& batched : *msg.mutable_batch()->mutable_messages()) {
+			UnpackMessage(batched, reassembler, compressor, handler);
+		}
+		break;
+	}
+
+	case MessageWrapper::kCompressed:
+	{
+		MessageWrapper decompressed;
+		if (compressor.Decompress(msg.compressed(), decompressed)) {
+			UnpackMessage(decompressed, reassembler, compressor, handler);
+		} else {
+			OsiErrorS("Failed to decompress extender message");
+		}
+		break;
+	}
+
+	case MessageWrapper::kFragment:
+	{
+		MessageWrapper reassembled;
+		if (reassembler.AddFragment(msg.fragment(), reassembled)) {
+			UnpackMessage(reassembled, reassembler, compressor, handler);
+		}
+		break;
+	}
+
+	default:
+		handler(msg);
+		break;
+	}
+}
+
 ProtocolResult ExtenderProtocolBase::PreUpdate(GameTime const& time)
 {
 	return ProtocolResult::Handled;
@@ -93,6 +143,330 @@ void ExtenderProtocolBase::OnRemovedFromHost()
 
 void ExtenderProtocolBase::Reset()
 {
+	ClearReassemblers();
+}
+
+void ExtenderProtocolBase::ClearReassembler(PeerId peerId)
+{
+	reassemblers_.erase(peerId);
+}
+
+void ExtenderProtocolBase::ClearReassemblers()
+{
+	reassemblers_.clear();
+}
+
+void OutgoingMessageQueue::Push(MessageWrapper const& msg, bool allowFragmentation, MessageCompressor* compressor)
+{
+	if (allowFragmentation && msg.ByteSizeLong() > FragmentSize) {
+		PushFragments(msg, compressor);
+	} else {
+		messages_.push_back(msg);
+	}
+}
+
+void OutgoingMessageQueue::PushFragments(MessageWrapper const& msg, MessageCompressor* compressor)
+{
+	MessageWrapper payload;
+	payload.CopyFrom(msg);
+	if (compressor != nullptr) {
+		compressor->Compress(payload);
+	}
+
+	std::string serialized;
+	if (!payload.SerializeToString(&serialized)) {
+		OsiErrorS("Failed to serialize message for fragmentation");
+		return;
+	}
+
+	auto transferId = nextTransferId_++;
+	uint32_t count = (uint32_t)((serialized.size() + FragmentSize - 1) / FragmentSize);
+	for (uint32_t i = 0; i < count; i++) {
+		auto offset = i * FragmentSize;
+		auto& wrapper = fragments_.emplace_back();
+		auto fragment = wrapper.mutable_fragment();
+		fragment->set_transfer_id(transferId);
+		fragment->set_index(i);
+		fragment->set_count(count);
+		fragment->set_offset(offset);
+		fragment->set_total_size((uint32_t)serialized.size());
+		fragment->set_data(serialized.data() + offset, std::min<std::size_t>(FragmentSize, serialized.size() - offset));
+	}
+}
+
+void OutgoingMessageQueue::Clear()
+{
+	messages_.clear();
+	next_ = 0;
+	fragments_.clear();
+	fragmentBudget_ = FragmentBudgetPerTick;
+}
+
+void OutgoingMessageQueue::BeginTick()
+{
+	fragmentBudget_ = FragmentBudgetPerTick;
+}
+
+std::size_t OutgoingMessageQueue::PopMessages(MessageWrapper& packet, MessageCompressor* compressor)
+{
+	if (next_ >= messages_.size()) {
+		return 0;
+	}
+
+	if (next_ + 1 == messages_.size()) {
+		packet.Swap(&messages_[next_++]);
+	} else {
+		auto batch = packet.mutable_batch();
+		std::size_t packetSize{ 0 };
+		while (next_ < messages_.size()) {
+			// Add tag + length overhead of the nested message
+			auto msgSize = messages_[next_].ByteSizeLong() + 8;
+			if (packetSize > 0 && packetSize + msgSize > ExtenderMessage::MaxPayloadLength) {
+				break;
+			}
+
+			batch->add_messages()->Swap(&messages_[next_++]);
+			packetSize += msgSize;
+		}
+	}
+
+	if (next_ >= messages_.size()) {
+		messages_.clear();
+		next_ = 0;
+	}
+
+	auto size = packet.ByteSizeLong();
+	if (compressor != nullptr && size >= CompressionThreshold && compressor->Compress(packet)) {
+		size = packet.ByteSizeLong();
+	}
+
+	return size;
+}
+
+void OutgoingMessageQueue::PopPacket(MessageWrapper& packet, MessageCompressor* compressor)
+{
+	packet.Clear();
+
+	MessageWrapper messages;
+	auto packetSize = PopMessages(messages, compressor);
+
+	// Fill the remaining space in the packet with fragments, if we still have budget for this tick
+	std::vector<MessageWrapper> fragments;
+	while (!fragments_.empty() && fragmentBudget_ > 0) {
+		auto fragmentSize = (uint32_t)fragments_.front().ByteSizeLong() + 8;
+		if (packetSize + fragmentSize > ExtenderMessage::MaxPayloadLength) {
+			break;
+		}
+
+		fragments.push_back(std::move(fragments_.front()));
+		fragments_.pop_front();
+		packetSize += fragmentSize;
+		fragmentBudget_ = (fragmentBudget_ > fragmentSize) ? (fragmentBudget_ - fragmentSize) : 0;
+	}
+
+	if (fragments.empty()) {
+		packet.Swap(&messages);
+	} else if (messages.msg_case() == MessageWrapper::MSG_NOT_SET && fragments.size() == 1) {
+		packet.Swap(&fragments[0]);
+	} else {
+		auto batch = packet.mutable_batch();
+		if (messages.msg_case() != MessageWrapper::MSG_NOT_SET) {
+			batch->add_messages()->Swap(&messages);
+		}
+
+		for (auto& fragment : fragments) {
+			batch->add_messages()->Swap(&fragment);
+		}
+	}
+}
+
+bool FragmentReassembler::AddFragment(MsgFragment const& fragment, MessageWrapper& msg)
+{
+	constexpr uint64_t fragmentSize = OutgoingMessageQueue::FragmentSize;
+	// Each fragment index maps to exactly one range of the message, so receiving all indices
+	// means that the whole message was received without overlaps or gaps
+	uint64_t expectedOffset = (uint64_t)fragment.index() * fragmentSize;
+	if (fragment.total_size() == 0
+		|| fragment.total_size() > MaxMessageSize
+		|| fragment.count() != (fragment.total_size() + fragmentSize - 1) / fragmentSize
+		|| fragment.index() >= fragment.count()
+		|| fragment.offset() != expectedOffset
+		|| fragment.data().size() != std::min<uint64_t>(fragmentSize, fragment.total_size() - expectedOffset)) {
+		OsiErrorS("Received malformed message fragment");
+		return false;
+	}
+
+	auto it = transfers_.find(fragment.transfer_id());
+	if (it == transfers_.end()) {
+		if (std::find(completedTransfers_.begin(), completedTransfers_.end(), fragment.transfer_id()) != completedTransfers_.end()) {
+			// Duplicate of a fragment from an already reassembled message
+			return false;
+		}
+
+		while (!transfers_.empty() 
+			&& (transfers_.size() >= MaxPendingTransfers || pendingBytes_ + fragment.total_size() > MaxPendingBytes)) {
+			DiscardOldestTransfer();
+		}
+
+		Transfer transfer;
+		transfer.Count = fragment.count();
+		transfer.Sequence = nextSequence_++;
+		transfer.Received.resize(fragment.count(), false);
+		transfer.Data.resize(fragment.total_size());
+		pendingBytes_ += fragment.total_size();
+		it = transfers_.insert(std::make_pair(fragment.transfer_id(), std::move(transfer))).first;
+	}
+
+	auto& transfer = it->second;
+	if (transfer.Count != fragment.count() || transfer.Data.size() != fragment.total_size()) {
+		OsiErrorS("Message fragment doesn't match transfer; discarding transfer");
+		DiscardTransfer(it);
+		return false;
+	}
+
+	if (transfer.Received[fragment.index()]) {
+		// Duplicate fragment
+		return false;
+	}
+
+	memcpy(transfer.Data.data() + fragment.offset(), fragment.data().data(), fragment.data().size());
+	transfer.Received[fragment.index()] = true;
+	transfer.ReceivedCount++;
+
+	if (transfer.ReceivedCount < transfer.Count) {
+		return false;
+	}
+
+	bool parsed = msg.ParseFromString(transfer.Data)
+		// Don't allow fragments to contain further fragments
+		&& msg.msg_case() != MessageWrapper::kFragment;
+	completedTransfers_.push_back(it->first);
+	if (completedTransfers_.size() > CompletedTransferHistory) {
+		completedTransfers_.pop_front();
+	}
+	DiscardTransfer(it);
+
+	if (!parsed) {
+		OsiErrorS("Failed to parse reassembled message");
+	}
+
+	return parsed;
+}
+
+void FragmentReassembler::Clear()
+{
+	transfers_.clear();
+	completedTransfers_.clear();
+	pendingBytes_ = 0;
+}
+
+std::vector<uint32_t> FragmentReassembler::GetPendingTransfers() const
+{
+	std::vector<uint32_t> transfers;
+	for (auto const& transfer : transfers_) {
+		transfers.push_back(transfer.first);
+	}
+
+	return transfers;
+}
+
+void FragmentReassembler::DiscardOldestTransfer()
+{
+	auto oldest = transfers_.begin();
+	for (auto it = transfers_.begin(); it != transfers_.end(); it++) {
+		if (it->second.Sequence < oldest->second.Sequence) {
+			oldest = it;
+		}
+	}
+
+	WARN("Discarding incomplete fragmented message %d", oldest->first);
+	DiscardTransfer(oldest);
+}
+
+void FragmentReassembler::DiscardTransfer(std::unordered_map<uint32_t, Transfer>::iterator it)
+{
+	pendingBytes_ -= it->second.Data.size();
+	transfers_.erase(it);
+}
+
+MessageCompressor::~MessageCompressor()
+{
+	if (compressor_ != nullptr) {
+		CloseCompressor((COMPRESSOR_HANDLE)compressor_);
+	}
+
+	if (decompressor_ != nullptr) {
+		CloseDecompressor((DECOMPRESSOR_HANDLE)decompressor_);
+	}
+}
+
+bool MessageCompressor::Compress(MessageWrapper& msg)
+{
+	if (compressor_ == nullptr) {
+		COMPRESSOR_HANDLE compressor;
+		if (!CreateCompressor(COMPRESS_ALGORITHM_XPRESS, NULL, &compressor)) {
+			ERR("CreateCompressor() failed: %d", GetLastError());
+			return false;
+		}
+
+		compressor_ = compressor;
+	}
+
+	auto size = msg.ByteSizeLong();
+	std::string uncompressed;
+	uncompressed.resize(size);
+	if (!msg.SerializeToArray(uncompressed.data(), (int)size)) {
+		return false;
+	}
+
+	std::string compressed;
+	compressed.resize(size);
+	SIZE_T compressedSize{ 0 };
+	auto succeeded = ::Compress((COMPRESSOR_HANDLE)compressor_, uncompressed.data(), size, compressed.data(), compressed.size(), &compressedSize);
+
+	// Compress() fails with ERROR_INSUFFICIENT_BUFFER if the output wouldn't be smaller than the input
+	if (!succeeded || compressedSize + 16 >= size || size > compressedSize * MaxCompressionRatio) {
+		return false;
+	}
+
+	compressed.resize(compressedSize);
+	auto payload = msg.mutable_compressed();
+	payload->set_uncompressed_size((uint32_t)size);
+	payload->set_data(std::move(compressed));
+	return true;
+}
+
+bool MessageCompressor::Decompress(MsgCompressed const& compressed, MessageWrapper& msg)
+{
+	if (compressed.uncompressed_size() > FragmentReassembler::MaxMessageSize
+		|| compressed.uncompressed_size() > (uint64_t)compressed.data().size() * MaxCompressionRatio) {
+		ERR("Compressed message too large (%d bytes, %d bytes compressed)", compressed.uncompressed_size(), (uint32_t)compressed.data().size());
+		return false;
+	}
+
+	if (decompressor_ == nullptr) {
+		DECOMPRESSOR_HANDLE decompressor;
+		if (!CreateDecompressor(COMPRESS_ALGORITHM_XPRESS, NULL, &decompressor)) {
+			ERR("CreateDecompressor() failed: %d", GetLastError());
+			return false;
+		}
+
+		decompressor_ = decompressor;
+	}
+
+	std::string uncompressed;
+	uncompressed.resize(compressed.uncompressed_size());
+	SIZE_T uncompressedSize{ 0 };
+	auto succeeded = ::Decompress((DECOMPRESSOR_HANDLE)decompressor_, compressed.data().data(), compressed.data().size(),
+		uncompressed.data(), uncompressed.size(), &uncompressedSize);
+
+	if (!succeeded || uncompressedSize != uncompressed.size()) {
+		return false;
+	}
+
+	return msg.ParseFromArray(uncompressed.data(), (int)uncompressed.size())
+		// Don't allow nesting compressed payloads
+		&& msg.msg_case() != MessageWrapper::kCompressed;
 }
 
 ExtenderMessage::ExtenderMessage()
@@ -2,6 +2,7 @@
 
 #include <GameDefinitions/Net.h>
 #include <Extender/Shared/ExtenderProtocol.pb.h>
+#include <deque>
 
 BEGIN_NS(net)
 
@@ -12,8 +13,14 @@ public:
 	static constexpr uint32_t MaxPayloadLength = 0xfffff;
 
 	static constexpr uint32_t VerInitial = 1;
+	// Added support for MsgBatch and MsgCompressed
+	static constexpr uint32_t VerBatching = 2;
+	// Added support for MsgFragment
+	static constexpr uint32_t VerFragmentation = 3;
+	// Composite user variables are sent in binary format instead of JSON
+	static constexpr uint32_t VerBinaryUserVars = 4;
 	// Version of protocol, increment each time the protobuf changes
-	static constexpr uint32_t ProtoVersion = VerInitial;
+	static constexpr uint32_t ProtoVersion = VerBinaryUserVars;
 
 	ExtenderMessage();
 	~ExtenderMessage() override;
@@ -47,9 +54,122 @@ private:
 };
 
 
+// Keeps XPRESS compressor/decompressor handles alive between messages,
+// since creating them for every packet costs more than compressing small payloads
+class MessageCompressor : public Noncopyable<MessageCompressor>
+{
+public:
+	// Max. ratio of decompressed to compressed size; protects against small payloads
+	// that would expand into huge allocations. Payloads that compress better are sent uncompressed.
+	static constexpr uint32_t MaxCompressionRatio = 256;
+
+	~MessageCompressor();
+
+	bool Compress(MessageWrapper& msg);
+	bool Decompress(MsgCompressed const& compressed, MessageWrapper& msg);
+
+private:
+	// COMPRESSOR_HANDLE, DECOMPRESSOR_HANDLE
+	void* compressor_{ nullptr };
+	void* decompressor_{ nullptr };
+};
+
+// Collects messages sent to a single peer during a tick and packs them into
+// as few (optionally compressed) extender packets as possible.
+// Messages that don't fit into a single packet are split into fragments that are
+// sent over multiple ticks, interleaved with regular traffic.
+// Regular messages are sent ahead of queued fragments, so a large fragmented message may
+// arrive after small messages that were sent later; the order of regular messages is preserved.
+class OutgoingMessageQueue
+{
+public:
+	// Minimum packet size where we attempt to compress the payload
+	static constexpr uint32_t CompressionThreshold = 0x400;
+	// Messages larger than this are split into fragments
+	static constexpr uint32_t FragmentSize = 0x10000;
+	// Max. amount of fragment data sent to a peer per tick
+	static constexpr uint32_t FragmentBudgetPerTick = 0x40000;
+
+	// Messages are sent uncompressed if no compressor is specified (i.e. for the local peer)
+	void Push(MessageWrapper const& msg, bool allowFragmentation, MessageCompressor* compressor);
+	void Clear();
+	// Resets the per-tick fragment budget
+	void BeginTick();
+	// Moves the next packet worth of queued messages into the outgoing message
+	void PopPacket(MessageWrapper& packet, MessageCompressor* compressor);
+
+	// Is there anything that can be sent during this tick?
+	inline bool HasPacket() const
+	{
+		return next_ < messages_.size()
+			|| (!fragments_.empty() && fragmentBudget_ > 0);
+	}
+
+	// Are there any messages or fragments waiting to be sent?
+	inline bool IsEmpty() const
+	{
+		return next_ >= messages_.size() && fragments_.empty();
+	}
+
+private:
+	std::vector<MessageWrapper> messages_;
+	std::size_t next_{ 0 };
+	std::deque<MessageWrapper> fragments_;
+	uint32_t fragmentBudget_{ FragmentBudgetPerTick };
+	uint32_t nextTransferId_{ 1 };
+
+	void PushFragments(MessageWrapper const& msg, MessageCompressor* compressor);
+	std::size_t PopMessages(MessageWrapper& packet, MessageCompressor* compressor);
+};
+
+// Reassembles fragmented messages received from a single peer.
+// Memory usage is bounded; the oldest incomplete transfers are discarded when the limits are exceeded.
+class FragmentReassembler
+{
+public:
+	// Max. size of a reassembled message
+	static constexpr uint32_t MaxMessageSize = 0x4000000;
+	// Max. amount of memory used by incomplete transfers
+	static constexpr uint32_t MaxPendingBytes = 0x8000000;
+	static constexpr uint32_t MaxPendingTransfers = 16;
+	// Number of completed transfer IDs remembered for discarding late duplicate fragments
+	static constexpr uint32_t CompletedTransferHistory = 16;
+
+	// Returns true if the fragment completed a message.
+	// Fragments must tile the message exactly, the way OutgoingMessageQueue splits it.
+	bool AddFragment(MsgFragment const& fragment, MessageWrapper& msg);
+	void Clear();
+	// Transfer IDs of incomplete messages
+	std::vector<uint32_t> GetPendingTransfers() const;
+
+private:
+	struct Transfer
+	{
+		uint32_t Count{ 0 };
+		uint32_t ReceivedCount{ 0 };
+		uint64_t Sequence{ 0 };
+		std::vector<bool> Received;
+		std::string Data;
+	};
+
+	std::unordered_map<uint32_t, Transfer> transfers_;
+	std::deque<uint32_t> completedTransfers_;
+	std::size_t pendingBytes_{ 0 };
+	uint64_t nextSequence_{ 0 };
+
+	void DiscardOldestTransfer();
+	void DiscardTransfer(std::unordered_map<uint32_t, Transfer>::iterator it);
+};
+
+// Unpacks batched, compressed and fragmented messages; calls the handler for each regular message
+void UnpackMessage(MessageWrapper& msg, FragmentReassembler& reassembler, MessageCompressor& compressor,
+	std::function<void (MessageWrapper&)> const& handler);
+
+
 class ExtenderProtocolBase : public Protocol
 {
 public:
+	ExtenderProtocolBase(MessageCompressor& compressor);
 	~ExtenderProtocolBase() override;
 
 	ProtocolResult ProcessMsg(void * unused, MessageContext * unknown, Message* usg) override;
@@ -60,8 +180,17 @@ public:
 	void Reset() override;
 
 	void SyncUserVars(MsgUserVars const& msg);
+	// Drops partially received fragmented messages
+	void ClearReassembler(PeerId peerId);
+	void ClearReassemblers();
 
 protected:
+	// Reassembly state for fragmented messages, by sender
+	std::unordered_map<PeerId, FragmentReassembler> reassemblers_;
+	// Owned by the network manager
+	MessageCompressor& compressor_;
+
+	void DispatchExtenderMessage(net::MessageContext& context, MessageWrapper& msg);
 	virtual void ProcessExtenderMessage(net::MessageContext& context, MessageWrapper & msg) = 0;
 };
 
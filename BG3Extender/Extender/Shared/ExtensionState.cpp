@@ -494,6 +494,7 @@ namespace bg3se
 		}
 
 		luaPostResetCallbacks_.clear();
+		gExtender->GetLuaChunkCache().SavePersistentCache();
 
 		// Prevent Lua state deletion during startup; it would most likely lead to an infinite delete loop
 		if (LuaPendingDelete) {
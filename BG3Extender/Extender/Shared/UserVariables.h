@@ -23,15 +23,19 @@ struct UserVariable
 	UserVariable(STDString const& v) : Type(UserVariableType::Composite), CompositeStr(v) {}
 
 	void SavegameVisit(ObjectVisitor* visitor);
-	void ToNetMessage(net::UserVar& var) const;
+	// Composite values are converted to JSON if the receiving peers don't support the binary format
+	void ToNetMessage(net::UserVar& var, bool allowBinary) const;
 	void FromNetMessage(net::UserVar const& var);
 	size_t Budget() const;
+	bool HasSameValue(UserVariable const& o) const;
 
 	UserVariableType Type{ UserVariableType::Null };
 	bool Dirty{ false };
 	int64_t Int{ 0ll };
 	double Dbl{ 0.0 };
 	FixedString Str;
+	// Binary encoded Lua value (see LuaBinaryEncoding.h);
+	// may also be JSON text when loaded from older savegames or received from older peers
 	STDString CompositeStr;
 };
 
@@ -118,8 +122,10 @@ private:
 	UserVariableInterface* vars_;
 	Array<SyncRequest> deferredSyncs_;
 	Array<SyncRequest> nextTickSyncs_;
-	net::ExtenderMessage* syncMsg_{ nullptr };
+	net::MessageWrapper syncMsg_;
 	size_t syncMsgBudget_{ 0 };
+	// Whether all recipients of the current sync message understand binary composite values
+	bool allowBinary_{ false };
 	bool isServer_;
 	UserVarClass varClass_;
 
@@ -278,8 +284,8 @@ struct CachedUserVariable
 	void Push(lua_State* L) const;
 	bool LikelyChanged(CachedUserVariable const& o) const;
 	UserVariable ToUserVariable(lua_State* L) const;
-	STDString StringifyReference(lua_State* L) const;
-	void ParseReference(lua_State* L, StringView json);
+	STDString SerializeReference(lua_State* L) const;
+	void ParseReference(lua_State* L, StringView data);
 };
 
 class CachedUserVariableManager
@@ -1,6 +1,7 @@
 #include <Extender/Shared/UserVariables.h>
 #include <GameDefinitions/Components/Components.h>
 #include <Lua/Libs/Json.h>
+#include <Lua/Shared/LuaBinaryEncoding.h>
 
 #define USER_VAR_DBG(msg, ...)
 //#define USER_VAR_DBG(msg, ...) DEBUG(msg, __VA_ARGS__)
@@ -43,6 +44,17 @@ void UserVariable::SavegameVisit(ObjectVisitor* visitor)
 			break;
 		case UserVariableType::Composite:
 			visitor->VisitSTDString(GFS.strValue, CompositeStr, STDString{});
+			// Binary values are stored as text; anything else is JSON from an older version
+			if (lua::binary::IsTextEncoded(CompositeStr)) {
+				STDString data;
+				if (lua::binary::FromText(CompositeStr, data)) {
+					CompositeStr = std::move(data);
+				} else {
+					ERR("Failed to decode user variable blob from savegame");
+					Type = UserVariableType::Null;
+					CompositeStr.clear();
+				}
+			}
 			break;
 		}
 	} else {
@@ -59,13 +71,18 @@ void UserVariable::SavegameVisit(ObjectVisitor* visitor)
 			visitor->VisitFixedString(GFS.strValue, Str, GFS.strEmpty);
 			break;
 		case UserVariableType::Composite:
-			visitor->VisitSTDString(GFS.strValue, CompositeStr, STDString{});
+			if (lua::binary::IsBinaryEncoded(CompositeStr)) {
+				auto text = lua::binary::ToText(CompositeStr);
+				visitor->VisitSTDString(GFS.strValue, text, STDString{});
+			} else {
+				visitor->VisitSTDString(GFS.strValue, CompositeStr, STDString{});
+			}
 			break;
 		}
 	}
 }
 
-void UserVariable::ToNetMessage(net::UserVar& var) const
+void UserVariable::ToNetMessage(net::UserVar& var, bool allowBinary) const
 {
 	switch (Type) {
 	case UserVariableType::Null:
@@ -84,7 +101,16 @@ void UserVariable::ToNetMessage(net::UserVar& var) const
 		break;
 
 	case UserVariableType::Composite:
-		var.set_luaval(CompositeStr.c_str(), CompositeStr.size());
+		if (allowBinary || !lua::binary::IsBinaryEncoded(CompositeStr)) {
+			var.set_luaval(CompositeStr.c_str(), CompositeStr.size());
+		} else {
+			STDString json;
+			if (lua::binary::ToJson(CompositeStr, json)) {
+				var.set_luaval(json.c_str(), json.size());
+			} else {
+				ERR("Failed to convert user variable blob to JSON");
+			}
+		}
 		break;
 	}
 }
@@ -134,6 +160,23 @@ size_t UserVariable::Budget() const
 	return budget;
 }
 
+bool UserVariable::HasSameValue(UserVariable const& o) const
+{
+	if (Type != o.Type) return false;
+
+	switch (Type) {
+	case UserVariableType::Int64: return Int == o.Int;
+	case UserVariableType::Double: return Dbl == o.Dbl;
+	case UserVariableType::String: return Str == o.Str;
+	// Encoded values are compared byte-by-byte; since table iteration order isn't stable,
+	// this may report equal tables as different, but never the other way around
+	case UserVariableType::Composite: return CompositeStr == o.CompositeStr;
+	case UserVariableType::Null:
+	default:
+		return true;
+	}
+}
+
 
 bool UserVariablePrototype::NeedsRebroadcast(bool server) const
 {
@@ -196,7 +239,7 @@ void UserVariableSyncWriter::Clear()
 {
 	deferredSyncs_.clear();
 	nextTickSyncs_.clear();
-	syncMsg_ = nullptr;
+	syncMsg_.Clear();
 	syncMsgBudget_ = 0;
 }
 
@@ -240,7 +283,7 @@ void UserVariableSyncWriter::AppendToSyncMessage(Guid const& entity, FixedString
 		MakeSyncMessage();
 	}
 
-	auto var = syncMsg_->GetMessage().mutable_user_vars()->add_vars();
+	auto var = syncMsg_.mutable_user_vars()->add_vars();
 	switch (varClass_) {
 	case UserVarClass::EntityVar: var->set_type(net::UserVarType::ENTITY_VAR); break;
 	case UserVarClass::ModuleVar: var->set_type(net::UserVarType::MODULE_VAR); break;
@@ -249,7 +292,7 @@ void UserVariableSyncWriter::AppendToSyncMessage(Guid const& entity, FixedString
 	var->set_uuid1(entity.Val[0]);
 	var->set_uuid2(entity.Val[1]);
 	var->set_key(key.GetString());
-	value.ToNetMessage(*var);
+	value.ToNetMessage(*var, allowBinary_);
 	syncMsgBudget_ += value.Budget() + key.GetLength();
 }
 
@@ -271,24 +314,30 @@ void UserVariableSyncWriter::FlushSyncQueue(Array<SyncRequest>& queue)
 
 bool UserVariableSyncWriter::MakeSyncMessage()
 {
-	if (syncMsg_ == nullptr) {
+	if (!syncMsg_.has_user_vars()) {
+		bool canSend;
 		if (isServer_) {
-			syncMsg_ = gExtender->GetServer().GetNetworkManager().GetFreeMessage();
+			canSend = gExtender->GetServer().GetNetworkManager().GetServer() != nullptr;
 		} else {
-			syncMsg_ = gExtender->GetClient().GetNetworkManager().GetFreeMessage();
+			canSend = gExtender->GetClient().GetNetworkManager().CanSendExtenderMessages();
 		}
 
-		if (syncMsg_) {
-			syncMsg_->GetMessage().mutable_user_vars();
+		if (canSend) {
+			syncMsg_.mutable_user_vars();
+			if (isServer_) {
+				allowBinary_ = gExtender->GetServer().GetNetworkManager().GetMinPeerVersion() >= net::ExtenderMessage::VerBinaryUserVars;
+			} else {
+				allowBinary_ = gExtender->GetClient().GetNetworkManager().GetHostVersion() >= net::ExtenderMessage::VerBinaryUserVars;
+			}
 		}
 	}
 
-	return syncMsg_ != nullptr;
+	return syncMsg_.has_user_vars();
 }
 
 void UserVariableSyncWriter::SendSyncs()
 {
-	if (syncMsg_ && syncMsg_->GetMessage().user_vars().vars_size() > 0) {
+	if (syncMsg_.has_user_vars() && syncMsg_.user_vars().vars_size() > 0) {
 		if (isServer_) {
 			USER_VAR_DBG("Syncing user vars to client(s)");
 			gExtender->GetServer().GetNetworkManager().BroadcastToConnectedPeers(syncMsg_, ReservedUserId, false);
@@ -297,7 +346,7 @@ void UserVariableSyncWriter::SendSyncs()
 			gExtender->GetClient().GetNetworkManager().Send(syncMsg_);
 		}
 
-		syncMsg_ = nullptr;
+		syncMsg_.Clear();
 		syncMsgBudget_ = 0;
 	}
 }
@@ -340,7 +389,13 @@ void UserVariableManager::MarkDirty(Guid const& entity, FixedString const& key,
 UserVariableManager::EntityVariables* UserVariableManager::Set(Guid const& entity, FixedString const& key, UserVariablePrototype const& proto, UserVariable&& value)
 {
 	if (value.Dirty) {
-		sync_.Sync(entity, key, proto, &value);
+		auto existing = Get(entity, key);
+		if (existing && existing->HasSameValue(value)) {
+			// Skip resync of unchanged values; a pending sync of the old value is still needed though
+			value.Dirty = existing->Dirty;
+		} else {
+			sync_.Sync(entity, key, proto, &value);
+		}
 	}
 
 	auto it = vars_.try_get(entity);
@@ -675,7 +730,13 @@ ModVariableMap* ModVariableManager::Set(Guid const& modUuid, FixedString const&
 void ModVariableManager::Set(ModVariableMap& mod, FixedString const& key, UserVariablePrototype const& proto, UserVariable&& value)
 {
 	if (value.Dirty) {
-		sync_.Sync(mod.ModuleUuid(), key, proto, &value);
+		auto existing = mod.Get(key);
+		if (existing && existing->HasSameValue(value)) {
+			// Skip resync of unchanged values; a pending sync of the old value is still needed though
+			value.Dirty = existing->Dirty;
+		} else {
+			sync_.Sync(mod.ModuleUuid(), key, proto, &value);
+		}
 	}
 
 	mod.Set(key, proto, std::move(value));
@@ -921,14 +982,28 @@ CachedUserVariable& CachedUserVariable::operator = (CachedUserVariable&& o)
 	return *this;
 }
 
-void CachedUserVariable::ParseReference(lua_State* L, StringView json)
+void CachedUserVariable::ParseReference(lua_State* L, StringView data)
 {
-	if (json::Parse(L, json)) {
+	bool parsed;
+	if (binary::IsBinaryEncoded(data)) {
+		STDString error;
+		parsed = binary::Decode(L, data, error);
+		if (!parsed) {
+			ERR("Failed to decode user variable blob: %s", error.c_str());
+		}
+	} else {
+		// Legacy JSON value from an older savegame or peer
+		parsed = json::Parse(L, data);
+		if (!parsed) {
+			ERR("Failed to parse user variable blob");
+		}
+	}
+
+	if (parsed) {
 		Reference = RegistryEntry(L, -1);
 		lua_pop(L, 1);
 		Type = CachedUserVariableType::Reference;
 	} else {
-		ERR("Failed to parse user variable blob");
 		Type = CachedUserVariableType::Null;
 	}
 }
@@ -960,7 +1035,8 @@ bool CachedUserVariable::LikelyChanged(CachedUserVariable const& o) const
 		return Str != o.Str;
 	case CachedUserVariableType::Reference:
 		// There is no fast way to compare values apart from serializing the values on both sides;
-		// assume that a write to a composite value is an explicit way to indicate that the value changed.
+		// assume that the value changed here, unchanged encoded values are filtered out when
+		// the value is written to the global variable store (see UserVariable::HasSameValue())
 		return true;
 
 	case CachedUserVariableType::Null:
@@ -993,7 +1069,7 @@ UserVariable CachedUserVariable::ToUserVariable(lua_State* L) const
 		break;
 		
 	case CachedUserVariableType::Reference:
-		var.CompositeStr = StringifyReference(L);
+		var.CompositeStr = SerializeReference(L);
 		if (!var.CompositeStr.empty()) {
 			var.Type = UserVariableType::Composite;
 		} else {
@@ -1006,17 +1082,15 @@ UserVariable CachedUserVariable::ToUserVariable(lua_State* L) const
 	return var;
 }
 
-STDString CachedUserVariable::StringifyReference(lua_State* L) const
+STDString CachedUserVariable::SerializeReference(lua_State* L) const
 {
 	Reference.Push();
-	json::StringifyContext ctx;
-	ctx.Beautify = false;
 
 	STDString str;
 	try {
-		str = json::Stringify(L, ctx, lua_absindex(L, -1));
+		binary::Encode(L, -1, str);
 	} catch (std::runtime_error& e) {
-		ERR("Error stringifying user variable: %s", e.what());
+		ERR("Error serializing user variable: %s", e.what());
 		str.clear();
 	}
 
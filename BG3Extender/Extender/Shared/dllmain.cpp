@@ -79,10 +79,19 @@ void LoadConfig(std::wstring const & configPath, ExtenderConfig & config)
 	ConfigGetBool(root, "DisableStoryMerge", config.DisableStoryMerge);
 	ConfigGetBool(root, "DisableStoryPatching", config.DisableStoryPatching);
 	ConfigGetBool(root, "DisableStoryCompilation", config.DisableStoryCompilation);
+	ConfigGetBool(root, "EnableSymbolCache", config.EnableSymbolCache);
+	ConfigGetBool(root, "VerifySymbolScan", config.VerifySymbolScan);
+	ConfigGetBool(root, "EnableLuaChunkCache", config.EnableLuaChunkCache);
+	ConfigGetBool(root, "PersistLuaChunkCache", config.PersistLuaChunkCache);
+	ConfigGetBool(root, "AsyncLogging", config.AsyncLogging);
 
 	ConfigGetInt(root, "DebuggerPort", config.DebuggerPort);
 	ConfigGetInt(root, "LuaDebuggerPort", config.LuaDebuggerPort);
 	ConfigGetInt(root, "DebugFlags", config.DebugFlags);
+	ConfigGetInt(root, "LogRateLimit", config.LogRateLimit);
+	ConfigGetInt(root, "LuaGCBudget", config.LuaGCBudget);
+	ConfigGetInt(root, "LuaGCPause", config.LuaGCPause);
+	ConfigGetInt(root, "LuaGCStepMul", config.LuaGCStepMul);
 
 	ConfigGet(root, "LogDirectory", config.LogDirectory);
 	ConfigGet(root, "LuaBuiltinResourceDirectory", config.LuaBuiltinResourceDirectory);
@@ -96,6 +105,11 @@ void SetupScriptExtender(HMODULE hModule)
 	LoadConfig(L"ScriptExtenderSettings.json", config);
 
 	DisableThreadLibraryCalls(hModule);
+	gCoreLibPlatformInterface.GlobalConsole->SetRateLimit(config.LogRateLimit);
+	if (config.AsyncLogging) {
+		gCoreLibPlatformInterface.GlobalConsole->EnableAsyncOutput();
+	}
+
 	if (config.CreateConsole) {
 		gCoreLibPlatformInterface.GlobalConsole->Create();
 	}
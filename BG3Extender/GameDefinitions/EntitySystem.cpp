@@ -245,6 +245,81 @@ void* EntityStorageData::GetComponent(EntityStorageIndex const& entityPtr, uint8
 	}
 }
 
+EntityStorageQuery::EntityStorageQuery(EntityStorageContainer const* storage)
+	: storage_(storage)
+{}
+
+bool EntityStorageQuery::AddComponent(ComponentTypeIndex type, std::size_t componentSize, bool isProxy)
+{
+	if (numComponents_ >= MaxComponents) {
+		return false;
+	}
+
+	components_[numComponents_++] = ComponentInfo{ type, (uint16_t)componentSize, isProxy, 0 };
+	return true;
+}
+
+bool EntityStorageQuery::BindClass(EntityStorageData const* cls)
+{
+	if (cls == nullptr || cls->InstanceToPageMap.size() == 0) {
+		return false;
+	}
+
+	for (unsigned i = 0; i < numComponents_; i++) {
+		auto& component = components_[i];
+		if (!cls->HasComponent(component.Type)) {
+			return false;
+		}
+
+		auto slot = cls->ComponentTypeToIndex.try_get(component.Type);
+		if (!slot) {
+			return false;
+		}
+
+		component.Slot = *slot;
+	}
+
+	return true;
+}
+
+bool EntityStorageQuery::Next()
+{
+	if (class_ != nullptr) {
+		// The class may have been destroyed or replaced during iteration
+		if (nextClass_ <= storage_->Entities.size()
+			&& storage_->Entities[nextClass_ - 1] == class_
+			&& ++instance_ < class_->InstanceToPageMap.size()) {
+			return true;
+		}
+
+		class_ = nullptr;
+	}
+
+	while (nextClass_ < storage_->Entities.size()) {
+		auto cls = storage_->Entities[nextClass_++];
+		if (BindClass(cls)) {
+			class_ = cls;
+			instance_ = 0;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+EntityHandle EntityStorageQuery::GetEntity() const
+{
+	assert(class_ != nullptr);
+	return class_->InstanceToPageMap.keys()[instance_];
+}
+
+void* EntityStorageQuery::GetComponent(unsigned index) const
+{
+	assert(class_ != nullptr && index < numComponents_);
+	auto const& component = components_[index];
+	return class_->GetComponent(class_->InstanceToPageMap.values()[instance_], component.Slot, component.Size, component.IsProxy);
+}
+
 void* ImmediateWorldCache::Changes::GetChange(EntityHandle entityHandle, ComponentTypeIndex type) const
 {
 	auto typeIdx = (uint16_t)type;
@@ -823,12 +898,44 @@ EntityHandle EntitySystemHelpersBase::GetEntityHandle(FixedString const& guidStr
 	}
 }
 
+bool EntitySystemHelpersBase::BindUuidCache()
+{
+	auto world = GetEntityWorld();
+	if (world == nullptr) {
+		return false;
+	}
+
+	if (uuidCache_.GetWorld() != world) {
+		auto uuidType = GetComponentIndex(ExtComponentType::Uuid);
+		if (!uuidType) {
+			// Entries can't be evicted without the component callbacks, so caching is disabled
+			return false;
+		}
+
+		uuidCache_.Bind(world, *uuidType);
+	}
+
+	return true;
+}
+
 EntityHandle EntitySystemHelpersBase::GetEntityHandle(Guid const& uuid)
 {
+	auto cached = BindUuidCache();
+	if (cached) {
+		auto handle = uuidCache_.Find(uuid);
+		if (handle) {
+			return handle;
+		}
+	}
+
 	auto entityMap = GetUuidMappings();
 	if (entityMap) {
 		auto handle = entityMap->Mappings.try_get(uuid);
 		if (handle) {
+			if (cached) {
+				uuidCache_.Add(uuid, *handle);
+			}
+
 			return *handle;
 		}
 	}
@@ -836,6 +943,103 @@ EntityHandle EntitySystemHelpersBase::GetEntityHandle(Guid const& uuid)
 	return {};
 }
 
+void EntitySystemHelpersBase::GetEntityHandles(std::span<Guid const> uuids, Array<EntityHandle>& handles)
+{
+	handles.clear();
+
+	auto cached = BindUuidCache();
+	UuidToHandleMappingComponent* entityMap{ nullptr };
+	bool entityMapFetched{ false };
+
+	for (auto const& uuid : uuids) {
+		EntityHandle handle;
+		if (cached) {
+			handle = uuidCache_.Find(uuid);
+		}
+
+		if (!handle) {
+			// Only look up the mapping component once for all cache misses
+			if (!entityMapFetched) {
+				entityMap = GetUuidMappings();
+				entityMapFetched = true;
+			}
+
+			auto mapped = entityMap ? entityMap->Mappings.try_get(uuid) : nullptr;
+			if (mapped) {
+				handle = *mapped;
+				if (cached) {
+					uuidCache_.Add(uuid, handle);
+				}
+			}
+		}
+
+		handles.push_back(handle);
+	}
+}
+
+void EntityUuidCache::Bind(EntityWorld* world, ComponentTypeIndex uuidType)
+{
+	// The previous world may already be destroyed, so its callbacks are left as-is;
+	// they're ignored by OnUuidChanged() as the world doesn't match anymore.
+	entries_.clear();
+	world_ = world;
+	uuidType_ = uuidType;
+
+	auto callbacks = world_->ComponentCallbacks[uuidType.Value()];
+	callbacks->OnConstruct.Add(ComponentCallbackHandler{ &OnUuidCreated, this });
+	callbacks->OnDestroy.Add(ComponentCallbackHandler{ &OnUuidDestroyed, this });
+}
+
+EntityHandle EntityUuidCache::Find(Guid const& uuid) const
+{
+	auto handle = entries_.try_get(uuid);
+	// Make sure that the entity wasn't destroyed or reused since the entry was added
+	if (handle && world_->GetEntityStorage(*handle) != nullptr) {
+		return *handle;
+	} else {
+		return {};
+	}
+}
+
+void EntityUuidCache::Add(Guid const& uuid, EntityHandle entity)
+{
+	entries_.set(uuid, entity);
+}
+
+void EntityUuidCache::Clear()
+{
+	entries_.clear();
+}
+
+void EntityUuidCache::OnUuidChanged(EntityWorld* world, EntityHandle entity, UuidComponent const* component, bool destroyed)
+{
+	if (world != world_ || component == nullptr || !component->EntityUuid) {
+		return;
+	}
+
+	if (destroyed) {
+		auto cached = entries_.try_get(component->EntityUuid);
+		if (cached && *cached == entity) {
+			entries_.remove(component->EntityUuid);
+		}
+	} else {
+		// The UUID may have been moved to a new entity
+		entries_.remove(component->EntityUuid);
+	}
+}
+
+void EntityUuidCache::OnUuidCreated(void* object, ComponentCallbackParams const& params, void* component)
+{
+	auto self = reinterpret_cast<EntityUuidCache*>(object);
+	self->OnUuidChanged(params.World, params.Entity, reinterpret_cast<UuidComponent const*>(component), false);
+}
+
+void EntityUuidCache::OnUuidDestroyed(void* object, ComponentCallbackParams const& params, void* component)
+{
+	auto self = reinterpret_cast<EntityUuidCache*>(object);
+	self->OnUuidChanged(params.World, params.Entity, reinterpret_cast<UuidComponent const*>(component), true);
+}
+
 resource::GuidResourceBankBase* EntitySystemHelpersBase::GetRawResourceManager(ExtResourceManagerType type)
 {
 	auto index = staticDataIndices_[(unsigned)type];
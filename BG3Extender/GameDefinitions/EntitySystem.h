@@ -406,6 +406,51 @@ struct EntityStorageContainer : public ProtectedGameObject<EntityStorageContaine
 	EntityStorageData* GetEntityStorage(EntityHandle entityHandle) const;
 };
 
+// Cursor over all entities that have every component in the filter.
+// Handles and components are read directly from the storage pages of each matching entity class,
+// so no intermediate entity or component lists are built.
+// Positions are stored as indices and are bounds-checked on every step, so entities
+// being added or removed during iteration can't cause out-of-bounds reads.
+class EntityStorageQuery
+{
+public:
+	static constexpr unsigned MaxComponents = 8;
+
+	EntityStorageQuery(EntityStorageContainer const* storage);
+
+	// Adds a component to the filter; must be called before the first Next() call
+	bool AddComponent(ComponentTypeIndex type, std::size_t componentSize, bool isProxy);
+	// Moves to the next matching entity; returns false if there are no more matches
+	bool Next();
+
+	EntityHandle GetEntity() const;
+	void* GetComponent(unsigned index) const;
+
+	inline unsigned GetComponentCount() const
+	{
+		return numComponents_;
+	}
+
+private:
+	struct ComponentInfo
+	{
+		ComponentTypeIndex Type;
+		uint16_t Size;
+		bool IsProxy;
+		uint8_t Slot;
+	};
+
+	EntityStorageContainer const* storage_;
+	std::array<ComponentInfo, MaxComponents> components_;
+	unsigned numComponents_{ 0 };
+	// Index of the next entity class to check
+	uint32_t nextClass_{ 0 };
+	EntityStorageData const* class_{ nullptr };
+	uint32_t instance_{ 0 };
+
+	bool BindClass(EntityStorageData const* cls);
+};
+
 struct alignas(64) FrameAllocator : public ProtectedGameObject<FrameAllocator>
 {
 	__int64 FastLock;
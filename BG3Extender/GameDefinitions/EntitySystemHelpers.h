@@ -32,6 +32,38 @@ enum class RuntimeCheckLevel
 	FullECS
 };
 
+// Cache of UUID to entity handle lookups.
+// Entries are evicted by the construct/destroy callbacks of the UUID component, and cached handles
+// are checked against the entity salt before use, so a stale entry is never returned.
+class EntityUuidCache : public Noncopyable<EntityUuidCache>
+{
+public:
+	// Attaches the cache to a new world; entries of the previous world are discarded
+	void Bind(EntityWorld* world, ComponentTypeIndex uuidType);
+	EntityHandle Find(Guid const& uuid) const;
+	void Add(Guid const& uuid, EntityHandle entity);
+	void Clear();
+
+	inline EntityWorld* GetWorld() const
+	{
+		return world_;
+	}
+
+	inline uint32_t Size() const
+	{
+		return entries_.size();
+	}
+
+private:
+	EntityWorld* world_{ nullptr };
+	ComponentTypeIndex uuidType_{ UndefinedComponent };
+	MultiHashMap<Guid, EntityHandle> entries_;
+
+	void OnUuidChanged(EntityWorld* world, EntityHandle entity, UuidComponent const* component, bool destroyed);
+	static void OnUuidCreated(void* object, ComponentCallbackParams const& params, void* component);
+	static void OnUuidDestroyed(void* object, ComponentCallbackParams const& params, void* component);
+};
+
 class EntitySystemHelpersBase : public Noncopyable<EntitySystemHelpersBase>
 {
 public:
@@ -190,6 +222,8 @@ public:
 	void* GetRawSystem(ExtSystemType type);
 	EntityHandle GetEntityHandle(FixedString const& guidString);
 	EntityHandle GetEntityHandle(Guid const& uuid);
+	// Resolves a list of UUIDs; unknown UUIDs are resolved to a null handle
+	void GetEntityHandles(std::span<Guid const> uuids, Array<EntityHandle>& handles);
 	UuidToHandleMappingComponent* GetUuidMappings();
 
 	void Update();
@@ -232,6 +266,8 @@ private:
 	std::unordered_map<STDString, int32_t> staticDataMappings_;
 	std::vector<STDString const*> staticDataIdToName_;
 
+	EntityUuidCache uuidCache_;
+
 	bool initialized_{ false };
 	bool validated_{ false };
 
@@ -242,6 +278,7 @@ private:
 	void BindReplication(std::string_view name, int32_t id);
 	void* GetRawComponent(Guid const& guid, ExtComponentType type);
 	void* GetRawComponent(FixedString const& guid, ExtComponentType type);
+	bool BindUuidCache();
 	resource::GuidResourceBankBase* GetRawResourceManager(ExtResourceManagerType type);
 };
 
@@ -116,6 +116,7 @@ FS(Timer);
 FS(Time);
 FS(Handler);
 FS(Args);
+FS(Paused);
 
 // Enums
 FS(Label);
@@ -64,6 +64,17 @@ namespace bg3se
 		}
 
 		RegisterLibraries(symbolMapper_);
+
+		if (gExtender->GetConfig().VerifySymbolScan) {
+			// Cached matches skip the prescan, so there would be nothing to verify
+			symbolMapper_.EnableScanVerification();
+		} else if (gExtender->GetConfig().EnableSymbolCache) {
+			auto cachePath = GetCacheFilePath(L"SymbolCache.bin");
+			if (!cachePath.empty()) {
+				symbolMapper_.EnableMatchCache(cachePath);
+			}
+		}
+
 		symbolMapper_.MapAllSymbols(false);
 
 		CriticalInitFailed = CriticalInitFailed || symbolMapper_.HasFailedCriticalMappings();
@@ -12600,13 +12600,42 @@ local Ext_ClientUI = {}
 
 
 --- @class Ext_Debug
+--- @field BenchmarkLogQueue fun(a1:uint32, a2:uint32):table
+--- @field BenchmarkOsirisSubscriberTable fun(a1:uint32, a2:uint32, a3:uint32):table
+--- @field CountLuaLineHooks fun():uint64
+--- @field CountMapIterationWork fun(a1:uint32, a2:uint32):table
 --- @field Crash fun(a1:int32)
 --- @field DebugBreak fun()
 --- @field DebugDumpLifetimes fun()
+--- @field DumpLuaProfile fun():string
 --- @field DumpStack fun()
+--- @field FlushConsole fun(a1:uint32?):boolean
 --- @field GenerateIdeHelpers fun(a1:boolean?)
+--- @field GetConsoleStats fun():table
+--- @field GetLuaChunkCacheStats fun():table
+--- @field GetLuaGCStats fun():table
+--- @field GetLuaProfile fun():table
+--- @field GetMemoryStats fun():table
+--- @field GetOsirisProfile fun():table
 --- @field IsDeveloperMode fun():boolean
+--- @field JsoncppRoundTrip fun(a1:string):table
+--- @field LoadLuaChunk fun(a1:string, a2:string, a3:boolean):function
+--- @field LuaBundleRoundTrip fun(a1:table, a2:table?):table
+--- @field MapSymbolsWithCache fun(a1:string, a2:table<string, string>, a3:table?):table
+--- @field NetLoopback fun(a1:string|string[], a2:table?):table
+--- @field ProfileOsirisNodeTrace fun(a1:table):table
+--- @field ResetLuaGCStats fun()
+--- @field ResetLuaProfiler fun()
+--- @field ResetOsirisProfiler fun()
+--- @field RunTimerTrace fun(a1:string, a2:table):table
+--- @field ScanPatterns fun(a1:string, a2:string[]):table
 --- @field SetEntityRuntimeCheckLevel fun(a1:int32)
+--- @field SetJsonUserVariable fun(a1:EntityHandle, a2:FixedString, a3:string):boolean
+--- @field SetLuaGCBudget fun(a1:uint32)
+--- @field StartLuaProfiler fun(a1:uint32?)
+--- @field StartOsirisProfiler fun(a1:boolean?):boolean
+--- @field StopLuaProfiler fun()
+--- @field StopOsirisProfiler fun()
 local Ext_Debug = {}
 
 
@@ -12795,7 +12824,10 @@ local Ext_StatsTreasureTable = {}
 
 --- @class Ext_Timer
 --- @field Cancel fun(a1:uint64):boolean
+--- @field IsPaused fun(a1:uint64):boolean
+--- @field Pause fun(a1:uint64):boolean
 --- @field RegisterPersistentHandler fun(a1:FixedString, a2:Ref)
+--- @field Resume fun(a1:uint64):boolean
 --- @field WaitFor fun(a1:number, a2:Ref, a3:number?):uint64
 --- @field WaitForPersistent fun(a1:number, a2:FixedString, a3:Ref):uint64
 --- @field WaitForRealtime fun(a1:number, a2:Ref, a3:number?):uint64
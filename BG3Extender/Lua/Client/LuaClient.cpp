@@ -45,6 +45,7 @@ void ExtensionLibraryClient::RegisterLib(lua_State * L)
 	lua_setglobal(L, "Ext"); // stack: -
 
 	RegisterSharedMetatables(L);
+	RegisterEventBusLib(L);
 	gModuleRegistry.ConstructState(L, ModuleRole::Client);
 }
 
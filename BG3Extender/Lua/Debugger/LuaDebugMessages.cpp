@@ -277,6 +277,28 @@ void DebugMessageHandler::SendGetVariablesResponse(DebuggerGetVariablesRequest c
 	}
 }
 
+void DebugMessageHandler::SendProfileData(uint32_t seq, DbgContext context, LuaSamplingProfiler const& profiler)
+{
+	DEBUGGER_MSG(msg);
+	msg.set_reply_seq_no(seq);
+	auto profile = msg.mutable_profiledata();
+	profile->set_context(context);
+	profile->set_samples(profiler.GetSampleCount());
+
+	std::unordered_map<STDString, uint64_t> mods;
+	profiler.GetModSamples(mods);
+	for (auto const& mod : mods) {
+		auto modMsg = profile->add_mod();
+		modMsg->set_name(mod.first.c_str());
+		modMsg->set_samples(mod.second);
+	}
+
+	auto folded = profiler.DumpFoldedStacks();
+	profile->set_folded_stacks(folded.data(), folded.size());
+	Send(msg);
+	DBGMSG(" <-- BkProfileData()");
+}
+
 void DebugMessageHandler::SendDebugOutput(DebugMessageType type, char const* message)
 {
 	DEBUGGER_MSG(msg);
@@ -515,6 +537,61 @@ void DebugMessageHandler::HandleReset(uint32_t seq, DbgReset const& req)
 	}
 }
 
+void DebugMessageHandler::ControlProfiler(uint32_t seq, DbgProfilerControl const& req, ExtensionStateBase& state)
+{
+	LuaVirtualPin lua(state);
+	if (!lua) {
+		SendResult(seq, ResultCode::NoDebuggee);
+		return;
+	}
+
+	auto& profiler = lua->GetSamplingProfiler();
+	switch (req.action()) {
+	case DbgProfilerControl::START:
+		profiler.Start(lua->GetState(), req.interval() ? req.interval() : LuaSamplingProfiler::DefaultInterval);
+		break;
+
+	case DbgProfilerControl::STOP:
+		profiler.Stop(lua->GetState());
+		break;
+
+	case DbgProfilerControl::RESET:
+		profiler.Reset();
+		break;
+
+	case DbgProfilerControl::DUMP:
+		SendProfileData(seq, req.context(), profiler);
+		return;
+	}
+
+	SendResult(seq, ResultCode::Success);
+}
+
+void DebugMessageHandler::HandleProfilerControl(uint32_t seq, DbgProfilerControl const& req)
+{
+	DBGMSG(" --> DbgProfilerControl(%d, %d)", req.context(), req.action());
+
+	// The profiler must be accessed from the thread that owns the Lua state
+	if (req.context() == DbgContext::SERVER) {
+		if (gExtender->GetServer().HasExtensionState()) {
+			gExtender->GetServer().EnqueueTask([this, seq, req]() {
+				ControlProfiler(seq, req, gExtender->GetServer().GetExtensionState());
+			});
+			return;
+		}
+	} else {
+		if (gExtender->GetClient().HasExtensionState()) {
+			gExtender->GetClient().EnqueueTask([this, seq, req]() {
+				ControlProfiler(seq, req, gExtender->GetClient().GetExtensionState());
+			});
+			return;
+		}
+	}
+
+	WARN("DebugMessageHandler::HandleProfilerControl(): Lua context is not running");
+	SendResult(seq, ResultCode::NoDebuggee);
+}
+
 bool DebugMessageHandler::HandleMessage(DebuggerToBackend const* msg)
 {
 	uint32_t seq = msg->seq_no();
@@ -562,6 +639,10 @@ bool DebugMessageHandler::HandleMessage(DebuggerToBackend const* msg)
 		HandleReset(seq, msg->reset());
 		break;
 
+	case DebuggerToBackend::kProfilerControl:
+		HandleProfilerControl(seq, msg->profilercontrol());
+		break;
+
 	default:
 		ERR("DebugMessageHandler::HandleMessage(): Unknown message type received: %d", msg->msg_case());
 		return false;
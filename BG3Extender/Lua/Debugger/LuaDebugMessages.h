@@ -16,6 +16,16 @@
 struct lua_State;
 struct lua_Debug;
 
+namespace bg3se
+{
+	class ExtensionStateBase;
+}
+
+namespace bg3se::lua
+{
+	class LuaSamplingProfiler;
+}
+
 namespace bg3se::lua::dbg
 {
 	struct DebuggerEvaluateRequest;
@@ -65,6 +75,7 @@ namespace bg3se::lua::dbg
 		void SendDebuggerReady();
 		void SendSourceResponse(uint32_t seq, STDString const& path, STDString const& body);
 		void SendGetVariablesResponse(DebuggerGetVariablesRequest const& req);
+		void SendProfileData(uint32_t seq, DbgContext context, LuaSamplingProfiler const& profiler);
 
 	private:
 		LuaDebugInterface& intf_;
@@ -86,6 +97,8 @@ namespace bg3se::lua::dbg
 		void HandleRequestSource(uint32_t seq, DbgRequestSource const& req);
 		void HandleGetVariables(uint32_t seq, DbgGetVariables const& req);
 		void HandleReset(uint32_t seq, DbgReset const& req);
+		void HandleProfilerControl(uint32_t seq, DbgProfilerControl const& req);
+		void ControlProfiler(uint32_t seq, DbgProfilerControl const& req, ExtensionStateBase& state);
 
 		void Send(dbg::BackendToDebugger& msg);
 	};
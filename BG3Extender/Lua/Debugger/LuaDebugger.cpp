@@ -39,7 +39,8 @@ namespace bg3se::lua::dbg
 	}
 
 	ContextDebugger::ContextDebugger(DebugMessageHandler& messageHandler, DbgContext ctx)
-		: messageHandler_(messageHandler), context_(ctx)
+		: messageHandler_(messageHandler), context_(ctx),
+		lineHooks_([this](char const* source) { return GetBreakpointLines(source); })
 	{}
 
 	void LuaHook(lua_State* L, lua_Debug* ar)
@@ -475,15 +476,12 @@ namespace bg3se::lua::dbg
 	{
 		StackCheck _(L);
 		auto impl = MapProxyMetatable::GetImpl(meta);
-		push(L, nullptr);
+		uint64_t cursor{ 0 };
 
-		while (impl->Next(L, meta, -1) == 2) {
+		while (impl->Next(L, meta, cursor) == 2) {
 			LuaElementToEvalResults(L, -2, -1, req);
-			lua_pop(L, 1);
-			lua_remove(L, -2);
+			lua_pop(L, 2);
 		}
-
-		lua_pop(L, 1);
 	}
 
 	void LuaSetToEvalResults(lua_State* L, int index, CppObjectMetadata& meta, DebuggerGetVariablesRequest const& req)
@@ -688,15 +686,65 @@ namespace bg3se::lua::dbg
 		}
 
 		DBGMSG("Continuing from breakpoint.");
+		// Line hooks are needed everywhere if we're stepping
+		UpdateLineHook(L, L->ci);
+	}
+
+	std::unordered_set<int> const* ContextDebugger::GetBreakpointLines(char const* source)
+	{
+		if (!breakpoints_) {
+			return nullptr;
+		}
+
+		auto const& paths = GetExtensionState().GetLoadedFileFullPaths();
+		auto pathIt = paths.find(source);
+		if (pathIt == paths.end()) {
+			return nullptr;
+		}
+
+		auto fileIt = breakpoints_->breakpoints.find(pathIt->second);
+		if (fileIt != breakpoints_->breakpoints.end()) {
+			return &fileIt->second;
+		} else {
+			return nullptr;
+		}
+	}
+
+	void ContextDebugger::UpdateLineHook(lua_State* L, CallInfo* ci)
+	{
+		if (!enabled_) return;
+
+		auto mask = lineHooks_.GetHookMask(L, ci, requestPause_, (bool)breakpoints_);
+		if (mask && (lua_gethookmask(L) & ~LUA_MASKCOUNT) != *mask) {
+			State::FromLua(L)->GetSamplingProfiler().SetChainedHook(L, LuaHook, *mask);
+		}
 	}
 
 	void ContextDebugger::OnLuaHook(lua_State* L, lua_Debug* ar)
 	{
-		ExecuteQueuedActions();
-		
-		BkBreakpointTriggered::Reason reason = BkBreakpointTriggered::BREAKPOINT;
-		if (IsBreakpoint(L, ar, reason)) {
-			TriggerBreakpoint(L, reason, nullptr);
+		switch (ar->event) {
+		case LUA_HOOKCALL:
+		case LUA_HOOKTAILCALL:
+			UpdateLineHook(L, L->ci);
+			break;
+
+		case LUA_HOOKRET:
+			UpdateLineHook(L, L->ci->previous);
+			break;
+
+		case LUA_HOOKLINE:
+		{
+			ExecuteQueuedActions();
+
+			BkBreakpointTriggered::Reason reason = BkBreakpointTriggered::BREAKPOINT;
+			if (IsBreakpoint(L, ar, reason)) {
+				TriggerBreakpoint(L, reason, nullptr);
+			}
+
+			// Breakpoints may have been updated and stepping may have been started or finished
+			UpdateLineHook(L, L->ci);
+			break;
+		}
 		}
 	}
 
@@ -737,6 +785,7 @@ namespace bg3se::lua::dbg
 	void ContextDebugger::OnContextDestroyed()
 	{
 		evalContextRef_ = -1;
+		lineHooks_.Invalidate();
 	}
 
 	void ContextDebugger::SetupLuaBindings(lua_State* L)
@@ -744,7 +793,7 @@ namespace bg3se::lua::dbg
 		if (evalContextRef_ != -1) return;
 
 		StackCheck _(L);
-		lua_sethook(L, LuaHook, LUA_MASKLINE, 0);
+		State::FromLua(L)->GetSamplingProfiler().SetChainedHook(L, LuaHook, LUA_MASKCALL);
 		lua_newtable(L);
 		evalContextRef_ = luaL_ref(L, LUA_REGISTRYINDEX);
 	}
@@ -754,7 +803,7 @@ namespace bg3se::lua::dbg
 		if (evalContextRef_ == -1) return;
 
 		StackCheck _(L);
-		lua_sethook(L, nullptr, 0, 0);
+		State::FromLua(L)->GetSamplingProfiler().SetChainedHook(L, nullptr, 0);
 		luaL_unref(L, LUA_REGISTRYINDEX, evalContextRef_);
 		evalContextRef_ = -1;
 	}
@@ -776,6 +825,7 @@ namespace bg3se::lua::dbg
 		if (!enabled) {
 			breakpoints_.reset();
 			newBreakpoints_.reset();
+			lineHooks_.Invalidate();
 			requestPause_ = false;
 			pauseMaxStackDepth_ = -1;
 			breakOnError_ = false;
@@ -831,6 +881,7 @@ namespace bg3se::lua::dbg
 
 		pendingActions_.push([=]() {
 			breakpoints_.reset(bps);
+			lineHooks_.Invalidate();
 		});
 		breakpointCv_.notify_one();
 	}
@@ -7,8 +7,10 @@
 #include "LuaDebug.pb.h"
 #include <GameDefinitions/Osiris.h>
 #include <Lua/Debugger/LuaDebugMessages.h>
+#include <Lua/Debugger/LuaLineHookFilter.h>
 
 struct lua_Debug;
+struct CallInfo;
 
 namespace bg3se
 {
@@ -132,6 +134,8 @@ namespace bg3se::lua::dbg
 		std::unique_ptr<BreakpointSet> breakpoints_;
 		// Breakpoint set being updated through DAP
 		std::unique_ptr<BreakpointSet> newBreakpoints_;
+		// Decides where line hooks are needed based on the active breakpoints
+		LineHookFilter lineHooks_;
 
 		ExtensionStateBase& GetExtensionState();
 		void SetupLuaBindings(lua_State* L);
@@ -139,6 +143,10 @@ namespace bg3se::lua::dbg
 		void EnableDebugging(bool enabled);
 		void ExecuteQueuedActions();
 		bool IsBreakpoint(lua_State* L, lua_Debug* ar, BkBreakpointTriggered::Reason& reason);
+		// Enables line hooks only while executing a function that contains a breakpoint or while stepping;
+		// call/return hooks are used to track which function is being executed
+		void UpdateLineHook(lua_State* L, CallInfo* ci);
+		std::unordered_set<int> const* GetBreakpointLines(char const* source);
 		void TriggerBreakpoint(lua_State* L, BkBreakpointTriggered_Reason reason, char const* msg);
 
 		ResultCode EvaluateInContext(DebuggerEvaluateRequest const& req);
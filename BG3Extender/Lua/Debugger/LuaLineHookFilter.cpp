@@ -0,0 +1,123 @@
+#include "stdafx.h"
+#include <Lua/Debugger/LuaLineHookFilter.h>
+#include <lstate.h>
+#include <lobject.h>
+
+namespace bg3se::lua::dbg
+{
+	LineHookFilter::LineHookFilter(BreakpointLookup lookup)
+		: lookup_(std::move(lookup))
+	{}
+
+	void LineHookFilter::Invalidate()
+	{
+		functions_.clear();
+	}
+
+	bool LineHookFilter::FunctionHasBreakpoints(Proto const* proto)
+	{
+		auto it = functions_.find(proto);
+		if (it != functions_.end()
+			&& it->second.Source == proto->source
+			&& it->second.FirstLine == proto->linedefined
+			&& it->second.LastLine == proto->lastlinedefined) {
+			return it->second.HasBreakpoints;
+		}
+
+		bool hasBreakpoints{ false };
+		auto lines = proto->source != nullptr ? lookup_(getstr(proto->source)) : nullptr;
+		if (lines != nullptr) {
+			if (proto->lineinfo != nullptr) {
+				// Only check lines that have code in this function, so that breakpoints in nested functions
+				// don't enable line hooks in the enclosing function
+				for (int i = 0; i < proto->sizelineinfo && !hasBreakpoints; i++) {
+					hasBreakpoints = lines->find(proto->lineinfo[i]) != lines->end();
+				}
+			} else {
+				for (auto line : *lines) {
+					if (proto->linedefined == 0 || (line >= proto->linedefined && line <= proto->lastlinedefined)) {
+						hasBreakpoints = true;
+						break;
+					}
+				}
+			}
+		}
+
+		functions_[proto] = FunctionBreakpointInfo{ proto->source, proto->linedefined, proto->lastlinedefined, hasBreakpoints };
+		return hasBreakpoints;
+	}
+
+	std::optional<int> LineHookFilter::GetHookMask(lua_State* L, CallInfo* ci, bool stepping, bool hasBreakpoints)
+	{
+		if (stepping) {
+			return LUA_MASKCALL | LUA_MASKRET | LUA_MASKLINE;
+		} else if (!hasBreakpoints) {
+			// Call hooks are still needed to notice pause requests
+			return LUA_MASKCALL;
+		} else if (ci == &L->base_ci || !isLua(ci)) {
+			// Line hooks aren't triggered in C functions; the hook is updated when it calls or returns to a Lua function
+			return {};
+		} else if (FunctionHasBreakpoints(clLvalue(ci->func)->p)) {
+			return LUA_MASKCALL | LUA_MASKRET | LUA_MASKLINE;
+		} else {
+			return LUA_MASKCALL | LUA_MASKRET;
+		}
+	}
+
+	namespace
+	{
+		struct LineHookCounter
+		{
+			LineHookFilter Filter;
+			bool Stepping;
+			uint64_t Lines{ 0 };
+		};
+
+		thread_local LineHookCounter* gLineHookCounter{ nullptr };
+
+		void LineHookCounterHook(lua_State* L, lua_Debug* ar)
+		{
+			auto counter = gLineHookCounter;
+			std::optional<int> mask;
+			switch (ar->event) {
+			case LUA_HOOKCALL:
+			case LUA_HOOKTAILCALL:
+				mask = counter->Filter.GetHookMask(L, L->ci, counter->Stepping, true);
+				break;
+
+			case LUA_HOOKRET:
+				mask = counter->Filter.GetHookMask(L, L->ci->previous, counter->Stepping, true);
+				break;
+
+			case LUA_HOOKLINE:
+				counter->Lines++;
+				break;
+			}
+
+			if (mask && lua_gethookmask(L) != *mask) {
+				lua_sethook(L, &LineHookCounterHook, *mask, 0);
+			}
+		}
+	}
+
+	uint64_t LineHookFilter::CountLineHooks(lua_State* L, BreakpointLookup lookup, bool stepping)
+	{
+		LineHookCounter counter{ LineHookFilter(std::move(lookup)), stepping };
+		auto prevCounter = gLineHookCounter;
+		auto prevHook = lua_gethook(L);
+		auto prevMask = lua_gethookmask(L);
+		auto prevCount = lua_gethookcount(L);
+
+		gLineHookCounter = &counter;
+		lua_sethook(L, &LineHookCounterHook, stepping ? (LUA_MASKCALL | LUA_MASKRET | LUA_MASKLINE) : LUA_MASKCALL, 0);
+		auto status = lua_pcall(L, 0, 0, 0);
+		lua_sethook(L, prevHook, prevMask, prevCount);
+		gLineHookCounter = prevCounter;
+
+		if (status != LUA_OK) {
+			lua_error(L);
+		}
+
+		return counter.Lines;
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
+struct lua_State;
+struct lua_Debug;
+struct CallInfo;
+struct Proto;
+
+namespace bg3se::lua::dbg
+{
+	// Decides which hooks the debugger needs while a Lua function is executing.
+	// Line hooks fire on every executed line, so they're only enabled inside functions that contain
+	// a breakpoint or while stepping; call/return hooks are used to track which function is executing.
+	class LineHookFilter
+	{
+	public:
+		// Returns the breakpoint lines in the chunk, or null if it has none
+		using BreakpointLookup = std::function<std::unordered_set<int> const* (char const* source)>;
+
+		LineHookFilter(BreakpointLookup lookup);
+
+		// Discards cached lookup results; must be called when the breakpoints change
+		void Invalidate();
+		// Returns the hook mask needed while executing the call frame,
+		// or nothing if the current mask should be kept
+		std::optional<int> GetHookMask(lua_State* L, CallInfo* ci, bool stepping, bool hasBreakpoints);
+		bool FunctionHasBreakpoints(Proto const* proto);
+
+		// Calls the function on the top of the stack with hooks managed by a filter using the specified
+		// breakpoint lookup, and returns the number of line hooks that were triggered.
+		// Allows testing the filter without attaching a debugger.
+		static uint64_t CountLineHooks(lua_State* L, BreakpointLookup lookup, bool stepping);
+
+	private:
+		// Cached breakpoint lookup result of a function prototype
+		struct FunctionBreakpointInfo
+		{
+			// Source and line range of the prototype; used to detect if the address was reused by another function
+			void const* Source;
+			int FirstLine;
+			int LastLine;
+			bool HasBreakpoints;
+		};
+
+		BreakpointLookup lookup_;
+		std::unordered_map<Proto const*, FunctionBreakpointInfo> functions_;
+	};
+}
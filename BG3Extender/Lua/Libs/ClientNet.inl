@@ -4,15 +4,16 @@ BEGIN_NS(ecl::lua::net)
 void PostMessageToServer(char const* channel, char const* payload)
 {
 	auto & networkMgr = gExtender->GetClient().GetNetworkManager();
-	auto msg = networkMgr.GetFreeMessage();
-	if (msg != nullptr) {
-		auto postMsg = msg->GetMessage().mutable_post_lua();
-		postMsg->set_channel_name(channel);
-		postMsg->set_payload(payload);
-		networkMgr.Send(msg);
-	} else {
-		OsiErrorS("Could not get free message!");
+	if (!networkMgr.CanSendExtenderMessages()) {
+		OsiErrorS("Attempted to send extender message to a host that does not understand extender protocol!");
+		return;
 	}
+
+	bg3se::net::MessageWrapper msg;
+	auto postMsg = msg.mutable_post_lua();
+	postMsg->set_channel_name(channel);
+	postMsg->set_payload(payload);
+	networkMgr.Send(msg);
 }
 
 bool IsHost()
@@ -1,4 +1,8 @@
 #include <Extender/ScriptExtender.h>
+#include <Lua/Debugger/LuaLineHookFilter.h>
+#include <json/json.h>
+#include <CoreLib/SymbolMapper.h>
+#include <Lua/Server/LuaOsirisBinding.h>
 
 /// <lua_module>Debug</lua_module>
 BEGIN_NS(lua::debug)
@@ -270,6 +274,1152 @@ void SetEntityRuntimeCheckLevel(int level)
 	}
 }
 
+// Returns allocation statistics of the current Lua state
+UserReturn GetMemoryStats(lua_State* L)
+{
+	auto const& stats = State::FromLua(L)->GetAllocator().GetStats();
+
+	lua_newtable(L);
+	setfield(L, "BytesLive", (uint64_t)stats.BytesLive);
+	setfield(L, "SlabBytes", (uint64_t)stats.SlabBytes);
+	setfield(L, "ReleasedSlabs", stats.ReleasedSlabs);
+	setfield(L, "MismatchedFrees", stats.MismatchedFrees);
+	setfield(L, "Allocations", stats.Allocations);
+	setfield(L, "Frees", stats.Frees);
+	setfield(L, "Reallocations", stats.Reallocations);
+	setfield(L, "InPlaceReallocations", stats.InPlaceReallocations);
+	setfield(L, "LargeAllocations", stats.Large.Allocations);
+	setfield(L, "LargeLiveBlocks", stats.Large.LiveBlocks);
+
+	lua_createtable(L, LuaAllocator::NumSizeClasses, 0);
+	for (unsigned i = 0; i < LuaAllocator::NumSizeClasses; i++) {
+		auto const& sizeClass = stats.SizeClasses[i];
+		lua_createtable(L, 0, 3);
+		setfield(L, "Size", (uint64_t)LuaAllocator::GetSizeClassSize(i));
+		setfield(L, "Allocations", sizeClass.Allocations);
+		setfield(L, "LiveBlocks", sizeClass.LiveBlocks);
+		lua_rawseti(L, -2, i + 1);
+	}
+	lua_setfield(L, -2, "SizeClasses");
+
+	return 1;
+}
+
+void CheckOsirisProfilerAvailable(lua_State* L)
+{
+	auto lua = State::FromLua(L);
+	if ((lua->RestrictionFlags & State::RestrictOsiris) || !gExtender->GetServer().IsInServerThread()) {
+		luaL_error(L, "The Osiris profiler can only be used when Osiris is available");
+	}
+}
+
+// Starts recording call counts and timings of story nodes
+bool StartOsirisProfiler(lua_State* L, std::optional<bool> reset)
+{
+	CheckOsirisProfilerAvailable(L);
+	auto& osiris = gExtender->GetServer().Osiris();
+	if (reset && *reset) {
+		osiris.GetNodeProfiler().Reset();
+	}
+
+	return osiris.StartNodeProfiler();
+}
+
+void StopOsirisProfiler(lua_State* L)
+{
+	CheckOsirisProfilerAvailable(L);
+	gExtender->GetServer().Osiris().StopNodeProfiler();
+}
+
+void ResetOsirisProfiler(lua_State* L)
+{
+	CheckOsirisProfilerAvailable(L);
+	gExtender->GetServer().Osiris().GetNodeProfiler().Reset();
+}
+
+// Replays a synthetic trace of node and hook enter/exit events with fixed timestamps on a standalone
+// profiler and returns the per-node statistics in ticks; used for testing time attribution.
+// Events: { "Enter", nodeId, ticks }, { "Exit", ticks }, { "Hook", ticks }, { "EndHook", ticks }
+UserReturn ProfileOsirisNodeTrace(lua_State* L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+
+	OsirisNodeProfiler profiler;
+	auto count = (int)lua_rawlen(L, 1);
+	for (int i = 1; i <= count; i++) {
+		lua_rawgeti(L, 1, i);
+		luaL_checktype(L, -1, LUA_TTABLE);
+		lua_rawgeti(L, -1, 1);
+		auto type = get<STDString>(L, -1);
+		lua_pop(L, 1);
+
+		if (type == "Enter") {
+			lua_rawgeti(L, -1, 2);
+			lua_rawgeti(L, -2, 3);
+			profiler.Enter(get<uint32_t>(L, -2), get<uint64_t>(L, -1));
+			lua_pop(L, 2);
+		} else {
+			lua_rawgeti(L, -1, 2);
+			auto ticks = get<uint64_t>(L, -1);
+			lua_pop(L, 1);
+
+			if (type == "Exit") {
+				profiler.Exit(ticks);
+			} else if (type == "Hook") {
+				profiler.EnterHook(ticks);
+			} else if (type == "EndHook") {
+				profiler.ExitHook(ticks);
+			} else {
+				luaL_error(L, "Unknown profiler event type: %s", type.c_str());
+			}
+		}
+
+		lua_pop(L, 1);
+	}
+
+	lua_newtable(L);
+	auto const& nodes = profiler.GetNodeStats();
+	for (uint32_t id = 0; id < nodes.size(); id++) {
+		auto const& stats = nodes[id];
+		if (stats.Calls == 0) continue;
+
+		lua_createtable(L, 0, 3);
+		setfield(L, "Calls", stats.Calls);
+		setfield(L, "InclusiveTicks", stats.InclusiveTicks);
+		setfield(L, "ExclusiveTicks", stats.ExclusiveTicks);
+		lua_rawseti(L, -2, id);
+	}
+
+	return 1;
+}
+
+char const* OsirisNodeTypeNames[] = {
+	"None", "Database", "Proc", "DivQuery", "And", "NotAnd", "RelOp", "Rule", "InternalQuery", "UserQuery"
+};
+
+// Returns the statistics collected by the Osiris profiler per node, aggregated per function symbol, and rolled up per rule and goal
+UserReturn GetOsirisProfile(lua_State* L)
+{
+	CheckOsirisProfilerAvailable(L);
+	auto& osiris = gExtender->GetServer().Osiris();
+	auto const& profiler = osiris.GetNodeProfiler();
+	auto const& nodeDb = (*osiris.GetGlobals().Nodes)->Db;
+	auto wrappers = osiris.GetVMTWrappers();
+
+	std::unordered_map<STDString, OsirisNodeProfiler::NodeStats> functions;
+
+	lua_newtable(L);
+	setfield(L, "ProfiledUs", profiler.TicksToMicroseconds(profiler.GetProfiledTicks()));
+
+	lua_newtable(L);
+	int32_t index = 1;
+	auto const& nodes = profiler.GetNodeStats();
+	for (uint32_t id = 1; id < nodes.size() && id <= nodeDb.Size; id++) {
+		auto const& stats = nodes[id];
+		if (stats.Calls == 0) continue;
+
+		auto node = nodeDb.Elements[id - 1];
+		auto type = wrappers ? wrappers->GetType(node) : NodeType::None;
+
+		lua_createtable(L, 0, 6);
+		setfield(L, "Id", id);
+		if ((unsigned)type < std::size(OsirisNodeTypeNames)) {
+			setfield(L, "Type", OsirisNodeTypeNames[(unsigned)type]);
+		}
+		setfield(L, "Calls", stats.Calls);
+		setfield(L, "InclusiveUs", profiler.TicksToMicroseconds(stats.InclusiveTicks));
+		setfield(L, "ExclusiveUs", profiler.TicksToMicroseconds(stats.ExclusiveTicks));
+
+		if (node->Function != nullptr) {
+			auto name = node->Function->Signature->Name;
+			setfield(L, "Name", name);
+
+			auto& fun = functions[name];
+			fun.Calls += stats.Calls;
+			fun.InclusiveTicks += stats.InclusiveTicks;
+			fun.ExclusiveTicks += stats.ExclusiveTicks;
+		}
+
+		lua_rawseti(L, -2, index++);
+	}
+	lua_setfield(L, -2, "Nodes");
+
+	lua_createtable(L, 0, (int)functions.size());
+	for (auto const& fun : functions) {
+		lua_createtable(L, 0, 3);
+		setfield(L, "Calls", fun.second.Calls);
+		setfield(L, "InclusiveUs", profiler.TicksToMicroseconds(fun.second.InclusiveTicks));
+		setfield(L, "ExclusiveUs", profiler.TicksToMicroseconds(fun.second.ExclusiveTicks));
+		lua_setfield(L, -2, fun.first.c_str());
+	}
+	lua_setfield(L, -2, "Functions");
+
+	OsirisNodeProfiler::Rollup rollup;
+	if (wrappers) {
+		profiler.BuildRollup(nodeDb, *wrappers, rollup);
+	}
+
+	auto goalDb = *osiris.GetGlobals().Goals;
+	auto getGoalName = [goalDb](uint32_t goalId) -> char const* {
+		auto goal = goalDb->Goals.Find(goalId);
+		return goal != nullptr ? (*goal)->Name : nullptr;
+	};
+
+	lua_createtable(L, (int)rollup.Rules.size(), 0);
+	index = 1;
+	for (auto const& rule : rollup.Rules) {
+		lua_createtable(L, 0, 5);
+		setfield(L, "Id", rule.first);
+		setfield(L, "Line", static_cast<RuleNode*>(nodeDb.Elements[rule.first - 1])->Line);
+		auto goalName = getGoalName(rule.second.GoalId);
+		if (goalName != nullptr) {
+			setfield(L, "Goal", goalName);
+		}
+		setfield(L, "Calls", rule.second.Calls);
+		setfield(L, "ExclusiveUs", profiler.TicksToMicroseconds(rule.second.ExclusiveTicks));
+		lua_rawseti(L, -2, index++);
+	}
+	lua_setfield(L, -2, "Rules");
+
+	lua_createtable(L, 0, (int)rollup.Goals.size());
+	for (auto const& goal : rollup.Goals) {
+		auto goalName = getGoalName(goal.first);
+		if (goalName == nullptr) continue;
+
+		lua_createtable(L, 0, 2);
+		setfield(L, "Calls", goal.second.Calls);
+		setfield(L, "ExclusiveUs", profiler.TicksToMicroseconds(goal.second.ExclusiveTicks));
+		lua_setfield(L, -2, goalName);
+	}
+	lua_setfield(L, -2, "Goals");
+
+	return 1;
+}
+
+// Starts sampling the Lua call stack every N VM instructions
+void StartLuaProfiler(lua_State* L, std::optional<uint32_t> interval)
+{
+	auto state = State::FromLua(L);
+	// Hooks are per-thread, so the hook must be installed on the main thread even if we're called from a coroutine
+	state->GetSamplingProfiler().Start(state->GetState(), interval.value_or(LuaSamplingProfiler::DefaultInterval));
+}
+
+void StopLuaProfiler(lua_State* L)
+{
+	auto state = State::FromLua(L);
+	state->GetSamplingProfiler().Stop(state->GetState());
+}
+
+void ResetLuaProfiler(lua_State* L)
+{
+	State::FromLua(L)->GetSamplingProfiler().Reset();
+}
+
+// Returns the number of samples collected by the Lua profiler, in total and per mod
+UserReturn GetLuaProfile(lua_State* L)
+{
+	auto const& profiler = State::FromLua(L)->GetSamplingProfiler();
+	std::unordered_map<STDString, uint64_t> mods;
+	profiler.GetModSamples(mods);
+
+	lua_newtable(L);
+	setfield(L, "Running", profiler.IsRunning());
+	setfield(L, "Interval", profiler.GetInterval());
+	setfield(L, "Samples", profiler.GetSampleCount());
+
+	lua_createtable(L, 0, (int)mods.size());
+	for (auto const& mod : mods) {
+		setfield(L, mod.first.c_str(), mod.second);
+	}
+	lua_setfield(L, -2, "Mods");
+
+	return 1;
+}
+
+// Returns the collected samples in the folded stack format used by flamegraph tools
+STDString DumpLuaProfile(lua_State* L)
+{
+	return State::FromLua(L)->GetSamplingProfiler().DumpFoldedStacks();
+}
+
+// Returns the state of the collector and the work done by the per-tick GC scheduler
+UserReturn GetLuaGCStats(lua_State* L)
+{
+	auto state = State::FromLua(L);
+	auto const& scheduler = state->GetGCScheduler();
+	auto const& stats = scheduler.GetStats();
+	auto toUs = [](std::chrono::steady_clock::duration d) {
+		return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(d).count() / 1000.0;
+	};
+
+	lua_newtable(L);
+	setfield(L, "State", LuaGCScheduler::GetCollectorState(L));
+	setfield(L, "Debt", LuaGCScheduler::GetDebt(L));
+	setfield(L, "Pause", LuaGCScheduler::GetPause(L));
+	setfield(L, "StepMul", LuaGCScheduler::GetStepMul(L));
+	setfield(L, "Budget", scheduler.GetBudget());
+	setfield(L, "Ticks", stats.Ticks);
+	setfield(L, "IdleTicks", stats.IdleTicks);
+	setfield(L, "OverBudgetTicks", stats.OverBudgetTicks);
+	setfield(L, "Steps", stats.Steps);
+	setfield(L, "Cycles", stats.Cycles);
+	setfield(L, "LastTickAllocated", stats.LastTickAllocated);
+	setfield(L, "LastTickUs", toUs(stats.LastTickTime));
+	setfield(L, "MaxTickUs", toUs(stats.MaxTickTime));
+	setfield(L, "MaxStepUs", toUs(stats.MaxStepTime));
+	setfield(L, "TotalUs", toUs(stats.TotalTime));
+	return 1;
+}
+
+// Sets the time budget of GC steps per tick, in microseconds; 0 leaves collection to the allocator
+void SetLuaGCBudget(lua_State* L, uint32_t budget)
+{
+	State::FromLua(L)->GetGCScheduler().SetBudget(budget);
+}
+
+void ResetLuaGCStats(lua_State* L)
+{
+	State::FromLua(L)->GetGCScheduler().ResetStats();
+}
+
+UserReturn GetLuaChunkCacheStats(lua_State* L)
+{
+	auto stats = gExtender->GetLuaChunkCache().GetStats();
+
+	lua_newtable(L);
+	setfield(L, "Enabled", gExtender->GetConfig().EnableLuaChunkCache);
+	setfield(L, "Hits", stats.Hits);
+	setfield(L, "Misses", stats.Misses);
+	setfield(L, "Evictions", stats.Evictions);
+	setfield(L, "Chunks", stats.Chunks);
+	setfield(L, "Bytes", (uint64_t)stats.Bytes);
+	return 1;
+}
+
+// Parses and writes a document using jsoncpp, the way Ext.Json did before the streaming implementation
+// (without the conversion from/to Lua values); used as a baseline in the JSON benchmark.
+UserReturn JsoncppRoundTrip(lua_State* L, STDString json)
+{
+	Json::CharReaderBuilder factory;
+	std::unique_ptr<Json::CharReader> reader(factory.newCharReader());
+
+	Json::Value root;
+	std::string errs;
+	auto startTime = std::chrono::steady_clock::now();
+	if (!reader->parse(json.data(), json.data() + json.size(), &root, &errs)) {
+		return luaL_error(L, "Unable to parse JSON: %s", errs.c_str());
+	}
+	auto parseTime = std::chrono::steady_clock::now() - startTime;
+
+	startTime = std::chrono::steady_clock::now();
+	Json::StreamWriterBuilder builder;
+	builder["indentation"] = "\t";
+	std::stringstream ss;
+	std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+	writer->write(root, &ss);
+	auto output = ss.str();
+	auto writeTime = std::chrono::steady_clock::now() - startTime;
+
+	lua_newtable(L);
+	setfield(L, "Output", STDString(output.data(), output.size()));
+	setfield(L, "ParseTime", std::chrono::duration<double, std::micro>(parseTime).count());
+	setfield(L, "StringifyTime", std::chrono::duration<double, std::micro>(writeTime).count());
+	return 1;
+}
+
+// Scans a buffer for a set of patterns (in the format used by the symbol mapping XML) in a single pass,
+// and with a separate scan for each pattern; used for testing the prescan of the symbol mapper.
+// Returns the match offsets of both scans for each pattern.
+UserReturn ScanPatterns(lua_State* L, STDString buffer)
+{
+	luaL_checktype(L, 2, LUA_TTABLE);
+	auto count = (int)lua_rawlen(L, 2);
+	std::vector<Pattern> patterns(count);
+	for (int i = 1; i <= count; i++) {
+		lua_rawgeti(L, 2, i);
+		auto pattern = get<STDString>(L, -1);
+		lua_pop(L, 1);
+		if (!patterns[i - 1].FromString(std::string_view(pattern.data(), pattern.size()))) {
+			return luaL_error(L, "Invalid pattern: %s", pattern.c_str());
+		}
+	}
+
+	auto start = reinterpret_cast<uint8_t const*>(buffer.data());
+	MultiPatternScanner scanner;
+	for (auto const& pattern : patterns) {
+		scanner.Add(&pattern);
+	}
+	scanner.Scan(start, buffer.size());
+
+	lua_createtable(L, count, 0);
+	for (int i = 0; i < count; i++) {
+		lua_createtable(L, 0, 2);
+
+		lua_newtable(L);
+		int idx = 1;
+		for (auto match : scanner.GetMatches(i)) {
+			push(L, (uint32_t)(match - start));
+			lua_rawseti(L, -2, idx++);
+		}
+		lua_setfield(L, -2, "Matches");
+
+		lua_newtable(L);
+		idx = 1;
+		patterns[i].Scan(start, buffer.size(), [L, start, &idx](uint8_t const* match) {
+			push(L, (uint32_t)(match - start));
+			lua_rawseti(L, -2, idx++);
+			return Pattern::ScanAction::Continue;
+		});
+		lua_setfield(L, -2, "Expected");
+
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
+// Maps a set of patterns in an in-memory module image with the symbol match cache enabled; used for testing
+// the cache load, revalidation and fallback paths. The cache is kept in SymbolCacheTest.bin between calls.
+// Options: TimeDateStamp, CheckSum (build identifiers of the module), Reset (delete the cache first),
+// Corrupt = "Magic"/"Truncate" (damage the cache file before it is loaded)
+UserReturn MapSymbolsWithCache(lua_State* L, STDString image)
+{
+	luaL_checktype(L, 2, LUA_TTABLE);
+	auto cachePath = GetCacheFilePath(L"SymbolCacheTest.bin");
+	if (cachePath.empty()) {
+		return luaL_error(L, "Symbol cache directory is not available");
+	}
+
+	std::map<std::string, std::string> patterns;
+	lua_pushnil(L);
+	while (lua_next(L, 2) != 0) {
+		auto name = get<STDString>(L, -2);
+		auto pattern = get<STDString>(L, -1);
+		patterns.insert(std::make_pair(std::string(name.data(), name.size()), std::string(pattern.data(), pattern.size())));
+		lua_pop(L, 1);
+	}
+
+	SymbolMapper::ModuleInfo module;
+	module.ModuleStart = reinterpret_cast<uint8_t const*>(image.data());
+	module.ModuleSize = image.size();
+	module.ModuleTextStart = module.ModuleStart;
+	module.ModuleTextSize = module.ModuleSize;
+
+	if (lua_type(L, 3) == LUA_TTABLE) {
+		module.TimeDateStamp = try_gettable<uint32_t>(L, "TimeDateStamp", 3, 0);
+		module.CheckSum = try_gettable<uint32_t>(L, "CheckSum", 3, 0);
+
+		if (try_gettable<bool>(L, "Reset", 3, false)) {
+			DeleteFileW(cachePath.c_str());
+		}
+
+		auto corrupt = try_gettable<STDString>(L, "Corrupt", 3);
+		std::vector<uint8_t> cache;
+		if (corrupt && LoadFile(cachePath, cache)) {
+			if (*corrupt == "Magic" && cache.size() >= 4) {
+				cache[0] ^= 0xff;
+			} else if (*corrupt == "Truncate") {
+				cache.resize(cache.size() / 2);
+			}
+			SaveFile(cachePath, cache);
+		}
+	}
+
+	std::string sourceKey;
+	for (auto const& pattern : patterns) {
+		sourceKey += pattern.first + "=" + pattern.second + ";";
+	}
+
+	SymbolMappings mappings;
+	MurmurHash3_x64_128(sourceKey.data(), (int)sourceKey.size(), 0, mappings.SourceHash.data());
+
+	SymbolMapper mapper(mappings);
+	mapper.AddModule("Test", module);
+	mapper.EnableMatchCache(cachePath);
+
+	std::map<std::string, std::vector<uint32_t>> matches;
+	for (auto const& pattern : patterns) {
+		auto& mapping = mappings.Mappings[pattern.first];
+		mapping.Name = pattern.first;
+		mapping.Module = "Test";
+		mapping.Flag = SymbolMappings::Mapping::kAllowFail;
+		if (!mapping.Pattern.FromString(pattern.second)) {
+			return luaL_error(L, "Invalid pattern: %s", pattern.second.c_str());
+		}
+
+		SymbolMappings::Target target;
+		target.Name = pattern.first;
+		target.Ref.Type = SymbolMappings::ReferenceType::kAbsolute;
+		target.EngineCallback = "Record" + pattern.first;
+		mapping.Targets.push_back(target);
+		mappings.OrderedMappings.push_back(&mapping);
+
+		auto& mappingMatches = matches[pattern.first];
+		mapper.AddEngineCallback(target.EngineCallback, [&mappingMatches, &module](uint8_t const* match) {
+			mappingMatches.push_back((uint32_t)(match - module.ModuleStart));
+			return SymbolMapper::MappingResult::TryNext;
+		});
+	}
+
+	mapper.MapAllSymbols(false);
+
+	lua_newtable(L);
+	lua_newtable(L);
+	for (auto const& mappingMatches : matches) {
+		lua_createtable(L, (int)mappingMatches.second.size(), 0);
+		for (std::size_t i = 0; i < mappingMatches.second.size(); i++) {
+			push(L, mappingMatches.second[i]);
+			lua_rawseti(L, -2, (int)i + 1);
+		}
+		lua_setfield(L, -2, mappingMatches.first.c_str());
+	}
+	lua_setfield(L, -2, "Matches");
+
+	auto const& stats = mapper.GetMatchCacheStats();
+	setfield(L, "LoadedEntries", stats.LoadedEntries);
+	setfield(L, "CachedMappings", stats.CachedMappings);
+	setfield(L, "ScannedMappings", stats.ScannedMappings);
+	setfield(L, "StaleMappings", stats.StaleMappings);
+	setfield(L, "Saved", stats.Saved);
+	return 1;
+}
+
+// Fills a map with pseudo-random keys, iterates it using pairs() on its Lua proxy, and counts the iterator
+// calls and the hash table slots and chain links read by the iteration cursor; used for checking that a
+// pairs() pass takes linear time.
+UserReturn CountMapIterationWork(lua_State* L, uint32_t size, uint32_t hashSize)
+{
+	using ProxyImpl = RefMapProxyImpl<int32_t, int32_t, MapInternals<int32_t, int32_t>, 3>;
+
+	Map<int32_t, int32_t> map(std::max(hashSize, 1u));
+	uint32_t seed = 12345;
+	while (map.size() < size) {
+		seed = seed * 1103515245 + 12345;
+		map.insert((int32_t)(seed >> 1), 0);
+	}
+
+	LifetimeStackPin pin(L);
+	auto impl = static_cast<ProxyImpl*>(MapProxyMetatable::GetImplementation<ProxyImpl>());
+	auto visitedBefore = impl->GetVisitedNodes();
+
+	lua_getglobal(L, "pairs");
+	MapProxyMetatable::Make(L, &map, pin.GetLifetime());
+	lua_call(L, 1, 3);
+
+	uint32_t steps{ 0 }, entries{ 0 };
+	int iterIdx = lua_absindex(L, -3);
+	for (;;) {
+		lua_pushvalue(L, iterIdx);
+		lua_pushvalue(L, iterIdx + 1);
+		lua_pushvalue(L, iterIdx + 2);
+		lua_call(L, 2, 2);
+		steps++;
+		if (lua_type(L, -2) == LUA_TNIL) {
+			lua_pop(L, 2);
+			break;
+		}
+
+		lua_replace(L, iterIdx + 2);
+		lua_pop(L, 1);
+		entries++;
+	}
+	lua_pop(L, 3);
+
+	lua_newtable(L);
+	setfield(L, "Entries", entries);
+	setfield(L, "Steps", steps);
+	setfield(L, "VisitedNodes", impl->GetVisitedNodes() - visitedBefore);
+	return 1;
+}
+
+// Fills a standalone Osiris subscriber table with subscribers of pseudo-random mock node IDs (including some IDs
+// above the dense range), then looks up random IDs and compares the results and lookup times against a hash map
+// keyed by node reference, which is how node subscribers were stored before the dense tables.
+// Half of the subscribers are removed halfway through, to check that removals clear the dense mask.
+UserReturn BenchmarkOsirisSubscriberTable(lua_State* L, uint32_t numNodes, uint32_t numSubscribers, uint32_t numLookups)
+{
+	esv::lua::OsirisNodeSubscriberTable table;
+	std::unordered_multimap<uint64_t, uint32_t> baseline;
+	table.Clear(numNodes + 1);
+
+	uint32_t seed = 12345;
+	auto nextRandom = [&seed]() {
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	};
+
+	std::vector<std::pair<uint32_t, uint32_t>> subscribers;
+	for (uint32_t i = 0; i < numSubscribers; i++) {
+		// Every 16th subscriber is outside the dense range
+		auto id = (i % 16 == 15) ? (numNodes + 1 + nextRandom() % numNodes) : (nextRandom() % numNodes);
+		table.Add(id, i);
+		baseline.insert(std::make_pair((uint64_t)id, i));
+		subscribers.push_back(std::make_pair(id, i));
+	}
+
+	std::vector<uint32_t> lookups(numLookups);
+	for (auto& id : lookups) {
+		id = nextRandom() % (numNodes * 2 + 2);
+	}
+
+	uint32_t mismatches{ 0 }, hits{ 0 };
+	std::chrono::steady_clock::duration tableTime{ 0 }, baselineTime{ 0 };
+	for (uint32_t pass = 0; pass < 2; pass++) {
+		if (pass == 1) {
+			for (uint32_t i = 0; i < subscribers.size(); i += 2) {
+				table.Remove(subscribers[i].first, subscribers[i].second);
+				auto range = baseline.equal_range(subscribers[i].first);
+				for (auto it = range.first; it != range.second; ++it) {
+					if (it->second == subscribers[i].second) {
+						baseline.erase(it);
+						break;
+					}
+				}
+			}
+		}
+
+		uint64_t tableSubscribers{ 0 }, baselineSubscribers{ 0 };
+		auto startTime = std::chrono::steady_clock::now();
+		for (auto id : lookups) {
+			auto found = table.Find(id);
+			if (found != nullptr) {
+				tableSubscribers += found->size();
+			}
+		}
+		tableTime += std::chrono::steady_clock::now() - startTime;
+
+		startTime = std::chrono::steady_clock::now();
+		for (auto id : lookups) {
+			auto range = baseline.equal_range(id);
+			baselineSubscribers += std::distance(range.first, range.second);
+		}
+		baselineTime += std::chrono::steady_clock::now() - startTime;
+
+		if (tableSubscribers != baselineSubscribers) {
+			mismatches++;
+		}
+
+		for (auto id : lookups) {
+			auto found = table.Find(id);
+			auto count = (uint32_t)baseline.count(id);
+			if ((found != nullptr ? found->size() : 0) != count || (found != nullptr && found->empty())) {
+				mismatches++;
+			}
+
+			if (count > 0) {
+				hits++;
+			}
+		}
+	}
+
+	auto totalLookups = (double)std::max(numLookups * 2, 1u);
+	lua_newtable(L);
+	setfield(L, "Mismatches", mismatches);
+	setfield(L, "Hits", hits);
+	setfield(L, "DenseSize", (uint32_t)table.Subscribers.size());
+	setfield(L, "SparseSize", (uint32_t)table.SparseSubscribers.size());
+	setfield(L, "NsPerLookup", (double)std::chrono::duration_cast<std::chrono::nanoseconds>(tableTime).count() / totalLookups);
+	setfield(L, "BaselineNsPerLookup", (double)std::chrono::duration_cast<std::chrono::nanoseconds>(baselineTime).count() / totalLookups);
+	return 1;
+}
+
+// Appends the handle of the fired timer to the table in upvalue 1
+int RecordTimerCallback(lua_State* L)
+{
+	lua_pushvalue(L, 1);
+	lua_rawseti(L, lua_upvalueindex(1), (int)lua_rawlen(L, lua_upvalueindex(1)) + 1);
+	return 0;
+}
+
+// Replays timer operations with fixed timestamps (in seconds) on a standalone timer system and returns
+// the fired timers in the order their callbacks were called; used for testing timer scheduling.
+// Operations: { "Add", time, repeat? }, { "Pause", timer, time }, { "Resume", timer, time }, { "Cancel", timer },
+// { "Update", time }; timers are referenced by the index of the "Add" operation that created them.
+UserReturn RunTimerTrace(lua_State* L, STDString kind)
+{
+	luaL_checktype(L, 2, LUA_TTABLE);
+	timer::TimerSystem timers(*State::FromLua(L), false);
+	auto& manager = (kind == "Realtime") ? timers.RealtimeTimer() : timers.GameTimer();
+	auto flag = (kind == "Realtime") ? timer::TimerManager::RealtimeFlag : 0;
+
+	lua_newtable(L);
+	auto firedIndex = lua_gettop(L);
+	lua_pushvalue(L, firedIndex);
+	lua_pushcclosure(L, &RecordTimerCallback, 1);
+	auto callbackIndex = lua_gettop(L);
+
+	lua_newtable(L);
+	auto resultIndex = lua_gettop(L);
+	int numFired{ 0 };
+
+	std::vector<timer::TimerHandle> handles;
+	auto getArg = [&](int n) {
+		lua_rawgeti(L, -1, n);
+		auto value = lua_tonumber(L, -1);
+		lua_pop(L, 1);
+		return value;
+	};
+	auto getTimer = [&](int n) {
+		auto index = (std::size_t)getArg(n);
+		if (index < 1 || index > handles.size()) {
+			luaL_error(L, "Invalid timer index: %d", (int)index);
+		}
+		return handles[index - 1] | flag;
+	};
+
+	auto count = (int)lua_rawlen(L, 2);
+	for (int i = 1; i <= count; i++) {
+		lua_rawgeti(L, 2, i);
+		luaL_checktype(L, -1, LUA_TTABLE);
+		lua_rawgeti(L, -1, 1);
+		auto op = get<STDString>(L, -1);
+		lua_pop(L, 1);
+
+		if (op == "Add") {
+			handles.push_back(manager.Add(getArg(2), Ref(L, callbackIndex), (float)getArg(3)));
+		} else if (op == "Pause") {
+			timers.Pause(getTimer(2), getArg(3));
+		} else if (op == "Resume") {
+			timers.Resume(getTimer(2), getArg(3));
+		} else if (op == "Cancel") {
+			timers.Cancel(getTimer(2));
+		} else if (op == "Update") {
+			auto time = getArg(2);
+			timers.Update(time);
+
+			// Callbacks receive the handle without the realtime flag
+			auto total = (int)lua_rawlen(L, firedIndex);
+			for (; numFired < total; numFired++) {
+				lua_rawgeti(L, firedIndex, numFired + 1);
+				auto handle = get<uint64_t>(L, -1);
+				lua_pop(L, 1);
+
+				auto it = std::find(handles.begin(), handles.end(), handle);
+				lua_createtable(L, 0, 2);
+				setfield(L, "Timer", (uint32_t)(it - handles.begin()) + 1);
+				setfield(L, "Time", time);
+				lua_rawseti(L, resultIndex, numFired + 1);
+			}
+		} else {
+			luaL_error(L, "Unknown timer operation: %s", op.c_str());
+		}
+
+		lua_pop(L, 1);
+	}
+
+	return 1;
+}
+
+// Stores a composite user variable value as JSON text, the way composite values were stored before binary
+// encoding (and are still received from older savegames and peers). The value is written to the global store
+// directly, so the variable should be registered with DontCache to make sure reads don't return a cached value.
+bool SetJsonUserVariable(lua_State* L, EntityHandle entity, FixedString key, STDString json)
+{
+	auto& global = State::FromLua(L)->GetVariableManager().GetGlobal();
+	auto proto = global.GetPrototype(key);
+	auto uuid = global.EntityToGuid(entity);
+	if (proto == nullptr || !uuid) {
+		return false;
+	}
+
+	UserVariable value(json);
+	value.Dirty = true;
+	global.Set(uuid, key, *proto, std::move(value));
+	return true;
+}
+
+// Compiles a chunk either directly or through the chunk cache (even if the cache is disabled in the config)
+UserReturn LoadLuaChunk(lua_State* L, STDString script, STDString name, bool cached)
+{
+	int status;
+	if (cached) {
+		status = gExtender->GetLuaChunkCache().Load(L, script, name);
+	} else {
+		status = luaL_loadbufferx(L, script.c_str(), script.size(), name.c_str(), "text");
+	}
+
+	if (status != LUA_OK) {
+		return lua_error(L);
+	}
+
+	return 1;
+}
+
+UserReturn GetConsoleStats(lua_State* L)
+{
+	auto console = gCoreLibPlatformInterface.GlobalConsole;
+	auto stats = console->GetStats();
+
+	lua_newtable(L);
+	setfield(L, "RateLimit", console->GetRateLimit());
+	setfield(L, "Written", stats.Written);
+	setfield(L, "Dropped", stats.Dropped);
+	setfield(L, "Suppressed", stats.Suppressed);
+	setfield(L, "QueueFullWrites", stats.QueueFullWrites);
+	return 1;
+}
+
+// Writes all queued console messages; returns false if the output couldn't be locked in time
+bool FlushConsole(lua_State* L, std::optional<uint32_t> timeoutMs)
+{
+	return gCoreLibPlatformInterface.GlobalConsole->Flush(timeoutMs.value_or(0));
+}
+
+// Pushes messages to a standalone log queue from several producer threads while a consumer thread
+// drains it, and checks that every message arrives exactly once and in per-producer order.
+// Producers retry when the queue is full, so this measures the queue itself, not the drop policy.
+UserReturn BenchmarkLogQueue(lua_State* L, uint32_t numThreads, uint32_t messagesPerThread)
+{
+	if (numThreads < 1 || numThreads > 64) {
+		luaL_error(L, "Thread count must be between 1 and 64");
+	}
+
+	auto queue = std::make_unique<LogMessageQueue>();
+	std::vector<uint32_t> nextIndex(numThreads, 0);
+	uint64_t received{ 0 }, outOfOrder{ 0 }, invalid{ 0 };
+	uint64_t total = (uint64_t)numThreads * messagesPerThread;
+	std::atomic<bool> start{ false };
+
+	std::thread consumer([&]() {
+		DebugMessageType type;
+		std::string msg;
+		while (received < total) {
+			if (!queue->TryPop(type, msg)) {
+				std::this_thread::yield();
+				continue;
+			}
+
+			received++;
+			unsigned thread, index;
+			if (sscanf_s(msg.c_str(), "%u %u", &thread, &index) != 2 || thread >= numThreads) {
+				invalid++;
+			} else if (nextIndex[thread] != index) {
+				outOfOrder++;
+				nextIndex[thread] = index + 1;
+			} else {
+				nextIndex[thread]++;
+			}
+		}
+	});
+
+	std::vector<std::thread> producers;
+	for (uint32_t i = 0; i < numThreads; i++) {
+		producers.emplace_back([&, i]() {
+			char msg[64];
+			while (!start.load()) {
+				std::this_thread::yield();
+			}
+
+			for (uint32_t j = 0; j < messagesPerThread; j++) {
+				sprintf_s(msg, "%u %u SE_LogQueueBenchmark", i, j);
+				while (!queue->TryPush(DebugMessageType::Debug, msg)) {
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+
+	auto startTime = std::chrono::steady_clock::now();
+	start = true;
+	for (auto& producer : producers) {
+		producer.join();
+	}
+	auto producerTime = std::chrono::steady_clock::now() - startTime;
+	consumer.join();
+
+	uint64_t missing{ 0 };
+	for (auto index : nextIndex) {
+		missing += messagesPerThread - std::min(index, messagesPerThread);
+	}
+
+	lua_newtable(L);
+	setfield(L, "Messages", received);
+	setfield(L, "Missing", missing);
+	setfield(L, "OutOfOrder", outOfOrder);
+	setfield(L, "Invalid", invalid);
+	setfield(L, "NsPerMessage", (double)std::chrono::duration_cast<std::chrono::nanoseconds>(producerTime).count() / (double)std::max(total, (uint64_t)1));
+	return 1;
+}
+
+// Calls a function with the line hook filter of the Lua debugger applied and returns the number of
+// line hooks that fired; used for testing the debugger overhead without attaching a debugger.
+// Breakpoints are passed as a table of chunk name -> list of lines.
+// Usage: Ext.Debug.CountLuaLineHooks(fn, { [debug.getinfo(fn, "S").source] = { 10, 12 } }, false)
+uint64_t CountLuaLineHooks(lua_State* L)
+{
+	luaL_checktype(L, 1, LUA_TFUNCTION);
+	luaL_checktype(L, 2, LUA_TTABLE);
+	auto stepping = lua_toboolean(L, 3) != 0;
+
+	std::unordered_map<STDString, std::unordered_set<int>> breakpoints;
+	for (auto idx : iterate(L, 2)) {
+		auto& lines = breakpoints[get<STDString>(L, idx - 1)];
+		auto count = (int)lua_rawlen(L, idx);
+		for (int i = 1; i <= count; i++) {
+			lua_rawgeti(L, idx, i);
+			lines.insert(get<int>(L, -1));
+			lua_pop(L, 1);
+		}
+	}
+
+	lua_pushvalue(L, 1);
+	return dbg::LineHookFilter::CountLineHooks(L, [&breakpoints](char const* source) -> std::unordered_set<int> const* {
+		auto it = breakpoints.find(source);
+		return it != breakpoints.end() ? &it->second : nullptr;
+	}, stepping);
+}
+
+// Packs the scripts into an in-memory Lua bundle, optionally damages it, then loads it and looks up scripts.
+// Options: Truncate = size, Patch = { { offset, uint32 value }, ... }, Lookup = { name, ... } (defaults to all scripts)
+UserReturn LuaBundleRoundTrip(lua_State* L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+	std::vector<std::pair<STDString, STDString>> scripts;
+	lua_pushnil(L);
+	while (lua_next(L, 1) != 0) {
+		scripts.push_back(std::make_pair(get<STDString>(L, -2), get<STDString>(L, -1)));
+		lua_pop(L, 1);
+	}
+
+	auto buf = LuaBundle::Pack(scripts);
+
+	std::vector<STDString> lookups;
+	if (lua_type(L, 2) == LUA_TTABLE) {
+		auto truncate = try_gettable<uint32_t>(L, "Truncate", 2);
+		if (truncate && *truncate < buf.size()) {
+			buf.resize(*truncate);
+		}
+
+		lua_getfield(L, 2, "Patch");
+		if (lua_type(L, -1) == LUA_TTABLE) {
+			auto count = (int)lua_rawlen(L, -1);
+			for (int i = 1; i <= count; i++) {
+				lua_rawgeti(L, -1, i);
+				lua_rawgeti(L, -1, 1);
+				lua_rawgeti(L, -2, 2);
+				auto offset = get<uint32_t>(L, -2);
+				auto value = get<uint32_t>(L, -1);
+				if ((std::size_t)offset + sizeof(value) <= buf.size()) {
+					memcpy(buf.data() + offset, &value, sizeof(value));
+				}
+				lua_pop(L, 3);
+			}
+		}
+		lua_pop(L, 1);
+
+		lua_getfield(L, 2, "Lookup");
+		if (lua_type(L, -1) == LUA_TTABLE) {
+			auto count = (int)lua_rawlen(L, -1);
+			for (int i = 1; i <= count; i++) {
+				lua_rawgeti(L, -1, i);
+				lookups.push_back(get<STDString>(L, -1));
+				lua_pop(L, 1);
+			}
+		} else {
+			for (auto const& script : scripts) {
+				lookups.push_back(script.first);
+			}
+		}
+		lua_pop(L, 1);
+	} else {
+		for (auto const& script : scripts) {
+			lookups.push_back(script.first);
+		}
+	}
+
+	LuaBundle bundle;
+	auto loaded = bundle.LoadBuffer(std::span<uint8_t const>(buf.data(), buf.size()));
+
+	lua_newtable(L);
+	setfield(L, "Loaded", loaded);
+	setfield(L, "Size", (uint32_t)buf.size());
+
+	// Table of contents of the undamaged bundle layout, so tests can locate the fields they want to patch
+	auto hdr = reinterpret_cast<LuaBundleHeader const*>(buf.data());
+	lua_newtable(L);
+	if (loaded) {
+		auto entries = reinterpret_cast<LuaBundleEntry const*>(buf.data() + sizeof(LuaBundleHeader));
+		auto names = reinterpret_cast<char const*>(entries + hdr->NumEntries);
+		for (uint32_t i = 0; i < hdr->NumEntries; i++) {
+			lua_createtable(L, 0, 6);
+			setfield(L, "Name", STDString(names + entries[i].NameOffset, entries[i].NameSize));
+			setfield(L, "Offset", (uint32_t)(sizeof(LuaBundleHeader) + i * sizeof(LuaBundleEntry)));
+			setfield(L, "DataOffset", entries[i].DataOffset);
+			setfield(L, "DataSize", entries[i].DataSize);
+			setfield(L, "UncompressedSize", entries[i].UncompressedSize);
+			setfield(L, "Compressed", entries[i].Flags == LuaBundleEntryFlags::CompressedXpress);
+			lua_rawseti(L, -2, i + 1);
+		}
+	}
+	lua_setfield(L, -2, "Entries");
+
+	lua_newtable(L);
+	if (loaded) {
+		for (auto const& name : lookups) {
+			auto script = bundle.GetResource(name);
+			if (script) {
+				setfield(L, name.c_str(), *script);
+			}
+		}
+	}
+	lua_setfield(L, -2, "Scripts");
+
+	setfield(L, "Decompressed", (uint32_t)bundle.GetNumDecompressedEntries());
+	return 1;
+}
+
+// Sends one payload (or an array of payloads) through the extender message queue and reassembler.
+// Options: Compress, Duplicate, Order = "Reverse"/"Shuffle", Corrupt = "Offset"/"Truncate"/"Count",
+// Drop = n (drops the second fragment of the first n fragmented messages)
+UserReturn NetLoopback(lua_State* L)
+{
+	std::vector<STDString> payloads;
+	if (lua_type(L, 1) == LUA_TTABLE) {
+		auto count = (int)lua_rawlen(L, 1);
+		for (int i = 1; i <= count; i++) {
+			lua_rawgeti(L, 1, i);
+			payloads.push_back(get<STDString>(L, -1));
+			lua_pop(L, 1);
+		}
+	} else {
+		payloads.push_back(get<STDString>(L, 1));
+	}
+
+	bool compress{ true }, duplicate{ false };
+	uint32_t drop{ 0 };
+	STDString order, corrupt;
+	if (lua_type(L, 2) == LUA_TTABLE) {
+		compress = try_gettable<bool>(L, "Compress", 2, true);
+		duplicate = try_gettable<bool>(L, "Duplicate", 2, false);
+		order = try_gettable<STDString>(L, "Order", 2, STDString{});
+		corrupt = try_gettable<STDString>(L, "Corrupt", 2, STDString{});
+		drop = try_gettable<uint32_t>(L, "Drop", 2, 0);
+	}
+
+	net::MessageCompressor compressor;
+	net::OutgoingMessageQueue queue;
+	net::FragmentReassembler reassembler;
+
+	for (auto const& payload : payloads) {
+		net::MessageWrapper msg;
+		auto post = msg.mutable_post_lua();
+		post->set_channel_name("Loopback");
+		post->set_payload(payload.data(), payload.size());
+		queue.Push(msg, true, compress ? &compressor : nullptr);
+	}
+
+	uint32_t numPackets{ 0 }, compressedPackets{ 0 };
+	uint64_t bytes{ 0 };
+	std::vector<net::MessageWrapper> messages, fragments;
+	while (!queue.IsEmpty()) {
+		queue.BeginTick();
+		while (queue.HasPacket()) {
+			net::MessageWrapper packet;
+			queue.PopPacket(packet, compress ? &compressor : nullptr);
+			numPackets++;
+			bytes += packet.ByteSizeLong();
+
+			if (packet.msg_case() == net::MessageWrapper::kCompressed) {
+				compressedPackets++;
+			}
+
+			// Split packets into fragments and regular messages, so fragments can be reordered
+			if (packet.msg_case() == net::MessageWrapper::kBatch) {
+				for (auto& batched : *packet.mutable_batch()->mutable_messages()) {
+					auto& target = (batched.msg_case() == net::MessageWrapper::kFragment) ? fragments : messages;
+					target.push_back(std::move(batched));
+				}
+			} else {
+				auto& target = (packet.msg_case() == net::MessageWrapper::kFragment) ? fragments : messages;
+				target.push_back(std::move(packet));
+			}
+		}
+	}
+
+	if (order == "Reverse") {
+		std::reverse(fragments.begin(), fragments.end());
+	} else if (order == "Shuffle") {
+		std::mt19937 rng(1234);
+		std::shuffle(fragments.begin(), fragments.end(), rng);
+	}
+
+	if (fragments.size() > 1 && !corrupt.empty()) {
+		auto fragment = fragments[1].mutable_fragment();
+		if (corrupt == "Offset") {
+			// Overlap the previous fragment
+			fragment->set_offset(fragment->offset() - 1);
+		} else if (corrupt == "Truncate") {
+			// Leave a gap before the next fragment
+			fragment->mutable_data()->pop_back();
+		} else if (corrupt == "Count") {
+			fragment->set_count(fragment->count() + 1);
+		}
+	}
+
+	if (drop > 0) {
+		// Transfer IDs are assigned sequentially from 1 by the queue
+		fragments.erase(std::remove_if(fragments.begin(), fragments.end(), [=](net::MessageWrapper const& msg) {
+			return msg.fragment().index() == 1 && msg.fragment().transfer_id() <= drop;
+		}), fragments.end());
+	}
+
+	if (duplicate) {
+		std::vector<net::MessageWrapper> duplicated;
+		for (auto const& fragment : fragments) {
+			duplicated.push_back(fragment);
+			duplicated.push_back(fragment);
+		}
+		fragments = std::move(duplicated);
+	}
+
+	uint32_t received{ 0 };
+	std::optional<STDString> receivedPayload;
+	lua_newtable(L);
+	auto payloadsIndex = lua_gettop(L);
+	auto handler = [&](net::MessageWrapper& unpacked) {
+		if (unpacked.msg_case() == net::MessageWrapper::kPostLua) {
+			receivedPayload = STDString(unpacked.post_lua().payload());
+			received++;
+			push(L, *receivedPayload);
+			lua_rawseti(L, payloadsIndex, received);
+		}
+	};
+
+	for (auto& message : messages) {
+		net::UnpackMessage(message, reassembler, compressor, handler);
+	}
+
+	for (auto& fragment : fragments) {
+		net::UnpackMessage(fragment, reassembler, compressor, handler);
+	}
+
+	lua_newtable(L);
+	setfield(L, "Packets", numPackets);
+	setfield(L, "CompressedPackets", compressedPackets);
+	// Serialized size of all packets sent
+	setfield(L, "Bytes", bytes);
+	setfield(L, "Fragments", (uint32_t)fragments.size());
+	setfield(L, "Received", received);
+	if (receivedPayload) {
+		setfield(L, "Payload", *receivedPayload);
+	}
+
+	// Payloads in the order they were received
+	lua_pushvalue(L, payloadsIndex);
+	lua_setfield(L, -2, "Payloads");
+
+	// Transfer IDs of messages that are still waiting for fragments
+	lua_newtable(L);
+	auto pending = reassembler.GetPendingTransfers();
+	std::sort(pending.begin(), pending.end());
+	for (std::size_t i = 0; i < pending.size(); i++) {
+		push(L, pending[i]);
+		lua_rawseti(L, -2, (int)i + 1);
+	}
+	lua_setfield(L, -2, "PendingTransfers");
+	return 1;
+}
+
 void RegisterDebugLib()
 {
 	DECLARE_MODULE(Debug, Both)
@@ -280,6 +1430,35 @@ void RegisterDebugLib()
 	MODULE_NAMED_FUNCTION("DebugBreak", LuaDebugBreak)
 	MODULE_FUNCTION(IsDeveloperMode)
 	MODULE_FUNCTION(SetEntityRuntimeCheckLevel)
+	MODULE_FUNCTION(GetMemoryStats)
+	MODULE_FUNCTION(StartOsirisProfiler)
+	MODULE_FUNCTION(StopOsirisProfiler)
+	MODULE_FUNCTION(ResetOsirisProfiler)
+	MODULE_FUNCTION(GetOsirisProfile)
+	MODULE_FUNCTION(ProfileOsirisNodeTrace)
+	MODULE_FUNCTION(StartLuaProfiler)
+	MODULE_FUNCTION(StopLuaProfiler)
+	MODULE_FUNCTION(ResetLuaProfiler)
+	MODULE_FUNCTION(GetLuaProfile)
+	MODULE_FUNCTION(DumpLuaProfile)
+	MODULE_FUNCTION(GetLuaGCStats)
+	MODULE_FUNCTION(SetLuaGCBudget)
+	MODULE_FUNCTION(ResetLuaGCStats)
+	MODULE_FUNCTION(GetLuaChunkCacheStats)
+	MODULE_FUNCTION(JsoncppRoundTrip)
+	MODULE_FUNCTION(LoadLuaChunk)
+	MODULE_FUNCTION(GetConsoleStats)
+	MODULE_FUNCTION(FlushConsole)
+	MODULE_FUNCTION(BenchmarkLogQueue)
+	MODULE_FUNCTION(CountLuaLineHooks)
+	MODULE_FUNCTION(NetLoopback)
+	MODULE_FUNCTION(LuaBundleRoundTrip)
+	MODULE_FUNCTION(RunTimerTrace)
+	MODULE_FUNCTION(SetJsonUserVariable)
+	MODULE_FUNCTION(ScanPatterns)
+	MODULE_FUNCTION(MapSymbolsWithCache)
+	MODULE_FUNCTION(CountMapIterationWork)
+	MODULE_FUNCTION(BenchmarkOsirisSubscriberTable)
 	MODULE_FUNCTION(Crash)
 	END_MODULE()
 }
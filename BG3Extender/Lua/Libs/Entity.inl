@@ -19,6 +19,36 @@ EntityHandle UuidToHandle(lua_State* L, Guid uuid)
 	return State::FromLua(L)->GetEntitySystemHelpers()->GetEntityHandle(uuid);
 }
 
+// Resolves a list of UUIDs in one call; the returned table has the entity of each UUID at the same index,
+// or nil if the UUID is unknown.
+// Usage: local entities = Ext.Entity.UuidsToHandles({uuid1, uuid2})
+UserReturn UuidsToHandles(lua_State* L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+
+	Vector<Guid> uuids;
+	auto count = (int)lua_rawlen(L, 1);
+	uuids.reserve(count);
+	for (int i = 1; i <= count; i++) {
+		lua_rawgeti(L, 1, i);
+		uuids.push_back(get<Guid>(L, -1));
+		lua_pop(L, 1);
+	}
+
+	Array<EntityHandle> handles;
+	State::FromLua(L)->GetEntitySystemHelpers()->GetEntityHandles(uuids, handles);
+
+	lua_createtable(L, count, 0);
+	for (int i = 0; i < count; i++) {
+		if (handles[i]) {
+			EntityProxyMetatable::Make(L, handles[i]);
+			lua_rawseti(L, -2, i + 1);
+		}
+	}
+
+	return 1;
+}
+
 UserReturn Get(lua_State* L, Guid uuid)
 {
 	auto handle = State::FromLua(L)->GetEntitySystemHelpers()->GetEntityHandle(uuid);
@@ -70,6 +100,125 @@ Array<EntityHandle> GetAllEntities(lua_State* L)
 	return entities;
 }
 
+struct EntityQueryIterator
+{
+	ecs::EntityStorageQuery Query;
+	std::array<ExtComponentType, ecs::EntityStorageQuery::MaxComponents> Types;
+	// The query walks entity storage directly, so it must not outlive the context it was created in
+	LifetimeHandle Lifetime;
+};
+
+static_assert(std::is_trivially_destructible_v<EntityQueryIterator>, "Query iterator is stored in a userdata without a finalizer");
+
+int EntityQueryNext(lua_State* L)
+{
+	auto iter = reinterpret_cast<EntityQueryIterator*>(lua_touserdata(L, lua_upvalueindex(1)));
+	if (!iter->Lifetime.IsAlive(L)) {
+		luaL_error(L, "Attempted to iterate an entity query whose lifetime has expired");
+		return 0;
+	}
+
+	if (!iter->Query.Next()) {
+		push(L, nullptr);
+		return 1;
+	}
+
+	auto numComponents = iter->Query.GetComponentCount();
+	luaL_checkstack(L, (int)numComponents + 1, "entity query");
+	EntityProxyMetatable::Make(L, iter->Query.GetEntity());
+
+	for (unsigned i = 0; i < numComponents; i++) {
+		PushComponent(L, iter->Query.GetComponent(i), iter->Types[i], iter->Lifetime);
+	}
+
+	return (int)numComponents + 1;
+}
+
+// Iterates all entities that have every component passed in the arguments, without building an entity list.
+// Usage: for entity, comp1, comp2 in Ext.Entity.Query("Comp1", "Comp2") do ... end
+UserReturn Query(lua_State* L)
+{
+	auto numComponents = lua_gettop(L);
+	if (numComponents < 1 || numComponents > (int)ecs::EntityStorageQuery::MaxComponents) {
+		luaL_error(L, "Entity queries must have between 1 and %d components", ecs::EntityStorageQuery::MaxComponents);
+	}
+
+	auto ecs = State::FromLua(L)->GetEntitySystemHelpers();
+	auto world = ecs->GetEntityWorld();
+	if (!world) {
+		luaL_error(L, "Entity world is not available");
+	}
+
+	auto iter = reinterpret_cast<EntityQueryIterator*>(lua_newuserdata(L, sizeof(EntityQueryIterator)));
+	new (iter) EntityQueryIterator{ ecs::EntityStorageQuery(world->Storage), {}, State::FromLua(L)->GetCurrentLifetime() };
+
+	for (int i = 0; i < numComponents; i++) {
+		auto type = get<ExtComponentType>(L, i + 1);
+		auto componentType = ecs->GetComponentIndex(type);
+		if (!componentType) {
+			luaL_error(L, "Component type %s is not available", EnumInfo<ExtComponentType>::GetStore().Find((EnumUnderlyingType)type).GetString());
+		}
+
+		auto const& meta = ecs->GetComponentMeta(type);
+		iter->Query.AddComponent(*componentType, meta.Size, meta.IsProxy);
+		iter->Types[i] = type;
+	}
+
+	lua_pushcclosure(L, &EntityQueryNext, 1);
+	return 1;
+}
+
+// Reads the optional component name arguments of spatial queries, starting at the specified stack index
+EntitySpatialIndex::ComponentFilter GetSpatialQueryFilter(lua_State* L, int firstIndex)
+{
+	EntitySpatialIndex::ComponentFilter filter;
+	auto numComponents = lua_gettop(L) - firstIndex + 1;
+	if (numComponents > (int)filter.Types.size()) {
+		luaL_error(L, "Spatial queries can filter on at most %d components", (int)filter.Types.size());
+	}
+
+	auto ecs = State::FromLua(L)->GetEntitySystemHelpers();
+	for (int i = 0; i < numComponents; i++) {
+		auto type = get<ExtComponentType>(L, firstIndex + i);
+		auto componentType = ecs->GetComponentIndex(type);
+		if (!componentType) {
+			luaL_error(L, "Component type %s is not available", EnumInfo<ExtComponentType>::GetStore().Find((EnumUnderlyingType)type).GetString());
+		}
+
+		filter.Types[filter.NumTypes++] = *componentType;
+	}
+
+	return filter;
+}
+
+// Returns all entities within the radius that have every component passed after the radius.
+// Usage: Ext.Entity.GetEntitiesAroundPosition(pos, 10.0, "ServerCharacter")
+Array<EntityHandle> GetEntitiesAroundPosition(lua_State* L, glm::vec3 const& position, float radius)
+{
+	auto filter = GetSpatialQueryFilter(L, 3);
+	Array<EntityHandle> entities;
+	State::FromLua(L)->GetSpatialIndex().QueryRadius(position, radius, filter, entities);
+	return entities;
+}
+
+Array<EntityHandle> GetEntitiesInBox(lua_State* L, glm::vec3 const& min, glm::vec3 const& max)
+{
+	auto filter = GetSpatialQueryFilter(L, 3);
+	Array<EntityHandle> entities;
+	State::FromLua(L)->GetSpatialIndex().QueryBox(min, max, filter, entities);
+	return entities;
+}
+
+// Returns the closest entities to the position, ordered by distance.
+// Usage: Ext.Entity.GetNearestEntities(pos, 5, 30.0, "ServerItem")
+Array<EntityHandle> GetNearestEntities(lua_State* L, glm::vec3 const& position, uint32_t count, std::optional<float> maxDistance)
+{
+	auto filter = GetSpatialQueryFilter(L, 4);
+	Array<EntityHandle> entities;
+	State::FromLua(L)->GetSpatialIndex().QueryNearest(position, count, maxDistance ? *maxDistance : std::numeric_limits<float>::max(), filter, entities);
+	return entities;
+}
+
 uint64_t Subscribe(lua_State* L, ExtComponentType type, FunctionRef func, std::optional<EntityHandle> entity, std::optional<uint64_t> flags)
 {
 	auto hooks = State::FromLua(L)->GetReplicationEventHooks();
@@ -86,6 +235,23 @@ uint64_t Subscribe(lua_State* L, ExtComponentType type, FunctionRef func, std::o
 	return (ReplicationEventHandleType << 32) | index;
 }
 
+// Handler is called once per tick for each component type with the list of changed entities and their replication flags
+uint64_t OnChanged(lua_State* L, ExtComponentType type, FunctionRef func, std::optional<EntityHandle> entity, std::optional<uint64_t> flags)
+{
+	auto hooks = State::FromLua(L)->GetReplicationEventHooks();
+	if (!hooks) {
+		luaL_error(L, "Entity events are only available on the server");
+	}
+
+	auto replicationType = State::FromLua(L)->GetEntitySystemHelpers()->GetReplicationIndex(type);
+	if (!replicationType) {
+		luaL_error(L, "No events are available for components of type %s", EnumInfo<ExtComponentType>::GetStore().Find((EnumUnderlyingType)type).GetString());
+	}
+
+	auto index = hooks->SubscribeBatched(*replicationType, entity ? *entity : EntityHandle{}, flags ? *flags : 0xffffffffffffffffull, RegistryEntry(L, func.Index));
+	return (ReplicationEventHandleType << 32) | index;
+}
+
 uint64_t OnCreate(lua_State* L, ExtComponentType type, FunctionRef func, std::optional<EntityHandle> entity)
 {
 	auto componentType = State::FromLua(L)->GetEntitySystemHelpers()->GetComponentIndex(type);
@@ -140,12 +306,18 @@ void RegisterEntityLib()
 	BEGIN_MODULE()
 	MODULE_FUNCTION(HandleToUuid)
 	MODULE_FUNCTION(UuidToHandle)
+	MODULE_FUNCTION(UuidsToHandles)
 	MODULE_FUNCTION(Get)
 	MODULE_FUNCTION(GetAllEntitiesWithUuid)
 	MODULE_FUNCTION(GetAllEntitiesWithComponent)
 	MODULE_FUNCTION(GetAllEntities)
+	MODULE_FUNCTION(Query)
+	MODULE_FUNCTION(GetEntitiesAroundPosition)
+	MODULE_FUNCTION(GetEntitiesInBox)
+	MODULE_FUNCTION(GetNearestEntities)
 	MODULE_FUNCTION(Subscribe)
 	MODULE_NAMED_FUNCTION("OnChange", Subscribe)
+	MODULE_FUNCTION(OnChanged)
 	MODULE_FUNCTION(OnCreate)
 	MODULE_FUNCTION(OnDestroy)
 	MODULE_FUNCTION(Unsubscribe)
@@ -1,6 +1,6 @@
 #include <Lua/Libs/Json.h>
 
-#include <fstream>
+#include <charconv>
 #include <unordered_set>
 #include <json/json.h>
 #include <lstate.h>
@@ -8,82 +8,419 @@
 /// <lua_module>Json</lua_module>
 BEGIN_NS(lua::json)
 
-void Parse(lua_State * L, Json::Value const & val);
-
-void ParseArray(lua_State * L, Json::Value const & val)
+void AppendUtf8(std::string& out, unsigned codepoint)
 {
-	lua_createtable(L, (int)val.size(), 0);
-	int idx = 1;
-	for (auto it = val.begin(), end = val.end(); it != end; ++it) {
-		push(L, idx++);
-		Parse(L, *it);
-		lua_rawset(L, -3);
+	if (codepoint < 0x80) {
+		out += (char)codepoint;
+	} else if (codepoint < 0x800) {
+		out += (char)(0xC0 | (codepoint >> 6));
+		out += (char)(0x80 | (codepoint & 0x3F));
+	} else if (codepoint < 0x10000) {
+		out += (char)(0xE0 | (codepoint >> 12));
+		out += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+		out += (char)(0x80 | (codepoint & 0x3F));
+	} else {
+		out += (char)(0xF0 | (codepoint >> 18));
+		out += (char)(0x80 | ((codepoint >> 12) & 0x3F));
+		out += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+		out += (char)(0x80 | (codepoint & 0x3F));
 	}
 }
 
-void ParseObject(lua_State * L, Json::Value const & val)
+// Recursive descent parser that pushes values directly to the Lua stack
+// without building an intermediate Json::Value tree.
+// Accepts the same dialect as the jsoncpp reader defaults we used previously
+// (comments, trailing commas and trailing garbage after the root value are allowed).
+class JsonReader
 {
-	lua_createtable(L, 0, (int)val.size());
-	for (auto it = val.begin(), end = val.end(); it != end; ++it) {
-		Parse(L, it.key());
-		Parse(L, *it);
-		lua_rawset(L, -3);
+public:
+	static constexpr unsigned MaxDepth = 1000;
+
+	JsonReader(lua_State* L, StringView json)
+		: L_(L), begin_(json.data()), cur_(json.data()), end_(json.data() + json.size())
+	{}
+
+	// Pushes the root value on success; leaves the stack untouched on failure.
+	bool Parse(std::string& errors)
+	{
+		auto top = lua_gettop(L_);
+		if (end_ - cur_ >= 3 && memcmp(cur_, "\xEF\xBB\xBF", 3) == 0) {
+			cur_ += 3;
+		}
+
+		if (ReadValue(0)) {
+			return true;
+		}
+
+		lua_settop(L_, top);
+		errors = FormatError();
+		return false;
 	}
-}
 
-void Parse(lua_State * L, Json::Value const & val)
-{
-	switch (val.type()) {
-	case Json::nullValue:
-		lua_pushnil(L);
-		break;
+private:
+	lua_State* L_;
+	char const* begin_;
+	char const* cur_;
+	char const* end_;
+	std::string buf_;
+	char const* errorMsg_{ nullptr };
+	char const* errorPos_{ nullptr };
+
+	bool Fail(char const* msg, char const* pos)
+	{
+		errorMsg_ = msg;
+		errorPos_ = pos;
+		return false;
+	}
 
-	case Json::intValue:
-		push(L, val.asInt64());
-		break;
+	std::string FormatError() const
+	{
+		int line = 1;
+		char const* lineStart = begin_;
+		for (auto p = begin_; p < errorPos_; p++) {
+			if (*p == '\n' || (*p == '\r' && (p + 1 == errorPos_ || p[1] != '\n'))) {
+				line++;
+				lineStart = p + 1;
+			}
+		}
 
-	case Json::uintValue:
-		push(L, (int64_t)val.asUInt64());
-		break;
+		char pos[64];
+		sprintf_s(pos, "* Line %d, Column %d\n  ", line, (int)(errorPos_ - lineStart) + 1);
+		return std::string(pos) + errorMsg_ + "\n";
+	}
 
-	case Json::realValue:
-		push(L, val.asDouble());
-		break;
+	bool SkipWhitespace()
+	{
+		while (cur_ < end_) {
+			switch (*cur_) {
+			case ' ':
+			case '\t':
+			case '\r':
+			case '\n':
+				cur_++;
+				break;
 
-	case Json::stringValue:
-		push(L, val.asCString());
-		break;
+			case '/':
+				if (cur_ + 1 < end_ && cur_[1] == '/') {
+					cur_ += 2;
+					while (cur_ < end_ && *cur_ != '\n' && *cur_ != '\r') cur_++;
+				} else if (cur_ + 1 < end_ && cur_[1] == '*') {
+					auto start = cur_;
+					cur_ += 2;
+					while (cur_ + 1 < end_ && !(cur_[0] == '*' && cur_[1] == '/')) cur_++;
+					if (cur_ + 1 >= end_) {
+						return Fail("Unterminated comment", start);
+					}
+					cur_ += 2;
+				} else {
+					return true;
+				}
+				break;
 
-	case Json::booleanValue:
-		push(L, val.asBool());
-		break;
+			default:
+				return true;
+			}
+		}
 
-	case Json::arrayValue:
-		ParseArray(L, val);
-		break;
+		return true;
+	}
 
-	case Json::objectValue:
-		ParseObject(L, val);
-		break;
+	bool ReadLiteral(char const* literal, std::size_t length)
+	{
+		if ((std::size_t)(end_ - cur_) < length || memcmp(cur_, literal, length) != 0) {
+			return Fail("Syntax error: value, object or array expected.", cur_);
+		}
 
-	default:
-		luaL_error(L, "Attempted to parse unknown Json value");
+		cur_ += length;
+		return true;
 	}
-}
+
+	bool ReadValue(unsigned depth)
+	{
+		if (depth > MaxDepth) {
+			return Fail("Exceeded stackLimit in readValue().", cur_);
+		}
+
+		if (!SkipWhitespace()) return false;
+
+		if (cur_ == end_) {
+			return Fail("Syntax error: value, object or array expected.", cur_);
+		}
+
+		switch (*cur_) {
+		case '{':
+			return ReadObject(depth);
+
+		case '[':
+			return ReadArray(depth);
+
+		case '"':
+			return ReadString();
+
+		case 't':
+			if (!ReadLiteral("true", 4)) return false;
+			lua_pushboolean(L_, 1);
+			return true;
+
+		case 'f':
+			if (!ReadLiteral("false", 5)) return false;
+			lua_pushboolean(L_, 0);
+			return true;
+
+		case 'n':
+			if (!ReadLiteral("null", 4)) return false;
+			lua_pushnil(L_);
+			return true;
+
+		case '-':
+		case '0': case '1': case '2': case '3': case '4':
+		case '5': case '6': case '7': case '8': case '9':
+			return ReadNumber();
+
+		default:
+			return Fail("Syntax error: value, object or array expected.", cur_);
+		}
+	}
+
+	bool ReadObject(unsigned depth)
+	{
+		luaL_checkstack(L_, 3, "JSON document nested too deeply");
+		cur_++;
+		lua_newtable(L_);
+
+		for (;;) {
+			if (!SkipWhitespace()) return false;
+			if (cur_ < end_ && *cur_ == '}') {
+				cur_++;
+				return true;
+			}
+
+			if (cur_ == end_ || *cur_ != '"') {
+				return Fail("Missing '}' or object member name", cur_);
+			}
+
+			if (!ReadString()) return false;
+
+			if (!SkipWhitespace()) return false;
+			if (cur_ == end_ || *cur_ != ':') {
+				return Fail("Missing ':' after object member name", cur_);
+			}
+			cur_++;
+
+			if (!ReadValue(depth + 1)) return false;
+			lua_rawset(L_, -3);
+
+			if (!SkipWhitespace()) return false;
+			if (cur_ < end_ && *cur_ == ',') {
+				cur_++;
+			} else if (cur_ < end_ && *cur_ == '}') {
+				cur_++;
+				return true;
+			} else {
+				return Fail("Missing ',' or '}' in object declaration", cur_);
+			}
+		}
+	}
+
+	bool ReadArray(unsigned depth)
+	{
+		luaL_checkstack(L_, 2, "JSON document nested too deeply");
+		cur_++;
+		lua_newtable(L_);
+
+		lua_Integer index = 1;
+		for (;;) {
+			if (!SkipWhitespace()) return false;
+			if (cur_ < end_ && *cur_ == ']') {
+				cur_++;
+				return true;
+			}
+
+			if (!ReadValue(depth + 1)) return false;
+			lua_rawseti(L_, -2, index++);
+
+			if (!SkipWhitespace()) return false;
+			if (cur_ < end_ && *cur_ == ',') {
+				cur_++;
+			} else if (cur_ < end_ && *cur_ == ']') {
+				cur_++;
+				return true;
+			} else {
+				return Fail("Missing ',' or ']' in array declaration", cur_);
+			}
+		}
+	}
+
+	bool ReadNumber()
+	{
+		auto start = cur_;
+		bool isInteger = true;
+
+		if (*cur_ == '-') cur_++;
+
+		auto digits = cur_;
+		while (cur_ < end_ && *cur_ >= '0' && *cur_ <= '9') cur_++;
+		if (cur_ == digits) {
+			return Fail("Syntax error: value, object or array expected.", start);
+		}
+
+		if (cur_ < end_ && *cur_ == '.') {
+			isInteger = false;
+			digits = ++cur_;
+			while (cur_ < end_ && *cur_ >= '0' && *cur_ <= '9') cur_++;
+			if (cur_ == digits) {
+				return Fail("Syntax error: value, object or array expected.", start);
+			}
+		}
+
+		if (cur_ < end_ && (*cur_ == 'e' || *cur_ == 'E')) {
+			isInteger = false;
+			cur_++;
+			if (cur_ < end_ && (*cur_ == '+' || *cur_ == '-')) cur_++;
+			digits = cur_;
+			while (cur_ < end_ && *cur_ >= '0' && *cur_ <= '9') cur_++;
+			if (cur_ == digits) {
+				return Fail("Syntax error: value, object or array expected.", start);
+			}
+		}
+
+		if (isInteger) {
+			// Integers are kept as integers if they fit in int64 (or uint64 for positive values),
+			// and fall back to doubles otherwise
+			if (*start == '-') {
+				int64_t value;
+				if (std::from_chars(start, cur_, value).ec == std::errc()) {
+					lua_pushinteger(L_, (lua_Integer)value);
+					return true;
+				}
+			} else {
+				uint64_t value;
+				if (std::from_chars(start, cur_, value).ec == std::errc()) {
+					lua_pushinteger(L_, (lua_Integer)value);
+					return true;
+				}
+			}
+		}
+
+		double value;
+		auto result = std::from_chars(start, cur_, value);
+		if (result.ec == std::errc::result_out_of_range) {
+			value = strtod(std::string(start, cur_).c_str(), nullptr);
+		} else if (result.ec != std::errc()) {
+			return Fail("Syntax error: value, object or array expected.", start);
+		}
+
+		lua_pushnumber(L_, value);
+		return true;
+	}
+
+	bool ReadHex4(unsigned& value)
+	{
+		if (end_ - cur_ < 4) return false;
+
+		value = 0;
+		for (auto i = 0; i < 4; i++) {
+			char c = *cur_++;
+			value <<= 4;
+			if (c >= '0' && c <= '9') {
+				value += c - '0';
+			} else if (c >= 'a' && c <= 'f') {
+				value += c - 'a' + 10;
+			} else if (c >= 'A' && c <= 'F') {
+				value += c - 'A' + 10;
+			} else {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool ReadUnicodeEscape(char const* escape)
+	{
+		unsigned codepoint;
+		if (!ReadHex4(codepoint)) {
+			return Fail("Bad unicode escape sequence in string: four digits expected.", escape);
+		}
+
+		if (codepoint >= 0xD800 && codepoint <= 0xDBFF) {
+			unsigned low;
+			if (end_ - cur_ < 6 || cur_[0] != '\\' || cur_[1] != 'u') {
+				return Fail("additional six characters expected to parse unicode surrogate pair.", escape);
+			}
+
+			cur_ += 2;
+			if (!ReadHex4(low) || low < 0xDC00 || low > 0xDFFF) {
+				return Fail("expecting another \\u token to begin the second half of a unicode surrogate pair", escape);
+			}
+
+			codepoint = 0x10000 + ((codepoint & 0x3FF) << 10) + (low & 0x3FF);
+		}
+
+		AppendUtf8(buf_, codepoint);
+		return true;
+	}
+
+	bool ReadString()
+	{
+		auto quote = cur_++;
+		auto start = cur_;
+		while (cur_ < end_ && *cur_ != '"' && *cur_ != '\\') cur_++;
+
+		// Fast path for strings without escape sequences
+		if (cur_ < end_ && *cur_ == '"') {
+			lua_pushlstring(L_, start, cur_ - start);
+			cur_++;
+			return true;
+		}
+
+		buf_.assign(start, cur_);
+		while (cur_ < end_) {
+			char c = *cur_++;
+			if (c == '"') {
+				lua_pushlstring(L_, buf_.data(), buf_.size());
+				return true;
+			}
+
+			if (c != '\\') {
+				buf_ += c;
+				continue;
+			}
+
+			auto escape = cur_ - 1;
+			if (cur_ == end_) break;
+
+			switch (*cur_++) {
+			case '"': buf_ += '"'; break;
+			case '/': buf_ += '/'; break;
+			case '\\': buf_ += '\\'; break;
+			case 'b': buf_ += '\b'; break;
+			case 'f': buf_ += '\f'; break;
+			case 'n': buf_ += '\n'; break;
+			case 'r': buf_ += '\r'; break;
+			case 't': buf_ += '\t'; break;
+			case 'u':
+				if (!ReadUnicodeEscape(escape)) return false;
+				break;
+
+			default:
+				return Fail("Bad escape sequence in string", escape);
+			}
+		}
+
+		return Fail("Missing '\"' after string", quote);
+	}
+};
 
 bool Parse(lua_State * L, StringView json)
 {
-	Json::CharReaderBuilder factory;
-	std::unique_ptr<Json::CharReader> reader(factory.newCharReader());
-
-	Json::Value root;
+	JsonReader reader(L, json);
 	std::string errs;
-	if (!reader->parse(json.data(), json.data() + json.size(), &root, &errs)) {
+	if (!reader.Parse(errs)) {
 		ERR("Unable to parse JSON: %s", errs.c_str());
 		return false;
 	}
 
-	Parse(L, root);
 	return true;
 }
 
@@ -93,16 +430,12 @@ UserReturn LuaParse(lua_State * L)
 	size_t length;
 	auto json = luaL_checklstring(L, 1, &length);
 
-	Json::CharReaderBuilder factory;
-	std::unique_ptr<Json::CharReader> reader(factory.newCharReader());
-
-	Json::Value root;
+	JsonReader reader(L, StringView(json, length));
 	std::string errs;
-	if (!reader->parse(json, json + length, &root, &errs)) {
+	if (!reader.Parse(errs)) {
 		return luaL_error(L, "Unable to parse JSON: %s", errs.c_str());
 	}
 
-	Parse(L, root);
 	return 1;
 }
 
@@ -245,318 +578,685 @@ bool IsMapLikeUserdata(lua_State* L, int index)
 	return false;
 }
 
-Json::Value Stringify(lua_State * L, int index, unsigned depth, StringifyContext& ctx);
-
-Json::Value StringifyUserdata(lua_State * L, int index, unsigned depth, StringifyContext& ctx)
+bool JsonCanStringifyAsArray(lua_State * L, int index)
 {
-	StackCheck _(L, 0);
+	lua_pushnil(L);
 
-	index = lua_absindex(L, index);
+	if (index < 0) index--;
 
-	if (CheckForRecursion(L, index, ctx)) {
-		return Json::Value("*RECURSION*");
-	}
+	int next = 1;
+	bool isArray = true;
+	while (lua_next(L, index) != 0) {
+#if LUA_VERSION_NUM > 501
+		if (lua_isinteger(L, -2)) {
+			auto key = lua_tointeger(L, -2);
+			if (key != next++) {
+				isArray = false;
+			}
+		} else {
+			isArray = false;
+		}
+#else
+		if (lua_isnumber(L, -2)) {
+			auto key = lua_tonumber(L, -2);
+			if (abs(key - next++) < 0.0001) {
+				isArray = false;
+			}
+		} else {
+			isArray = false;
+		}
+#endif
 
-	Json::Value arr;
-	if (IsArrayLikeUserdata(L, index)) {
-		arr = Json::Value(Json::arrayValue);
-	} else {
-		arr = Json::Value(Json::objectValue);
+		if (!isArray) {
+			// No need to check the remaining keys
+			lua_pop(L, 2);
+			break;
+		}
+
+		lua_pop(L, 1);
 	}
 
-	bool isMap = IsMapLikeUserdata(L, index);
+	return isArray;
+}
 
-	if (!TryGetUserdataPairs(L, index)) {
-		return Json::Value();
+// Serializes Lua values directly into the output string without building an intermediate Json::Value tree.
+// The output format matches the jsoncpp StreamWriter we used previously (sorted object keys,
+// tab indentation, 17 significant digits for doubles, \u escapes for non-ASCII characters).
+class JsonWriter
+{
+public:
+	JsonWriter(lua_State* L, StringifyContext& ctx)
+		: L_(L), ctx_(ctx)
+	{}
+
+	std::string Release()
+	{
+		return std::move(out_);
 	}
 
-#if !defined(NDEBUG)
-	auto ptrVal = GetPointerValue(L, index);
+	void Write(int index, unsigned depth, bool indented)
+	{
+		if (depth > ctx_.MaxDepth) {
+			throw std::runtime_error("Recursion depth exceeded while stringifying JSON");
+		}
+
+		index = lua_absindex(L_, index);
+
+		switch (lua_type(L_, index)) {
+		case LUA_TNIL:
+			out_ += "null";
+			break;
+
+		case LUA_TBOOLEAN:
+			out_ += lua_toboolean(L_, index) ? "true" : "false";
+			break;
+
+		case LUA_TNUMBER:
+#if LUA_VERSION_NUM > 501
+			if (lua_isinteger(L_, index)) {
+				WriteInteger(lua_tointeger(L_, index));
+			} else {
+				WriteDouble(lua_tonumber(L_, index));
+			}
+#else
+			WriteDouble(lua_tonumber(L_, index));
 #endif
+			break;
 
-	// Call __pairs(obj)
-	auto nextIndex = lua_absindex(L, -1);
-	lua_pushvalue(L, index);
-	lua_call(L, 1, 3); // returns __next, obj, nil
-
-	// Push next, obj, k
-	lua_pushvalue(L, nextIndex);
-	lua_pushvalue(L, nextIndex + 1);
-	lua_pushvalue(L, nextIndex + 2);
-	// Call __next(obj, k)
-	lua_call(L, 2, 2); // returns k, val
-
-	int numElements{ 0 };
-	while (lua_type(L, -2) != LUA_TNIL) {
-		if (isMap && ctx.LimitArrayElements != -1 && numElements > ctx.LimitArrayElements) {
+		case LUA_TSTRING:
+		{
+			size_t len;
+			auto str = lua_tolstring(L_, index, &len);
+			WriteString(str, len);
 			break;
 		}
 
-#if !defined(NDEBUG)
-		STDString key;
-		if (lua_type(L, -2) == LUA_TSTRING) {
-			key = lua_tostring(L, -2);
-		} else if (lua_type(L, -2) == LUA_TNUMBER) {
-			lua_pushvalue(L, -2);
-			key = lua_tostring(L, -1);
-			lua_pop(L, 1);
+		case LUA_TTABLE:
+			if (ctx_.LimitDepth != -1 && depth > (uint32_t)ctx_.LimitDepth) {
+				WriteString("*DEPTH LIMIT EXCEEDED*");
+			} else {
+				WriteTable(index, depth, indented);
+			}
+			break;
+
+		case LUA_TUSERDATA:
+		case LUA_TLIGHTCPPOBJECT:
+		case LUA_TCPPOBJECT:
+			WriteUserdata(index, depth, indented);
+			break;
+
+		case LUA_TLIGHTUSERDATA:
+		case LUA_TFUNCTION:
+		case LUA_TTHREAD:
+			WriteInternalType(index);
+			break;
+
+		default:
+			throw std::runtime_error("Attempted to stringify an unknown type");
 		}
-#endif
+	}
 
-		Json::Value val(Stringify(L, -1, depth + 1, ctx));
+private:
+	struct ObjectScope
+	{
+		std::size_t Start;
+		std::size_t BodyStart;
+		std::size_t FirstMember;
+		std::size_t KeysStart;
+	};
+
+	struct ArrayScope
+	{
+		std::size_t Start;
+		std::size_t Size;
+	};
+
+	struct Member
+	{
+		// Unescaped key in keys_
+		std::size_t KeyOffset;
+		std::size_t KeyLength;
+		// Serialized member (without the separating comma) in out_
+		std::size_t Start;
+		std::size_t End;
+	};
+
+	lua_State* L_;
+	StringifyContext& ctx_;
+	std::string out_;
+	std::string indent_;
+	std::string keys_;
+	std::string scratch_;
+	std::vector<Member> members_;
+
+	void WriteIndent()
+	{
+		if (ctx_.Beautify) {
+			out_ += '\n';
+			out_ += indent_;
+		}
+	}
 
-		auto type = lua_type(L, -2);
-		if (type == LUA_TSTRING) {
-			auto key = lua_tostring(L, -2);
-			arr[key] = val;
-		} else if (type == LUA_TNUMBER) {
-			auto key = lua_tointeger(L, -2);
-			if (ctx.LimitArrayElements != -1 && key > ctx.LimitArrayElements) {
+	ObjectScope BeginObject(bool indented)
+	{
+		ObjectScope obj{ out_.size(), 0, members_.size(), keys_.size() };
+		if (!indented) WriteIndent();
+		out_ += '{';
+		obj.BodyStart = out_.size();
+		if (ctx_.Beautify) indent_ += '\t';
+		return obj;
+	}
+
+	void BeginMember(ObjectScope& obj, char const* key, std::size_t keyLength)
+	{
+		if (members_.size() > obj.FirstMember) {
+			out_ += ',';
+		}
+
+		members_.push_back(Member{ keys_.size(), keyLength, out_.size(), 0 });
+		keys_.append(key, keyLength);
+		WriteIndent();
+		WriteString(key, keyLength);
+		out_ += ctx_.Beautify ? " : " : ":";
+	}
+
+	void EndMember()
+	{
+		members_.back().End = out_.size();
+	}
+
+	StringView GetKey(Member const& member) const
+	{
+		return StringView(keys_.data() + member.KeyOffset, member.KeyLength);
+	}
+
+	void SortMembers(ObjectScope& obj)
+	{
+		auto first = members_.begin() + obj.FirstMember;
+		auto last = members_.end();
+
+		bool sorted = true;
+		for (auto it = first + 1; it < last; ++it) {
+			if (!(GetKey(*(it - 1)) < GetKey(*it))) {
+				sorted = false;
 				break;
 			}
+		}
 
-			if (arr.type() == Json::arrayValue) {
-				arr[(uint32_t)key - 1] = val;
-			} else {
-				lua_pushvalue(L, -2);
-				auto key = lua_tostring(L, -1);
-				arr[key] = val;
-				lua_pop(L, 1);
-			}
-		} else if ((type == LUA_TUSERDATA || type == LUA_TLIGHTCPPOBJECT || type == LUA_TCPPOBJECT) && ctx.StringifyInternalTypes) {
-			int top = lua_gettop(L);
-			lua_getglobal(L, "tostring");  /* function to be called */
-			lua_pushvalue(L, -3);   /* value to print */
-			lua_call(L, 1, 1);
-			const char* key = lua_tostring(L, -1);  /* get result */
-			if (key) {
-				arr[key] = val;
-			}
-			int top2 = lua_gettop(L);
-			lua_pop(L, 1);  /* pop result */
-		} else if (type == LUA_TLIGHTUSERDATA && ctx.StringifyInternalTypes) {
-			auto handle = get<EntityHandle>(L, -2);
-			char key[100];
-			sprintf_s(key, "%016llx", handle.Handle);
-			arr[key] = val;
+		if (sorted) return;
+
+		std::stable_sort(first, last, [this](Member const& a, Member const& b) {
+			return GetKey(a) < GetKey(b);
+		});
+
+		// Reassemble members in key order; if a key was written multiple times, the last value wins
+		scratch_.assign(out_, obj.BodyStart, std::string::npos);
+		out_.resize(obj.BodyStart);
+		bool firstMember = true;
+		for (auto it = first; it < last; ++it) {
+			if (it + 1 < last && GetKey(*it) == GetKey(*(it + 1))) continue;
+
+			if (!firstMember) out_ += ',';
+			firstMember = false;
+			out_.append(scratch_, it->Start - obj.BodyStart, it->End - it->Start);
+		}
+	}
+
+	void EndObject(ObjectScope& obj)
+	{
+		if (ctx_.Beautify) indent_.pop_back();
+
+		if (members_.size() == obj.FirstMember) {
+			out_.resize(obj.Start);
+			out_ += "{}";
 		} else {
-			throw std::runtime_error("Can only stringify string or number table keys");
+			SortMembers(obj);
+			WriteIndent();
+			out_ += '}';
 		}
 
-		// Push next, obj, k
-		lua_pushvalue(L, nextIndex);
-		lua_pushvalue(L, nextIndex + 1);
-		lua_pushvalue(L, nextIndex + 3);
-		lua_remove(L, -4);
-		lua_remove(L, -4);
-		// Call __next(obj, k)
-		lua_call(L, 2, 2); // returns k, val
-		numElements++;
+		members_.resize(obj.FirstMember);
+		keys_.resize(obj.KeysStart);
 	}
 
-	lua_pop(L, 2);
+	ArrayScope BeginArray(bool indented)
+	{
+		ArrayScope arr{ out_.size(), 0 };
+		if (!indented) WriteIndent();
+		out_ += '[';
+		if (ctx_.Beautify) indent_ += '\t';
+		return arr;
+	}
 
-	// Pop __next, obj, nil
-	lua_pop(L, 3);
-	return arr;
-}
+	void BeginElement(ArrayScope& arr)
+	{
+		if (arr.Size++ > 0) {
+			out_ += ',';
+		}
 
-Json::Value StringifyTableAsObject(lua_State * L, int index, unsigned depth, StringifyContext& ctx)
-{
-	Json::Value arr(Json::objectValue);
-	lua_pushnil(L);
+		WriteIndent();
+	}
 
-	if (index < 0) index--;
+	void EndArray(ArrayScope& arr)
+	{
+		if (ctx_.Beautify) indent_.pop_back();
 
-	while (lua_next(L, index) != 0) {
-		Json::Value val(Stringify(L, -1, depth + 1, ctx));
-
-		if (lua_type(L, -2) == LUA_TSTRING) {
-			auto key = lua_tostring(L, -2);
-			arr[key] = val;
-		} else if (lua_type(L, -2) == LUA_TNUMBER) {
-			lua_pushvalue(L, -2);
-			auto key = lua_tostring(L, -1);
-			arr[key] = val;
-			lua_pop(L, 1);
+		if (arr.Size == 0) {
+			out_.resize(arr.Start);
+			out_ += "[]";
 		} else {
-			throw std::runtime_error("Can only stringify string or number table keys");
+			WriteIndent();
+			out_ += ']';
 		}
+	}
 
-		lua_pop(L, 1);
+	template <class T>
+	void WriteInteger(T value)
+	{
+		char buf[32];
+		auto result = std::to_chars(buf, buf + std::size(buf), value);
+		out_.append(buf, result.ptr);
 	}
 
-	return arr;
-}
+	void WriteDouble(double value)
+	{
+		if (std::isnan(value)) {
+			out_ += "null";
+		} else if (std::isinf(value)) {
+			out_ += (value < 0) ? "-1e+9999" : "1e+9999";
+		} else {
+			char buf[40];
+			auto len = sprintf_s(buf, "%.17g", value);
+			bool hasFraction = false;
+			for (auto i = 0; i < len; i++) {
+				// Undo locale-specific decimal separators
+				if (buf[i] == ',') buf[i] = '.';
+				if (buf[i] == '.' || buf[i] == 'e') hasFraction = true;
+			}
 
-Json::Value StringifyTableAsArray(lua_State * L, int index, unsigned depth, StringifyContext& ctx)
-{
-	Json::Value arr(Json::arrayValue);
-	lua_pushnil(L);
+			out_.append(buf, len);
+			// Make sure that the value is read back as a double
+			if (!hasFraction) {
+				out_ += ".0";
+			}
+		}
+	}
 
-	if (index < 0) index--;
+	static unsigned DecodeUtf8(char const*& s, char const* end)
+	{
+		constexpr unsigned ReplacementCharacter = 0xFFFD;
+		auto b = (unsigned char const*)s;
+		unsigned first = b[0];
+		if (first < 0x80) return first;
+
+		if (first < 0xE0) {
+			if (end - s < 2) return ReplacementCharacter;
+			unsigned cp = ((first & 0x1F) << 6) | (b[1] & 0x3F);
+			s += 1;
+			return cp < 0x80 ? ReplacementCharacter : cp;
+		}
 
-	while (lua_next(L, index) != 0) {
-		arr.append(Stringify(L, -1, depth + 1, ctx));
-		lua_pop(L, 1);
-	}
+		if (first < 0xF0) {
+			if (end - s < 3) return ReplacementCharacter;
+			unsigned cp = ((first & 0x0F) << 12) | ((b[1] & 0x3F) << 6) | (b[2] & 0x3F);
+			s += 2;
+			if (cp >= 0xD800 && cp <= 0xDFFF) return ReplacementCharacter;
+			return cp < 0x800 ? ReplacementCharacter : cp;
+		}
 
-	return arr;
-}
+		if (first < 0xF8) {
+			if (end - s < 4) return ReplacementCharacter;
+			unsigned cp = ((first & 0x07) << 18) | ((b[1] & 0x3F) << 12) | ((b[2] & 0x3F) << 6) | (b[3] & 0x3F);
+			s += 3;
+			return cp < 0x10000 ? ReplacementCharacter : cp;
+		}
 
-bool JsonCanStringifyAsArray(lua_State * L, int index)
-{
-	Json::Value arr(Json::objectValue);
-	lua_pushnil(L);
+		return ReplacementCharacter;
+	}
 
-	if (index < 0) index--;
+	void WriteEscapedCodepoint(unsigned codepoint)
+	{
+		static constexpr char hex[] = "0123456789abcdef";
+		char buf[6] = { '\\', 'u',
+			hex[(codepoint >> 12) & 0xf], hex[(codepoint >> 8) & 0xf],
+			hex[(codepoint >> 4) & 0xf], hex[codepoint & 0xf] };
+		out_.append(buf, 6);
+	}
 
-	int next = 1;
-	bool isArray = true;
-	while (lua_next(L, index) != 0) {
-#if LUA_VERSION_NUM > 501
-		if (lua_isinteger(L, -2)) {
-			auto key = lua_tointeger(L, -2);
-			if (key != next++) {
-				isArray = false;
+	void WriteString(char const* str)
+	{
+		WriteString(str, strlen(str));
+	}
+
+	void WriteString(char const* str, std::size_t length)
+	{
+		auto end = str + length;
+		out_ += '"';
+
+		auto run = str;
+		for (auto s = str; s < end; ++s) {
+			auto c = (unsigned char)*s;
+			if (c >= 0x20 && c < 0x80 && c != '"' && c != '\\') continue;
+
+			out_.append(run, s);
+			switch (c) {
+			case '"': out_ += "\\\""; break;
+			case '\\': out_ += "\\\\"; break;
+			case '\b': out_ += "\\b"; break;
+			case '\f': out_ += "\\f"; break;
+			case '\n': out_ += "\\n"; break;
+			case '\r': out_ += "\\r"; break;
+			case '\t': out_ += "\\t"; break;
+			default:
+			{
+				auto codepoint = DecodeUtf8(s, end);
+				if (codepoint < 0x10000) {
+					WriteEscapedCodepoint(codepoint);
+				} else {
+					codepoint -= 0x10000;
+					WriteEscapedCodepoint(0xD800 + ((codepoint >> 10) & 0x3FF));
+					WriteEscapedCodepoint(0xDC00 + (codepoint & 0x3FF));
+				}
+				break;
 			}
-		} else {
-			isArray = false;
-		}
-#else
-		if (lua_isnumber(L, -2)) {
-			auto key = lua_tonumber(L, -2);
-			if (abs(key - next++) < 0.0001) {
-				isArray = false;
 			}
-		} else {
-			isArray = false;
+			run = s + 1;
 		}
-#endif
 
-		lua_pop(L, 1);
+		out_.append(run, end);
+		out_ += '"';
 	}
 
-	return isArray;
-}
+	void WriteJsonValue(Json::Value const& value, bool indented)
+	{
+		switch (value.type()) {
+		case Json::nullValue:
+			out_ += "null";
+			break;
 
-Json::Value StringifyTable(lua_State * L, int index, unsigned depth, StringifyContext& ctx)
-{
-	if (CheckForRecursion(L, index, ctx)) {
-		return Json::Value("*RECURSION*");
-	}
+		case Json::intValue:
+			WriteInteger(value.asInt64());
+			break;
 
-	if (JsonCanStringifyAsArray(L, index)) {
-		return StringifyTableAsArray(L, index, depth, ctx);
-	} else {
-		return StringifyTableAsObject(L, index, depth, ctx);
-	}
-}
+		case Json::uintValue:
+			WriteInteger(value.asUInt64());
+			break;
 
+		case Json::realValue:
+			WriteDouble(value.asDouble());
+			break;
 
-Json::Value StringifyInternalType(lua_State * L, int index, StringifyContext& ctx)
-{
-	if (ctx.StringifyInternalTypes) {
-		auto val = Json::Value(luaL_tolstring(L, index, NULL));
-		lua_pop(L, 1);
-		return val;
-	} else {
-		throw std::runtime_error("Attempted to stringify a lightuserdata, userdata, function or thread value");
-	}
-}
+		case Json::stringValue:
+		{
+			char const* begin;
+			char const* end;
+			value.getString(&begin, &end);
+			WriteString(begin, end - begin);
+			break;
+		}
 
-Json::Value TryStringifyUserdata(lua_State * L, int index, unsigned depth, StringifyContext& ctx)
-{
-	CppValueMetadata meta;
-	index = lua_absindex(L, index);
-	if (lua_try_get_cppvalue(L, index, EnumValueMetatable::MetaTag, meta)) {
-		return Json::Value(EnumValueMetatable::GetLabel(meta).GetString());
+		case Json::booleanValue:
+			out_ += value.asBool() ? "true" : "false";
+			break;
+
+		case Json::arrayValue:
+		{
+			auto arr = BeginArray(indented);
+			for (auto const& child : value) {
+				BeginElement(arr);
+				WriteJsonValue(child, true);
+			}
+			EndArray(arr);
+			break;
+		}
+
+		case Json::objectValue:
+		{
+			auto obj = BeginObject(indented);
+			for (auto it = value.begin(), end = value.end(); it != end; ++it) {
+				auto name = it.name();
+				BeginMember(obj, name.data(), name.size());
+				WriteJsonValue(*it, false);
+				EndMember();
+			}
+			EndObject(obj);
+			break;
+		}
+		}
 	}
 
-	if (lua_try_get_cppvalue(L, index, BitfieldValueMetatable::MetaTag, meta)) {
-		return BitfieldValueMetatable::ToJson(meta);
+	void WriteTableAsObject(int index, unsigned depth, bool indented)
+	{
+		auto obj = BeginObject(indented);
+		luaL_checkstack(L_, 4, "JSON stringify stack exhausted");
+		lua_pushnil(L_);
+
+		while (lua_next(L_, index) != 0) {
+			size_t len;
+			if (lua_type(L_, -2) == LUA_TSTRING) {
+				auto key = lua_tolstring(L_, -2, &len);
+				BeginMember(obj, key, len);
+			} else if (lua_type(L_, -2) == LUA_TNUMBER) {
+				lua_pushvalue(L_, -2);
+				auto key = lua_tolstring(L_, -1, &len);
+				BeginMember(obj, key, len);
+				lua_pop(L_, 1);
+			} else {
+				throw std::runtime_error("Can only stringify string or number table keys");
+			}
+
+			Write(-1, depth + 1, false);
+			EndMember();
+			lua_pop(L_, 1);
+		}
+
+		EndObject(obj);
 	}
 
-	if (ctx.IterateUserdata) {
-		if (ctx.LimitDepth != -1 && depth > (uint32_t)ctx.LimitDepth) {
-			return Json::Value("*DEPTH LIMIT EXCEEDED*");
+	void WriteTableAsArray(int index, unsigned depth, bool indented)
+	{
+		auto arr = BeginArray(indented);
+		luaL_checkstack(L_, 3, "JSON stringify stack exhausted");
+		lua_pushnil(L_);
+
+		while (lua_next(L_, index) != 0) {
+			BeginElement(arr);
+			Write(-1, depth + 1, true);
+			lua_pop(L_, 1);
 		}
 
-		auto obj = StringifyUserdata(L, index, depth, ctx);
-		if (!obj.isNull()) {
-			return obj;
+		EndArray(arr);
+	}
+
+	void WriteTable(int index, unsigned depth, bool indented)
+	{
+		if (CheckForRecursion(L_, index, ctx_)) {
+			WriteString("*RECURSION*");
+		} else if (JsonCanStringifyAsArray(L_, index)) {
+			WriteTableAsArray(index, depth, indented);
+		} else {
+			WriteTableAsObject(index, depth, indented);
 		}
 	}
 
-	return StringifyInternalType(L, index, ctx);
-}
+	// Writes the key of the current userdata member (at index -2).
+	// Returns false if the key can't be converted to a string.
+	bool BeginUserdataMember(ObjectScope& obj)
+	{
+		size_t len;
+		auto type = lua_type(L_, -2);
+		if (type == LUA_TSTRING) {
+			auto key = lua_tolstring(L_, -2, &len);
+			BeginMember(obj, key, len);
+		} else if (type == LUA_TNUMBER) {
+			lua_pushvalue(L_, -2);
+			auto key = lua_tolstring(L_, -1, &len);
+			BeginMember(obj, key, len);
+			lua_pop(L_, 1);
+		} else if ((type == LUA_TUSERDATA || type == LUA_TLIGHTCPPOBJECT || type == LUA_TCPPOBJECT) && ctx_.StringifyInternalTypes) {
+			lua_getglobal(L_, "tostring");  /* function to be called */
+			lua_pushvalue(L_, -3);   /* value to print */
+			lua_call(L_, 1, 1);
+			auto key = lua_tolstring(L_, -1, &len);  /* get result */
+			if (key) {
+				BeginMember(obj, key, len);
+			}
+			lua_pop(L_, 1);  /* pop result */
+			return key != nullptr;
+		} else if (type == LUA_TLIGHTUSERDATA && ctx_.StringifyInternalTypes) {
+			auto handle = get<EntityHandle>(L_, -2);
+			char key[100];
+			auto keyLen = sprintf_s(key, "%016llx", handle.Handle);
+			BeginMember(obj, key, keyLen);
+		} else {
+			throw std::runtime_error("Can only stringify string or number table keys");
+		}
 
-Json::Value Stringify(lua_State * L, int index, unsigned depth, StringifyContext& ctx)
-{
-	if (depth > ctx.MaxDepth) {
-		throw std::runtime_error("Recursion depth exceeded while stringifying JSON");
+		return true;
 	}
 
-	switch (lua_type(L, index)) {
-	case LUA_TNIL:
-		return Json::Value(Json::nullValue);
+	bool TryWriteUserdataMembers(int index, unsigned depth, bool indented)
+	{
+		StackCheck _(L_, 0);
 
-	case LUA_TBOOLEAN:
-		return Json::Value(lua_toboolean(L, index) == 1);
+		if (CheckForRecursion(L_, index, ctx_)) {
+			WriteString("*RECURSION*");
+			return true;
+		}
 
-	case LUA_TNUMBER:
-#if LUA_VERSION_NUM > 501
-		if (lua_isinteger(L, index)) {
-			return Json::Value(lua_tointeger(L, index));
+		bool isArray = IsArrayLikeUserdata(L_, index);
+		bool isMap = IsMapLikeUserdata(L_, index);
+
+		luaL_checkstack(L_, 8, "JSON stringify stack exhausted");
+		if (!TryGetUserdataPairs(L_, index)) {
+			return false;
+		}
+
+		// Call __pairs(obj)
+		auto nextIndex = lua_absindex(L_, -1);
+		lua_pushvalue(L_, index);
+		lua_call(L_, 1, 3); // returns __next, obj, nil
+
+		// Push next, obj, k
+		lua_pushvalue(L_, nextIndex);
+		lua_pushvalue(L_, nextIndex + 1);
+		lua_pushvalue(L_, nextIndex + 2);
+		// Call __next(obj, k)
+		lua_call(L_, 2, 2); // returns k, val
+
+		ArrayScope arr{};
+		ObjectScope obj{};
+		if (isArray) {
+			arr = BeginArray(indented);
 		} else {
-			return Json::Value(lua_tonumber(L, index));
+			obj = BeginObject(indented);
 		}
-#else
-		return Json::Value(lua_tonumber(L, index));
-#endif
 
-	case LUA_TSTRING:
-		return Json::Value(lua_tostring(L, index));
+		int numElements{ 0 };
+		while (lua_type(L_, -2) != LUA_TNIL) {
+			if (isMap && ctx_.LimitArrayElements != -1 && numElements > ctx_.LimitArrayElements) {
+				break;
+			}
 
-	case LUA_TTABLE:
-		if (ctx.LimitDepth != -1 && depth > (uint32_t)ctx.LimitDepth) {
-			return Json::Value("*DEPTH LIMIT EXCEEDED*");
+			if (lua_type(L_, -2) == LUA_TNUMBER && ctx_.LimitArrayElements != -1
+				&& lua_tointeger(L_, -2) > ctx_.LimitArrayElements) {
+				break;
+			}
+
+			if (isArray) {
+				if (lua_type(L_, -2) != LUA_TNUMBER) {
+					throw std::runtime_error("Can only stringify number keys for array-like userdata");
+				}
+
+				// Array proxies enumerate in ascending order; missing indices are written as null
+				auto key = lua_tointeger(L_, -2);
+				if (key > (lua_Integer)arr.Size) {
+					while ((lua_Integer)arr.Size < key - 1) {
+						BeginElement(arr);
+						out_ += "null";
+					}
+
+					BeginElement(arr);
+					Write(-1, depth + 1, true);
+				}
+			} else if (BeginUserdataMember(obj)) {
+				Write(-1, depth + 1, false);
+				EndMember();
+			}
+
+			// Push next, obj, k
+			lua_pushvalue(L_, nextIndex);
+			lua_pushvalue(L_, nextIndex + 1);
+			lua_pushvalue(L_, nextIndex + 3);
+			lua_remove(L_, -4);
+			lua_remove(L_, -4);
+			// Call __next(obj, k)
+			lua_call(L_, 2, 2); // returns k, val
+			numElements++;
 		}
 
-		return StringifyTable(L, index, depth, ctx);
+		lua_pop(L_, 2);
 
-	case LUA_TUSERDATA:
-	case LUA_TLIGHTCPPOBJECT:
-	case LUA_TCPPOBJECT:
-		return TryStringifyUserdata(L, index, depth, ctx);
+		// Pop __next, obj, nil
+		lua_pop(L_, 3);
 
-	case LUA_TLIGHTUSERDATA:
-	case LUA_TFUNCTION:
-	case LUA_TTHREAD:
-		return StringifyInternalType(L, index, ctx);
+		if (isArray) {
+			EndArray(arr);
+		} else {
+			EndObject(obj);
+		}
 
-	default:
-		throw std::runtime_error("Attempted to stringify an unknown type");
+		return true;
 	}
-}
 
+	void WriteInternalType(int index)
+	{
+		if (ctx_.StringifyInternalTypes) {
+			size_t len;
+			auto str = luaL_tolstring(L_, index, &len);
+			WriteString(str, len);
+			lua_pop(L_, 1);
+		} else {
+			throw std::runtime_error("Attempted to stringify a lightuserdata, userdata, function or thread value");
+		}
+	}
 
-std::string Stringify(lua_State * L, StringifyContext& ctx, int index)
-{
-	StackCheck _(L);
+	void WriteUserdata(int index, unsigned depth, bool indented)
+	{
+		CppValueMetadata meta;
+		if (lua_try_get_cppvalue(L_, index, EnumValueMetatable::MetaTag, meta)) {
+			auto label = EnumValueMetatable::GetLabel(meta);
+			WriteString(label.GetString(), label.GetLength());
+			return;
+		}
+
+		if (lua_try_get_cppvalue(L_, index, BitfieldValueMetatable::MetaTag, meta)) {
+			WriteJsonValue(BitfieldValueMetatable::ToJson(meta), indented);
+			return;
+		}
 
-	Json::Value root;
-	root = Stringify(L, index, 0, ctx);
+		if (ctx_.IterateUserdata) {
+			if (ctx_.LimitDepth != -1 && depth > (uint32_t)ctx_.LimitDepth) {
+				WriteString("*DEPTH LIMIT EXCEEDED*");
+				return;
+			}
 
-	Json::StreamWriterBuilder builder;
-	if (ctx.Beautify) {
-		builder["indentation"] = "\t";
+			if (TryWriteUserdataMembers(index, depth, indented)) {
+				return;
+			}
+		}
+
+		WriteInternalType(index);
 	}
-	std::stringstream ss;
-	std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
-	writer->write(root, &ss);
+};
+
+std::string Stringify(lua_State * L, StringifyContext& ctx, int index)
+{
+	StackCheck _(L);
 
-	return ss.str();
+	JsonWriter writer(L, ctx);
+	writer.Write(index, 0, true);
+	return writer.Release();
 }
 
 UserReturn LuaStringify(lua_State * L)
@@ -9,29 +9,25 @@ void BroadcastMessage(lua_State* L, char const* channel, char const* payload, st
 	}
 
 	auto & networkMgr = gExtender->GetServer().GetNetworkManager();
-	auto msg = networkMgr.GetFreeMessage(ReservedUserId);
-	if (msg != nullptr) {
-		auto postMsg = msg->GetMessage().mutable_post_lua();
-		postMsg->set_channel_name(channel);
-		postMsg->set_payload(payload);
-		if (excludeCharacter != nullptr) {
-			networkMgr.Broadcast(msg, excludeCharacter->UserID);
-		} else {
-			networkMgr.Broadcast(msg, ReservedUserId);
-		}
+	bg3se::net::MessageWrapper msg;
+	auto postMsg = msg.mutable_post_lua();
+	postMsg->set_channel_name(channel);
+	postMsg->set_payload(payload);
+	if (excludeCharacter != nullptr) {
+		networkMgr.Broadcast(msg, excludeCharacter->UserID);
+	} else {
+		networkMgr.Broadcast(msg, ReservedUserId);
 	}
 }
 
 void PostMessageToUserInternal(UserId userId, char const* channel, char const* payload)
 {
 	auto& networkMgr = gExtender->GetServer().GetNetworkManager();
-	auto msg = networkMgr.GetFreeMessage(userId);
-	if (msg != nullptr) {
-		auto postMsg = msg->GetMessage().mutable_post_lua();
-		postMsg->set_channel_name(channel);
-		postMsg->set_payload(payload);
-		networkMgr.Send(msg, userId);
-	}
+	bg3se::net::MessageWrapper msg;
+	auto postMsg = msg.mutable_post_lua();
+	postMsg->set_channel_name(channel);
+	postMsg->set_payload(payload);
+	networkMgr.Send(msg, userId);
 }
 
 void PostMessageToClient(lua_State* L, Guid characterGuid, char const* channel, char const* payload)
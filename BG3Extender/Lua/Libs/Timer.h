@@ -1,23 +1,78 @@
 #pragma once
 
-#include <queue>
-
 /// <lua_module>Timer</lua_module>
 BEGIN_NS(lua::timer)
 
 using TimerHandle = uint64_t;
 
+// Hierarchical timing wheel with millisecond resolution.
+// Each level has 256 slots, each slot covering 256x the range of a slot on the previous level;
+// timers further away than 2^32 ms are kept in an overflow list.
+// Insertion and removal are O(1); Advance() skips empty ranges using per-level occupancy bitmaps.
+class TimerWheel
+{
+public:
+	using NodeIndex = uint32_t;
+	static constexpr NodeIndex NullNode = 0xffffffffu;
+
+	struct ExpiredTimer
+	{
+		double Time;
+		TimerHandle Handle;
+	};
+
+	TimerWheel();
+	NodeIndex Insert(double time, TimerHandle handle);
+	void Remove(NodeIndex node);
+	// Removes all timers expiring at or before the specified time and appends them to the expired list
+	void Advance(double time, Vector<ExpiredTimer>& expired);
+
+private:
+	static constexpr unsigned SlotBits = 8;
+	static constexpr unsigned SlotsPerLevel = 1 << SlotBits;
+	static constexpr unsigned NumLevels = 4;
+	static constexpr unsigned OverflowSlot = NumLevels * SlotsPerLevel;
+
+	struct Node
+	{
+		double Time;
+		TimerHandle Handle;
+		uint64_t Tick;
+		NodeIndex Prev;
+		NodeIndex Next;
+		uint32_t Slot;
+	};
+
+	Array<Node> nodes_;
+	Array<NodeIndex> freeNodes_;
+	std::array<NodeIndex, OverflowSlot + 1> slots_;
+	std::array<uint64_t, OverflowSlot / 64> occupied_;
+	uint64_t currentTick_{ 0 };
+	uint32_t size_{ 0 };
+
+	static uint64_t ToTick(double time);
+	void Link(NodeIndex node);
+	void Unlink(NodeIndex node);
+	void Cascade(uint32_t slot);
+	void Expire(uint32_t slot, double time, Vector<ExpiredTimer>& expired);
+	bool FindOccupiedSlot(unsigned level, unsigned after, unsigned& slot) const;
+	uint64_t NextEventTick() const;
+};
+
 class TimerManager
 {
 public:
 	static constexpr uint64_t PersistentFlag = 0x100000000ull;
 	static constexpr uint64_t RealtimeFlag = 0x200000000ull;
 
+	// For paused timers Time is the remaining delay instead of the expiration time
 	struct EphemeralTimer 
 	{
 		double Time;
 		LuaDelegate<void(TimerHandle)> Callback;
 		float Repeat;
+		TimerWheel::NodeIndex Node;
+		bool Paused;
 	};
 	
 	struct PersistentTimer
@@ -25,17 +80,8 @@ public:
 		double Time;
 		FixedString Callback;
 		STDString ArgsJson;
-	};
-	
-	struct TimerQueueEntry
-	{
-		double Time;
-		TimerHandle Handle;
-
-		inline bool operator > (TimerQueueEntry const& o) const
-		{
-			return Time > o.Time;
-		}
+		TimerWheel::NodeIndex Node;
+		bool Paused;
 	};
 
 	TimerManager(State& state, DeferredLuaDelegateQueue& queue);
@@ -43,6 +89,9 @@ public:
 	TimerHandle AddPersistent(double time, FixedString const& callback, StringView argsJson);
 	void RegisterPersistentCallback(FixedString const& name, Ref callback);
 	bool Cancel(TimerHandle handle);
+	bool Pause(TimerHandle handle, double time);
+	bool Resume(TimerHandle handle, double time);
+	bool IsPaused(TimerHandle handle);
 	void Update(double time);
 	void SavegameVisit(ObjectVisitor* visitor);
 
@@ -50,12 +99,20 @@ private:
 	SaltedPool<EphemeralTimer> ephemeralTimers_;
 	SaltedPool<PersistentTimer> persistentTimers_;
 	MultiHashMap<FixedString, LuaDelegate<void(RegistryEntry, TimerHandle)>> persistentCallbacks_;
-	std::priority_queue<TimerQueueEntry, Vector<TimerQueueEntry>, std::greater<TimerQueueEntry>> queue_;
+	TimerWheel wheel_;
+	Vector<TimerWheel::ExpiredTimer> expired_;
 
 	State& state_;
 	DeferredLuaDelegateQueue& eventQueue_;
 
 	void FireTimer(TimerHandle handle, double time);
+
+	template <class T>
+	bool CancelTimer(SaltedPool<T>& pool, TimerHandle handle);
+	template <class T>
+	bool PauseTimer(T* timer, double time);
+	template <class T>
+	bool ResumeTimer(T* timer, TimerHandle handle, double time);
 };
 
 class TimerSystem
@@ -80,9 +137,14 @@ public:
 
 	void Update(double time);
 	bool Cancel(TimerHandle handle);
+	bool Pause(TimerHandle handle, double time);
+	bool Resume(TimerHandle handle, double time);
+	bool IsPaused(TimerHandle handle);
 	void SavegameVisit(ObjectVisitor* visitor);
 
 private:
+	TimerManager& GetManager(TimerHandle handle);
+
 	TimerManager realtime_;
 	TimerManager game_;
 	DeferredLuaDelegateQueue eventQueue_;
@@ -3,6 +3,187 @@
 /// <lua_module>Timer</lua_module>
 BEGIN_NS(lua::timer)
 
+TimerWheel::TimerWheel()
+{
+	slots_.fill(NullNode);
+	occupied_.fill(0);
+}
+
+uint64_t TimerWheel::ToTick(double time)
+{
+	return (time > 0.0) ? (uint64_t)(time * 1000.0) : 0;
+}
+
+TimerWheel::NodeIndex TimerWheel::Insert(double time, TimerHandle handle)
+{
+	NodeIndex index;
+	if (freeNodes_.empty()) {
+		index = nodes_.size();
+		nodes_.push_back(Node{});
+	} else {
+		index = freeNodes_.pop_last();
+	}
+
+	auto& node = nodes_[index];
+	node.Time = time;
+	node.Handle = handle;
+	// Timers scheduled in the past are fired on the next update
+	node.Tick = std::max(ToTick(time), currentTick_);
+	Link(index);
+	size_++;
+	return index;
+}
+
+void TimerWheel::Remove(NodeIndex index)
+{
+	Unlink(index);
+	freeNodes_.push_back(index);
+	size_--;
+}
+
+void TimerWheel::Link(NodeIndex index)
+{
+	auto& node = nodes_[index];
+
+	// Place the timer on the lowest level where it shares the same parent slot with the current tick
+	auto diff = node.Tick ^ currentTick_;
+	uint32_t slot = OverflowSlot;
+	for (unsigned level = 0; level < NumLevels; level++) {
+		if ((diff >> ((level + 1) * SlotBits)) == 0) {
+			slot = level * SlotsPerLevel + (uint32_t)((node.Tick >> (level * SlotBits)) & (SlotsPerLevel - 1));
+			break;
+		}
+	}
+
+	node.Slot = slot;
+	node.Prev = NullNode;
+	node.Next = slots_[slot];
+	if (node.Next != NullNode) {
+		nodes_[node.Next].Prev = index;
+	}
+
+	slots_[slot] = index;
+	if (slot != OverflowSlot) {
+		occupied_[slot / 64] |= (1ull << (slot % 64));
+	}
+}
+
+void TimerWheel::Unlink(NodeIndex index)
+{
+	auto& node = nodes_[index];
+	if (node.Prev != NullNode) {
+		nodes_[node.Prev].Next = node.Next;
+	} else {
+		slots_[node.Slot] = node.Next;
+	}
+
+	if (node.Next != NullNode) {
+		nodes_[node.Next].Prev = node.Prev;
+	}
+
+	if (slots_[node.Slot] == NullNode && node.Slot != OverflowSlot) {
+		occupied_[node.Slot / 64] &= ~(1ull << (node.Slot % 64));
+	}
+}
+
+void TimerWheel::Cascade(uint32_t slot)
+{
+	auto index = slots_[slot];
+	slots_[slot] = NullNode;
+	if (slot != OverflowSlot) {
+		occupied_[slot / 64] &= ~(1ull << (slot % 64));
+	}
+
+	while (index != NullNode) {
+		auto next = nodes_[index].Next;
+		Link(index);
+		index = next;
+	}
+}
+
+void TimerWheel::Expire(uint32_t slot, double time, Vector<ExpiredTimer>& expired)
+{
+	auto index = slots_[slot];
+	while (index != NullNode) {
+		auto& node = nodes_[index];
+		auto next = node.Next;
+		// Only timers in the slot of the last tick may not be due yet
+		if (node.Time <= time) {
+			expired.push_back(ExpiredTimer{ node.Time, node.Handle });
+			Remove(index);
+		}
+		index = next;
+	}
+}
+
+bool TimerWheel::FindOccupiedSlot(unsigned level, unsigned after, unsigned& slot) const
+{
+	for (auto i = after + 1; i < SlotsPerLevel; i = (i | 63) + 1) {
+		auto word = occupied_[(level * SlotsPerLevel + i) / 64] >> (i % 64);
+		unsigned long bit;
+		if (_BitScanForward64(&bit, word)) {
+			slot = i + bit;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+uint64_t TimerWheel::NextEventTick() const
+{
+	for (unsigned level = 0; level < NumLevels; level++) {
+		auto shift = level * SlotBits;
+		unsigned slot;
+		if (FindOccupiedSlot(level, (unsigned)(currentTick_ >> shift) & (SlotsPerLevel - 1), slot)) {
+			auto parentMask = ~((1ull << (shift + SlotBits)) - 1);
+			return (currentTick_ & parentMask) | ((uint64_t)slot << shift);
+		}
+	}
+
+	if (slots_[OverflowSlot] != NullNode) {
+		auto shift = NumLevels * SlotBits;
+		return ((currentTick_ >> shift) + 1) << shift;
+	}
+
+	return std::numeric_limits<uint64_t>::max();
+}
+
+void TimerWheel::Advance(double time, Vector<ExpiredTimer>& expired)
+{
+	auto target = ToTick(time);
+	for (;;) {
+		Expire((uint32_t)(currentTick_ & (SlotsPerLevel - 1)), time, expired);
+
+		if (size_ == 0) {
+			currentTick_ = std::max(currentTick_, target);
+			break;
+		}
+
+		if (currentTick_ >= target) break;
+
+		// Skip directly to the next tick that has timers to expire or to cascade
+		auto next = NextEventTick();
+		if (next > target) {
+			currentTick_ = target;
+			continue;
+		}
+
+		currentTick_ = next;
+		for (unsigned level = NumLevels; level > 0; level--) {
+			auto shift = level * SlotBits;
+			if ((currentTick_ & ((1ull << shift) - 1)) == 0) {
+				if (level == NumLevels) {
+					Cascade(OverflowSlot);
+				} else {
+					Cascade(level * SlotsPerLevel + (uint32_t)((currentTick_ >> shift) & (SlotsPerLevel - 1)));
+				}
+			}
+		}
+	}
+}
+
+
 TimerManager::TimerManager(State& state, lua::DeferredLuaDelegateQueue& queue)
 	: state_(state), eventQueue_(queue)
 {}
@@ -14,14 +195,10 @@ TimerHandle TimerManager::Add(double time, Ref callback, float repeat)
 	timer->Time = time;
 	timer->Callback = LuaDelegate<void(TimerHandle)>(state_.GetState(), callback);
 	timer->Repeat = repeat;
+	timer->Paused = false;
 
 	TimerHandle handle{ id };
-
-	queue_.push(TimerQueueEntry{
-		.Time = time,
-		.Handle = handle
-	});
-
+	timer->Node = wheel_.Insert(time, handle);
 	return handle;
 }
 
@@ -32,14 +209,10 @@ TimerHandle TimerManager::AddPersistent(double time, FixedString const& callback
 	timer->Time = time;
 	timer->Callback = callback;
 	timer->ArgsJson = argsJson;
+	timer->Paused = false;
 
 	TimerHandle handle{ (uint64_t)id | PersistentFlag };
-
-	queue_.push(TimerQueueEntry{
-		.Time = time,
-		.Handle = handle
-	});
-
+	timer->Node = wheel_.Insert(time, handle);
 	return handle;
 }
 
@@ -48,23 +221,102 @@ void TimerManager::RegisterPersistentCallback(FixedString const& name, Ref callb
 	persistentCallbacks_.set(name, LuaDelegate<void(RegistryEntry, TimerHandle)>(state_.GetState(), callback));
 }
 
+template <class T>
+bool TimerManager::CancelTimer(SaltedPool<T>& pool, TimerHandle handle)
+{
+	auto timer = pool.Find((uint32_t)handle);
+	if (timer == nullptr) {
+		return false;
+	}
+
+	if (!timer->Paused) {
+		wheel_.Remove(timer->Node);
+	}
+
+	return pool.Free((uint32_t)handle);
+}
+
+template <class T>
+bool TimerManager::PauseTimer(T* timer, double time)
+{
+	if (timer == nullptr || timer->Paused) {
+		return false;
+	}
+
+	wheel_.Remove(timer->Node);
+	timer->Node = TimerWheel::NullNode;
+	timer->Time = std::max(timer->Time - time, 0.0);
+	timer->Paused = true;
+	return true;
+}
+
+template <class T>
+bool TimerManager::ResumeTimer(T* timer, TimerHandle handle, double time)
+{
+	if (timer == nullptr || !timer->Paused) {
+		return false;
+	}
+
+	timer->Time += time;
+	timer->Node = wheel_.Insert(timer->Time, handle);
+	timer->Paused = false;
+	return true;
+}
+
 bool TimerManager::Cancel(TimerHandle handle)
 {
 	if (handle & PersistentFlag) {
-		return persistentTimers_.Free((uint32_t)handle);
+		return CancelTimer(persistentTimers_, handle);
+	} else {
+		return CancelTimer(ephemeralTimers_, handle);
+	}
+}
+
+bool TimerManager::Pause(TimerHandle handle, double time)
+{
+	if (handle & PersistentFlag) {
+		return PauseTimer(persistentTimers_.Find((uint32_t)handle), time);
+	} else {
+		return PauseTimer(ephemeralTimers_.Find((uint32_t)handle), time);
+	}
+}
+
+bool TimerManager::Resume(TimerHandle handle, double time)
+{
+	auto timerHandle = handle & (PersistentFlag | 0xffffffffull);
+	if (handle & PersistentFlag) {
+		return ResumeTimer(persistentTimers_.Find((uint32_t)handle), timerHandle, time);
 	} else {
-		return ephemeralTimers_.Free((uint32_t)handle);
+		return ResumeTimer(ephemeralTimers_.Find((uint32_t)handle), timerHandle, time);
+	}
+}
+
+bool TimerManager::IsPaused(TimerHandle handle)
+{
+	if (handle & PersistentFlag) {
+		auto timer = persistentTimers_.Find((uint32_t)handle);
+		return timer != nullptr && timer->Paused;
+	} else {
+		auto timer = ephemeralTimers_.Find((uint32_t)handle);
+		return timer != nullptr && timer->Paused;
 	}
 }
 
 void TimerManager::Update(double time)
 {
-	while (!queue_.empty() && queue_.top().Time <= time) {
-		auto handle = queue_.top().Handle;
-		queue_.pop();
+	wheel_.Advance(time, expired_);
+	if (expired_.empty()) return;
+
+	// Callbacks are deferred until all managers were updated, so the whole batch can be fired in deadline order
+	std::stable_sort(expired_.begin(), expired_.end(), [](TimerWheel::ExpiredTimer const& a, TimerWheel::ExpiredTimer const& b) {
+		return a.Time < b.Time;
+	});
 
-		FireTimer(handle, time);
+	for (auto const& timer : expired_) {
+		FireTimer(timer.Handle, time);
 	}
+
+	expired_.clear();
 }
 
 void TimerManager::FireTimer(TimerHandle handle, double time)
@@ -72,6 +324,7 @@ void TimerManager::FireTimer(TimerHandle handle, double time)
 	if (handle & PersistentFlag) {
 		auto timer = persistentTimers_.Find((uint32_t)handle);
 		if (timer != nullptr) {
+			timer->Node = TimerWheel::NullNode;
 			auto callback = persistentCallbacks_.try_get(timer->Callback);
 			if (callback) {
 				auto L = state_.GetState();
@@ -91,14 +344,12 @@ void TimerManager::FireTimer(TimerHandle handle, double time)
 	} else {
 		auto timer = ephemeralTimers_.Find((uint32_t)handle);
 		if (timer != nullptr) {
+			timer->Node = TimerWheel::NullNode;
 			eventQueue_.Call(timer->Callback, handle);
 
 			if (timer->Repeat > 0.0f) {
 				timer->Time = time + timer->Repeat;
-				queue_.push(TimerQueueEntry{
-					.Time = timer->Time,
-					.Handle = handle
-				});
+				timer->Node = wheel_.Insert(timer->Time, handle);
 			} else {
 				ephemeralTimers_.Free((uint32_t)handle);
 			}
@@ -119,7 +370,12 @@ void TimerManager::SavegameVisit(ObjectVisitor* visitor)
 				visitor->VisitDouble(GFS.strTime, timer.Time, 0.0);
 				visitor->VisitFixedString(GFS.strHandler, timer.Callback, GFS.strEmpty);
 				visitor->VisitSTDString(GFS.strArgs, timer.ArgsJson, STDString{});
-				AddPersistent(timer.Time, timer.Callback, timer.ArgsJson);
+				visitor->VisitBool(GFS.strPaused, timer.Paused, false);
+				auto handle = AddPersistent(timer.Time, timer.Callback, timer.ArgsJson);
+				if (timer.Paused) {
+					// Time already contains the remaining delay
+					PauseTimer(persistentTimers_.Find((uint32_t)handle), 0.0);
+				}
 			}
 		}
 	} else {
@@ -132,6 +388,7 @@ void TimerManager::SavegameVisit(ObjectVisitor* visitor)
 				visitor->VisitDouble(GFS.strTime, timer->Time, 0.0);
 				visitor->VisitFixedString(GFS.strHandler, timer->Callback, GFS.strEmpty);
 				visitor->VisitSTDString(GFS.strArgs, timer->ArgsJson, STDString{});
+				visitor->VisitBool(GFS.strPaused, timer->Paused, false);
 				visitor->ExitNode(GFS.strTimer);
 			}
 		}
@@ -152,15 +409,35 @@ void TimerSystem::Update(double time)
 	eventQueue_.Flush();
 }
 
-bool TimerSystem::Cancel(TimerHandle handle)
+TimerManager& TimerSystem::GetManager(TimerHandle handle)
 {
 	if (handle & TimerManager::RealtimeFlag) {
-		return realtime_.Cancel(handle);
+		return realtime_;
 	} else {
-		return game_.Cancel(handle);
+		return game_;
 	}
 }
 
+bool TimerSystem::Cancel(TimerHandle handle)
+{
+	return GetManager(handle).Cancel(handle);
+}
+
+bool TimerSystem::Pause(TimerHandle handle, double time)
+{
+	return GetManager(handle).Pause(handle, time);
+}
+
+bool TimerSystem::Resume(TimerHandle handle, double time)
+{
+	return GetManager(handle).Resume(handle, time);
+}
+
+bool TimerSystem::IsPaused(TimerHandle handle)
+{
+	return GetManager(handle).IsPaused(handle);
+}
+
 void TimerSystem::SavegameVisit(ObjectVisitor* visitor)
 {
 	if (visitor->EnterNode(GFS.strPersistentTimers, GFS.strEmpty)) {
@@ -221,6 +498,23 @@ bool Cancel(lua_State* L, TimerHandle handle)
 	return State::FromLua(L)->GetTimers().Cancel(handle);
 }
 
+bool Pause(lua_State* L, TimerHandle handle)
+{
+	double time = GetCurrentExtensionState()->Time().Time;
+	return State::FromLua(L)->GetTimers().Pause(handle, time);
+}
+
+bool Resume(lua_State* L, TimerHandle handle)
+{
+	double time = GetCurrentExtensionState()->Time().Time;
+	return State::FromLua(L)->GetTimers().Resume(handle, time);
+}
+
+bool IsPaused(lua_State* L, TimerHandle handle)
+{
+	return State::FromLua(L)->GetTimers().IsPaused(handle);
+}
+
 void RegisterTimerLib()
 {
 	DECLARE_MODULE(Timer, Both)
@@ -230,6 +524,9 @@ void RegisterTimerLib()
 	MODULE_FUNCTION(WaitForRealtime)
 	MODULE_FUNCTION(RegisterPersistentHandler)
 	MODULE_FUNCTION(Cancel)
+	MODULE_FUNCTION(Pause)
+	MODULE_FUNCTION(Resume)
+	MODULE_FUNCTION(IsPaused)
 	END_MODULE()
 }
 
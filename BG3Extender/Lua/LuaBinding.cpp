@@ -6,6 +6,11 @@
 #include <fstream>
 #include <lstate.h>
 #include <Lua/Shared/EntityComponentEvents.inl>
+#include <Lua/Shared/LuaEventBus.inl>
+#include <Lua/Shared/EntitySpatialIndex.inl>
+#include <Lua/Shared/LuaSamplingProfiler.inl>
+#include <Lua/Shared/LuaGCScheduler.inl>
+#include <Lua/Shared/LuaBinaryEncoding.inl>
 
 // Callback from the Lua runtime when a handled (i.e. pcall/xpcall'd) error was thrown.
 // This is needed to capture errors for the Lua debugger, as there is no
@@ -244,19 +249,7 @@ namespace bg3se::lua
 
 	void* LuaAlloc(void* ud, void* ptr, size_t osize, size_t nsize)
 	{
-		(void)ud; (void)osize;  /* not used */
-		if (nsize == 0) {
-			GameFree(ptr);
-			return NULL;
-		} else {
-			auto newBuf = GameAllocRaw(nsize);
-			if (ptr != nullptr) {
-				memcpy(newBuf, ptr, std::min(nsize, osize));
-				GameFree(ptr);
-			}
-
-			return newBuf;
-		}
+		return reinterpret_cast<LuaAllocator*>(ud)->Realloc(ptr, osize, nsize);
 	}
 
 	LifetimeHandle GetCurrentLifetime(lua_State* L)
@@ -266,7 +259,7 @@ namespace bg3se::lua
 
 	LuaStateWrapper::LuaStateWrapper()
 	{
-		L = lua_newstate(LuaAlloc, nullptr);
+		L = lua_newstate(LuaAlloc, &Allocator);
 		Internal = lua_new_internal_state();
 		lua_setup_cppobjects(L, &LuaCppAlloc, &LuaCppFree, &LuaCppGetLightMetatable, &LuaCppGetMetatable, &LuaCppCanonicalize);
 		lua_setup_strcache(L, &LuaCacheString, &LuaReleaseString);
@@ -279,6 +272,8 @@ namespace bg3se::lua
 	LuaStateWrapper::~LuaStateWrapper()
 	{
 		lua_close(L);
+		// Released after the state is closed, as freeing strings updates the FixedString push cache
+		lua_release_internal_state(Internal);
 	}
 
 	State::State(uint32_t generationId, bool isServer)
@@ -288,10 +283,15 @@ namespace bg3se::lua
 		variableManager_(isServer ? gExtender->GetServer().GetExtensionState().GetUserVariables() : gExtender->GetClient().GetExtensionState().GetUserVariables(), isServer),
 		modVariableManager_(isServer ? gExtender->GetServer().GetExtensionState().GetModVariables() : gExtender->GetClient().GetExtensionState().GetModVariables(), isServer),
 		entityHooks_(*this),
-		timers_(*this, isServer)
+		timers_(*this, isServer),
+		eventBus_(*this),
+		spatialIndex_(*this)
 	{
 		*reinterpret_cast<State**>(lua_getextraspace(L.L)) = this;
 		OpenLibs();
+
+		auto const& config = gExtender->GetConfig();
+		gcScheduler_.Configure(L, config.LuaGCBudget, config.LuaGCPause, config.LuaGCStepMul);
 	}
 
 	State::~State()
@@ -374,7 +374,12 @@ namespace bg3se::lua
 		int top = lua_gettop(L);
 
 		/* Load the file containing the script we are going to run */
-		int status = luaL_loadbufferx(L, script.c_str(), script.size(), name.c_str(), "text");
+		int status;
+		if (gExtender->GetConfig().EnableLuaChunkCache) {
+			status = gExtender->GetLuaChunkCache().Load(L, script, name);
+		} else {
+			status = luaL_loadbufferx(L, script.c_str(), script.size(), name.c_str(), "text");
+		}
 		if (status != LUA_OK) {
 			LuaError("Failed to parse script: " << lua_tostring(L, -1));
 			lua_pop(L, 1);  /* pop error message from the stack */
@@ -445,11 +450,12 @@ namespace bg3se::lua
 	void State::OnUpdate(GameTime const& time)
 	{
 		timers_.Update(time.Time);
+		spatialIndex_.Invalidate();
 
 		TickEvent params{ .Time = time };
 		ThrowEvent("Tick", params, false, 0);
 
-		lua_gc(L, LUA_GCSTEP, 10);
+		gcScheduler_.Update(L, L.Allocator);
 		variableManager_.Flush();
 		modVariableManager_.Flush();
 	}
@@ -479,18 +485,17 @@ namespace bg3se::lua
 		}
 	}
 
-	EventResult State::DispatchEvent(EventBase& evt, char const* eventName, bool canPreventAction, uint32_t restrictions)
+	EventResult State::DispatchEvent(EventBase& evt, EventBus::Event& event, bool canPreventAction, uint32_t restrictions)
 	{
-		auto stackSize = lua_gettop(L) - 2;
+		auto stackSize = lua_gettop(L) - 1;
 
 		try {
 			Restriction restriction(*this, restrictions);
-			evt.Name = FixedString(eventName);
+			evt.Name = event.Name;
 			evt.CanPreventAction = canPreventAction;
 
-			if (!CheckedCall(L, 1, "_ThrowEvent")) {
-				return EventResult::Failed;
-			}
+			eventBus_.Throw(event, -1, &evt);
+			lua_pop(L, 1);
 
 			if (evt.ActionPrevented) {
 				return EventResult::ActionPrevented;
@@ -498,13 +503,17 @@ namespace bg3se::lua
 				return EventResult::Successful;
 			}
 		} catch (Exception&) {
+			// Stack: event object, (error message)
 			auto stackRemaining = lua_gettop(L) - stackSize;
-			if (stackRemaining > 0) {
-				LuaError("Failed to dispatch event '" << eventName << "': " << lua_tostring(L, -1));
-				lua_pop(L, stackRemaining);
+			if (stackRemaining > 1 && lua_type(L, -1) == LUA_TSTRING) {
+				LuaError("Failed to dispatch event '" << event.Name.GetString() << "': " << lua_tostring(L, -1));
 			}
 			else {
-				LuaError("Internal error while dispatching event '" << eventName << "'");
+				LuaError("Internal error while dispatching event '" << event.Name.GetString() << "'");
+			}
+
+			if (stackRemaining > 0) {
+				lua_pop(L, stackRemaining);
 			}
 
 			return EventResult::Failed;
@@ -2,6 +2,7 @@
 
 #include <Lua/LuaHelpers.h>
 #include <Lua/Shared/LuaLifetime.h>
+#include <Lua/Shared/LuaAllocator.h>
 #include <Lua/Shared/Proxies/LuaObjectProxy.h>
 #include <Lua/Shared/Proxies/LuaEvent.h>
 #include <Lua/Shared/Proxies/LuaEntityProxy.h>
@@ -16,6 +17,10 @@
 #include <Lua/Shared/Proxies/LuaImguiProxy.h>
 #endif
 #include <Lua/Shared/EntityComponentEvents.h>
+#include <Lua/Shared/LuaEventBus.h>
+#include <Lua/Shared/EntitySpatialIndex.h>
+#include <Lua/Shared/LuaSamplingProfiler.h>
+#include <Lua/Shared/LuaGCScheduler.h>
 #include <Extender/Shared/UserVariables.h>
 #include <Lua/Libs/Timer.h>
 
@@ -56,6 +61,7 @@ namespace bg3se::lua
 			return L;
 		}
 
+		LuaAllocator Allocator;
 		lua_State* L;
 		LuaInternalState* Internal;
 	};
@@ -112,6 +118,11 @@ namespace bg3se::lua
 			return L.Internal;
 		}
 
+		inline LuaAllocator& GetAllocator()
+		{
+			return L.Allocator;
+		}
+
 		inline LifetimeStack & GetStack()
 		{
 			return lifetimeStack_;
@@ -167,6 +178,26 @@ namespace bg3se::lua
 			return entityHooks_;
 		}
 
+		inline EventBus& GetEventBus()
+		{
+			return eventBus_;
+		}
+
+		inline EntitySpatialIndex& GetSpatialIndex()
+		{
+			return spatialIndex_;
+		}
+
+		inline LuaSamplingProfiler& GetSamplingProfiler()
+		{
+			return samplingProfiler_;
+		}
+
+		inline LuaGCScheduler& GetGCScheduler()
+		{
+			return gcScheduler_;
+		}
+
 		void FinishStartup();
 		void LoadBootstrap(STDString const& path, STDString const& modTable);
 		virtual void OnGameSessionLoading();
@@ -208,11 +239,15 @@ namespace bg3se::lua
 		EventResult ThrowEvent(char const* eventName, TEvent& evt, bool canPreventAction = false, uint32_t restrictions = 0)
 		{
 			static_assert(std::is_base_of_v<EventBase, TEvent>, "Event object must be a descendant of EventBase");
+			auto& event = eventBus_.GetEvent(eventName);
+			if (!event.HasSubscribers()) {
+				return EventResult::Successful;
+			}
+
 			StackCheck _(L, 0);
 			LifetimeStackPin _p(GetStack());
-			PushInternalFunction(L, "_ThrowEvent");
 			MakeObjectRef(L, &evt);
-			return DispatchEvent(evt, eventName, canPreventAction, restrictions);
+			return DispatchEvent(evt, event, canPreventAction, restrictions);
 		}
 
 		std::optional<int> LoadScript(STDString const & script, STDString const & name = "", int globalsIdx = 0);
@@ -236,9 +271,13 @@ namespace bg3se::lua
 		CachedModVariableManager modVariableManager_;
 		EntityComponentEventHooks entityHooks_;
 		timer::TimerSystem timers_;
+		EventBus eventBus_;
+		EntitySpatialIndex spatialIndex_;
+		LuaSamplingProfiler samplingProfiler_;
+		LuaGCScheduler gcScheduler_;
 
 		void OpenLibs();
-		EventResult DispatchEvent(EventBase& evt, char const* eventName, bool canPreventAction, uint32_t restrictions);
+		EventResult DispatchEvent(EventBase& evt, EventBus::Event& event, bool canPreventAction, uint32_t restrictions);
 	};
 
 	class Restriction
@@ -338,7 +338,7 @@ namespace bg3se::esv::lua
 
 		case FunctionType::Event:
 		case FunctionType::Proc:
-			OsiInsert(L, false);
+			OsiInsert(L, 2, false);
 			return 0;
 
 		case FunctionType::Database:
@@ -349,7 +349,7 @@ namespace bg3se::esv::lua
 			auto node = function_->Node.Get();
 			if (node) {
 				if (node->IsDataNode()) {
-					OsiInsert(L, false);
+					OsiInsert(L, 2, false);
 					return 0;
 				} else {
 					return OsiUserQuery(L);
@@ -391,14 +391,28 @@ namespace bg3se::esv::lua
 			return luaL_error(L, "Attempted to read Osiris database in restricted context");
 		}
 
-		auto db = function_->Node.Get()->Database.Get();
-		
-
-		auto head = db->Facts.Head;
-		auto current = head->Next;
+		auto dbRef = function_->Node.Get()->Database;
+		auto db = dbRef.Get();
 
 		lua_newtable(L);
 		auto index = 1;
+
+		auto indexes = state_->Osiris().GetDatabaseIndexes().GetIndexes(dbRef.Id);
+		auto candidates = indexes ? indexes->FindCandidates(L, 2) : nullptr;
+		if (candidates != nullptr) {
+			for (auto fact : *candidates) {
+				if (MatchTuple(L, 2, fact->Item)) {
+					push(L, index++);
+					ConstructTuple(L, fact->Item);
+					lua_rawset(L, -3);
+				}
+			}
+
+			return 1;
+		}
+
+		auto head = db->Facts.Head;
+		auto current = head->Next;
 		while (current != head) {
 			if (MatchTuple(L, 2, current->Item)) {
 				push(L, index++);
@@ -431,10 +445,68 @@ namespace bg3se::esv::lua
 			return luaL_error(L, "Attempted to delete from Osiris database in restricted context");
 		}
 
-		OsiInsert(L, true);
+		if (OsiIndexedDelete(L)) {
+			return 0;
+		}
+
+		OsiInsert(L, 2, true);
 		return 0;
 	}
 
+	bool OsiFunction::OsiIndexedDelete(lua_State * L)
+	{
+		auto numArgs = lua_gettop(L);
+		if ((uint32_t)numArgs - 1 != function_->Signature->Params->Params.Size) {
+			return false;
+		}
+
+		auto hasWildcards = false;
+		for (auto i = 2; i <= numArgs; i++) {
+			if (lua_isnil(L, i)) {
+				hasWildcards = true;
+			}
+		}
+
+		// Fully bound deletes only affect a single fact; let Osiris handle those directly
+		if (!hasWildcards) {
+			return false;
+		}
+
+		auto dbRef = function_->Node.Get()->Database;
+		auto indexes = state_->Osiris().GetDatabaseIndexes().GetIndexes(dbRef.Id);
+		auto candidates = indexes ? indexes->FindCandidates(L, 2) : nullptr;
+		if (candidates == nullptr) {
+			return false;
+		}
+
+		// Copy matching facts before deleting anything, as deletes modify the index
+		lua_newtable(L);
+		auto numMatches = 0;
+		for (auto fact : *candidates) {
+			if (MatchTuple(L, 2, fact->Item)) {
+				push(L, ++numMatches);
+				ConstructTuple(L, fact->Item);
+				lua_rawset(L, -3);
+			}
+		}
+
+		auto matches = lua_gettop(L);
+		luaL_checkstack(L, numArgs + 1, nullptr);
+		for (auto i = 1; i <= numMatches; i++) {
+			lua_rawgeti(L, matches, i);
+			auto tuple = lua_gettop(L);
+			for (auto col = 1; col < numArgs; col++) {
+				lua_rawgeti(L, tuple, col);
+			}
+
+			OsiInsert(L, tuple + 1, true);
+			lua_settop(L, matches);
+		}
+
+		lua_pop(L, 1);
+		return true;
+	}
+
 	int OsiFunction::LuaDeferredNotification(lua_State * L)
 	{
 		if (function_ == nullptr) {
@@ -585,10 +657,10 @@ namespace bg3se::esv::lua
 		OsiError("FIXME: OsiDeferredNotification not implemented yet!");
 	}
 
-	void OsiFunction::OsiInsert(lua_State * L, bool deleteTuple)
+	void OsiFunction::OsiInsert(lua_State * L, int firstIndex, bool deleteTuple)
 	{
 		auto funcArgs = function_->Signature->Params->Params.Size;
-		int numArgs = lua_gettop(L);
+		int numArgs = lua_gettop(L) - firstIndex + 2;
 		if (numArgs - 1 != funcArgs) {
 			luaL_error(L, "Incorrect number of arguments for '%s'; expected %d, got %d",
 				function_->Signature->Name, funcArgs, numArgs - 1);
@@ -609,7 +681,7 @@ namespace bg3se::esv::lua
 		auto prev = args.Head;
 		for (uint32_t i = 0; i < funcArgs; i++) {
 			auto tv = tvs.Args() + i;
-			LuaToOsi(L, i + 2, *tv, (ValueType)argType->Item.Type, deleteTuple);
+			LuaToOsi(L, firstIndex + i, *tv, (ValueType)argType->Item.Type, deleteTuple);
 			auto node = nodes.Args() + i + 1;
 			args.Insert(tv, node, prev);
 			prev = node;
@@ -11,9 +11,13 @@ public:
 	~EntityReplicationEventHooks();
 
 	SubscriptionIndex Subscribe(ecs::ReplicationTypeIndex type, EntityHandle entity, uint64_t flags, RegistryEntry&& hook);
+	// Subscribes to changes that are collected during the tick and delivered in a single call per component type
+	SubscriptionIndex SubscribeBatched(ecs::ReplicationTypeIndex type, EntityHandle entity, uint64_t flags, RegistryEntry&& hook);
 	bool Unsubscribe(SubscriptionIndex index);
 
 	void OnEntityReplication(ecs::EntityWorld& world);
+	// Calls batched subscribers with the changes collected since the last call
+	void FireBatchedEvents();
 
 private:
 	struct ReplicationHook
@@ -23,23 +27,39 @@ private:
 		// Needed for looking up unsubscribe data
 		ecs::ReplicationTypeIndex Type;
 		EntityHandle Entity;
+		bool Batched;
+	};
+
+	// Entities whose replication flags were dirtied since the last batch was delivered
+	struct ChangeBatch
+	{
+		Array<EntityHandle> Entities;
+		Array<uint64_t> Flags;
+		MultiHashMap<EntityHandle, uint32_t> EntityIndices;
 	};
 
 	struct ReplicationHooks
 	{
 		uint64_t InvalidationFlags;
+		uint64_t BatchedInvalidationFlags;
 		Array<SubscriptionIndex> GlobalHooks;
 		MultiHashMap<EntityHandle, Array<SubscriptionIndex>> EntityHooks;
+		ChangeBatch PendingChanges;
 	};
 
 	lua::State& state_;
 	BitSet<> hookedReplicationComponentMask_;
 	Array<ReplicationHooks> hookedReplicationComponents_;
 	SaltedPool<ReplicationHook> subscriptions_;
+	Array<ecs::ReplicationTypeIndex> pendingChangeTypes_;
 
 	void OnEntityReplication(ecs::EntityWorld& world, EntityHandle entity, BitSet<> const& flags, ecs::ReplicationTypeIndex type);
 	void CallHandler(EntityHandle entity, BitSet<> const& flags, ecs::ReplicationTypeIndex type, ReplicationHook const& hook);
+	void AddPendingChange(ReplicationHooks& hooks, ecs::ReplicationTypeIndex type, EntityHandle entity, uint64_t flags);
+	void CallBatchedHandler(Array<EntityHandle> const& entities, Array<uint64_t> const& flags, ecs::ReplicationTypeIndex type, ReplicationHook const& hook);
+	SubscriptionIndex AddSubscription(ecs::ReplicationTypeIndex type, EntityHandle entity, uint64_t flags, RegistryEntry&& hook, bool batched);
 	ReplicationHooks& AddComponentType(ecs::ReplicationTypeIndex type);
+	void RecomputeInvalidationFlags(ecs::ReplicationTypeIndex type);
 };
 
 END_SE()
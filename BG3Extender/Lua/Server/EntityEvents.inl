@@ -22,6 +22,16 @@ EntityReplicationEventHooks::ReplicationHooks& EntityReplicationEventHooks::AddC
 }
 
 EntityReplicationEventHooks::SubscriptionIndex EntityReplicationEventHooks::Subscribe(ecs::ReplicationTypeIndex type, EntityHandle entity, uint64_t flags, RegistryEntry&& hook)
+{
+	return AddSubscription(type, entity, flags, std::move(hook), false);
+}
+
+EntityReplicationEventHooks::SubscriptionIndex EntityReplicationEventHooks::SubscribeBatched(ecs::ReplicationTypeIndex type, EntityHandle entity, uint64_t flags, RegistryEntry&& hook)
+{
+	return AddSubscription(type, entity, flags, std::move(hook), true);
+}
+
+EntityReplicationEventHooks::SubscriptionIndex EntityReplicationEventHooks::AddSubscription(ecs::ReplicationTypeIndex type, EntityHandle entity, uint64_t flags, RegistryEntry&& hook, bool batched)
 {
 	SubscriptionIndex index;
 	auto sub = subscriptions_.Add(index);
@@ -29,9 +39,14 @@ EntityReplicationEventHooks::SubscriptionIndex EntityReplicationEventHooks::Subs
 	sub->Hook = std::move(hook);
 	sub->Type = type;
 	sub->Entity = entity;
+	sub->Batched = batched;
 
 	auto& pool = AddComponentType(type);
 	pool.InvalidationFlags |= flags;
+	if (batched) {
+		pool.BatchedInvalidationFlags |= flags;
+	}
+
 	if (!entity) {
 		pool.GlobalHooks.Add(index);
 	} else {
@@ -74,10 +89,44 @@ bool EntityReplicationEventHooks::Unsubscribe(SubscriptionIndex index)
 		}
 	}
 
+	auto type = sub->Type;
 	subscriptions_.Free(index);
+	RecomputeInvalidationFlags(type);
 	return true;
 }
 
+void EntityReplicationEventHooks::RecomputeInvalidationFlags(ecs::ReplicationTypeIndex type)
+{
+	auto& pool = hookedReplicationComponents_[(unsigned)type.Value()];
+	pool.InvalidationFlags = 0;
+	pool.BatchedInvalidationFlags = 0;
+
+	auto addFlags = [&](SubscriptionIndex index) {
+		auto hook = subscriptions_.Find(index);
+		if (hook != nullptr) {
+			pool.InvalidationFlags |= hook->InvalidationFlags;
+			if (hook->Batched) {
+				pool.BatchedInvalidationFlags |= hook->InvalidationFlags;
+			}
+		}
+	};
+
+	for (auto index : pool.GlobalHooks) {
+		addFlags(index);
+	}
+
+	for (auto const& entityHooks : pool.EntityHooks) {
+		for (auto index : entityHooks.Value()) {
+			addFlags(index);
+		}
+	}
+
+	// Stop scanning the replication pool of this type if nobody listens to it anymore
+	if (pool.InvalidationFlags == 0) {
+		hookedReplicationComponentMask_.Clear((unsigned)type.Value());
+	}
+}
+
 void EntityReplicationEventHooks::OnEntityReplication(ecs::EntityWorld& world)
 {
 	if (!world.Replication || !world.Replication->Dirty) return;
@@ -98,9 +147,13 @@ void EntityReplicationEventHooks::OnEntityReplication(ecs::EntityWorld& world, E
 	auto word1 = *flags.GetBuf();
 	if ((hooks.InvalidationFlags & word1) == 0) return;
 
+	if ((hooks.BatchedInvalidationFlags & word1) != 0) {
+		AddPendingChange(hooks, type, entity, word1);
+	}
+
 	for (auto index : hooks.GlobalHooks) {
 		auto hook = subscriptions_.Find(index);
-		if (hook != nullptr && (hook->InvalidationFlags & word1) != 0) {
+		if (hook != nullptr && !hook->Batched && (hook->InvalidationFlags & word1) != 0) {
 			CallHandler(entity, flags, type, *hook);
 		}
 	}
@@ -109,13 +162,71 @@ void EntityReplicationEventHooks::OnEntityReplication(ecs::EntityWorld& world, E
 	if (entityHooks) {
 		for (auto index : *entityHooks) {
 			auto hook = subscriptions_.Find(index);
-			if (hook != nullptr && (hook->InvalidationFlags & word1) != 0) {
+			if (hook != nullptr && !hook->Batched && (hook->InvalidationFlags & word1) != 0) {
 				CallHandler(entity, flags, type, *hook);
 			}
 		}
 	}
 }
 
+void EntityReplicationEventHooks::AddPendingChange(ReplicationHooks& hooks, ecs::ReplicationTypeIndex type, EntityHandle entity, uint64_t flags)
+{
+	auto& batch = hooks.PendingChanges;
+	if (batch.Entities.empty()) {
+		pendingChangeTypes_.push_back(type);
+	}
+
+	// The replication pass may run more than once before the batch is delivered;
+	// an entity is only reported once per batch with the union of its dirty flags
+	auto index = batch.EntityIndices.try_get(entity);
+	if (index) {
+		batch.Flags[*index] |= flags;
+	} else {
+		batch.EntityIndices.set(entity, batch.Entities.size());
+		batch.Entities.push_back(entity);
+		batch.Flags.push_back(flags);
+	}
+}
+
+void EntityReplicationEventHooks::FireBatchedEvents()
+{
+	if (pendingChangeTypes_.empty()) return;
+
+	// Handlers may dirty components or (un)subscribe, so all lists are copied before delivery
+	auto types = pendingChangeTypes_;
+	pendingChangeTypes_.clear();
+
+	for (auto type : types) {
+		auto& pending = hookedReplicationComponents_[type.Value()].PendingChanges;
+		auto entities = pending.Entities;
+		auto flags = pending.Flags;
+		pending.Entities.clear();
+		pending.Flags.clear();
+		pending.EntityIndices.clear();
+
+		auto globalHooks = hookedReplicationComponents_[type.Value()].GlobalHooks;
+		for (auto index : globalHooks) {
+			auto hook = subscriptions_.Find(index);
+			if (hook != nullptr && hook->Batched) {
+				CallBatchedHandler(entities, flags, type, *hook);
+			}
+		}
+
+		for (auto entity : entities) {
+			auto entityHooks = hookedReplicationComponents_[type.Value()].EntityHooks.try_get(entity);
+			if (entityHooks) {
+				auto hookIndices = *entityHooks;
+				for (auto index : hookIndices) {
+					auto hook = subscriptions_.Find(index);
+					if (hook != nullptr && hook->Batched) {
+						CallBatchedHandler(entities, flags, type, *hook);
+					}
+				}
+			}
+		}
+	}
+}
+
 void EntityReplicationEventHooks::CallHandler(EntityHandle entity, BitSet<> const& flags, ecs::ReplicationTypeIndex type, ReplicationHook const& hook)
 {
 	auto L = state_.GetState();
@@ -129,4 +240,38 @@ void EntityReplicationEventHooks::CallHandler(EntityHandle entity, BitSet<> cons
 	lua_pop(L, 1);
 }
 
+void EntityReplicationEventHooks::CallBatchedHandler(Array<EntityHandle> const& entities, Array<uint64_t> const& flags, ecs::ReplicationTypeIndex type, ReplicationHook const& hook)
+{
+	auto L = state_.GetState();
+	StackCheck _(L, 0);
+	LifetimeStackPin _p(state_.GetStack());
+	auto componentType = state_.GetEntitySystemHelpers()->GetComponentType(type);
+
+	hook.Hook.Push();
+	push(L, *componentType);
+
+	lua_newtable(L);
+	lua_newtable(L);
+	int changes = 0;
+	for (uint32_t i = 0; i < entities.size(); i++) {
+		if ((hook.InvalidationFlags & flags[i]) != 0 && (!hook.Entity || hook.Entity == entities[i])) {
+			changes++;
+			push(L, entities[i]);
+			lua_rawseti(L, -3, changes);
+			push(L, flags[i]);
+			lua_rawseti(L, -2, changes);
+		}
+	}
+
+	if (changes == 0) {
+		lua_pop(L, 4);
+		return;
+	}
+
+	if (CallWithTraceback(L, 3, 0) != 0) {
+		ERR("Entity change event dispatch failed: %s", lua_tostring(L, -1));
+		lua_pop(L, 1);
+	}
+}
+
 END_NS()
@@ -262,6 +262,7 @@ namespace bg3se::esv::lua
 		}
 
 		void OnGameSessionLoading() override;
+		void OnUpdate(GameTime const& time) override;
 		void StoryFunctionMappingsUpdated();
 
 		ecs::EntityWorld* GetEntityWorld() override;
@@ -11,21 +11,16 @@ PendingCallbackManager::~PendingCallbackManager()
 	}
 }
 
-Array<uint32_t>* PendingCallbackManager::Enter(std::unordered_multimap<uint64_t, uint32_t>::iterator& begin,
-	std::unordered_multimap<uint64_t, uint32_t>::iterator& end)
+Array<uint32_t>* PendingCallbackManager::Enter(Array<uint32_t> const& subscribers)
 {
 	if (depth_ >= cache_.size()) {
 		cache_.push_back(GameAlloc<Array<uint32_t>>());
 	}
 
 	auto entry = cache_[depth_];
-	entry->clear();
+	*entry = subscribers;
 	depth_++;
 
-	for (auto it = begin; it != end; it++) {
-		entry->Add(it->second);
-	}
-
 	return entry;
 }
 
@@ -36,8 +31,64 @@ void PendingCallbackManager::Exit(Array<uint32_t>* v)
 }
 
 
-OsirisCallbackManager::OsirisCallbackManager(ExtensionState& state)
-	: state_(state)
+void OsirisNodeSubscriberTable::Add(uint32_t id, uint32_t subscriber)
+{
+	if (id >= DenseLimit) {
+		SparseSubscribers[id].push_back(subscriber);
+		return;
+	}
+
+	if (Subscribers.size() <= id) {
+		Subscribers.resize(id + 1);
+	}
+
+	Subscribers[id].push_back(subscriber);
+	Mask.Set(id);
+}
+
+void OsirisNodeSubscriberTable::Remove(uint32_t id, uint32_t subscriber)
+{
+	auto removeSubscriber = [=](Array<uint32_t>& subscribers) {
+		for (uint32_t i = 0; i < subscribers.size(); i++) {
+			if (subscribers[i] == subscriber) {
+				subscribers.remove_at(i);
+				break;
+			}
+		}
+	};
+
+	if (id >= DenseLimit) {
+		auto it = SparseSubscribers.find(id);
+		if (it != SparseSubscribers.end()) {
+			removeSubscriber(it->second);
+			if (it->second.empty()) {
+				SparseSubscribers.erase(it);
+			}
+		}
+		return;
+	}
+
+	if (id >= Subscribers.size()) return;
+
+	auto& subscribers = Subscribers[id];
+	removeSubscriber(subscribers);
+
+	if (subscribers.empty()) {
+		Mask.Clear(id);
+	}
+}
+
+void OsirisNodeSubscriberTable::Clear(uint32_t denseLimit)
+{
+	Subscribers.clear();
+	SparseSubscribers.clear();
+	Mask.Clear();
+	DenseLimit = denseLimit;
+}
+
+
+OsirisCallbackManager::OsirisCallbackManager(ExtensionState& state, OsirisDatabaseIndexManager& databaseIndexes)
+	: state_(state), databaseIndexes_(databaseIndexes)
 {}
 
 OsirisCallbackManager::~OsirisCallbackManager()
@@ -82,15 +133,7 @@ bool OsirisCallbackManager::Unsubscribe(SubscriptionId id)
 	}
 
 	if (sub->Node) {
-		auto it = nodeSubscriberRefs_.find(*sub->Node);
-		while (it != nodeSubscriberRefs_.end() && it->first == *sub->Node) {
-			if (it->second == id) {
-				nodeSubscriberRefs_.erase(it);
-				break;
-			}
-
-			it++;
-		}
+		GetSubscriberTable(*sub->Node).Remove((uint32_t)*sub->Node, id);
 	}
 
 	sub->Callback.Reset();
@@ -104,50 +147,47 @@ void OsirisCallbackManager::RunHandlers(uint64_t nodeRef, TuplePtrLL* tuple)
 		return;
 	}
 
-	auto it = nodeSubscriberRefs_.equal_range(nodeRef);
-	if (it.first == nodeSubscriberRefs_.end()) {
+	auto subscribers = GetSubscriberTable(nodeRef).Find((uint32_t)nodeRef);
+	if (subscribers == nullptr) {
 		return;
 	}
 
 	LuaServerPin lua(state_);
 	if (lua) {
-		// Make a copy of the subscriber indices to as the subscriber map iterator can be invalidated
-		// if the Lua handler function registers a new subscriber
-		auto indices = pendingCallbacks_.Enter(it.first, it.second);
+		// Make a copy of the subscriber indices as the subscriber list can be modified
+		// if the Lua handler function registers or removes a subscriber
+		auto indices = pendingCallbacks_.Enter(*subscribers);
 		for (auto index : *indices) {
 			auto sub = subscriptions_.Find(index);
 			if (sub) {
-				RunHandler(lua.Get(), sub->Callback, tuple);
+				RunHandler(lua.Get(), *sub, tuple);
 			}
 		}
 		pendingCallbacks_.Exit(indices);
 	}
 }
 
-void OsirisCallbackManager::RunHandler(ServerState& lua, RegistryEntry const& func, TuplePtrLL* tuple)
+void OsirisCallbackManager::RunHandler(ServerState& lua, Subscription const& sub, TuplePtrLL* tuple)
 {
 	auto L = lua.GetState();
 	StackCheck _(L, 0);
 	LifetimeStackPin p_(lua.GetStack());
-	int32_t stackArgs = 1;
-	if (tuple != nullptr) {
-		auto node = tuple->Items.Head->Next;
-		while (node != tuple->Items.Head) {
-			node = node->Next;
-			stackArgs++;
-		}
-	}
-
+	// The tuple length is the arity of the subscribed symbol, so the list only needs to be walked once
+	int32_t stackArgs = (int32_t)sub.Signature.arity + 1;
 	lua_checkstack(L, stackArgs);
 	auto stackSize = lua_gettop(L);
 
 	try {
-		func.Push();
+		sub.Callback.Push();
 
 		int32_t numArgs = 0;
 		if (tuple != nullptr) {
 			auto node = tuple->Items.Head->Next;
 			while (node != tuple->Items.Head) {
+				if (numArgs + 1 >= stackArgs) {
+					lua_checkstack(L, 1);
+				}
+
 				OsiToLua(L, *node->Item);
 				node = node->Next;
 				numArgs++;
@@ -172,47 +212,45 @@ void OsirisCallbackManager::RunHandler(ServerState& lua, RegistryEntry const& fu
 
 void OsirisCallbackManager::RunHandlers(uint64_t nodeRef, OsiArgumentDesc* args)
 {
-	auto it = nodeSubscriberRefs_.equal_range(nodeRef);
-	if (it.first == nodeSubscriberRefs_.end()) {
+	auto subscribers = GetSubscriberTable(nodeRef).Find((uint32_t)nodeRef);
+	if (subscribers == nullptr) {
 		return;
 	}
 
 	LuaServerPin lua(state_);
 	if (lua) {
-		// Make a copy of the subscriber indices to as the subscriber map iterator can be invalidated
-		// if the Lua handler function registers a new subscriber
-		auto indices = pendingCallbacks_.Enter(it.first, it.second);
+		// Make a copy of the subscriber indices as the subscriber list can be modified
+		// if the Lua handler function registers or removes a subscriber
+		auto indices = pendingCallbacks_.Enter(*subscribers);
 		for (auto index : *indices) {
 			auto sub = subscriptions_.Find(index);
 			if (sub) {
-				RunHandler(lua.Get(), sub->Callback, args);
+				RunHandler(lua.Get(), *sub, args);
 			}
 		}
 		pendingCallbacks_.Exit(indices);
 	}
 }
 
-void OsirisCallbackManager::RunHandler(ServerState& lua, RegistryEntry const& func, OsiArgumentDesc* args)
+void OsirisCallbackManager::RunHandler(ServerState& lua, Subscription const& sub, OsiArgumentDesc* args)
 {
 	auto L = lua.GetState();
 	StackCheck _(L, 0);
 	LifetimeStackPin _p(lua.GetStack());
-	int32_t stackArgs = 1;
-	auto node = args;
-	while (node) {
-		node = node->NextParam;
-		stackArgs++;
-	}
-
+	int32_t stackArgs = (int32_t)sub.Signature.arity + 1;
 	lua_checkstack(L, stackArgs);
 	auto stackSize = lua_gettop(L);
 
 	try {
-		func.Push();
+		sub.Callback.Push();
 
 		int32_t numArgs = 0;
 		auto node = args;
 		while (node) {
+			if (numArgs + 1 >= stackArgs) {
+				lua_checkstack(L, 1);
+			}
+
 			OsiToLua(L, node->Value);
 			node = node->NextParam;
 			numArgs++;
@@ -239,7 +277,14 @@ void OsirisCallbackManager::StoryLoaded()
 {
 	HookOsiris();
 	storyLoaded_ = true;
-	nodeSubscriberRefs_.clear();
+
+	// Node and function IDs are indices into their DBs, so the DB sizes bound the dense range
+	auto const& globals = gExtender->GetServer().Osiris().GetGlobals();
+	auto denseLimit = std::min(std::max((*globals.Nodes)->Db.Size, (*globals.Functions)->NumItems) + 1, MaxDenseSubscriberId);
+	for (auto& table : nodeSubscribers_) {
+		table.Clear(denseLimit);
+	}
+
 	for (auto const& it : nameSubscriberRefs_) {
 		RegisterNodeHandler(it.first, it.second);
 	}
@@ -303,7 +348,7 @@ void OsirisCallbackManager::RegisterNodeHandler(OsirisHookSignature const& sig,
 		}
 	}
 
-	nodeSubscriberRefs_.insert(std::make_pair(nodeRef, handlerId));
+	GetSubscriberTable(nodeRef).Add((uint32_t)nodeRef, handlerId);
 	auto sub = subscriptions_.Find(handlerId);
 	if (sub) {
 		sub->Node = nodeRef;
@@ -322,6 +367,8 @@ void OsirisCallbackManager::HookOsiris()
 
 void OsirisCallbackManager::InsertPreHook(Node* node, TuplePtrLL* tuple, bool deleted)
 {
+	databaseIndexes_.InsertPreHook(node, tuple, deleted);
+
 	uint64_t nodeRef = node->Id;
 	if (deleted) {
 		nodeRef |= DeleteTriggerNodeRef;
@@ -332,6 +379,8 @@ void OsirisCallbackManager::InsertPreHook(Node* node, TuplePtrLL* tuple, bool de
 
 void OsirisCallbackManager::InsertPostHook(Node* node, TuplePtrLL* tuple, bool deleted)
 {
+	databaseIndexes_.InsertPostHook(node, tuple, deleted);
+
 	uint64_t nodeRef = node->Id | AfterTriggerNodeRef;
 	if (deleted) {
 		nodeRef |= DeleteTriggerNodeRef;
@@ -379,7 +428,7 @@ void OsirisCallbackManager::EventPostHook(Function* node, OsiArgumentDesc* args)
 
 OsirisBinding::OsirisBinding(ExtensionState& state)
 	: identityAdapters_(gExtender->GetServer().Osiris().GetGlobals()),
-	osirisCallbacks_(state)
+	osirisCallbacks_(state, databaseIndexes_)
 {
 	identityAdapters_.UpdateAdapters();
 }
@@ -400,6 +449,7 @@ void OsirisBinding::StoryLoaded()
 		OsiWarn("Not all identity adapters are available - some queries may not work!");
 	}
 
+	databaseIndexes_.StoryLoaded();
 	osirisCallbacks_.StoryLoaded();
 }
 
@@ -5,6 +5,7 @@
 #include <Osiris/Shared/CustomFunctions.h>
 #include <Extender/Shared/ExtensionHelpers.h>
 #include <Osiris/Shared/OsirisHelpers.h>
+#include <Lua/Server/LuaOsirisIndex.h>
 
 BEGIN_NS(esv)
 
@@ -58,6 +59,7 @@ void LuaToOsi(lua_State * L, int i, OsiArgumentValue & arg, ValueType osiType, b
 void OsiToLua(lua_State * L, OsiArgumentValue const & arg);
 void OsiToLua(lua_State * L, TypedValue const & tv);
 Function const* LookupOsiFunction(STDString const& name, uint32_t arity);
+ValueType GetBaseType(ValueType type);
 
 class OsiFunction
 {
@@ -87,7 +89,8 @@ private:
 
 	void OsiCall(lua_State * L);
 	void OsiDeferredNotification(lua_State * L);
-	void OsiInsert(lua_State * L, bool deleteTuple);
+	void OsiInsert(lua_State * L, int firstIndex, bool deleteTuple);
+	bool OsiIndexedDelete(lua_State * L);
 	int OsiQuery(lua_State * L);
 	int OsiUserQuery(lua_State * L);
 
@@ -237,14 +240,52 @@ private:
 
 class ServerState;
 
+// Subscribers of one hook type (before/after, insert/delete, node/function), indexed by node or function ID.
+// IDs below DenseLimit are stored in an array; the mask allows rejecting IDs without subscribers
+// without touching the subscriber lists. IDs above the limit go to a hash map instead, so a
+// bogus or unusually large ID can't blow up the size of the array.
+struct OsirisNodeSubscriberTable
+{
+	uint32_t DenseLimit{ 0 };
+	BitSet<> Mask;
+	Array<Array<uint32_t>> Subscribers;
+	std::unordered_map<uint32_t, Array<uint32_t>> SparseSubscribers;
+
+	inline Array<uint32_t> const* Find(uint32_t id) const
+	{
+		if (id < DenseLimit) {
+			if (id < Mask.Size && Mask[id]) {
+				return &Subscribers[id];
+			} else {
+				return nullptr;
+			}
+		}
+
+		if (SparseSubscribers.empty()) {
+			return nullptr;
+		}
+
+		auto it = SparseSubscribers.find(id);
+		if (it != SparseSubscribers.end()) {
+			return &it->second;
+		} else {
+			return nullptr;
+		}
+	}
+
+	void Add(uint32_t id, uint32_t subscriber);
+	void Remove(uint32_t id, uint32_t subscriber);
+	void Clear(uint32_t denseLimit);
+};
+
+
 // Stores an immutable copy of the subscribed handler ID-s during callback evaluation
 // to ensure that changes to the subscriber list don't affect the current list being evaluated
 class PendingCallbackManager
 {
 public:
 	~PendingCallbackManager();
-	Array<uint32_t>* Enter(std::unordered_multimap<uint64_t, uint32_t>::iterator& begin,
-		std::unordered_multimap<uint64_t, uint32_t>::iterator& end);
+	Array<uint32_t>* Enter(Array<uint32_t> const& subscribers);
 	void Exit(Array<uint32_t>* v);
 
 private:
@@ -257,7 +298,7 @@ class OsirisCallbackManager : Noncopyable<OsirisCallbackManager>
 public:
 	using SubscriptionId = uint32_t;
 
-	OsirisCallbackManager(ExtensionState& state);
+	OsirisCallbackManager(ExtensionState& state, OsirisDatabaseIndexManager& databaseIndexes);
 	~OsirisCallbackManager();
 
 	SubscriptionId Subscribe(STDString const& name, uint32_t arity, OsirisHookSignature::HookType type, RegistryEntry handler);
@@ -288,10 +329,17 @@ private:
 		std::optional<uint64_t> Node;
 	};
 
+	// Upper bound of the dense subscriber range, regardless of the size of the story
+	static constexpr uint32_t MaxDenseSubscriberId = 0x100000;
+
+	using NodeSubscriberTable = OsirisNodeSubscriberTable;
+
 	ExtensionState& state_;
+	OsirisDatabaseIndexManager& databaseIndexes_;
 	SaltedPool<Subscription> subscriptions_;
 	std::unordered_multimap<OsirisHookSignature, SubscriptionId> nameSubscriberRefs_;
-	std::unordered_multimap<uint64_t, SubscriptionId> nodeSubscriberRefs_;
+	// Subscriber tables for each combination of the node reference flags in the top 4 bits of the node reference
+	std::array<NodeSubscriberTable, 16> nodeSubscribers_;
 	PendingCallbackManager pendingCallbacks_;
 	bool storyLoaded_{ false };
 	bool osirisHooked_{ false };
@@ -303,10 +351,15 @@ private:
 	void RegisterNodeHandler(OsirisHookSignature const& sig, SubscriptionId handlerId);
 	void HookOsiris();
 
+	inline NodeSubscriberTable& GetSubscriberTable(uint64_t nodeRef)
+	{
+		return nodeSubscribers_[nodeRef >> 60];
+	}
+
 	void RunHandlers(uint64_t nodeRef, TuplePtrLL* tuple);
-	void RunHandler(ServerState& lua, RegistryEntry const& func, TuplePtrLL* tuple);
+	void RunHandler(ServerState& lua, Subscription const& sub, TuplePtrLL* tuple);
 	void RunHandlers(uint64_t nodeRef, OsiArgumentDesc* tuple);
-	void RunHandler(ServerState& lua, RegistryEntry const& func, OsiArgumentDesc* tuple);
+	void RunHandler(ServerState& lua, Subscription const& sub, OsiArgumentDesc* tuple);
 };
 
 class OsirisBinding : Noncopyable<OsirisBinding>
@@ -350,6 +403,11 @@ public:
 		return osirisCallbacks_;
 	}
 
+	inline OsirisDatabaseIndexManager& GetDatabaseIndexes()
+	{
+		return databaseIndexes_;
+	}
+
 	void StoryLoaded();
 	void StorySetMerging(bool isMerging);
 
@@ -362,6 +420,7 @@ private:
 	// ID of current story instance.
 	// Used to invalidate function/node pointers in Lua userdata objects
 	uint32_t generationId_{ 0 };
+	OsirisDatabaseIndexManager databaseIndexes_;
 	OsirisCallbackManager osirisCallbacks_;
 };
 
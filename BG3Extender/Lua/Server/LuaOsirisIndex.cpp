@@ -0,0 +1,501 @@
+#include <stdafx.h>
+#include <Lua/Server/LuaOsirisBinding.h>
+#include <Extender/ScriptExtender.h>
+
+BEGIN_NS(esv::lua)
+
+namespace
+{
+	Vector<OsirisDatabaseIndex::FactNode*> const NoFacts;
+
+	uint64_t HashInt(int64_t value)
+	{
+		// splitmix64 finalizer
+		uint64_t x = (uint64_t)value;
+		x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+		x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+		return x ^ (x >> 31);
+	}
+
+	// Case-insensitive FNV-1a, as strings are compared using _stricmp()
+	uint64_t HashStringNoCase(char const* str, std::size_t len)
+	{
+		uint64_t hash = 0xcbf29ce484222325ull;
+		for (std::size_t i = 0; i < len; i++) {
+			hash ^= (uint8_t)tolower((uint8_t)str[i]);
+			hash *= 0x100000001b3ull;
+		}
+
+		return hash;
+	}
+
+	constexpr std::size_t GuidLength = 36;
+
+	std::optional<uint64_t> HashString(ValueType type, char const* str)
+	{
+		if (str == nullptr) {
+			return {};
+		}
+
+		auto len = strlen(str);
+		if (type == ValueType::GuidString) {
+			// GUID strings are matched on their trailing UUID only
+			if (len < GuidLength) {
+				return {};
+			}
+
+			return HashStringNoCase(str + len - GuidLength, GuidLength);
+		} else {
+			return HashStringNoCase(str, len);
+		}
+	}
+
+	// Converts a Lua argument to the value it is compared against in OsiFunction::MatchTuple,
+	// so that it can be hashed and compared the same way as the column values of facts.
+	// Returns false if the argument can't be equal to any value of the column.
+	bool LuaToMatchValue(lua_State* L, int index, ValueType type, TypedValue& value)
+	{
+		value.TypeId = (uint16_t)type;
+		switch (type) {
+		case ValueType::Integer:
+		{
+			// MatchTuple compares the 32-bit column value against the 64-bit Lua integer
+			auto v = (int64_t)lua_tointeger(L, index);
+			if (v < std::numeric_limits<int32_t>::min() || v > std::numeric_limits<int32_t>::max()) {
+				return false;
+			}
+
+			value.Value.Int32 = (int32_t)v;
+			return true;
+		}
+
+		case ValueType::Integer64:
+			value.Value.Int64 = (int64_t)lua_tointeger(L, index);
+			return true;
+
+		case ValueType::String:
+		case ValueType::GuidString:
+			value.Value.String = const_cast<char*>(lua_tostring(L, index));
+			return value.Value.String != nullptr;
+
+		default:
+			return false;
+		}
+	}
+
+	// Same equality rules as OsiFunction::MatchTuple
+	bool ValuesMatch(ValueType type, TypedValue const& a, TypedValue const& b)
+	{
+		switch (type) {
+		case ValueType::Integer:
+			return a.Value.Int32 == b.Value.Int32;
+
+		case ValueType::Integer64:
+			return a.Value.Int64 == b.Value.Int64;
+
+		case ValueType::Real:
+			return abs(a.Value.Float - b.Value.Float) <= 0.00001f;
+
+		case ValueType::String:
+			return a.Value.String != nullptr && b.Value.String != nullptr
+				&& _stricmp(a.Value.String, b.Value.String) == 0;
+
+		case ValueType::GuidString:
+		{
+			if (a.Value.String == nullptr || b.Value.String == nullptr) {
+				return false;
+			}
+
+			auto aLen = strlen(a.Value.String);
+			auto bLen = strlen(b.Value.String);
+			return aLen >= GuidLength && bLen >= GuidLength
+				&& _stricmp(a.Value.String + aLen - GuidLength, b.Value.String + bLen - GuidLength) == 0;
+		}
+
+		default:
+			return false;
+		}
+	}
+
+	TypedValue const* GetTupleValue(TuplePtrLL* tuple, uint32_t column)
+	{
+		auto node = tuple->Items.Head->Next;
+		for (uint32_t i = 0; i < column && node != tuple->Items.Head; i++) {
+			node = node->Next;
+		}
+
+		return node != tuple->Items.Head ? node->Item : nullptr;
+	}
+}
+
+OsirisDatabaseIndex::OsirisDatabaseIndex(uint32_t column, ValueType type)
+	: column_(column), type_(type)
+{}
+
+bool OsirisDatabaseIndex::IsIndexable(ValueType type)
+{
+	// Reals are compared with a tolerance, so they can't be hashed
+	return type == ValueType::Integer
+		|| type == ValueType::Integer64
+		|| type == ValueType::String
+		|| type == ValueType::GuidString;
+}
+
+std::optional<uint64_t> OsirisDatabaseIndex::HashValue(ValueType type, TypedValue const& value)
+{
+	switch (type) {
+	case ValueType::Integer: return HashInt(value.Value.Int32);
+	case ValueType::Integer64: return HashInt(value.Value.Int64);
+	case ValueType::String:
+	case ValueType::GuidString: return HashString(type, value.Value.String);
+	default: return {};
+	}
+}
+
+std::optional<uint64_t> OsirisDatabaseIndex::HashLuaValue(lua_State* L, int index, ValueType type)
+{
+	TypedValue value;
+	if (!LuaToMatchValue(L, index, type, value)) {
+		return {};
+	}
+
+	return HashValue(type, value);
+}
+
+Vector<OsirisDatabaseIndex::FactNode*> const* OsirisDatabaseIndex::Find(uint64_t key) const
+{
+	auto it = buckets_.find(key);
+	return it != buckets_.end() ? &it->second : nullptr;
+}
+
+void OsirisDatabaseIndex::Clear()
+{
+	buckets_.clear();
+}
+
+void OsirisDatabaseIndex::Append(FactNode* fact)
+{
+	auto key = HashValue(type_, fact->Item.Values[column_]);
+	if (key) {
+		buckets_[*key].push_back(fact);
+	}
+}
+
+void OsirisDatabaseIndex::Prepend(FactNode* fact)
+{
+	auto key = HashValue(type_, fact->Item.Values[column_]);
+	if (key) {
+		auto& bucket = buckets_[*key];
+		bucket.insert(bucket.begin(), fact);
+	}
+}
+
+void OsirisDatabaseIndex::Remove(FactNode* fact, TypedValue const& value)
+{
+	auto key = HashValue(type_, value);
+	if (!key) return;
+
+	auto it = buckets_.find(*key);
+	if (it == buckets_.end()) return;
+
+	auto& bucket = it->second;
+	auto factIt = std::find(bucket.begin(), bucket.end(), fact);
+	if (factIt != bucket.end()) {
+		bucket.erase(factIt);
+		if (bucket.empty()) {
+			buckets_.erase(it);
+		}
+	}
+}
+
+
+Vector<OsirisDatabaseIndex::FactNode*> const* OsirisDatabaseIndexManager::DatabaseIndexes::FindCandidates(lua_State* L, int firstIndex) const
+{
+	Vector<FactNode*> const* best = nullptr;
+	for (auto const& index : Indexes) {
+		auto argIndex = firstIndex + (int)index.GetColumn();
+		if (lua_isnil(L, argIndex)) continue;
+
+		auto key = OsirisDatabaseIndex::HashLuaValue(L, argIndex, index.GetType());
+		auto facts = key ? index.Find(*key) : nullptr;
+		if (facts == nullptr) {
+			return &NoFacts;
+		}
+
+		if (best == nullptr || facts->size() < best->size()) {
+			best = facts;
+		}
+	}
+
+	return best;
+}
+
+bool OsirisDatabaseIndexManager::DatabaseIndexes::FactEquals(FactNode* fact, TuplePtrLL* tuple) const
+{
+	auto node = tuple->Items.Head->Next;
+	for (uint32_t i = 0; i < fact->Item.Size; i++, node = node->Next) {
+		if (node == tuple->Items.Head || i >= ColumnTypes.size()) {
+			return false;
+		}
+
+		// Wildcard values can't be mapped to a single fact
+		if ((ValueType)node->Item->TypeId == ValueType::None
+			|| !ValuesMatch(ColumnTypes[i], fact->Item.Values[i], *node->Item)) {
+			return false;
+		}
+	}
+
+	return node == tuple->Items.Head;
+}
+
+
+bool OsirisDatabaseIndexManager::Bind(DatabaseIndexes& indexes)
+{
+	auto func = LookupOsiFunction(indexes.Name, indexes.Arity);
+	auto node = func ? func->Node.Get() : nullptr;
+	// User queries also use the database function type, but aren't backed by a data node
+	if (func == nullptr || func->Type != FunctionType::Database || node == nullptr
+		|| !node->IsDataNode() || node->Database.Get() == nullptr) {
+		return false;
+	}
+
+	indexes.Db = node->Database;
+	indexes.ColumnTypes.clear();
+	auto param = func->Signature->Params->Params.Head->Next;
+	for (uint32_t i = 0; i < indexes.Arity; i++) {
+		indexes.ColumnTypes.push_back(GetBaseType((ValueType)param->Item.Type));
+		param = param->Next;
+	}
+
+	for (auto& index : indexes.Indexes) {
+		index = OsirisDatabaseIndex(index.GetColumn(), indexes.ColumnTypes[index.GetColumn()]);
+	}
+
+	indexes.Dirty = true;
+	return true;
+}
+
+bool OsirisDatabaseIndexManager::CreateIndex(STDString const& name, uint32_t arity, uint32_t column)
+{
+	DatabaseIndexes indexes;
+	indexes.Name = name;
+	indexes.Arity = arity;
+	if (!Bind(indexes)) {
+		OsiError("Cannot create index: No database named '" << name << "(" << arity << ")' exists");
+		return false;
+	}
+
+	if (column >= arity) {
+		OsiError("Cannot create index on column " << (column + 1) << " of '" << name << "(" << arity << ")': Column index out of range");
+		return false;
+	}
+
+	auto type = indexes.ColumnTypes[column];
+	if (!OsirisDatabaseIndex::IsIndexable(type)) {
+		OsiError("Cannot create index on column " << (column + 1) << " of '" << name << "(" << arity << ")': Column type " << (unsigned)type << " is not indexable");
+		return false;
+	}
+
+	auto it = databases_.find(indexes.Db.Id);
+	if (it == databases_.end()) {
+		it = databases_.insert(std::make_pair(indexes.Db.Id, std::move(indexes))).first;
+	}
+
+	auto& dbIndexes = it->second;
+	for (auto const& index : dbIndexes.Indexes) {
+		if (index.GetColumn() == column) {
+			return true;
+		}
+	}
+
+	dbIndexes.Indexes.push_back(OsirisDatabaseIndex(column, type));
+	dbIndexes.Dirty = true;
+	return true;
+}
+
+bool OsirisDatabaseIndexManager::DropIndex(STDString const& name, uint32_t arity, uint32_t column)
+{
+	for (auto it = databases_.begin(); it != databases_.end(); it++) {
+		auto& indexes = it->second;
+		if (indexes.Name != name || indexes.Arity != arity) continue;
+
+		for (auto indexIt = indexes.Indexes.begin(); indexIt != indexes.Indexes.end(); indexIt++) {
+			if (indexIt->GetColumn() == column) {
+				indexes.Indexes.erase(indexIt);
+				if (indexes.Indexes.empty()) {
+					databases_.erase(it);
+				}
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	return false;
+}
+
+void OsirisDatabaseIndexManager::StoryLoaded()
+{
+	// Database IDs and fact lists aren't preserved between story instances; rebind all indexes
+	auto databases = std::move(databases_);
+	databases_.clear();
+	pending_.clear();
+
+	for (auto& it : databases) {
+		auto& indexes = it.second;
+		if (Bind(indexes)) {
+			auto id = indexes.Db.Id;
+			databases_.insert(std::make_pair(id, std::move(indexes)));
+		} else {
+			OsiWarn("Dropping indexes of '" << indexes.Name << "(" << indexes.Arity << ")': Database no longer exists");
+		}
+	}
+}
+
+void OsirisDatabaseIndexManager::Rebuild(DatabaseIndexes& indexes)
+{
+	auto db = indexes.Db.Get();
+	for (auto& index : indexes.Indexes) {
+		index.Clear();
+	}
+
+	auto head = db->Facts.Head;
+	for (auto fact = head->Next; fact != head; fact = fact->Next) {
+		for (auto& index : indexes.Indexes) {
+			index.Append(fact);
+		}
+	}
+
+	indexes.FactCount = db->Facts.Size;
+	indexes.Dirty = false;
+}
+
+OsirisDatabaseIndexManager::DatabaseIndexes* OsirisDatabaseIndexManager::GetIndexes(uint32_t databaseId)
+{
+	auto it = databases_.find(databaseId);
+	if (it == databases_.end()) {
+		return nullptr;
+	}
+
+	auto& indexes = it->second;
+	auto db = indexes.Db.Get();
+	if (db == nullptr) {
+		return nullptr;
+	}
+
+	if (indexes.Dirty || db->Facts.Size != indexes.FactCount) {
+		Rebuild(indexes);
+	}
+
+	return &indexes;
+}
+
+OsirisDatabaseIndexManager::FactNode* OsirisDatabaseIndexManager::FindFact(DatabaseIndexes& indexes, TuplePtrLL* tuple)
+{
+	auto const& index = indexes.Indexes[0];
+	auto value = GetTupleValue(tuple, index.GetColumn());
+	if (value == nullptr || (ValueType)value->TypeId == ValueType::None) {
+		return nullptr;
+	}
+
+	auto key = OsirisDatabaseIndex::HashValue(index.GetType(), *value);
+	auto facts = key ? index.Find(*key) : nullptr;
+	if (facts == nullptr) {
+		return nullptr;
+	}
+
+	// Facts are compared using the loosest equality rules Osiris may use (case-insensitive,
+	// GUID suffix only); if more than one fact matches, we can't tell which one is deleted.
+	FactNode* found{ nullptr };
+	for (auto fact : *facts) {
+		if (indexes.FactEquals(fact, tuple)) {
+			if (found != nullptr) {
+				return nullptr;
+			}
+
+			found = fact;
+		}
+	}
+
+	return found;
+}
+
+void OsirisDatabaseIndexManager::InsertPreHook(Node* node, TuplePtrLL* tuple, bool deleted)
+{
+	auto it = databases_.find(node->Database.Id);
+	if (it == databases_.end()) {
+		pending_.push_back(PendingChange{ 0, nullptr });
+		return;
+	}
+
+	auto& indexes = it->second;
+	auto db = indexes.Db.Get();
+	if (db == nullptr || db->Facts.Size != indexes.FactCount) {
+		indexes.Dirty = true;
+	}
+
+	// Nested modification of a database that is already being modified (eg. from a rule
+	// or an Osiris listener); we can't reliably tell which facts were affected by each change.
+	for (auto const& change : pending_) {
+		if (change.DatabaseId == it->first) {
+			indexes.Dirty = true;
+			break;
+		}
+	}
+
+	FactNode* fact{ nullptr };
+	if (deleted && !indexes.Dirty) {
+		fact = FindFact(indexes, tuple);
+	}
+
+	pending_.push_back(PendingChange{ it->first, fact });
+}
+
+void OsirisDatabaseIndexManager::InsertPostHook(Node* node, TuplePtrLL* tuple, bool deleted)
+{
+	if (pending_.empty()) return;
+
+	auto change = pending_.back();
+	pending_.pop_back();
+
+	auto it = databases_.find(change.DatabaseId);
+	if (change.DatabaseId == 0 || it == databases_.end()) return;
+
+	auto& indexes = it->second;
+	auto db = indexes.Db.Get();
+	if (indexes.Dirty || db == nullptr) return;
+
+	auto size = db->Facts.Size;
+	if (deleted) {
+		if (change.Fact != nullptr && size + 1 == indexes.FactCount) {
+			for (auto const& index : indexes.Indexes) {
+				if (GetTupleValue(tuple, index.GetColumn()) == nullptr) {
+					indexes.Dirty = true;
+					return;
+				}
+			}
+
+			for (auto& index : indexes.Indexes) {
+				index.Remove(change.Fact, *GetTupleValue(tuple, index.GetColumn()));
+			}
+			indexes.FactCount = size;
+		} else if (change.Fact != nullptr || size != indexes.FactCount) {
+			indexes.Dirty = true;
+		}
+	} else {
+		// New facts are inserted at the front of the fact list; if the new fact is not
+		// found there, fall back to rebuilding the index on the next lookup.
+		auto first = db->Facts.Head->Next;
+		if (size == indexes.FactCount + 1 && first != db->Facts.Head && indexes.FactEquals(first, tuple)) {
+			for (auto& index : indexes.Indexes) {
+				index.Prepend(first);
+			}
+			indexes.FactCount = size;
+		} else if (size != indexes.FactCount) {
+			indexes.Dirty = true;
+		}
+	}
+}
+
+END_NS()
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <GameDefinitions/Osiris.h>
+#include <unordered_map>
+#include <optional>
+
+struct lua_State;
+
+BEGIN_NS(esv::lua)
+
+// Hash index over a single column of an Osiris database.
+// Buckets keep facts in the same order as the database fact list, so lookups through the
+// index return rows in the same order as a full scan would.
+class OsirisDatabaseIndex
+{
+public:
+	using FactNode = ListNode<TupleVec>;
+
+	OsirisDatabaseIndex(uint32_t column, ValueType type);
+
+	inline uint32_t GetColumn() const
+	{
+		return column_;
+	}
+
+	inline ValueType GetType() const
+	{
+		return type_;
+	}
+
+	// Returns facts whose indexed column hashes to the same value as the key.
+	// The caller is responsible for checking the full tuple of each returned fact.
+	Vector<FactNode*> const* Find(uint64_t key) const;
+
+	void Clear();
+	void Append(FactNode* fact);
+	void Prepend(FactNode* fact);
+	// The fact may already be freed, so its key is computed from the value of the removed tuple
+	void Remove(FactNode* fact, TypedValue const& value);
+
+	// Hashes a value using the same equality rules as OsiFunction::MatchTuple;
+	// returns nothing if the value cannot match any fact.
+	static std::optional<uint64_t> HashValue(ValueType type, TypedValue const& value);
+	// Converts the Lua value the same way as MatchTuple before hashing it
+	static std::optional<uint64_t> HashLuaValue(lua_State* L, int index, ValueType type);
+	static bool IsIndexable(ValueType type);
+
+private:
+	uint32_t column_;
+	ValueType type_;
+	std::unordered_map<uint64_t, Vector<FactNode*>> buckets_;
+};
+
+// Opt-in column indexes for Osiris databases queried from Lua.
+// Indexes are rebuilt lazily from the fact list and are kept up to date incrementally using the
+// DB insert/delete node hooks. Changes that can't be tracked precisely (nested modifications
+// during an insert/delete, wildcard deletes, facts added by story loading/merging) mark the
+// index as stale, which causes a rebuild on the next lookup.
+class OsirisDatabaseIndexManager : Noncopyable<OsirisDatabaseIndexManager>
+{
+public:
+	using FactNode = OsirisDatabaseIndex::FactNode;
+
+	struct DatabaseIndexes
+	{
+		STDString Name;
+		uint32_t Arity{ 0 };
+		DatabaseRef Db;
+		Vector<ValueType> ColumnTypes;
+		Vector<OsirisDatabaseIndex> Indexes;
+		uint64_t FactCount{ 0 };
+		bool Dirty{ true };
+
+		// Finds the smallest candidate list for the arguments bound on the Lua stack.
+		// Returns null if no indexed column is bound, and an empty list if the arguments can't match any fact.
+		Vector<FactNode*> const* FindCandidates(lua_State* L, int firstIndex) const;
+		bool FactEquals(FactNode* fact, TuplePtrLL* tuple) const;
+	};
+
+	bool CreateIndex(STDString const& name, uint32_t arity, uint32_t column);
+	bool DropIndex(STDString const& name, uint32_t arity, uint32_t column);
+	void StoryLoaded();
+
+	// Returns the up-to-date indexes of the database, or null if the database has no indexes
+	DatabaseIndexes* GetIndexes(uint32_t databaseId);
+
+	void InsertPreHook(Node* node, TuplePtrLL* tuple, bool deleted);
+	void InsertPostHook(Node* node, TuplePtrLL* tuple, bool deleted);
+
+private:
+	struct PendingChange
+	{
+		uint32_t DatabaseId;
+		FactNode* Fact;
+	};
+
+	std::unordered_map<uint32_t, DatabaseIndexes> databases_;
+	Vector<PendingChange> pending_;
+
+	bool Bind(DatabaseIndexes& indexes);
+	void Rebuild(DatabaseIndexes& indexes);
+	FactNode* FindFact(DatabaseIndexes& indexes, TuplePtrLL* tuple);
+};
+
+END_NS()
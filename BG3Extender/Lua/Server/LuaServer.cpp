@@ -93,11 +93,41 @@ namespace bg3se::esv::lua
 		return 1;
 	}
 
+	int CreateOsirisIndex(lua_State* L)
+	{
+		auto name = get<STDString>(L, 1);
+		auto arity = get<uint32_t>(L, 2);
+		auto column = get<uint32_t>(L, 3);
+		if (column < 1) {
+			luaL_error(L, "Column index must be at least 1");
+		}
+
+		LuaServerPin lua(ExtensionState::Get());
+		push(L, lua->Osiris().GetDatabaseIndexes().CreateIndex(name, arity, column - 1));
+		return 1;
+	}
+
+	int DropOsirisIndex(lua_State* L)
+	{
+		auto name = get<STDString>(L, 1);
+		auto arity = get<uint32_t>(L, 2);
+		auto column = get<uint32_t>(L, 3);
+		if (column < 1) {
+			luaL_error(L, "Column index must be at least 1");
+		}
+
+		LuaServerPin lua(ExtensionState::Get());
+		push(L, lua->Osiris().GetDatabaseIndexes().DropIndex(name, arity, column - 1));
+		return 1;
+	}
+
 	void RegisterOsirisLibrary(lua_State* L)
 	{
 		static const luaL_Reg extLib[] = {
 			{"RegisterListener", RegisterOsirisListener},
 			{"UnregisterListener", UnregisterOsirisListener},
+			{"CreateIndex", CreateOsirisIndex},
+			{"DropIndex", DropOsirisIndex},
 			{0,0}
 		};
 
@@ -115,6 +145,7 @@ namespace bg3se::esv::lua
 		lua_setglobal(L, "Ext"); // stack: -
 
 		RegisterSharedMetatables(L);
+		RegisterEventBusLib(L);
 		RegisterOsirisLibrary(L);
 		gModuleRegistry.ConstructState(L, ModuleRole::Server);
 	}
@@ -227,6 +258,14 @@ namespace bg3se::esv::lua
 		State::OnGameSessionLoading();
 	}
 
+	void ServerState::OnUpdate(GameTime const& time)
+	{
+		// Deliver changes collected since the last update before the Tick event, so Tick
+		// handlers observe the batches of all changes made before the tick
+		replicationHooks_.FireBatchedEvents();
+		State::OnUpdate(time);
+	}
+
 	void ServerState::StoryFunctionMappingsUpdated()
 	{
 		auto helpers = library_.GenerateOsiHelpers();
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <unordered_map>
+
+BEGIN_NS(lua)
+
+// Uniform grid of entity positions used for radius, box and nearest-neighbor entity queries.
+// The grid is brought up to date on the first query of each tick.
+// On the server, only entities whose transform was created, destroyed or replicated since the last
+// update are re-read; every FullRefreshInterval ticks all transforms are rescanned to pick up
+// entities that move without replicating. Worlds without transform replication (i.e. the client)
+// rescan all transforms on each update. Only entities that moved to a different cell are rebucketed.
+class EntitySpatialIndex
+{
+public:
+	static constexpr float CellSize = 8.0f;
+	static constexpr uint32_t FullRefreshInterval = 60;
+
+	struct ComponentFilter
+	{
+		std::array<ecs::ComponentTypeIndex, ecs::EntityStorageQuery::MaxComponents> Types;
+		unsigned NumTypes{ 0 };
+	};
+
+	EntitySpatialIndex(State& state);
+	~EntitySpatialIndex();
+
+	// Collects entities whose transform was replicated during the last ECS update
+	void OnEntityReplication(ecs::EntityWorld& world);
+
+	// Marks the index as stale; positions are refreshed when the next query is made
+	void Invalidate();
+
+	void QueryRadius(glm::vec3 const& center, float radius, ComponentFilter const& filter, Array<EntityHandle>& results);
+	void QueryBox(glm::vec3 const& min, glm::vec3 const& max, ComponentFilter const& filter, Array<EntityHandle>& results);
+	// Returns at most count entities within maxDistance, ordered by ascending distance
+	void QueryNearest(glm::vec3 const& center, uint32_t count, float maxDistance, ComponentFilter const& filter, Array<EntityHandle>& results);
+
+	inline uint32_t GetEntityCount() const
+	{
+		return (uint32_t)entities_.size();
+	}
+
+private:
+	using CellKey = uint64_t;
+
+	struct EntityEntry
+	{
+		glm::vec3 Position;
+		CellKey Cell;
+		// Index of the entity in the entity list of its cell
+		uint32_t CellSlot;
+		uint32_t Generation;
+	};
+
+	struct CellRange
+	{
+		glm::ivec3 Min;
+		glm::ivec3 Max;
+
+		inline int64_t GetCellCount() const
+		{
+			return ((int64_t)Max.x - Min.x + 1) * ((int64_t)Max.y - Min.y + 1) * ((int64_t)Max.z - Min.z + 1);
+		}
+	};
+
+	State& state_;
+	std::unordered_map<EntityHandle, EntityEntry> entities_;
+	std::unordered_map<CellKey, Array<EntityHandle>> cells_;
+	ecs::EntityWorld* world_{ nullptr };
+	uint32_t generation_{ 0 };
+	bool dirty_{ true };
+
+	std::optional<ecs::ComponentTypeIndex> transformType_;
+	std::optional<ecs::ReplicationTypeIndex> transformReplicationType_;
+	uint64_t constructRegistrant_{ 0 };
+	uint64_t destroyRegistrant_{ 0 };
+	// Entities whose transform changed since the last update; may contain duplicates
+	Array<EntityHandle> changed_;
+	bool needsFullRefresh_{ true };
+	uint32_t ticksSinceFullRefresh_{ 0 };
+
+	void Bind();
+	void Unbind();
+	void Update();
+	void Refresh(ecs::EntityWorld& world);
+	void ApplyChanges();
+	void UpdateEntity(EntityHandle entity, glm::vec3 const& position);
+	void RemoveEntity(EntityHandle entity);
+	void AddChanged(EntityHandle entity);
+	void AddToCell(EntityHandle entity, EntityEntry& entry);
+	void RemoveFromCell(EntityEntry const& entry);
+	bool MatchesFilter(ecs::EntityWorld& world, EntityHandle entity, ComponentFilter const& filter) const;
+
+	// Calls the visitor for each entity in the cells overlapping the range;
+	// falls back to visiting all entities if the range covers more cells than are populated
+	template <class Visitor>
+	void VisitCells(CellRange const& range, Visitor const& visitor) const;
+
+	static glm::ivec3 ToCell(glm::vec3 const& position);
+	static CellKey MakeKey(glm::ivec3 const& cell);
+	static CellRange MakeRange(glm::vec3 const& min, glm::vec3 const& max);
+	static void OnTransformCreated(void* object, ecs::ComponentCallbackParams const& params, void* component);
+	static void OnTransformDestroyed(void* object, ecs::ComponentCallbackParams const& params, void* component);
+};
+
+END_NS()
@@ -0,0 +1,374 @@
+#include <Lua/Shared/EntitySpatialIndex.h>
+
+BEGIN_NS(lua)
+
+EntitySpatialIndex::EntitySpatialIndex(State& state)
+	: state_(state)
+{}
+
+EntitySpatialIndex::~EntitySpatialIndex()
+{
+	Unbind();
+}
+
+void EntitySpatialIndex::Invalidate()
+{
+	dirty_ = true;
+	ticksSinceFullRefresh_++;
+}
+
+void EntitySpatialIndex::Bind()
+{
+	auto ecs = state_.GetEntitySystemHelpers();
+	transformType_ = ecs->GetComponentIndex(ExtComponentType::Transform);
+	transformReplicationType_ = {};
+
+	// Incremental updates need both the construct/destroy callbacks and the replication
+	// dirty flags of transforms; without them we fall back to rescanning every transform.
+	if (!transformType_ || world_->Replication == nullptr) {
+		return;
+	}
+
+	auto replicationType = ecs->GetReplicationIndex(ExtComponentType::Transform);
+	if (!replicationType) {
+		return;
+	}
+
+	auto callbacks = world_->ComponentCallbacks[transformType_->Value()];
+	constructRegistrant_ = callbacks->OnConstruct.Add(ecs::ComponentCallbackHandler{ &OnTransformCreated, this });
+	destroyRegistrant_ = callbacks->OnDestroy.Add(ecs::ComponentCallbackHandler{ &OnTransformDestroyed, this });
+	transformReplicationType_ = replicationType;
+}
+
+void EntitySpatialIndex::Unbind()
+{
+	if (transformReplicationType_) {
+		auto callbacks = world_->ComponentCallbacks[transformType_->Value()];
+		callbacks->OnConstruct.Remove(constructRegistrant_);
+		callbacks->OnDestroy.Remove(destroyRegistrant_);
+		transformReplicationType_ = {};
+	}
+}
+
+void EntitySpatialIndex::OnTransformCreated(void* object, ecs::ComponentCallbackParams const& params, void* component)
+{
+	reinterpret_cast<EntitySpatialIndex*>(object)->AddChanged(params.Entity);
+}
+
+void EntitySpatialIndex::OnTransformDestroyed(void* object, ecs::ComponentCallbackParams const& params, void* component)
+{
+	reinterpret_cast<EntitySpatialIndex*>(object)->AddChanged(params.Entity);
+}
+
+void EntitySpatialIndex::AddChanged(EntityHandle entity)
+{
+	if (needsFullRefresh_) {
+		return;
+	}
+
+	// Once the change list outgrows the index, a full rescan is cheaper than replaying it
+	if (changed_.size() >= std::max((std::size_t)4096, entities_.size())) {
+		changed_.clear();
+		needsFullRefresh_ = true;
+		return;
+	}
+
+	changed_.push_back(entity);
+}
+
+void EntitySpatialIndex::OnEntityReplication(ecs::EntityWorld& world)
+{
+	if (&world != world_ || !transformReplicationType_ || needsFullRefresh_
+		|| !world.Replication || !world.Replication->Dirty) {
+		return;
+	}
+
+	auto const& pool = world.Replication->ComponentPools[transformReplicationType_->Value()];
+	for (auto const& entity : pool) {
+		AddChanged(entity.Key());
+	}
+}
+
+glm::ivec3 EntitySpatialIndex::ToCell(glm::vec3 const& position)
+{
+	// Clamp to the range of cell keys so that huge query extents don't overflow
+	constexpr float limit = (float)((1 << 20) - 1);
+	return glm::ivec3(glm::clamp(glm::floor(position / CellSize), glm::vec3(-limit), glm::vec3(limit)));
+}
+
+EntitySpatialIndex::CellKey EntitySpatialIndex::MakeKey(glm::ivec3 const& cell)
+{
+	// 21 bits per axis, which covers +/- 8M meters with the default cell size
+	constexpr int32_t bias = 1 << 20;
+	constexpr uint64_t mask = (1ull << 21) - 1;
+	return (((uint64_t)(cell.x + bias) & mask) << 42)
+		| (((uint64_t)(cell.y + bias) & mask) << 21)
+		| ((uint64_t)(cell.z + bias) & mask);
+}
+
+EntitySpatialIndex::CellRange EntitySpatialIndex::MakeRange(glm::vec3 const& min, glm::vec3 const& max)
+{
+	return CellRange{ ToCell(min), ToCell(max) };
+}
+
+void EntitySpatialIndex::AddToCell(EntityHandle entity, EntityEntry& entry)
+{
+	auto& cell = cells_[entry.Cell];
+	entry.CellSlot = cell.Size();
+	cell.Add(entity);
+}
+
+void EntitySpatialIndex::RemoveFromCell(EntityEntry const& entry)
+{
+	auto it = cells_.find(entry.Cell);
+	if (it == cells_.end()) {
+		return;
+	}
+
+	auto& cell = it->second;
+	auto last = cell.Size() - 1;
+	if (entry.CellSlot != last) {
+		auto moved = cell[last];
+		cell[entry.CellSlot] = moved;
+		entities_[moved].CellSlot = entry.CellSlot;
+	}
+
+	cell.remove_last();
+	if (cell.Size() == 0) {
+		cells_.erase(it);
+	}
+}
+
+void EntitySpatialIndex::Update()
+{
+	auto world = state_.GetEntityWorld();
+	if (world != world_) {
+		Unbind();
+		entities_.clear();
+		cells_.clear();
+		changed_.clear();
+		world_ = world;
+		needsFullRefresh_ = true;
+		if (world_ != nullptr) {
+			Bind();
+		}
+	}
+
+	if (world_ != nullptr && dirty_) {
+		if (!transformReplicationType_ || needsFullRefresh_ || ticksSinceFullRefresh_ >= FullRefreshInterval) {
+			Refresh(*world_);
+		} else {
+			ApplyChanges();
+		}
+	}
+
+	dirty_ = false;
+}
+
+void EntitySpatialIndex::Refresh(ecs::EntityWorld& world)
+{
+	changed_.clear();
+	needsFullRefresh_ = false;
+	ticksSinceFullRefresh_ = 0;
+
+	if (!transformType_) {
+		return;
+	}
+
+	auto ecs = state_.GetEntitySystemHelpers();
+	auto const& meta = ecs->GetComponentMeta(ExtComponentType::Transform);
+	ecs::EntityStorageQuery query(world.Storage);
+	query.AddComponent(*transformType_, meta.Size, meta.IsProxy);
+
+	generation_++;
+	while (query.Next()) {
+		auto transform = reinterpret_cast<TransformComponent const*>(query.GetComponent(0));
+		UpdateEntity(query.GetEntity(), transform->Transform.Translate);
+	}
+
+	// Drop entities whose transform disappeared since the last refresh
+	for (auto it = entities_.begin(); it != entities_.end();) {
+		if (it->second.Generation != generation_) {
+			RemoveFromCell(it->second);
+			it = entities_.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+void EntitySpatialIndex::ApplyChanges()
+{
+	auto ecs = state_.GetEntitySystemHelpers();
+	for (auto entity : changed_) {
+		auto transform = ecs->GetComponent<TransformComponent>(entity);
+		if (transform != nullptr) {
+			UpdateEntity(entity, transform->Transform.Translate);
+		} else {
+			RemoveEntity(entity);
+		}
+	}
+
+	changed_.clear();
+}
+
+void EntitySpatialIndex::UpdateEntity(EntityHandle entity, glm::vec3 const& position)
+{
+	auto cell = MakeKey(ToCell(position));
+	auto it = entities_.find(entity);
+	if (it == entities_.end()) {
+		auto& entry = entities_.insert(std::make_pair(entity, EntityEntry{ position, cell, 0, generation_ })).first->second;
+		AddToCell(entity, entry);
+	} else {
+		auto& entry = it->second;
+		entry.Position = position;
+		entry.Generation = generation_;
+		if (entry.Cell != cell) {
+			RemoveFromCell(entry);
+			entry.Cell = cell;
+			AddToCell(entity, entry);
+		}
+	}
+}
+
+void EntitySpatialIndex::RemoveEntity(EntityHandle entity)
+{
+	auto it = entities_.find(entity);
+	if (it != entities_.end()) {
+		RemoveFromCell(it->second);
+		entities_.erase(it);
+	}
+}
+
+bool EntitySpatialIndex::MatchesFilter(ecs::EntityWorld& world, EntityHandle entity, ComponentFilter const& filter) const
+{
+	if (filter.NumTypes == 0) {
+		return true;
+	}
+
+	auto storage = world.GetEntityStorage(entity);
+	if (storage == nullptr) {
+		return false;
+	}
+
+	for (unsigned i = 0; i < filter.NumTypes; i++) {
+		if (!storage->HasComponent(filter.Types[i])) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+template <class Visitor>
+void EntitySpatialIndex::VisitCells(CellRange const& range, Visitor const& visitor) const
+{
+	if (range.GetCellCount() > (int64_t)cells_.size()) {
+		for (auto const& it : entities_) {
+			visitor(it.first, it.second);
+		}
+		return;
+	}
+
+	for (auto x = range.Min.x; x <= range.Max.x; x++) {
+		for (auto y = range.Min.y; y <= range.Max.y; y++) {
+			for (auto z = range.Min.z; z <= range.Max.z; z++) {
+				auto cell = cells_.find(MakeKey(glm::ivec3(x, y, z)));
+				if (cell == cells_.end()) {
+					continue;
+				}
+
+				for (auto entity : cell->second) {
+					visitor(entity, entities_.find(entity)->second);
+				}
+			}
+		}
+	}
+}
+
+void EntitySpatialIndex::QueryRadius(glm::vec3 const& center, float radius, ComponentFilter const& filter, Array<EntityHandle>& results)
+{
+	Update();
+	if (world_ == nullptr) {
+		return;
+	}
+
+	auto radiusSq = radius * radius;
+	auto range = MakeRange(center - glm::vec3(radius), center + glm::vec3(radius));
+	VisitCells(range, [&](EntityHandle entity, EntityEntry const& entry) {
+		auto delta = entry.Position - center;
+		if (glm::dot(delta, delta) <= radiusSq && MatchesFilter(*world_, entity, filter)) {
+			results.Add(entity);
+		}
+	});
+}
+
+void EntitySpatialIndex::QueryBox(glm::vec3 const& min, glm::vec3 const& max, ComponentFilter const& filter, Array<EntityHandle>& results)
+{
+	Update();
+	if (world_ == nullptr) {
+		return;
+	}
+
+	auto range = MakeRange(min, max);
+	VisitCells(range, [&](EntityHandle entity, EntityEntry const& entry) {
+		auto const& pos = entry.Position;
+		if (pos.x >= min.x && pos.y >= min.y && pos.z >= min.z
+			&& pos.x <= max.x && pos.y <= max.y && pos.z <= max.z
+			&& MatchesFilter(*world_, entity, filter)) {
+			results.Add(entity);
+		}
+	});
+}
+
+void EntitySpatialIndex::QueryNearest(glm::vec3 const& center, uint32_t count, float maxDistance, ComponentFilter const& filter, Array<EntityHandle>& results)
+{
+	Update();
+	if (world_ == nullptr || count == 0) {
+		return;
+	}
+
+	struct Candidate
+	{
+		float DistanceSq;
+		EntityHandle Entity;
+	};
+
+	Vector<Candidate> candidates;
+	auto radius = std::min(CellSize, maxDistance);
+
+	// Grow the search radius until enough matches are found; every match inside the radius
+	// is closer than any entity outside of it, so the closest matches within the radius are final.
+	for (;;) {
+		auto range = MakeRange(center - glm::vec3(radius), center + glm::vec3(radius));
+		// The range covers more cells than are populated, so VisitCells() will scan every entity anyway
+		auto visitsAll = range.GetCellCount() > (int64_t)cells_.size();
+		auto radiusSq = visitsAll ? maxDistance * maxDistance : radius * radius;
+
+		candidates.clear();
+		VisitCells(range, [&](EntityHandle entity, EntityEntry const& entry) {
+			auto delta = entry.Position - center;
+			auto distanceSq = glm::dot(delta, delta);
+			if (distanceSq <= radiusSq && MatchesFilter(*world_, entity, filter)) {
+				candidates.push_back(Candidate{ distanceSq, entity });
+			}
+		});
+
+		if (candidates.size() >= count || radius >= maxDistance || visitsAll) {
+			break;
+		}
+
+		radius = std::min(radius * 2.0f, maxDistance);
+	}
+
+	auto numResults = std::min((std::size_t)count, candidates.size());
+	std::partial_sort(candidates.begin(), candidates.begin() + numResults, candidates.end(), [](Candidate const& a, Candidate const& b) {
+		return a.DistanceSq < b.DistanceSq;
+	});
+
+	for (std::size_t i = 0; i < numResults; i++) {
+		results.Add(candidates[i].Entity);
+	}
+}
+
+END_NS()
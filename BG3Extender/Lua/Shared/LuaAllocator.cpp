@@ -0,0 +1,291 @@
+#include <stdafx.h>
+#include <Lua/Shared/LuaAllocator.h>
+
+BEGIN_NS(lua)
+
+LuaAllocator::LuaAllocator()
+{
+	for (unsigned i = 0; i < NumSizeClasses; i++) {
+		classes_[i].BlockSize = GetSizeClassSize(i);
+	}
+}
+
+LuaAllocator::~LuaAllocator()
+{
+	// lua_close() returns every block to the allocator before we get here,
+	// so only the slabs themselves need to be released.
+	for (auto slab : slabs_) {
+		GameFree(slab);
+	}
+}
+
+// Size classes: 16-128 bytes in 16-byte steps, 160-256 in 32-byte steps, 320-512 in 64-byte steps
+unsigned LuaAllocator::GetSizeClass(std::size_t size)
+{
+	if (size <= 128) {
+		return (unsigned)((size + 15) / 16) - 1;
+	} else if (size <= 256) {
+		return 8 + (unsigned)((size - 128 + 31) / 32) - 1;
+	} else {
+		return 12 + (unsigned)((size - 256 + 63) / 64) - 1;
+	}
+}
+
+std::size_t LuaAllocator::GetSizeClassSize(unsigned sizeClass)
+{
+	if (sizeClass < 8) {
+		return (sizeClass + 1) * 16;
+	} else if (sizeClass < 12) {
+		return 128 + (sizeClass - 7) * 32;
+	} else {
+		return 256 + (sizeClass - 11) * 64;
+	}
+}
+
+LuaAllocator::Slab* LuaAllocator::AllocateSlab(unsigned sizeClass)
+{
+	auto slab = reinterpret_cast<Slab*>(GameAllocRaw(SlabSize));
+	if (slab == nullptr) {
+		return nullptr;
+	}
+
+	auto base = reinterpret_cast<uint8_t*>(slab);
+	auto blockSize = classes_[sizeClass].BlockSize;
+	slab->FreeList = nullptr;
+	slab->Pos = base + SlabHeaderSize;
+	slab->End = slab->Pos + ((SlabSize - SlabHeaderSize) / blockSize) * blockSize;
+	slab->PrevAvailable = nullptr;
+	slab->NextAvailable = nullptr;
+	slab->LiveBlocks = 0;
+	slab->SizeClass = sizeClass;
+	slab->Available = false;
+
+	auto first = slabs_.raw_buf();
+	auto index = (uint32_t)(std::upper_bound(first, first + slabs_.size(), slab) - first);
+	slabs_.push_back(slab);
+	for (auto i = slabs_.size() - 1; i > index; i--) {
+		slabs_[i] = slabs_[i - 1];
+	}
+	slabs_[index] = slab;
+
+	stats_.SlabBytes += SlabSize;
+	MakeAvailable(slab);
+	return slab;
+}
+
+void LuaAllocator::ReleaseSlab(Slab* slab)
+{
+	MakeUnavailable(slab);
+
+	auto first = slabs_.raw_buf();
+	auto pos = std::lower_bound(first, first + slabs_.size(), slab);
+	assert(pos != first + slabs_.size() && *pos == slab);
+	slabs_.remove_at((uint32_t)(pos - first));
+
+	stats_.SlabBytes -= SlabSize;
+	stats_.ReleasedSlabs++;
+	GameFree(slab);
+}
+
+LuaAllocator::Slab* LuaAllocator::FindSlab(void* ptr) const
+{
+	auto block = reinterpret_cast<uint8_t*>(ptr);
+	auto first = slabs_.raw_buf();
+	auto pos = std::upper_bound(first, first + slabs_.size(), block, [](uint8_t* p, Slab* slab) {
+		return p < reinterpret_cast<uint8_t*>(slab);
+	});
+	if (pos == first) {
+		return nullptr;
+	}
+
+	auto slab = *(pos - 1);
+	auto blocks = reinterpret_cast<uint8_t*>(slab) + SlabHeaderSize;
+	if (block < blocks 
+		|| block >= slab->Pos
+		|| (std::size_t)(block - blocks) % classes_[slab->SizeClass].BlockSize != 0) {
+		return nullptr;
+	}
+
+	return slab;
+}
+
+// Returns the slab that owns the block, or null for large blocks. The size class of the block is
+// determined by its slab, so a wrong size passed by the caller cannot corrupt another size class.
+LuaAllocator::Slab* LuaAllocator::FindSlabChecked(void* ptr, std::size_t size)
+{
+	auto slab = FindSlab(ptr);
+	bool matches = (slab == nullptr)
+		? size > MaxSmallSize
+		: size <= MaxSmallSize && GetSizeClass(size) == slab->SizeClass;
+	if (!matches) {
+		stats_.MismatchedFrees++;
+		ERR("Lua block %p freed with size %d that doesn't match its size class", ptr, (uint32_t)size);
+	}
+
+	return slab;
+}
+
+void LuaAllocator::MakeAvailable(Slab* slab)
+{
+	auto& cls = classes_[slab->SizeClass];
+	slab->Available = true;
+	slab->PrevAvailable = nullptr;
+	slab->NextAvailable = cls.Available;
+	if (cls.Available != nullptr) {
+		cls.Available->PrevAvailable = slab;
+	}
+	cls.Available = slab;
+}
+
+void LuaAllocator::MakeUnavailable(Slab* slab)
+{
+	if (!slab->Available) return;
+
+	auto& cls = classes_[slab->SizeClass];
+	if (slab->PrevAvailable != nullptr) {
+		slab->PrevAvailable->NextAvailable = slab->NextAvailable;
+	} else {
+		cls.Available = slab->NextAvailable;
+	}
+
+	if (slab->NextAvailable != nullptr) {
+		slab->NextAvailable->PrevAvailable = slab->PrevAvailable;
+	}
+
+	slab->Available = false;
+	slab->PrevAvailable = nullptr;
+	slab->NextAvailable = nullptr;
+}
+
+void* LuaAllocator::Allocate(std::size_t size)
+{
+	void* block;
+	SizeClassStats* classStats;
+
+	if (size > MaxSmallSize) {
+		block = GameAllocRaw(size);
+		classStats = &stats_.Large;
+	} else {
+		auto sizeClass = GetSizeClass(size);
+		auto& cls = classes_[sizeClass];
+		auto slab = cls.Available;
+		if (slab == nullptr) {
+			slab = AllocateSlab(sizeClass);
+		}
+
+		if (slab == nullptr) {
+			block = nullptr;
+		} else {
+			if (slab->FreeList != nullptr) {
+				block = slab->FreeList;
+				slab->FreeList = slab->FreeList->Next;
+			} else {
+				block = slab->Pos;
+				slab->Pos += cls.BlockSize;
+			}
+
+			slab->LiveBlocks++;
+			if (slab->FreeList == nullptr && slab->Pos == slab->End) {
+				MakeUnavailable(slab);
+			}
+		}
+
+		classStats = &stats_.SizeClasses[sizeClass];
+	}
+
+	if (block != nullptr) {
+		stats_.Allocations++;
+		stats_.BytesLive += size;
+		stats_.BytesAllocated += size;
+		classStats->Allocations++;
+		classStats->LiveBlocks++;
+	}
+
+	return block;
+}
+
+void LuaAllocator::Free(void* ptr, std::size_t size, Slab* slab)
+{
+	stats_.Frees++;
+	stats_.BytesLive -= size;
+
+	if (slab == nullptr) {
+		if (size > MaxSmallSize) {
+			stats_.Large.LiveBlocks--;
+			GameFree(ptr);
+		}
+		// Otherwise the block wasn't allocated by us; leaking it is safer than freeing it
+		return;
+	}
+
+	auto block = reinterpret_cast<FreeBlock*>(ptr);
+	block->Next = slab->FreeList;
+	slab->FreeList = block;
+	slab->LiveBlocks--;
+	stats_.SizeClasses[slab->SizeClass].LiveBlocks--;
+
+	if (slab->LiveBlocks == 0) {
+		// Keep the last available slab of the class to avoid reallocating it when the class
+		// repeatedly goes from zero to one live block
+		auto& cls = classes_[slab->SizeClass];
+		bool hasOtherSlab = slab->Available
+			? (cls.Available != slab || slab->NextAvailable != nullptr)
+			: cls.Available != nullptr;
+		if (hasOtherSlab) {
+			ReleaseSlab(slab);
+			return;
+		}
+	}
+
+	if (!slab->Available) {
+		MakeAvailable(slab);
+	}
+}
+
+void* LuaAllocator::Realloc(void* ptr, std::size_t osize, std::size_t nsize)
+{
+	// When ptr is null, osize holds the type of the object being allocated, not a size
+	if (ptr == nullptr) {
+		return nsize ? Allocate(nsize) : nullptr;
+	}
+
+	auto slab = FindSlabChecked(ptr, osize);
+	if (nsize == 0) {
+		Free(ptr, osize, slab);
+		return nullptr;
+	}
+
+	stats_.Reallocations++;
+
+	// Lua always passes the size of the last allocation/reallocation as osize, so a block that
+	// stays in its size class (or a large block that shrinks moderately) can be reused as-is.
+	// The size class is taken from the owning slab, not from osize.
+	bool inPlace;
+	if (slab != nullptr) {
+		inPlace = nsize <= MaxSmallSize && GetSizeClass(nsize) == slab->SizeClass;
+	} else {
+		inPlace = osize > MaxSmallSize && nsize > MaxSmallSize && nsize <= osize && nsize >= osize / 2;
+	}
+
+	if (inPlace) {
+		stats_.InPlaceReallocations++;
+		stats_.BytesLive += nsize;
+		stats_.BytesLive -= osize;
+		if (nsize > osize) {
+			stats_.BytesAllocated += nsize - osize;
+		}
+		return ptr;
+	}
+
+	auto newPtr = Allocate(nsize);
+	// On failure Lua expects the original block to be left untouched
+	if (newPtr != nullptr) {
+		auto blockSize = slab != nullptr ? classes_[slab->SizeClass].BlockSize : osize;
+		memcpy(newPtr, ptr, std::min({ osize, nsize, blockSize }));
+		Free(ptr, osize, slab);
+	}
+
+	return newPtr;
+}
+
+END_NS()
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <GameDefinitions/Base/Base.h>
+#include <array>
+
+BEGIN_NS(lua)
+
+// Size-class slab allocator for Lua VM allocations.
+// Small blocks are carved out of slabs obtained from the game allocator; each slab holds blocks
+// of a single size class and keeps its own free list, so slabs whose blocks were all freed can be
+// returned to the game allocator. Reallocations that stay within the same size class are done in place.
+// A Lua state is only ever accessed by one thread at a time, so each state owns its allocator
+// and the free lists need no locking.
+class LuaAllocator : Noncopyable<LuaAllocator>
+{
+public:
+	static constexpr unsigned NumSizeClasses = 16;
+	static constexpr std::size_t MaxSmallSize = 512;
+	static constexpr std::size_t SlabSize = 0x10000;
+
+	struct SizeClassStats
+	{
+		uint64_t Allocations{ 0 };
+		uint64_t LiveBlocks{ 0 };
+	};
+
+	struct Stats
+	{
+		// Bytes currently allocated by Lua (as requested, without size class rounding)
+		std::size_t BytesLive{ 0 };
+		// Total number of bytes allocated since the state was created; used for measuring the allocation rate
+		uint64_t BytesAllocated{ 0 };
+		// Bytes reserved for slabs
+		std::size_t SlabBytes{ 0 };
+		// Number of empty slabs returned to the game allocator
+		uint64_t ReleasedSlabs{ 0 };
+		// Frees/reallocations where the size passed by Lua doesn't match the block
+		uint64_t MismatchedFrees{ 0 };
+		uint64_t Allocations{ 0 };
+		uint64_t Frees{ 0 };
+		uint64_t Reallocations{ 0 };
+		uint64_t InPlaceReallocations{ 0 };
+		std::array<SizeClassStats, NumSizeClasses> SizeClasses;
+		// Blocks above MaxSmallSize that are passed directly to the game allocator
+		SizeClassStats Large;
+	};
+
+	LuaAllocator();
+	~LuaAllocator();
+
+	void* Realloc(void* ptr, std::size_t osize, std::size_t nsize);
+
+	inline Stats const& GetStats() const
+	{
+		return stats_;
+	}
+
+	static std::size_t GetSizeClassSize(unsigned sizeClass);
+
+private:
+	struct FreeBlock
+	{
+		FreeBlock* Next;
+	};
+
+	// Placed at the beginning of each slab
+	struct Slab
+	{
+		FreeBlock* FreeList;
+		// Blocks past Pos were never allocated
+		uint8_t* Pos;
+		uint8_t* End;
+		Slab* PrevAvailable;
+		Slab* NextAvailable;
+		uint32_t LiveBlocks;
+		uint32_t SizeClass;
+		bool Available;
+	};
+
+	static constexpr std::size_t SlabHeaderSize = (sizeof(Slab) + 15) & ~(std::size_t)15;
+
+	struct SizeClass
+	{
+		// Slabs that have at least one free block
+		Slab* Available{ nullptr };
+		std::size_t BlockSize{ 0 };
+	};
+
+	std::array<SizeClass, NumSizeClasses> classes_;
+	// Sorted by address, for finding the slab that owns a block
+	Array<Slab*> slabs_;
+	Stats stats_;
+
+	void* Allocate(std::size_t size);
+	void Free(void* ptr, std::size_t size, Slab* slab);
+	Slab* AllocateSlab(unsigned sizeClass);
+	void ReleaseSlab(Slab* slab);
+	Slab* FindSlab(void* ptr) const;
+	Slab* FindSlabChecked(void* ptr, std::size_t size);
+	void MakeAvailable(Slab* slab);
+	void MakeUnavailable(Slab* slab);
+
+	static unsigned GetSizeClass(std::size_t size);
+};
+
+END_NS()
@@ -0,0 +1,38 @@
+#pragma once
+
+BEGIN_NS(lua::binary)
+
+// Compact tagged encoding of Lua values, used for storing and syncing composite user variables.
+// Values are encoded using the MessagePack format (https://msgpack.org/), prefixed with a two-byte
+// header (FormatTag, FormatVersion) that tells encoded values apart from the JSON text used previously.
+// Unlike JSON, the encoding keeps the distinction between integers and floats, supports
+// non-string table keys and preserves strings byte-by-byte.
+// Tables with consecutive integer keys 1..N are encoded as arrays, all other tables as maps.
+// Integer keys of sparse tables therefore read back as integers, while values stored as JSON
+// (older savegames and peers) still return them as strings, as JSON object keys are always strings.
+
+// "Never used" tag in MessagePack; can't be the first byte of JSON or UTF-8 text
+static constexpr uint8_t FormatTag = 0xC1;
+static constexpr uint8_t FormatVersion = 1;
+static constexpr unsigned MaxDepth = 64;
+
+bool IsBinaryEncoded(StringView data);
+
+// Encodes the value at the specified stack index.
+// Throws std::runtime_error if the value contains types that can't be encoded (functions, userdata, etc.)
+void Encode(lua_State* L, int index, STDString& out);
+// Pushes the decoded value on success; leaves the stack untouched on failure
+bool Decode(lua_State* L, StringView data, STDString& error);
+
+// Converts an encoded value to JSON without going through a Lua state;
+// used for syncing values to peers that don't support the binary encoding
+bool ToJson(StringView data, STDString& json);
+
+// Base64 representation of an encoded value, for places that can only store text (i.e. savegame strings)
+STDString ToText(StringView data);
+bool FromText(StringView text, STDString& data);
+// Checks whether the string was produced by ToText(); base64 text of the format header starts with "wQ",
+// which is never valid JSON
+bool IsTextEncoded(StringView text);
+
+END_NS()
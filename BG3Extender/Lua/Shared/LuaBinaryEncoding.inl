@@ -0,0 +1,902 @@
+#include <Lua/Shared/LuaBinaryEncoding.h>
+#include <charconv>
+
+BEGIN_NS(lua::binary)
+
+// MessagePack type tags
+enum class Tag : uint8_t
+{
+	PositiveFixInt = 0x00,
+	FixMap = 0x80,
+	FixArray = 0x90,
+	FixStr = 0xA0,
+	Nil = 0xC0,
+	False = 0xC2,
+	True = 0xC3,
+	Bin8 = 0xC4,
+	Bin16 = 0xC5,
+	Bin32 = 0xC6,
+	Float32 = 0xCA,
+	Float64 = 0xCB,
+	UInt8 = 0xCC,
+	UInt16 = 0xCD,
+	UInt32 = 0xCE,
+	UInt64 = 0xCF,
+	Int8 = 0xD0,
+	Int16 = 0xD1,
+	Int32 = 0xD2,
+	Int64 = 0xD3,
+	Str8 = 0xD9,
+	Str16 = 0xDA,
+	Str32 = 0xDB,
+	Array16 = 0xDC,
+	Array32 = 0xDD,
+	Map16 = 0xDE,
+	Map32 = 0xDF,
+	NegativeFixInt = 0xE0
+};
+
+bool IsBinaryEncoded(StringView data)
+{
+	return data.size() >= 2 && (uint8_t)data[0] == FormatTag;
+}
+
+// Serializes Lua values directly into the output buffer.
+// Accepts the same values as Ext.Json.Stringify() with the default options: enum and bitfield values
+// are written as their labels, other userdata, functions and threads are rejected.
+class BinaryWriter
+{
+public:
+	BinaryWriter(lua_State* L, STDString& out)
+		: L_(L), out_(out)
+	{}
+
+	void WriteHeader()
+	{
+		out_ += (char)FormatTag;
+		out_ += (char)FormatVersion;
+	}
+
+	void Write(int index, unsigned depth)
+	{
+		if (depth > MaxDepth) {
+			throw std::runtime_error("Recursion depth exceeded while encoding value");
+		}
+
+		index = lua_absindex(L_, index);
+
+		switch (lua_type(L_, index)) {
+		case LUA_TNIL:
+			WriteTag(Tag::Nil);
+			break;
+
+		case LUA_TBOOLEAN:
+			WriteTag(lua_toboolean(L_, index) ? Tag::True : Tag::False);
+			break;
+
+		case LUA_TNUMBER:
+			if (lua_isinteger(L_, index)) {
+				WriteInteger(lua_tointeger(L_, index));
+			} else {
+				WriteDouble(lua_tonumber(L_, index));
+			}
+			break;
+
+		case LUA_TSTRING:
+		{
+			size_t len;
+			auto str = lua_tolstring(L_, index, &len);
+			WriteString(str, len);
+			break;
+		}
+
+		case LUA_TTABLE:
+			WriteTable(index, depth);
+			break;
+
+		case LUA_TUSERDATA:
+		case LUA_TLIGHTCPPOBJECT:
+		case LUA_TCPPOBJECT:
+			WriteUserdata(index);
+			break;
+
+		default:
+			throw std::runtime_error("Attempted to encode a lightuserdata, userdata, function or thread value");
+		}
+	}
+
+private:
+	lua_State* L_;
+	STDString& out_;
+
+	void WriteTag(Tag tag)
+	{
+		out_ += (char)tag;
+	}
+
+	// MessagePack stores multi-byte values in big-endian order
+	void WriteBE(uint8_t v)
+	{
+		out_ += (char)v;
+	}
+
+	void WriteBE(uint16_t v)
+	{
+		v = _byteswap_ushort(v);
+		out_.append(reinterpret_cast<char const*>(&v), sizeof(v));
+	}
+
+	void WriteBE(uint32_t v)
+	{
+		v = _byteswap_ulong(v);
+		out_.append(reinterpret_cast<char const*>(&v), sizeof(v));
+	}
+
+	void WriteBE(uint64_t v)
+	{
+		v = _byteswap_uint64(v);
+		out_.append(reinterpret_cast<char const*>(&v), sizeof(v));
+	}
+
+	void WriteInteger(int64_t v)
+	{
+		if (v >= 0) {
+			if (v < 0x80) {
+				out_ += (char)v;
+			} else if (v <= 0xFF) {
+				WriteTag(Tag::UInt8);
+				WriteBE((uint8_t)v);
+			} else if (v <= 0xFFFF) {
+				WriteTag(Tag::UInt16);
+				WriteBE((uint16_t)v);
+			} else if (v <= 0xFFFFFFFFll) {
+				WriteTag(Tag::UInt32);
+				WriteBE((uint32_t)v);
+			} else {
+				WriteTag(Tag::UInt64);
+				WriteBE((uint64_t)v);
+			}
+		} else {
+			if (v >= -32) {
+				out_ += (char)(int8_t)v;
+			} else if (v >= INT8_MIN) {
+				WriteTag(Tag::Int8);
+				WriteBE((uint8_t)(int8_t)v);
+			} else if (v >= INT16_MIN) {
+				WriteTag(Tag::Int16);
+				WriteBE((uint16_t)(int16_t)v);
+			} else if (v >= INT32_MIN) {
+				WriteTag(Tag::Int32);
+				WriteBE((uint32_t)(int32_t)v);
+			} else {
+				WriteTag(Tag::Int64);
+				WriteBE((uint64_t)v);
+			}
+		}
+	}
+
+	void WriteDouble(double v)
+	{
+		// Most game values (positions, multipliers, etc.) come from floats and can be stored losslessly in 4 bytes
+		auto f = (float)v;
+		if ((double)f == v) {
+			WriteTag(Tag::Float32);
+			WriteBE(std::bit_cast<uint32_t>(f));
+		} else {
+			WriteTag(Tag::Float64);
+			WriteBE(std::bit_cast<uint64_t>(v));
+		}
+	}
+
+	void WriteString(char const* str, std::size_t len)
+	{
+		if (len < 32) {
+			out_ += (char)((uint8_t)Tag::FixStr | (uint8_t)len);
+		} else if (len <= 0xFF) {
+			WriteTag(Tag::Str8);
+			WriteBE((uint8_t)len);
+		} else if (len <= 0xFFFF) {
+			WriteTag(Tag::Str16);
+			WriteBE((uint16_t)len);
+		} else {
+			WriteTag(Tag::Str32);
+			WriteBE((uint32_t)len);
+		}
+
+		out_.append(str, len);
+	}
+
+	void WriteArrayHeader(std::size_t size)
+	{
+		if (size < 16) {
+			out_ += (char)((uint8_t)Tag::FixArray | (uint8_t)size);
+		} else if (size <= 0xFFFF) {
+			WriteTag(Tag::Array16);
+			WriteBE((uint16_t)size);
+		} else {
+			WriteTag(Tag::Array32);
+			WriteBE((uint32_t)size);
+		}
+	}
+
+	void WriteMapHeader(std::size_t size)
+	{
+		if (size < 16) {
+			out_ += (char)((uint8_t)Tag::FixMap | (uint8_t)size);
+		} else if (size <= 0xFFFF) {
+			WriteTag(Tag::Map16);
+			WriteBE((uint16_t)size);
+		} else {
+			WriteTag(Tag::Map32);
+			WriteBE((uint32_t)size);
+		}
+	}
+
+	void WriteKey(int index)
+	{
+		switch (lua_type(L_, index)) {
+		case LUA_TSTRING:
+		case LUA_TNUMBER:
+		case LUA_TBOOLEAN:
+			Write(index, 0);
+			break;
+
+		default:
+			throw std::runtime_error("Can only encode string, number or boolean table keys");
+		}
+	}
+
+	void WriteTable(int index, unsigned depth)
+	{
+		luaL_checkstack(L_, 4, "Encoding stack exhausted");
+
+		// Count the entries and check whether the keys are exactly 1..N
+		auto length = lua_rawlen(L_, index);
+		std::size_t entries{ 0 };
+		bool isArray{ true };
+		lua_pushnil(L_);
+		while (lua_next(L_, index) != 0) {
+			entries++;
+			if (isArray) {
+				if (!lua_isinteger(L_, -2)) {
+					isArray = false;
+				} else {
+					auto key = lua_tointeger(L_, -2);
+					isArray = key >= 1 && (std::size_t)key <= length;
+				}
+			}
+			lua_pop(L_, 1);
+		}
+
+		if (isArray && entries == length) {
+			WriteArrayHeader(length);
+			for (std::size_t i = 1; i <= length; i++) {
+				lua_rawgeti(L_, index, (lua_Integer)i);
+				Write(-1, depth + 1);
+				lua_pop(L_, 1);
+			}
+		} else {
+			WriteMapHeader(entries);
+			lua_pushnil(L_);
+			while (lua_next(L_, index) != 0) {
+				WriteKey(-2);
+				Write(-1, depth + 1);
+				lua_pop(L_, 1);
+			}
+		}
+	}
+
+	void WriteJsonValue(Json::Value const& value)
+	{
+		switch (value.type()) {
+		case Json::intValue:
+			WriteInteger(value.asInt64());
+			break;
+
+		case Json::uintValue:
+			WriteInteger((int64_t)value.asUInt64());
+			break;
+
+		case Json::realValue:
+			WriteDouble(value.asDouble());
+			break;
+
+		case Json::stringValue:
+		{
+			char const* begin;
+			char const* end;
+			value.getString(&begin, &end);
+			WriteString(begin, end - begin);
+			break;
+		}
+
+		case Json::booleanValue:
+			WriteTag(value.asBool() ? Tag::True : Tag::False);
+			break;
+
+		case Json::arrayValue:
+			WriteArrayHeader(value.size());
+			for (auto const& child : value) {
+				WriteJsonValue(child);
+			}
+			break;
+
+		case Json::objectValue:
+			WriteMapHeader(value.size());
+			for (auto it = value.begin(), end = value.end(); it != end; ++it) {
+				auto name = it.name();
+				WriteString(name.data(), name.size());
+				WriteJsonValue(*it);
+			}
+			break;
+
+		case Json::nullValue:
+		default:
+			WriteTag(Tag::Nil);
+			break;
+		}
+	}
+
+	void WriteUserdata(int index)
+	{
+		CppValueMetadata meta;
+		if (lua_try_get_cppvalue(L_, index, EnumValueMetatable::MetaTag, meta)) {
+			auto label = EnumValueMetatable::GetLabel(meta);
+			WriteString(label.GetString(), label.GetLength());
+			return;
+		}
+
+		if (lua_try_get_cppvalue(L_, index, BitfieldValueMetatable::MetaTag, meta)) {
+			WriteJsonValue(BitfieldValueMetatable::ToJson(meta));
+			return;
+		}
+
+		throw std::runtime_error("Attempted to encode a lightuserdata, userdata, function or thread value");
+	}
+};
+
+// Bounds-checked cursor over an encoded value; shared by the Lua decoder and the JSON transcoder
+class BinaryCursor
+{
+public:
+	BinaryCursor(StringView data)
+		: cur_(reinterpret_cast<uint8_t const*>(data.data())), end_(cur_ + data.size())
+	{}
+
+	bool SkipHeader()
+	{
+		if (Remaining() < 2 || cur_[0] != FormatTag) {
+			return Fail("Missing format header");
+		}
+
+		if (cur_[1] != FormatVersion) {
+			return Fail("Unsupported format version");
+		}
+
+		cur_ += 2;
+		return true;
+	}
+
+	inline std::size_t Remaining() const
+	{
+		return end_ - cur_;
+	}
+
+	inline bool AtEnd() const
+	{
+		return cur_ == end_;
+	}
+
+	inline char const* GetError() const
+	{
+		return error_;
+	}
+
+	bool Fail(char const* msg)
+	{
+		if (error_ == nullptr) {
+			error_ = msg;
+		}
+		return false;
+	}
+
+	bool ReadByte(uint8_t& v)
+	{
+		if (cur_ == end_) return Fail("Unexpected end of data");
+		v = *cur_++;
+		return true;
+	}
+
+	template <class T>
+	bool ReadBE(T& v)
+	{
+		if (Remaining() < sizeof(T)) return Fail("Unexpected end of data");
+		memcpy(&v, cur_, sizeof(T));
+		cur_ += sizeof(T);
+		if constexpr (sizeof(T) == 2) {
+			v = (T)_byteswap_ushort((uint16_t)v);
+		} else if constexpr (sizeof(T) == 4) {
+			v = (T)_byteswap_ulong((uint32_t)v);
+		} else if constexpr (sizeof(T) == 8) {
+			v = (T)_byteswap_uint64((uint64_t)v);
+		}
+		return true;
+	}
+
+	bool ReadBytes(std::size_t len, char const*& str)
+	{
+		if (Remaining() < len) return Fail("Unexpected end of data");
+		str = reinterpret_cast<char const*>(cur_);
+		cur_ += len;
+		return true;
+	}
+
+	// Reads the length of a container; each element takes at least one byte, so larger counts are invalid
+	bool CheckContainerSize(uint32_t size, uint32_t elementsPerEntry)
+	{
+		if ((uint64_t)size * elementsPerEntry > Remaining()) {
+			return Fail("Container size exceeds data size");
+		}
+		return true;
+	}
+
+	template <class T>
+	bool ReadLength(uint32_t& len)
+	{
+		T v;
+		if (!ReadBE(v)) return false;
+		len = (uint32_t)v;
+		return true;
+	}
+
+private:
+	uint8_t const* cur_;
+	uint8_t const* end_;
+	char const* error_{ nullptr };
+};
+
+// Visits the elements of an encoded value; the handler receives typed callbacks for each element.
+// Returns false if the data is malformed.
+template <class Handler>
+bool VisitValue(BinaryCursor& cursor, Handler& handler, unsigned depth)
+{
+	if (depth > MaxDepth) {
+		return cursor.Fail("Recursion depth exceeded");
+	}
+
+	uint8_t tag;
+	if (!cursor.ReadByte(tag)) return false;
+
+	if (tag < 0x80) {
+		return handler.OnInteger((int64_t)tag);
+	} else if (tag >= (uint8_t)Tag::NegativeFixInt) {
+		return handler.OnInteger((int64_t)(int8_t)tag);
+	}
+
+	uint32_t len{ 0 };
+	bool isMap{ false };
+	switch (tag & 0xF0) {
+	case (uint8_t)Tag::FixMap:
+		len = tag & 0x0F;
+		isMap = true;
+		goto container;
+
+	case (uint8_t)Tag::FixArray:
+		len = tag & 0x0F;
+		goto container;
+
+	case (uint8_t)Tag::FixStr:
+	case (uint8_t)Tag::FixStr + 0x10:
+		len = tag & 0x1F;
+		goto string;
+	}
+
+	switch ((Tag)tag) {
+	case Tag::Nil: return handler.OnNil();
+	case Tag::False: return handler.OnBool(false);
+	case Tag::True: return handler.OnBool(true);
+
+	case Tag::Float32:
+	{
+		uint32_t v;
+		return cursor.ReadBE(v) && handler.OnDouble((double)std::bit_cast<float>(v));
+	}
+
+	case Tag::Float64:
+	{
+		uint64_t v;
+		return cursor.ReadBE(v) && handler.OnDouble(std::bit_cast<double>(v));
+	}
+
+	case Tag::UInt8: { uint8_t v; return cursor.ReadBE(v) && handler.OnInteger((int64_t)v); }
+	case Tag::UInt16: { uint16_t v; return cursor.ReadBE(v) && handler.OnInteger((int64_t)v); }
+	case Tag::UInt32: { uint32_t v; return cursor.ReadBE(v) && handler.OnInteger((int64_t)v); }
+	// Lua integers are 64-bit signed; larger values wrap around like in Lua arithmetic
+	case Tag::UInt64: { uint64_t v; return cursor.ReadBE(v) && handler.OnInteger((int64_t)v); }
+	case Tag::Int8: { uint8_t v; return cursor.ReadBE(v) && handler.OnInteger((int64_t)(int8_t)v); }
+	case Tag::Int16: { uint16_t v; return cursor.ReadBE(v) && handler.OnInteger((int64_t)(int16_t)v); }
+	case Tag::Int32: { uint32_t v; return cursor.ReadBE(v) && handler.OnInteger((int64_t)(int32_t)v); }
+	case Tag::Int64: { uint64_t v; return cursor.ReadBE(v) && handler.OnInteger((int64_t)v); }
+
+	case Tag::Str8:
+	case Tag::Bin8:
+		if (!cursor.ReadLength<uint8_t>(len)) return false;
+		goto string;
+
+	case Tag::Str16:
+	case Tag::Bin16:
+		if (!cursor.ReadLength<uint16_t>(len)) return false;
+		goto string;
+
+	case Tag::Str32:
+	case Tag::Bin32:
+		if (!cursor.ReadLength<uint32_t>(len)) return false;
+		goto string;
+
+	case Tag::Array16:
+		if (!cursor.ReadLength<uint16_t>(len)) return false;
+		goto container;
+
+	case Tag::Array32:
+		if (!cursor.ReadLength<uint32_t>(len)) return false;
+		goto container;
+
+	case Tag::Map16:
+		isMap = true;
+		if (!cursor.ReadLength<uint16_t>(len)) return false;
+		goto container;
+
+	case Tag::Map32:
+		isMap = true;
+		if (!cursor.ReadLength<uint32_t>(len)) return false;
+		goto container;
+
+	default:
+		return cursor.Fail("Unsupported type tag");
+	}
+
+string:
+	{
+		char const* str;
+		return cursor.ReadBytes(len, str) && handler.OnString(str, len);
+	}
+
+container:
+	if (!cursor.CheckContainerSize(len, isMap ? 2 : 1)) return false;
+
+	if (isMap) {
+		if (!handler.OnBeginMap(len)) return false;
+		for (uint32_t i = 0; i < len; i++) {
+			if (!handler.OnBeginKey(i)) return false;
+			if (!VisitValue(cursor, handler, depth + 1)) return false;
+			if (!handler.OnBeginValue()) return false;
+			if (!VisitValue(cursor, handler, depth + 1)) return false;
+			if (!handler.OnEndMapEntry()) return false;
+		}
+		return handler.OnEndMap();
+	} else {
+		if (!handler.OnBeginArray(len)) return false;
+		for (uint32_t i = 0; i < len; i++) {
+			if (!handler.OnBeginElement(i)) return false;
+			if (!VisitValue(cursor, handler, depth + 1)) return false;
+			if (!handler.OnEndElement(i)) return false;
+		}
+		return handler.OnEndArray();
+	}
+}
+
+// Pushes decoded values to the Lua stack
+class LuaDecoder
+{
+public:
+	LuaDecoder(lua_State* L, BinaryCursor& cursor)
+		: L_(L), cursor_(cursor)
+	{}
+
+	bool OnNil() { return Push([this] { lua_pushnil(L_); }); }
+	bool OnBool(bool v) { return Push([=, this] { lua_pushboolean(L_, v ? 1 : 0); }); }
+	bool OnInteger(int64_t v) { return Push([=, this] { lua_pushinteger(L_, v); }); }
+	bool OnDouble(double v) { return Push([=, this] { lua_pushnumber(L_, v); }); }
+	bool OnString(char const* s, std::size_t len) { return Push([=, this] { lua_pushlstring(L_, s, len); }); }
+
+	bool OnBeginArray(uint32_t size)
+	{
+		return Push([=, this] { lua_createtable(L_, (int)size, 0); });
+	}
+
+	bool OnBeginElement(uint32_t) { return true; }
+
+	bool OnEndElement(uint32_t index)
+	{
+		lua_rawseti(L_, -2, (lua_Integer)index + 1);
+		return true;
+	}
+
+	bool OnEndArray() { return true; }
+
+	bool OnBeginMap(uint32_t size)
+	{
+		return Push([=, this] { lua_createtable(L_, 0, (int)size); });
+	}
+
+	bool OnBeginKey(uint32_t) { return true; }
+
+	bool OnBeginValue()
+	{
+		auto type = lua_type(L_, -1);
+		if (type == LUA_TNIL || type == LUA_TTABLE
+			|| (type == LUA_TNUMBER && !lua_isinteger(L_, -1) && std::isnan(lua_tonumber(L_, -1)))) {
+			return cursor_.Fail("Invalid table key");
+		}
+		return true;
+	}
+
+	bool OnEndMapEntry()
+	{
+		lua_rawset(L_, -3);
+		return true;
+	}
+
+	bool OnEndMap() { return true; }
+
+private:
+	lua_State* L_;
+	BinaryCursor& cursor_;
+
+	template <class Fun>
+	bool Push(Fun const& fun)
+	{
+		if (!lua_checkstack(L_, 3)) {
+			return cursor_.Fail("Decoding stack exhausted");
+		}
+
+		fun();
+		return true;
+	}
+};
+
+// Writes decoded values as JSON text that can be read back by Ext.Json.Parse() and older extender versions.
+// Non-string keys are written using their string representation, as with Ext.Json.Stringify().
+class JsonTranscoder
+{
+public:
+	JsonTranscoder(STDString& out, BinaryCursor& cursor)
+		: out_(out), cursor_(cursor)
+	{}
+
+	bool OnNil()
+	{
+		if (BeginScalar()) return cursor_.Fail("Invalid table key");
+		out_ += "null";
+		return true;
+	}
+
+	bool OnBool(bool v)
+	{
+		bool isKey = BeginScalar();
+		if (isKey) out_ += '"';
+		out_ += v ? "true" : "false";
+		if (isKey) out_ += '"';
+		return true;
+	}
+
+	bool OnInteger(int64_t v)
+	{
+		bool isKey = BeginScalar();
+		if (isKey) out_ += '"';
+		char buf[32];
+		auto result = std::to_chars(buf, buf + std::size(buf), v);
+		out_.append(buf, result.ptr);
+		if (isKey) out_ += '"';
+		return true;
+	}
+
+	bool OnDouble(double v)
+	{
+		bool isKey = BeginScalar();
+		if (isKey) out_ += '"';
+		if (std::isnan(v)) {
+			out_ += "null";
+		} else if (std::isinf(v)) {
+			out_ += (v < 0) ? "-1e+9999" : "1e+9999";
+		} else {
+			// Shortest representation that reads back to the same value
+			char buf[32];
+			auto result = std::to_chars(buf, buf + std::size(buf), v);
+			out_.append(buf, result.ptr);
+			// Make sure that the value is read back as a double
+			if (std::find_if(buf, result.ptr, [](char c) { return c == '.' || c == 'e'; }) == result.ptr) {
+				out_ += ".0";
+			}
+		}
+		if (isKey) out_ += '"';
+		return true;
+	}
+
+	bool OnString(char const* s, std::size_t len)
+	{
+		BeginScalar();
+		static constexpr char hex[] = "0123456789abcdef";
+		out_ += '"';
+		auto run = s;
+		auto end = s + len;
+		for (auto p = s; p < end; ++p) {
+			auto c = (unsigned char)*p;
+			if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+			out_.append(run, p);
+			switch (c) {
+			case '"': out_ += "\\\""; break;
+			case '\\': out_ += "\\\\"; break;
+			case '\n': out_ += "\\n"; break;
+			case '\r': out_ += "\\r"; break;
+			case '\t': out_ += "\\t"; break;
+			default:
+			{
+				char buf[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf] };
+				out_.append(buf, 6);
+				break;
+			}
+			}
+			run = p + 1;
+		}
+		out_.append(run, end);
+		out_ += '"';
+		return true;
+	}
+
+	bool OnBeginArray(uint32_t)
+	{
+		if (BeginScalar()) return cursor_.Fail("Invalid table key");
+		out_ += '[';
+		return true;
+	}
+
+	bool OnBeginElement(uint32_t index) { if (index > 0) out_ += ','; return true; }
+	bool OnEndElement(uint32_t) { return true; }
+	bool OnEndArray() { out_ += ']'; return true; }
+
+	bool OnBeginMap(uint32_t)
+	{
+		if (BeginScalar()) return cursor_.Fail("Invalid table key");
+		out_ += '{';
+		return true;
+	}
+
+	bool OnBeginKey(uint32_t index)
+	{
+		if (index > 0) out_ += ',';
+		inKey_ = true;
+		return true;
+	}
+
+	bool OnBeginValue() { out_ += ':'; return true; }
+	bool OnEndMapEntry() { return true; }
+	bool OnEndMap() { out_ += '}'; return true; }
+
+private:
+	STDString& out_;
+	BinaryCursor& cursor_;
+	bool inKey_{ false };
+
+	// Returns whether the value being written is an object key
+	bool BeginScalar()
+	{
+		auto isKey = inKey_;
+		inKey_ = false;
+		return isKey;
+	}
+};
+
+void Encode(lua_State* L, int index, STDString& out)
+{
+	StackCheck _(L);
+	out.clear();
+	BinaryWriter writer(L, out);
+	writer.WriteHeader();
+	writer.Write(index, 0);
+}
+
+bool Decode(lua_State* L, StringView data, STDString& error)
+{
+	auto top = lua_gettop(L);
+	BinaryCursor cursor(data);
+	LuaDecoder decoder(L, cursor);
+	if (cursor.SkipHeader() && VisitValue(cursor, decoder, 0)) {
+		if (cursor.AtEnd()) {
+			return true;
+		}
+
+		cursor.Fail("Trailing data after value");
+	}
+
+	lua_settop(L, top);
+	error = cursor.GetError();
+	return false;
+}
+
+bool ToJson(StringView data, STDString& json)
+{
+	json.clear();
+	BinaryCursor cursor(data);
+	JsonTranscoder transcoder(json, cursor);
+	return cursor.SkipHeader()
+		&& VisitValue(cursor, transcoder, 0)
+		&& cursor.AtEnd();
+}
+
+static constexpr char Base64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+STDString ToText(StringView data)
+{
+	STDString text;
+	text.reserve((data.size() + 2) / 3 * 4);
+
+	auto src = reinterpret_cast<uint8_t const*>(data.data());
+	std::size_t i = 0;
+	for (; i + 3 <= data.size(); i += 3) {
+		uint32_t v = (src[i] << 16) | (src[i + 1] << 8) | src[i + 2];
+		text += Base64Alphabet[(v >> 18) & 0x3F];
+		text += Base64Alphabet[(v >> 12) & 0x3F];
+		text += Base64Alphabet[(v >> 6) & 0x3F];
+		text += Base64Alphabet[v & 0x3F];
+	}
+
+	auto rem = data.size() - i;
+	if (rem > 0) {
+		uint32_t v = src[i] << 16;
+		if (rem > 1) v |= src[i + 1] << 8;
+		text += Base64Alphabet[(v >> 18) & 0x3F];
+		text += Base64Alphabet[(v >> 12) & 0x3F];
+		text += (rem > 1) ? Base64Alphabet[(v >> 6) & 0x3F] : '=';
+		text += '=';
+	}
+
+	return text;
+}
+
+bool FromText(StringView text, STDString& data)
+{
+	static constexpr auto DecodeTable = [] {
+		std::array<int8_t, 256> table{};
+		table.fill(-1);
+		for (int i = 0; i < 64; i++) {
+			table[(uint8_t)Base64Alphabet[i]] = (int8_t)i;
+		}
+		return table;
+	}();
+
+	if (text.size() % 4 != 0) {
+		return false;
+	}
+
+	data.clear();
+	data.reserve(text.size() / 4 * 3);
+
+	for (std::size_t i = 0; i < text.size(); i += 4) {
+		auto a = DecodeTable[(uint8_t)text[i]];
+		auto b = DecodeTable[(uint8_t)text[i + 1]];
+		auto c = DecodeTable[(uint8_t)text[i + 2]];
+		auto d = DecodeTable[(uint8_t)text[i + 3]];
+		bool last = (i + 4 == text.size());
+		if (a < 0 || b < 0
+			|| (c < 0 && !(last && text[i + 2] == '=' && text[i + 3] == '='))
+			|| (d < 0 && !(last && text[i + 3] == '='))) {
+			return false;
+		}
+
+		uint32_t v = (a << 18) | (b << 12) | ((c < 0 ? 0 : c) << 6) | (d < 0 ? 0 : d);
+		data += (char)(v >> 16);
+		if (c >= 0) data += (char)((v >> 8) & 0xFF);
+		if (d >= 0) data += (char)(v & 0xFF);
+	}
+
+	return true;
+}
+
+bool IsTextEncoded(StringView text)
+{
+	return text.size() >= 4 && text[0] == 'w' && text[1] == 'Q';
+}
+
+END_NS()
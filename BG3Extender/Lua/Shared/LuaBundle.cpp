@@ -1,5 +1,6 @@
 #include <stdafx.h>
 #include <Lua/Shared/LuaBundle.h>
+#include <compressapi.h>
 #include <filesystem>
 
 BEGIN_NS(lua)
@@ -11,25 +12,107 @@ void LuaBundle::SetResourcePath(std::wstring const& path)
 
 bool LuaBundle::LoadBuiltinResource(int resourceId)
 {
-	auto res = GetExeResource(resourceId);
+	auto res = GetExeResourceView(resourceId);
 	if (res) {
-		LoadBuffer(std::span((uint8_t*)res->data(), res->size()));
-		return true;
+		return LoadBuffer(*res);
 	} else {
 		return false;
 	}
 }
 
-void LuaBundle::LoadBuffer(std::span<uint8_t> const& buf)
+bool LuaBundle::LoadBuffer(std::span<uint8_t const> const& buf)
 {
-	std::size_t offset = 0;
-	while (offset < buf.size()) {
-		auto hdr = reinterpret_cast<ResourceHeader*>(buf.data() + offset);
-		STDString path((char const*)buf.data() + offset + sizeof(ResourceHeader), hdr->FileNameSize);
-		STDString body((char const*)buf.data() + offset + sizeof(ResourceHeader) + hdr->FileNameSize, hdr->FileSize);
-		resources_.insert(std::make_pair(path, body));
-		offset += sizeof(ResourceHeader) + hdr->FileNameSize + hdr->FileSize;
+	if (buf.size() < sizeof(LuaBundleHeader)) {
+		ERR("Lua bundle too small");
+		return false;
+	}
+
+	auto hdr = reinterpret_cast<LuaBundleHeader const*>(buf.data());
+	if (hdr->Signature != LuaBundleSignature || hdr->Version != LuaBundleVersion) {
+		ERR("Unsupported Lua bundle format (signature %08x, version %d)", hdr->Signature, hdr->Version);
+		return false;
+	}
+
+	auto namesOffset = sizeof(LuaBundleHeader) + (std::size_t)hdr->NumEntries * sizeof(LuaBundleEntry);
+	if (namesOffset + hdr->NamesSize > buf.size()) {
+		ERR("Lua bundle table of contents is truncated");
+		return false;
+	}
+
+	std::span<LuaBundleEntry const> entries(reinterpret_cast<LuaBundleEntry const*>(buf.data() + sizeof(LuaBundleHeader)), hdr->NumEntries);
+	for (auto const& entry : entries) {
+		if ((std::size_t)entry.NameOffset + entry.NameSize > hdr->NamesSize
+			|| (std::size_t)entry.DataOffset + entry.DataSize > buf.size()) {
+			ERR("Lua bundle entry out of bounds");
+			return false;
+		}
+	}
+
+	bundle_ = buf;
+	entries_ = entries;
+	names_ = std::string_view(reinterpret_cast<char const*>(buf.data() + namesOffset), hdr->NamesSize);
+
+	std::lock_guard _(cacheMutex_);
+	decompressed_.clear();
+	return true;
+}
+
+std::string_view LuaBundle::GetEntryName(LuaBundleEntry const& entry) const
+{
+	return names_.substr(entry.NameOffset, entry.NameSize);
+}
+
+LuaBundleEntry const* LuaBundle::FindEntry(std::string_view path) const
+{
+	auto it = std::lower_bound(entries_.begin(), entries_.end(), path, [this](LuaBundleEntry const& entry, std::string_view path) {
+		return GetEntryName(entry) < path;
+	});
+
+	if (it != entries_.end() && GetEntryName(*it) == path) {
+		return &*it;
+	} else {
+		return nullptr;
+	}
+}
+
+std::optional<STDString> LuaBundle::ReadEntry(LuaBundleEntry const& entry) const
+{
+	auto data = bundle_.data() + entry.DataOffset;
+	if (entry.Flags == LuaBundleEntryFlags::None) {
+		return STDString(reinterpret_cast<char const*>(data), entry.DataSize);
+	}
+
+	auto index = (uint32_t)(&entry - entries_.data());
+	std::lock_guard _(cacheMutex_);
+	auto it = decompressed_.find(index);
+	if (it != decompressed_.end()) {
+		return it->second;
+	}
+
+	if (entry.Flags != LuaBundleEntryFlags::CompressedXpress) {
+		ERR("Unsupported Lua bundle entry flags: %d", (uint32_t)entry.Flags);
+		return {};
+	}
+
+	DECOMPRESSOR_HANDLE decompressor;
+	if (!CreateDecompressor(COMPRESS_ALGORITHM_XPRESS, NULL, &decompressor)) {
+		ERR("CreateDecompressor() failed: %d", GetLastError());
+		return {};
 	}
+
+	STDString body;
+	body.resize(entry.UncompressedSize);
+	SIZE_T uncompressedSize{ 0 };
+	auto succeeded = Decompress(decompressor, data, entry.DataSize, body.data(), body.size(), &uncompressedSize);
+	CloseDecompressor(decompressor);
+
+	if (!succeeded || uncompressedSize != body.size()) {
+		ERR("Failed to decompress Lua bundle entry '%s'", STDString(GetEntryName(entry)).c_str());
+		return {};
+	}
+
+	decompressed_.insert(std::make_pair(index, body));
+	return body;
 }
 
 std::optional<STDString> LuaBundle::GetResource(STDString const& path) const
@@ -47,12 +130,80 @@ std::optional<STDString> LuaBundle::GetResource(STDString const& path) const
 		}
 	}
 
-	auto it = resources_.find(path);
-	if (it != resources_.end()) {
-		return it->second;
+	auto entry = FindEntry(std::string_view(path.data(), path.size()));
+	if (entry != nullptr) {
+		return ReadEntry(*entry);
 	} else {
 		return {};
 	}
 }
 
+std::size_t LuaBundle::GetNumDecompressedEntries() const
+{
+	std::lock_guard _(cacheMutex_);
+	return decompressed_.size();
+}
+
+std::vector<uint8_t> LuaBundle::Pack(std::vector<std::pair<STDString, STDString>> scripts)
+{
+	auto align = [](std::size_t size) {
+		return (size + LuaBundleDataAlignment - 1) & ~(std::size_t)(LuaBundleDataAlignment - 1);
+	};
+
+	std::sort(scripts.begin(), scripts.end(), [](auto const& a, auto const& b) {
+		return a.first < b.first;
+	});
+
+	COMPRESSOR_HANDLE compressor{ NULL };
+	if (!CreateCompressor(COMPRESS_ALGORITHM_XPRESS, NULL, &compressor)) {
+		ERR("CreateCompressor() failed: %d", GetLastError());
+		compressor = NULL;
+	}
+
+	std::vector<LuaBundleEntry> entries(scripts.size());
+	STDString names;
+	for (std::size_t i = 0; i < scripts.size(); i++) {
+		entries[i].NameOffset = (uint32_t)names.size();
+		entries[i].NameSize = (uint32_t)scripts[i].first.size();
+		names += scripts[i].first;
+	}
+
+	std::vector<uint8_t> bundle;
+	bundle.resize(align(sizeof(LuaBundleHeader) + entries.size() * sizeof(LuaBundleEntry) + names.size()));
+
+	for (std::size_t i = 0; i < scripts.size(); i++) {
+		auto const& contents = scripts[i].second;
+		STDString compressed;
+		compressed.resize(contents.size());
+		SIZE_T compressedSize{ 0 };
+		// Compress() fails if the output wouldn't be smaller than the input
+		bool isCompressed = compressor != NULL && !contents.empty()
+			&& Compress(compressor, contents.data(), contents.size(), compressed.data(), compressed.size(), &compressedSize)
+			&& compressedSize < contents.size();
+
+		auto data = isCompressed ? std::string_view(compressed.data(), compressedSize) : std::string_view(contents.data(), contents.size());
+		auto& entry = entries[i];
+		entry.Flags = isCompressed ? LuaBundleEntryFlags::CompressedXpress : LuaBundleEntryFlags::None;
+		entry.DataOffset = (uint32_t)bundle.size();
+		entry.DataSize = (uint32_t)data.size();
+		entry.UncompressedSize = (uint32_t)contents.size();
+		bundle.insert(bundle.end(), data.begin(), data.end());
+		bundle.resize(align(bundle.size()));
+	}
+
+	if (compressor != NULL) {
+		CloseCompressor(compressor);
+	}
+
+	LuaBundleHeader hdr;
+	hdr.Signature = LuaBundleSignature;
+	hdr.Version = LuaBundleVersion;
+	hdr.NumEntries = (uint32_t)entries.size();
+	hdr.NamesSize = (uint32_t)names.size();
+	memcpy(bundle.data(), &hdr, sizeof(hdr));
+	memcpy(bundle.data() + sizeof(hdr), entries.data(), entries.size() * sizeof(LuaBundleEntry));
+	memcpy(bundle.data() + sizeof(hdr) + entries.size() * sizeof(LuaBundleEntry), names.data(), names.size());
+	return bundle;
+}
+
 END_NS()
@@ -1,30 +1,45 @@
 #pragma once
 
 #include <GameDefinitions/Base/Base.h>
+#include <Lua/Shared/LuaBundleFormat.h>
 #include <unordered_map>
 #include <span>
 #include <vector>
+#include <mutex>
 
 BEGIN_NS(lua)
 
+// Read-only view of the builtin Lua script bundle.
+// Only the table of contents is parsed when the bundle is loaded; scripts are read (and decompressed)
+// directly from the bundle memory the first time they're requested.
 class LuaBundle
 {
 public:
 	void SetResourcePath(std::wstring const& path);
 	bool LoadBuiltinResource(int resourceId);
-	void LoadBuffer(std::span<uint8_t> const& buf);
+	// The buffer must remain valid for the lifetime of the bundle
+	bool LoadBuffer(std::span<uint8_t const> const& buf);
 
 	std::optional<STDString> GetResource(STDString const& path) const;
+	// Number of compressed scripts that were decompressed and cached so far
+	std::size_t GetNumDecompressedEntries() const;
+
+	// Builds a bundle from in-memory scripts in the same format as ResourceBundler.
+	// Only used for testing the reader; the builtin bundle is written by ResourceBundler.
+	static std::vector<uint8_t> Pack(std::vector<std::pair<STDString, STDString>> scripts);
 
 private:
-	std::unordered_map<STDString, STDString> resources_;
+	std::span<uint8_t const> bundle_;
+	std::span<LuaBundleEntry const> entries_;
+	std::string_view names_;
 	std::wstring resourcePath_;
 
-	struct ResourceHeader
-	{
-		uint32_t FileNameSize;
-		uint32_t FileSize;
-	};
+	mutable std::mutex cacheMutex_;
+	mutable std::unordered_map<uint32_t, STDString> decompressed_;
+
+	LuaBundleEntry const* FindEntry(std::string_view path) const;
+	std::string_view GetEntryName(LuaBundleEntry const& entry) const;
+	std::optional<STDString> ReadEntry(LuaBundleEntry const& entry) const;
 };
 
 END_NS()
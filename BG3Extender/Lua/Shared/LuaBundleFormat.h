@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+
+// On-disk format of the builtin Lua script bundle.
+// Shared between the extender (reader) and ResourceBundler (writer), so it must not depend on
+// anything but the standard library.
+//
+// Layout:
+//   LuaBundleHeader
+//   LuaBundleEntry[NumEntries]  (sorted by name, byte-wise)
+//   Name table                  (NamesSize bytes, not null terminated)
+//   Entry data                  (each entry is aligned to DataAlignment bytes)
+namespace bg3se::lua
+{
+	constexpr uint32_t LuaBundleSignature = 'BESL';
+	constexpr uint32_t LuaBundleVersion = 1;
+	constexpr uint32_t LuaBundleDataAlignment = 16;
+
+	enum class LuaBundleEntryFlags : uint32_t
+	{
+		None = 0,
+		// Entry data is compressed using COMPRESS_ALGORITHM_XPRESS
+		CompressedXpress = 1 << 0
+	};
+
+	struct LuaBundleHeader
+	{
+		uint32_t Signature;
+		uint32_t Version;
+		uint32_t NumEntries;
+		uint32_t NamesSize;
+	};
+
+	struct LuaBundleEntry
+	{
+		// Offset of the name relative to the start of the name table
+		uint32_t NameOffset;
+		uint32_t NameSize;
+		// Offset of the data relative to the start of the bundle
+		uint32_t DataOffset;
+		uint32_t DataSize;
+		uint32_t UncompressedSize;
+		LuaBundleEntryFlags Flags;
+	};
+
+	static_assert(sizeof(LuaBundleHeader) == 16);
+	static_assert(sizeof(LuaBundleEntry) == 24);
+}
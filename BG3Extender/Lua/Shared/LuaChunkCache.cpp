@@ -0,0 +1,322 @@
+#include <stdafx.h>
+#include <Lua/Shared/LuaChunkCache.h>
+#include <CoreLib/Utils.h>
+#include <lua.h>
+#include <lauxlib.h>
+
+BEGIN_NS(lua)
+
+namespace
+{
+	// Compiled and dumped (stripped) to detect the bytecode format of the running Lua build.
+	// The dump contains the bytecode header (Lua version, format, type sizes and number encoding
+	// checks) and the opcodes used by the probe, so any change that would make previously
+	// cached bytecode incompatible also changes the cache key.
+	constexpr char FormatProbe[] = 
+		"local a, b = ... "
+		"local t = { a, b, x = 1.5, y = \"s\" } "
+		"for i = 1, #t do a = a + t[i] * 2 // 3 - (b or 0) % 4 end "
+		"return function(...) return a .. b, t.x, select('#', ...) end";
+
+	constexpr uint32_t CacheFileMagic = 'LCC1';
+	constexpr uint32_t CacheFileVersion = 2;
+
+	struct CacheFileHeader
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		std::array<uint8_t, 16> FormatKey;
+		uint32_t NumChunks;
+	};
+
+	// Followed by NameSize bytes of chunk name and Size bytes of bytecode
+	struct CacheFileChunk
+	{
+		std::array<uint8_t, 16> Key;
+		std::array<uint8_t, 16> BodyHash;
+		uint32_t NameSize;
+		uint32_t Size;
+	};
+
+	std::array<uint8_t, 16> HashBuffer(void const* buf, std::size_t size)
+	{
+		std::array<uint8_t, 16> hash;
+		MurmurHash3_x64_128(buf, (int)size, 0, hash.data());
+		return hash;
+	}
+
+	int WriteChunk(lua_State* L, void const* p, size_t sz, void* ud)
+	{
+		reinterpret_cast<STDString*>(ud)->append(reinterpret_cast<char const*>(p), sz);
+		return 0;
+	}
+}
+
+void LuaChunkCache::InitFormatKey(lua_State* L)
+{
+	{
+		std::lock_guard _(mutex_);
+		if (formatKeyInitialized_) return;
+	}
+
+	STDString format(LUA_VERSION_RELEASE);
+	format.push_back('\0');
+	if (luaL_loadbufferx(L, FormatProbe, sizeof(FormatProbe) - 1, "=FormatProbe", "text") == LUA_OK) {
+		lua_dump(L, &WriteChunk, &format, 1);
+	}
+	lua_pop(L, 1);
+
+	std::lock_guard _(mutex_);
+	formatKey_ = HashBuffer(format.data(), format.size());
+	formatKeyInitialized_ = true;
+}
+
+LuaChunkCache::Key LuaChunkCache::MakeKey(StringView script, STDString const& name)
+{
+	auto scriptHash = HashBuffer(script.data(), script.size());
+
+	// Debug info (and therefore the bytecode) depends on the chunk name
+	STDString keyData(name);
+	keyData.push_back('\0');
+	keyData.append(reinterpret_cast<char const*>(formatKey_.data()), formatKey_.size());
+	keyData.append(reinterpret_cast<char const*>(scriptHash.data()), scriptHash.size());
+	return HashBuffer(keyData.data(), keyData.size());
+}
+
+void LuaChunkCache::EnablePersistence(std::wstring const& path)
+{
+	std::lock_guard _(mutex_);
+	persistentPath_ = path;
+	persistentCacheLoaded_ = false;
+}
+
+int LuaChunkCache::Load(lua_State* L, StringView script, STDString const& name)
+{
+	InitFormatKey(L);
+	auto key = MakeKey(script, name);
+
+	STDString bytecode;
+	if (TryGetChunk(key, bytecode)) {
+		auto status = luaL_loadbufferx(L, bytecode.data(), bytecode.size(), name.c_str(), "b");
+		if (status == LUA_OK) {
+			std::lock_guard _(mutex_);
+			stats_.Hits++;
+			return status;
+		}
+
+		WARN("Cached bytecode for '%s' could not be loaded: %s", name.c_str(), lua_tostring(L, -1));
+		lua_pop(L, 1);
+		RemoveChunk(key);
+	}
+
+	{
+		std::lock_guard _(mutex_);
+		stats_.Misses++;
+	}
+
+	auto status = luaL_loadbufferx(L, script.data(), script.size(), name.c_str(), "text");
+	if (status == LUA_OK) {
+		bytecode.clear();
+		if (lua_dump(L, &WriteChunk, &bytecode, 0) == 0) {
+			AddChunk(key, name, std::move(bytecode));
+		}
+	}
+
+	return status;
+}
+
+bool LuaChunkCache::TryGetChunk(Key const& key, STDString& bytecode)
+{
+	std::lock_guard _(mutex_);
+	LoadPersistentCache();
+
+	auto it = chunks_.find(key);
+	if (it != chunks_.end()) {
+		if (!it->second.Used) {
+			it->second.Used = true;
+			dirty_ = true;
+		}
+
+		it->second.LastUsed = ++useCounter_;
+		bytecode = it->second.Bytecode;
+		return true;
+	} else {
+		return false;
+	}
+}
+
+void LuaChunkCache::AddChunk(Key const& key, STDString const& name, STDString&& bytecode)
+{
+	std::lock_guard _(mutex_);
+	if (bytecode.size() > MaxCacheSize) {
+		return;
+	}
+
+	// A different chunk with the same name is a previous version of the same script
+	auto nameIt = chunksByName_.find(name);
+	if (nameIt != chunksByName_.end() && nameIt->second != key) {
+		auto stale = chunks_.find(nameIt->second);
+		if (stale != chunks_.end()) {
+			EraseChunk(stale);
+			stats_.Evictions++;
+		}
+	}
+
+	auto it = chunks_.find(key);
+	if (it != chunks_.end()) {
+		EraseChunk(it);
+	}
+
+	while (!chunks_.empty() && cacheSize_ + bytecode.size() > MaxCacheSize) {
+		EvictLeastRecentlyUsed();
+	}
+
+	cacheSize_ += bytecode.size();
+	chunks_.insert(std::make_pair(key, Chunk{ name, std::move(bytecode), ++useCounter_, true }));
+	chunksByName_[name] = key;
+	dirty_ = true;
+}
+
+void LuaChunkCache::RemoveChunk(Key const& key)
+{
+	std::lock_guard _(mutex_);
+	auto it = chunks_.find(key);
+	if (it != chunks_.end()) {
+		EraseChunk(it);
+	}
+}
+
+void LuaChunkCache::EraseChunk(std::unordered_map<Key, Chunk, KeyHash>::iterator it)
+{
+	auto nameIt = chunksByName_.find(it->second.Name);
+	if (nameIt != chunksByName_.end() && nameIt->second == it->first) {
+		chunksByName_.erase(nameIt);
+	}
+
+	cacheSize_ -= it->second.Bytecode.size();
+	chunks_.erase(it);
+	dirty_ = true;
+}
+
+void LuaChunkCache::EvictLeastRecentlyUsed()
+{
+	// Eviction only happens when the cache is full, so a linear scan is cheaper than
+	// maintaining a separate LRU list on every lookup
+	auto oldest = chunks_.begin();
+	for (auto it = chunks_.begin(); it != chunks_.end(); ++it) {
+		if (it->second.LastUsed < oldest->second.LastUsed) {
+			oldest = it;
+		}
+	}
+
+	EraseChunk(oldest);
+	stats_.Evictions++;
+}
+
+void LuaChunkCache::Clear()
+{
+	std::lock_guard _(mutex_);
+	chunks_.clear();
+	chunksByName_.clear();
+	cacheSize_ = 0;
+	dirty_ = true;
+}
+
+LuaChunkCache::Stats LuaChunkCache::GetStats()
+{
+	std::lock_guard _(mutex_);
+	auto stats = stats_;
+	stats.Chunks = (uint32_t)chunks_.size();
+	stats.Bytes = cacheSize_;
+	return stats;
+}
+
+void LuaChunkCache::LoadPersistentCache()
+{
+	if (persistentCacheLoaded_ || persistentPath_.empty()) return;
+	persistentCacheLoaded_ = true;
+
+	std::string cache;
+	if (!LoadFile(persistentPath_, cache) || cache.size() < sizeof(CacheFileHeader)) return;
+
+	auto header = reinterpret_cast<CacheFileHeader const*>(cache.data());
+	if (header->Magic != CacheFileMagic
+		|| header->Version != CacheFileVersion
+		|| header->FormatKey != formatKey_) {
+		return;
+	}
+
+	std::size_t offset = sizeof(CacheFileHeader);
+	for (uint32_t i = 0; i < header->NumChunks; i++) {
+		if (offset + sizeof(CacheFileChunk) > cache.size()) break;
+
+		auto chunk = reinterpret_cast<CacheFileChunk const*>(cache.data() + offset);
+		offset += sizeof(CacheFileChunk);
+		std::size_t bodySize = (std::size_t)chunk->NameSize + chunk->Size;
+		if (offset + bodySize > cache.size()) break;
+
+		auto name = cache.data() + offset;
+		auto body = name + chunk->NameSize;
+		offset += bodySize;
+
+		// Skip corrupted entries; Lua doesn't validate bytecode, so these must never reach the loader
+		if (chunk->BodyHash != HashBuffer(name, bodySize)
+			|| cacheSize_ + chunk->Size > MaxCacheSize) {
+			continue;
+		}
+
+		// Persisted chunks are considered older than any chunk used in this session
+		STDString chunkName(name, chunk->NameSize);
+		if (chunks_.insert(std::make_pair(chunk->Key, Chunk{ chunkName, STDString(body, chunk->Size), 0, false })).second) {
+			cacheSize_ += chunk->Size;
+			chunksByName_.insert(std::make_pair(chunkName, chunk->Key));
+		}
+	}
+
+	DEBUG("Loaded %d precompiled Lua chunks from cache", (uint32_t)chunks_.size());
+}
+
+void LuaChunkCache::SavePersistentCache()
+{
+	std::lock_guard _(mutex_);
+	if (!dirty_ || persistentPath_.empty() || !formatKeyInitialized_) return;
+
+	std::string cache;
+	cache.reserve(sizeof(CacheFileHeader) + cacheSize_ + chunks_.size() * sizeof(CacheFileChunk));
+
+	CacheFileHeader header{
+		.Magic = CacheFileMagic,
+		.Version = CacheFileVersion,
+		.FormatKey = formatKey_,
+		.NumChunks = 0
+	};
+	cache.append(reinterpret_cast<char const*>(&header), sizeof(header));
+
+	for (auto const& chunk : chunks_) {
+		if (!chunk.second.Used) continue;
+
+		auto const& name = chunk.second.Name;
+		auto const& bytecode = chunk.second.Bytecode;
+		STDString body(name);
+		body += bytecode;
+		CacheFileChunk chunkHeader{
+			.Key = chunk.first,
+			.BodyHash = HashBuffer(body.data(), body.size()),
+			.NameSize = (uint32_t)name.size(),
+			.Size = (uint32_t)bytecode.size()
+		};
+		cache.append(reinterpret_cast<char const*>(&chunkHeader), sizeof(chunkHeader));
+		cache.append(body.data(), body.size());
+		header.NumChunks++;
+	}
+
+	memcpy(cache.data(), &header, sizeof(header));
+
+	if (SaveFile(persistentPath_, cache)) {
+		dirty_ = false;
+	} else {
+		WARN("Failed to save Lua chunk cache");
+	}
+}
+
+END_NS()
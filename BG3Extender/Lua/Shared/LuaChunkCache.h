@@ -0,0 +1,81 @@
+#pragma once
+
+#include <GameDefinitions/Base/Base.h>
+#include <array>
+#include <mutex>
+#include <unordered_map>
+
+struct lua_State;
+
+BEGIN_NS(lua)
+
+// Keeps precompiled bytecode of loaded scripts so that the same script doesn't need to be
+// reparsed after every Lua reset. Chunks are keyed by the hash of the script source, chunk name
+// and bytecode format; the cache is shared between the client and server states.
+// When the cache is full, the least recently used chunks are evicted; recompiling a chunk
+// with a different source evicts the stale chunk of the same name.
+class LuaChunkCache
+{
+public:
+	static constexpr std::size_t MaxCacheSize = 0x4000000;
+
+	struct Stats
+	{
+		uint64_t Hits{ 0 };
+		uint64_t Misses{ 0 };
+		uint64_t Evictions{ 0 };
+		uint32_t Chunks{ 0 };
+		std::size_t Bytes{ 0 };
+	};
+
+	void EnablePersistence(std::wstring const& path);
+	// Loads a script in the same way as luaL_loadbufferx(L, script, size, name, "text"),
+	// but uses cached bytecode if the script was compiled previously.
+	int Load(lua_State* L, StringView script, STDString const& name);
+	void SavePersistentCache();
+	void Clear();
+	Stats GetStats();
+
+private:
+	using Key = std::array<uint8_t, 16>;
+
+	struct KeyHash
+	{
+		inline std::size_t operator () (Key const& key) const
+		{
+			return *reinterpret_cast<std::size_t const*>(key.data());
+		}
+	};
+
+	struct Chunk
+	{
+		STDString Name;
+		STDString Bytecode;
+		uint64_t LastUsed;
+		// Only chunks used during the current session are persisted
+		bool Used;
+	};
+
+	std::mutex mutex_;
+	std::unordered_map<Key, Chunk, KeyHash> chunks_;
+	std::unordered_map<STDString, Key> chunksByName_;
+	std::size_t cacheSize_{ 0 };
+	uint64_t useCounter_{ 0 };
+	Stats stats_;
+	Key formatKey_;
+	bool formatKeyInitialized_{ false };
+	std::wstring persistentPath_;
+	bool persistentCacheLoaded_{ false };
+	bool dirty_{ false };
+
+	void InitFormatKey(lua_State* L);
+	Key MakeKey(StringView script, STDString const& name);
+	bool TryGetChunk(Key const& key, STDString& bytecode);
+	void AddChunk(Key const& key, STDString const& name, STDString&& bytecode);
+	void RemoveChunk(Key const& key);
+	void EraseChunk(std::unordered_map<Key, Chunk, KeyHash>::iterator it);
+	void EvictLeastRecentlyUsed();
+	void LoadPersistentCache();
+};
+
+END_NS()
@@ -1,8 +1,25 @@
 BEGIN_NS(lua)
 
+// Direct-mapped cache of FixedString -> interned Lua string, used when pushing FixedStrings.
+// Entries are weak; strings are removed from the cache when they're freed by the GC.
+struct FixedStringPushCache
+{
+	static constexpr unsigned SizeBits = 12;
+	static constexpr unsigned Size = 1 << SizeBits;
+
+	TString* Strings[Size];
+
+	static inline unsigned GetSlot(uint32_t index)
+	{
+		// Fibonacci hashing, as GFS indices are sequential within a subtable
+		return (index * 0x9E3779B1u) >> (32 - SizeBits);
+	}
+};
+
 struct LuaInternalState
 {
 	TValue canonicalizationCache;
+	FixedStringPushCache fixedStringCache;
 };
 
 struct CppObjectUdata
@@ -15,6 +32,8 @@ struct CachedFixedString
 {
 	FixedString Str;
 	bool IsCached;
+	// String is referenced by FixedStringPushCache
+	bool IsInPushCache;
 };
 
 // Lua C++ objects store an additional lifetime in the Lua value; however, for optimization purposes
@@ -397,6 +416,7 @@ LuaInternalState* lua_new_internal_state()
 {
 	auto st = GameAlloc<LuaInternalState>();
 	setnilvalue(&st->canonicalizationCache);
+	std::fill(std::begin(st->fixedStringCache.Strings), std::end(st->fixedStringCache.Strings), nullptr);
 	return st;
 }
 
@@ -452,13 +472,42 @@ FixedString do_get(lua_State* L, int index, Overload<FixedString>)
 	return fs;
 }
 
+static TString* GetCachedFixedString(lua_State* L, FixedString const& v)
+{
+	auto& slot = State::FromLua(L)->GetInternalState()->fixedStringCache.Strings[FixedStringPushCache::GetSlot(v.Index)];
+	auto ts = slot;
+	if (ts != nullptr && reinterpret_cast<CachedFixedString*>(&ts->cache)->Str == v) {
+		// The string may be unreachable but not swept yet; resurrect it the same way string interning does
+		if (isdead(G(L), ts)) {
+			changewhite(ts);
+		}
+
+		return ts;
+	}
+
+	ts = luaS_new(L, v.GetString());
+	LuaCacheString(L, ts);
+
+	auto fs = reinterpret_cast<CachedFixedString*>(&ts->cache);
+	// Strings that are too long to carry a FixedString reference can't be cached
+	if (fs->IsCached && !fs->IsInPushCache && fs->Str == v) {
+		if (slot != nullptr) {
+			reinterpret_cast<CachedFixedString*>(&slot->cache)->IsInPushCache = false;
+		}
+
+		fs->IsInPushCache = true;
+		slot = ts;
+	}
+
+	return ts;
+}
+
 void push(lua_State* L, FixedString const& v)
 {
 	lua_lock(L);
 	TString* ts;
 	if (v) {
-		ts = luaS_new(L, v.GetString());
-		LuaCacheString(L, ts);
+		ts = GetCachedFixedString(L, v);
 	} else {
 		ts = luaS_new(L, "");
 	}
@@ -478,6 +527,7 @@ void LuaCacheString(lua_State* L, TString* s)
 		// was previously: FixedString::DontCreate{}
 		new (&fs->Str) FixedString(StringView(getstr(s), tsslen(s)));
 		fs->IsCached = true;
+		fs->IsInPushCache = false;
 	}
 }
 
@@ -485,6 +535,14 @@ void LuaReleaseString(lua_State* L, TString* s)
 {
 	static_assert(sizeof(LUA_STRING_EXTRATYPE) == sizeof(CachedFixedString));
 	auto fs = reinterpret_cast<CachedFixedString*>(&s->cache);
+	if (fs->IsInPushCache) {
+		auto& slot = State::FromLua(L)->GetInternalState()->fixedStringCache.Strings[FixedStringPushCache::GetSlot(fs->Str.Index)];
+		if (slot == s) {
+			slot = nullptr;
+		}
+		fs->IsInPushCache = false;
+	}
+
 	if (fs->IsCached) {
 		fs->Str.~FixedString();
 		fs->IsCached = false;
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <unordered_map>
+
+BEGIN_NS(lua)
+
+// Subscriber registry for engine events (Ext.Events.*).
+// Handlers are kept in C++ so that events without subscribers can be skipped before
+// the event object is pushed to Lua or any Lua code is called.
+class EventBus
+{
+public:
+	using SubscriptionIndex = uint32_t;
+	static constexpr int32_t DefaultPriority = 100;
+
+	struct Subscription
+	{
+		RegistryEntry Handler;
+		SubscriptionIndex Index;
+		int32_t Priority;
+		bool Once;
+	};
+
+	struct Event
+	{
+		FixedString Name;
+		// Ordered by descending priority; subscriptions with the same priority are kept in subscription order
+		Vector<Subscription> Subscriptions;
+		SubscriptionIndex NextIndex{ 1 };
+		uint32_t EnterCount{ 0 };
+		Vector<SubscriptionIndex> PendingDeletions;
+		// Position of the next handler to call in each (possibly nested) dispatch of this event
+		Vector<uint32_t*> Cursors;
+
+		inline bool HasSubscribers() const
+		{
+			return !Subscriptions.empty();
+		}
+	};
+
+	EventBus(State& state);
+
+	// Looks up an event by name; the name must be a string with static storage duration,
+	// as the string pointer is used to look up the interned event name.
+	Event& GetEvent(char const* name);
+	Event& GetEvent(FixedString const& name);
+
+	SubscriptionIndex Subscribe(Event& evt, RegistryEntry&& handler, int32_t priority, bool once);
+	bool Unsubscribe(Event& evt, SubscriptionIndex index);
+
+	// Calls all handlers of the event with the event object at the specified stack index.
+	// If a native event is passed, propagation is controlled by its Stopped flag instead of the Lua object.
+	void Throw(Event& evt, int eventIndex, EventBase* nativeEvent);
+
+private:
+	State& state_;
+	std::unordered_map<FixedString, std::unique_ptr<Event>> events_;
+	std::unordered_map<char const*, Event*> eventNameCache_;
+
+	bool DoUnsubscribe(Event& evt, SubscriptionIndex index);
+	void RemoveAt(Event& evt, uint32_t position);
+	void ProcessUnsubscriptions(Event& evt);
+	bool IsStopped(lua_State* L, int eventIndex, EventBase* nativeEvent);
+};
+
+void RegisterEventBusLib(lua_State* L);
+
+END_NS()
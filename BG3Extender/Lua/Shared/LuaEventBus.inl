@@ -0,0 +1,232 @@
+#include <Lua/Shared/LuaEventBus.h>
+
+BEGIN_NS(lua)
+
+EventBus::EventBus(State& state)
+	: state_(state)
+{}
+
+EventBus::Event& EventBus::GetEvent(char const* name)
+{
+	auto it = eventNameCache_.find(name);
+	if (it != eventNameCache_.end()) {
+		return *it->second;
+	}
+
+	auto& evt = GetEvent(FixedString(name));
+	eventNameCache_.insert(std::make_pair(name, &evt));
+	return evt;
+}
+
+EventBus::Event& EventBus::GetEvent(FixedString const& name)
+{
+	auto it = events_.find(name);
+	if (it != events_.end()) {
+		return *it->second;
+	}
+
+	auto evt = std::make_unique<Event>();
+	evt->Name = name;
+	auto& ref = *evt;
+	events_.insert(std::make_pair(name, std::move(evt)));
+	return ref;
+}
+
+EventBus::SubscriptionIndex EventBus::Subscribe(Event& evt, RegistryEntry&& handler, int32_t priority, bool once)
+{
+	auto index = evt.NextIndex++;
+
+	uint32_t position = 0;
+	while (position < evt.Subscriptions.size() && evt.Subscriptions[position].Priority >= priority) {
+		position++;
+	}
+
+	evt.Subscriptions.insert(evt.Subscriptions.begin() + position, Subscription{ std::move(handler), index, priority, once });
+
+	// Handlers inserted before the one currently being called are not called in the current dispatch
+	for (auto cursor : evt.Cursors) {
+		if (*cursor > position) {
+			(*cursor)++;
+		}
+	}
+
+	return index;
+}
+
+bool EventBus::Unsubscribe(Event& evt, SubscriptionIndex index)
+{
+	if (evt.EnterCount == 0) {
+		return DoUnsubscribe(evt, index);
+	} else {
+		evt.PendingDeletions.push_back(index);
+		return true;
+	}
+}
+
+bool EventBus::DoUnsubscribe(Event& evt, SubscriptionIndex index)
+{
+	for (uint32_t i = 0; i < evt.Subscriptions.size(); i++) {
+		if (evt.Subscriptions[i].Index == index) {
+			RemoveAt(evt, i);
+			return true;
+		}
+	}
+
+	std::stringstream ss;
+	ss << "Attempted to remove subscriber ID " << index << " for event '" << evt.Name.GetString()
+		<< "', but no such subscriber exists (maybe it was removed already?)";
+	gExtender->LogOsirisWarning(ss.str());
+	return false;
+}
+
+void EventBus::RemoveAt(Event& evt, uint32_t position)
+{
+	evt.Subscriptions.erase(evt.Subscriptions.begin() + position);
+
+	for (auto cursor : evt.Cursors) {
+		if (*cursor > position) {
+			(*cursor)--;
+		}
+	}
+}
+
+void EventBus::ProcessUnsubscriptions(Event& evt)
+{
+	if (evt.EnterCount == 0 && !evt.PendingDeletions.empty()) {
+		Vector<SubscriptionIndex> deletions;
+		std::swap(deletions, evt.PendingDeletions);
+		for (auto index : deletions) {
+			DoUnsubscribe(evt, index);
+		}
+	}
+}
+
+bool EventBus::IsStopped(lua_State* L, int eventIndex, EventBase* nativeEvent)
+{
+	if (nativeEvent != nullptr) {
+		return nativeEvent->Stopped;
+	}
+
+	if (lua_type(L, eventIndex) != LUA_TTABLE) {
+		return false;
+	}
+
+	lua_getfield(L, eventIndex, "Stopped");
+	auto stopped = lua_toboolean(L, -1) != 0;
+	lua_pop(L, 1);
+	return stopped;
+}
+
+void EventBus::Throw(Event& evt, int eventIndex, EventBase* nativeEvent)
+{
+	auto L = state_.GetState();
+	eventIndex = lua_absindex(L, eventIndex);
+
+	struct DispatchScope
+	{
+		EventBus& Bus;
+		Event& Evt;
+		uint32_t Cursor{ 0 };
+
+		DispatchScope(EventBus& bus, Event& evt)
+			: Bus(bus), Evt(evt)
+		{
+			Evt.EnterCount++;
+			Evt.Cursors.push_back(&Cursor);
+		}
+
+		~DispatchScope()
+		{
+			Evt.Cursors.pop_back();
+			Evt.EnterCount--;
+			Bus.ProcessUnsubscriptions(Evt);
+		}
+	};
+
+	DispatchScope scope(*this, evt);
+	auto& cursor = scope.Cursor;
+
+	while (cursor < evt.Subscriptions.size() && !IsStopped(L, eventIndex, nativeEvent)) {
+		auto& sub = evt.Subscriptions[cursor++];
+		auto index = sub.Index;
+		auto once = sub.Once;
+
+		sub.Handler.Push();
+		lua_pushvalue(L, eventIndex);
+		if (CallWithTraceback(L, 1, 0) != 0) {
+			std::stringstream ss;
+			ss << "Error while dispatching event " << evt.Name.GetString() << ": " << lua_tostring(L, -1);
+			gExtender->LogLuaError(ss.str());
+			lua_pop(L, 1);
+		}
+
+		// The handler may have changed the subscription list, so the subscription is looked up again by index
+		if (once) {
+			for (uint32_t i = 0; i < evt.Subscriptions.size(); i++) {
+				if (evt.Subscriptions[i].Index == index) {
+					RemoveAt(evt, i);
+					break;
+				}
+			}
+		}
+	}
+}
+
+int EventBusSubscribe(lua_State* L)
+{
+	auto name = get<FixedString>(L, 1);
+	luaL_checktype(L, 2, LUA_TFUNCTION);
+	auto priority = lua_isnoneornil(L, 3) ? EventBus::DefaultPriority : get<int32_t>(L, 3);
+	auto once = lua_toboolean(L, 4) != 0;
+
+	auto& bus = State::FromLua(L)->GetEventBus();
+	auto index = bus.Subscribe(bus.GetEvent(name), RegistryEntry(L, 2), priority, once);
+	push(L, index);
+	return 1;
+}
+
+int EventBusUnsubscribe(lua_State* L)
+{
+	auto name = get<FixedString>(L, 1);
+	auto index = get<EventBus::SubscriptionIndex>(L, 2);
+
+	auto& bus = State::FromLua(L)->GetEventBus();
+	push(L, bus.Unsubscribe(bus.GetEvent(name), index));
+	return 1;
+}
+
+int EventBusThrow(lua_State* L)
+{
+	auto name = get<FixedString>(L, 1);
+	luaL_checkany(L, 2);
+
+	auto& bus = State::FromLua(L)->GetEventBus();
+	auto& evt = bus.GetEvent(name);
+	if (evt.HasSubscribers()) {
+		bus.Throw(evt, 2, nullptr);
+	}
+
+	return 0;
+}
+
+int EventBusHasSubscribers(lua_State* L)
+{
+	auto name = get<FixedString>(L, 1);
+	push(L, State::FromLua(L)->GetEventBus().GetEvent(name).HasSubscribers());
+	return 1;
+}
+
+void RegisterEventBusLib(lua_State* L)
+{
+	static const luaL_Reg eventLib[] = {
+		{"Subscribe", EventBusSubscribe},
+		{"Unsubscribe", EventBusUnsubscribe},
+		{"Throw", EventBusThrow},
+		{"HasSubscribers", EventBusHasSubscribers},
+		{0,0}
+	};
+
+	RegisterLib(L, "_NativeEvents", eventLib);
+}
+
+END_NS()
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <lua.h>
+#include <chrono>
+
+BEGIN_NS(lua)
+
+class LuaAllocator;
+
+// Runs the incremental collector of a Lua state at the end of each tick.
+// The amount of work done is proportional to the number of bytes allocated since the previous tick,
+// so states that don't allocate aren't stepped at all, while heavily allocating states are collected
+// before garbage can accumulate. Work is done in small steps until the per-tick time budget is used up;
+// any remaining debt is left to the allocation-triggered steps of the collector and the next tick.
+class LuaGCScheduler : public Noncopyable<LuaGCScheduler>
+{
+public:
+	// Default time budget for GC steps per tick, in microseconds
+	static constexpr uint32_t DefaultBudget = 1000;
+	// Amount of allocations (in KB) paid for by a single step; the budget is checked between steps
+	static constexpr int StepSizeKB = 16;
+	// Step size used to finish an in-progress collection cycle on ticks with no allocations
+	static constexpr int IdleStepSizeKB = 4;
+
+	struct Stats
+	{
+		uint64_t Ticks{ 0 };
+		// Ticks where no GC work was done
+		uint64_t IdleTicks{ 0 };
+		// Ticks where the time budget ran out before the allocations of the tick were paid for
+		uint64_t OverBudgetTicks{ 0 };
+		uint64_t Steps{ 0 };
+		// Number of collection cycles finished by the scheduler
+		uint64_t Cycles{ 0 };
+		// Bytes allocated during the previous tick
+		uint64_t LastTickAllocated{ 0 };
+		// Time spent in GC steps during the previous tick
+		std::chrono::steady_clock::duration LastTickTime{ 0 };
+		// Longest time spent in GC steps during a single tick
+		std::chrono::steady_clock::duration MaxTickTime{ 0 };
+		// Longest single GC step
+		std::chrono::steady_clock::duration MaxStepTime{ 0 };
+		std::chrono::steady_clock::duration TotalTime{ 0 };
+	};
+
+	// Applies the collector parameters; a pause or step multiplier of 0 keeps the Lua default
+	void Configure(lua_State* L, uint32_t budget, uint32_t pause, uint32_t stepMul);
+	void Update(lua_State* L, LuaAllocator const& allocator);
+	void ResetStats();
+
+	inline uint32_t GetBudget() const
+	{
+		return budget_;
+	}
+
+	inline void SetBudget(uint32_t budget)
+	{
+		budget_ = budget;
+	}
+
+	inline Stats const& GetStats() const
+	{
+		return stats_;
+	}
+
+	// Bytes the collector is behind; negative values are the bytes left until the next step is triggered
+	static int64_t GetDebt(lua_State* L);
+	static char const* GetCollectorState(lua_State* L);
+	static int GetPause(lua_State* L);
+	static int GetStepMul(lua_State* L);
+
+private:
+	uint32_t budget_{ DefaultBudget };
+	uint64_t lastBytesAllocated_{ 0 };
+	Stats stats_;
+
+	bool IsCollecting(lua_State* L) const;
+};
+
+END_NS()
@@ -0,0 +1,110 @@
+#include <Lua/Shared/LuaGCScheduler.h>
+#include <lgc.h>
+
+BEGIN_NS(lua)
+
+void LuaGCScheduler::Configure(lua_State* L, uint32_t budget, uint32_t pause, uint32_t stepMul)
+{
+	budget_ = budget;
+
+	if (pause != 0) {
+		lua_gc(L, LUA_GCSETPAUSE, (int)pause);
+	}
+
+	if (stepMul != 0) {
+		lua_gc(L, LUA_GCSETSTEPMUL, (int)stepMul);
+	}
+}
+
+void LuaGCScheduler::ResetStats()
+{
+	stats_ = Stats{};
+}
+
+bool LuaGCScheduler::IsCollecting(lua_State* L) const
+{
+	// While the collector is paused, the next cycle is started by the allocator when the debt becomes
+	// positive; stepping it earlier would only shorten the pause set by LUA_GCSETPAUSE
+	return G(L)->gcstate != GCSpause || G(L)->GCdebt > 0;
+}
+
+int64_t LuaGCScheduler::GetDebt(lua_State* L)
+{
+	return (int64_t)G(L)->GCdebt;
+}
+
+int LuaGCScheduler::GetPause(lua_State* L)
+{
+	return G(L)->gcpause;
+}
+
+int LuaGCScheduler::GetStepMul(lua_State* L)
+{
+	return G(L)->gcstepmul;
+}
+
+char const* LuaGCScheduler::GetCollectorState(lua_State* L)
+{
+	switch (G(L)->gcstate) {
+	case GCSpropagate: return "Propagate";
+	case GCSatomic: return "Atomic";
+	case GCSswpallgc:
+	case GCSswpfinobj:
+	case GCSswptobefnz:
+	case GCSswpend: return "Sweep";
+	case GCScallfin: return "CallFinalizers";
+	case GCSpause: return "Pause";
+	default: return "Unknown";
+	}
+}
+
+void LuaGCScheduler::Update(lua_State* L, LuaAllocator const& allocator)
+{
+	auto bytesAllocated = allocator.GetStats().BytesAllocated;
+	auto allocated = bytesAllocated - lastBytesAllocated_;
+	lastBytesAllocated_ = bytesAllocated;
+
+	stats_.Ticks++;
+	stats_.LastTickAllocated = allocated;
+	stats_.LastTickTime = std::chrono::steady_clock::duration{ 0 };
+
+	if (budget_ == 0 || !IsCollecting(L)) {
+		stats_.IdleTicks++;
+		return;
+	}
+
+	// Pay for the allocations of the last tick; if nothing was allocated, keep making some progress
+	// so that the garbage of an unfinished cycle is eventually released
+	int64_t debtKB = (allocated > 0) ? (int64_t)((allocated + 1023) / 1024) : IdleStepSizeKB;
+	auto budget = std::chrono::microseconds(budget_);
+	auto start = std::chrono::steady_clock::now();
+	auto stepStart = start;
+	bool cycleFinished{ false };
+
+	while (debtKB > 0) {
+		auto stepKB = (int)std::min<int64_t>(debtKB, StepSizeKB);
+		cycleFinished = lua_gc(L, LUA_GCSTEP, stepKB) == 1;
+		debtKB -= stepKB;
+		stats_.Steps++;
+
+		auto now = std::chrono::steady_clock::now();
+		stats_.MaxStepTime = std::max(stats_.MaxStepTime, now - stepStart);
+		stepStart = now;
+
+		if (cycleFinished || now - start >= budget) {
+			break;
+		}
+	}
+
+	if (cycleFinished) {
+		stats_.Cycles++;
+	} else if (debtKB > 0) {
+		stats_.OverBudgetTicks++;
+	}
+
+	stats_.LastTickTime = stepStart - start;
+	stats_.MaxTickTime = std::max(stats_.MaxTickTime, stats_.LastTickTime);
+	stats_.TotalTime += stats_.LastTickTime;
+}
+
+END_NS()
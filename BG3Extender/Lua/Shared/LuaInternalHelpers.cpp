@@ -12,6 +12,7 @@
 #include <lobject.h>
 #include <lstate.h>
 #include <lstring.h>
+#include <lgc.h>
 #include <lapi.h>
 
 BEGIN_NS(lua)
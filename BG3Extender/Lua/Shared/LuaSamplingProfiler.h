@@ -0,0 +1,154 @@
+#pragma once
+
+#include <lua.h>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+
+BEGIN_NS(lua)
+
+// Statistical profiler for Lua code.
+// A count hook interrupts the VM every N instructions and records the call stack at that point.
+// Each sample is attributed to the mod that owns the innermost mod function on the stack,
+// based on the chunk name assigned by LuaLoadModScript() ("<Mod directory>/<Script path>").
+//
+// Only one hook can be installed on a Lua state, so other hooks (i.e. the debugger) must be
+// installed using SetChainedHook(); the profiler forwards all non-count events to them while running.
+// Coroutines inherit the hook from the state that created them, so coroutines created before the
+// profiler was started are not sampled.
+class LuaSamplingProfiler : public Noncopyable<LuaSamplingProfiler>
+{
+public:
+	// Number of VM instructions between two samples
+	static constexpr uint32_t DefaultInterval = 1000;
+	// Stacks deeper than this are truncated at the outermost frames
+	static constexpr uint32_t MaxStackDepth = 64;
+
+	struct FrameInfo
+	{
+		char const* Source;
+		char const* Name;
+		char const* What;
+		int Line;
+	};
+
+	void Start(lua_State* L, uint32_t interval);
+	void Stop(lua_State* L);
+	void Reset();
+	// Installs a hook that is called alongside the profiler hook; count hooks are not supported
+	void SetChainedHook(lua_State* L, lua_Hook hook, int mask);
+
+	inline bool IsRunning() const
+	{
+		return running_;
+	}
+
+	inline uint32_t GetInterval() const
+	{
+		return interval_;
+	}
+
+	inline uint64_t GetSampleCount() const
+	{
+		return samples_;
+	}
+
+	// Records a sample; frames are ordered from the innermost to the outermost call
+	void AddSample(std::span<FrameInfo const> frames);
+	// Number of samples attributed to each mod
+	void GetModSamples(std::unordered_map<STDString, uint64_t>& samples) const;
+	// Returns the samples in the folded stack format ("Mod;Outer;...;Inner <count>" per line)
+	// that can be fed to flamegraph tools directly
+	STDString DumpFoldedStacks() const;
+
+	static STDString GetModName(char const* source);
+
+private:
+	// Frames are keyed by the contents of the source and name strings; the strings from lua_Debug
+	// may be collected after the sample is taken and their addresses reused for different strings.
+	// Lookups are made with a view of the strings, so no copies are made for frames that were seen before.
+	struct FrameKeyView
+	{
+		std::string_view Source;
+		std::string_view Name;
+		int Line;
+
+		inline bool operator == (FrameKeyView const& o) const
+		{
+			return Line == o.Line && Source == o.Source && Name == o.Name;
+		}
+	};
+
+	struct FrameKey
+	{
+		STDString Source;
+		STDString Name;
+		int Line;
+
+		inline operator FrameKeyView() const
+		{
+			return FrameKeyView{ Source, Name, Line };
+		}
+	};
+
+	struct FrameKeyHash
+	{
+		using is_transparent = void;
+
+		inline std::size_t operator () (FrameKeyView const& key) const
+		{
+			return std::hash<std::string_view>()(key.Source) ^ (std::hash<std::string_view>()(key.Name) << 1) ^ ((std::size_t)key.Line << 7);
+		}
+	};
+
+	struct FrameKeyEqual
+	{
+		using is_transparent = void;
+
+		inline bool operator () (FrameKeyView const& a, FrameKeyView const& b) const
+		{
+			return a == b;
+		}
+	};
+
+	// Node of the call tree; the first level of the tree are the mods, the subsequent levels
+	// are the Lua frames from the outermost to the innermost call
+	struct StackNode
+	{
+		uint32_t Parent;
+		uint32_t Frame;
+		uint64_t Samples;
+	};
+
+	struct Frame
+	{
+		STDString Label;
+		// Frame ID of the mod that owns the function, or NoFrame for C functions and unknown chunks
+		uint32_t Mod;
+	};
+
+	static constexpr uint32_t NoFrame = 0xffffffffu;
+
+	bool running_{ false };
+	lua_Hook chainedHook_{ nullptr };
+	int chainedMask_{ 0 };
+	uint32_t interval_{ DefaultInterval };
+	uint64_t samples_{ 0 };
+	// The label is only built the first time a frame is encountered
+	std::unordered_map<FrameKey, uint32_t, FrameKeyHash, FrameKeyEqual> frameIds_;
+	std::unordered_map<STDString, uint32_t> modFrameIds_;
+	Vector<Frame> frames_;
+	uint32_t builtinFrame_{ NoFrame };
+	std::unordered_map<uint64_t, uint32_t> children_;
+	Vector<StackNode> nodes_;
+
+	uint32_t GetFrameId(FrameInfo const& frame);
+	uint32_t GetModFrameId(STDString const& mod);
+	uint32_t GetChild(uint32_t parent, uint32_t frame);
+	void Sample(lua_State* L);
+
+	static STDString MakeFrameLabel(FrameInfo const& frame);
+	static void OnLuaHook(lua_State* L, lua_Debug* ar);
+};
+
+END_NS()
@@ -0,0 +1,267 @@
+#include <Lua/Shared/LuaSamplingProfiler.h>
+
+BEGIN_NS(lua)
+
+void LuaSamplingProfiler::Start(lua_State* L, uint32_t interval)
+{
+	auto hook = lua_gethook(L);
+	if (hook != &OnLuaHook) {
+		chainedHook_ = hook;
+		chainedMask_ = hook ? (lua_gethookmask(L) & ~LUA_MASKCOUNT) : 0;
+	}
+
+	interval_ = std::max(interval, 1u);
+	lua_sethook(L, &OnLuaHook, chainedMask_ | LUA_MASKCOUNT, (int)interval_);
+	running_ = true;
+}
+
+void LuaSamplingProfiler::Stop(lua_State* L)
+{
+	if (lua_gethook(L) == &OnLuaHook) {
+		lua_sethook(L, chainedHook_, chainedMask_, 0);
+	}
+
+	running_ = false;
+}
+
+void LuaSamplingProfiler::SetChainedHook(lua_State* L, lua_Hook hook, int mask)
+{
+	chainedHook_ = hook;
+	chainedMask_ = hook ? mask : 0;
+
+	if (running_) {
+		lua_sethook(L, &OnLuaHook, chainedMask_ | LUA_MASKCOUNT, (int)interval_);
+	} else {
+		lua_sethook(L, chainedHook_, chainedMask_, 0);
+	}
+}
+
+void LuaSamplingProfiler::Reset()
+{
+	samples_ = 0;
+	frameIds_.clear();
+	modFrameIds_.clear();
+	frames_.clear();
+	children_.clear();
+	nodes_.clear();
+	builtinFrame_ = NoFrame;
+}
+
+STDString LuaSamplingProfiler::GetModName(char const* source)
+{
+	if (source == nullptr || *source == '=' || *source == '@') {
+		return {};
+	}
+
+	std::string_view src(source);
+	if (src.starts_with("builtin://")) {
+		return "Builtin";
+	}
+
+	auto sep = src.find('/');
+	if (sep == std::string_view::npos || sep == 0) {
+		return {};
+	}
+
+	return STDString(src.substr(0, sep));
+}
+
+STDString LuaSamplingProfiler::MakeFrameLabel(FrameInfo const& frame)
+{
+	STDString label;
+	if (frame.What != nullptr && strcmp(frame.What, "C") == 0) {
+		label = frame.Name ? frame.Name : "?";
+		label += " [C]";
+	} else {
+		if (frame.What != nullptr && strcmp(frame.What, "main") == 0) {
+			label = "main chunk";
+		} else {
+			label = frame.Name ? frame.Name : "?";
+		}
+
+		label += " (";
+		label += frame.Source ? frame.Source : "?";
+		label += ":";
+		label += std::to_string(frame.Line).c_str();
+		label += ")";
+	}
+
+	// Semicolons separate frames and newlines separate stacks in the folded format
+	for (auto& c : label) {
+		if (c == ';' || c == '\n' || c == '\r') {
+			c = ' ';
+		}
+	}
+
+	return label;
+}
+
+uint32_t LuaSamplingProfiler::GetModFrameId(STDString const& mod)
+{
+	auto it = modFrameIds_.find(mod);
+	if (it != modFrameIds_.end()) {
+		return it->second;
+	}
+
+	auto id = (uint32_t)frames_.size();
+	frames_.push_back(Frame{ mod, NoFrame });
+	modFrameIds_.insert(std::make_pair(mod, id));
+	return id;
+}
+
+uint32_t LuaSamplingProfiler::GetFrameId(FrameInfo const& frame)
+{
+	FrameKeyView key{
+		frame.Source ? std::string_view(frame.Source) : std::string_view(),
+		frame.Name ? std::string_view(frame.Name) : std::string_view(),
+		frame.Line
+	};
+	auto it = frameIds_.find(key);
+	if (it != frameIds_.end()) {
+		return it->second;
+	}
+
+	auto mod = GetModName(frame.Source);
+	auto modFrame = mod.empty() ? NoFrame : GetModFrameId(mod);
+	if (mod == "Builtin") {
+		builtinFrame_ = modFrame;
+	}
+
+	auto id = (uint32_t)frames_.size();
+	frames_.push_back(Frame{ MakeFrameLabel(frame), modFrame });
+	frameIds_.insert(std::make_pair(FrameKey{ STDString(key.Source), STDString(key.Name), key.Line }, id));
+	return id;
+}
+
+uint32_t LuaSamplingProfiler::GetChild(uint32_t parent, uint32_t frame)
+{
+	if (nodes_.empty()) {
+		// Root node
+		nodes_.push_back(StackNode{ NoFrame, NoFrame, 0 });
+	}
+
+	auto key = ((uint64_t)parent << 32) | frame;
+	auto it = children_.find(key);
+	if (it != children_.end()) {
+		return it->second;
+	}
+
+	auto id = (uint32_t)nodes_.size();
+	nodes_.push_back(StackNode{ parent, frame, 0 });
+	children_.insert(std::make_pair(key, id));
+	return id;
+}
+
+void LuaSamplingProfiler::AddSample(std::span<FrameInfo const> frames)
+{
+	std::array<uint32_t, MaxStackDepth> frameIds;
+	auto depth = std::min(frames.size(), frameIds.size());
+
+	// Attribute the sample to the innermost mod function; builtin library code
+	// is only blamed if no mod code is on the stack
+	uint32_t mod = NoFrame;
+	uint32_t fallbackMod = NoFrame;
+	for (std::size_t i = 0; i < depth; i++) {
+		frameIds[i] = GetFrameId(frames[i]);
+		auto frameMod = frames_[frameIds[i]].Mod;
+		if (mod == NoFrame && frameMod != NoFrame) {
+			if (frameMod == builtinFrame_) {
+				fallbackMod = frameMod;
+			} else {
+				mod = frameMod;
+			}
+		}
+	}
+
+	if (mod == NoFrame) {
+		mod = (fallbackMod != NoFrame) ? fallbackMod : GetModFrameId("Other");
+	}
+
+	auto node = GetChild(0, mod);
+	for (auto i = depth; i > 0; i--) {
+		node = GetChild(node, frameIds[i - 1]);
+	}
+
+	nodes_[node].Samples++;
+	samples_++;
+}
+
+void LuaSamplingProfiler::Sample(lua_State* L)
+{
+	std::array<FrameInfo, MaxStackDepth> frames;
+	uint32_t depth = 0;
+	lua_Debug ar;
+	while (depth < MaxStackDepth && lua_getstack(L, depth, &ar)) {
+		lua_getinfo(L, "Sn", &ar);
+		frames[depth++] = FrameInfo{ ar.source, ar.name, ar.what, ar.linedefined };
+	}
+
+	AddSample(std::span<FrameInfo const>(frames.data(), depth));
+}
+
+void LuaSamplingProfiler::GetModSamples(std::unordered_map<STDString, uint64_t>& samples) const
+{
+	for (auto const& node : nodes_) {
+		if (node.Parent == 0) {
+			samples[frames_[node.Frame].Label] = 0;
+		}
+	}
+
+	// Walk up to the mod node of each stack that has samples
+	for (auto const& node : nodes_) {
+		if (node.Samples == 0) continue;
+
+		auto cur = &node;
+		while (cur->Parent != 0) {
+			cur = &nodes_[cur->Parent];
+		}
+
+		samples[frames_[cur->Frame].Label] += node.Samples;
+	}
+}
+
+STDString LuaSamplingProfiler::DumpFoldedStacks() const
+{
+	STDString folded;
+	Vector<uint32_t> stack;
+	for (auto const& node : nodes_) {
+		if (node.Samples == 0) continue;
+
+		stack.clear();
+		for (auto cur = &node; cur->Frame != NoFrame; cur = &nodes_[cur->Parent]) {
+			stack.push_back(cur->Frame);
+		}
+
+		for (auto i = stack.size(); i > 0; i--) {
+			folded += frames_[stack[i - 1]].Label;
+			folded += (i > 1) ? ";" : " ";
+		}
+
+		folded += std::to_string(node.Samples).c_str();
+		folded += "\n";
+	}
+
+	return folded;
+}
+
+void LuaSamplingProfiler::OnLuaHook(lua_State* L, lua_Debug* ar)
+{
+	auto& profiler = State::FromLua(L)->GetSamplingProfiler();
+	if (!profiler.running_) {
+		// Coroutines inherit the hook of their parent thread when they're created, so they may still
+		// have the sampling hook after Stop(); drop the count event from this thread's hook mask
+		lua_sethook(L, profiler.chainedHook_, profiler.chainedMask_, 0);
+		if (ar->event != LUA_HOOKCOUNT && profiler.chainedHook_ != nullptr) {
+			profiler.chainedHook_(L, ar);
+		}
+		return;
+	}
+
+	if (ar->event == LUA_HOOKCOUNT) {
+		profiler.Sample(L);
+	} else if (profiler.chainedHook_ != nullptr) {
+		profiler.chainedHook_(L, ar);
+	}
+}
+
+END_NS()
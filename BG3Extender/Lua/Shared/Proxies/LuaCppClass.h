@@ -247,6 +247,36 @@ public:
 		}
 	}
 
+	// __pairs implementation for classes that iterate using a cursor instead of looking up the previous key.
+	// The cursor is kept in an upvalue of the iterator function and is passed to TSubclass::Next().
+	static int CursorPairs(lua_State* L, CppObjectMetadata const& self)
+	{
+		StackCheck _(L, 3);
+		push(L, (int64_t)0);
+		lua_pushcclosure(L, &CursorNextProxy, 1);
+		lua_pushvalue(L, 1);
+		push(L, nullptr);
+
+		return 3;
+	}
+
+	static int CursorNextProxy(lua_State* L)
+	{
+		CppObjectMetadata self;
+		lua_get_cppobject(L, 1, TSubclass::MetaTag, self);
+
+		if (!self.Lifetime.IsAlive(L)) {
+			luaL_error(L, "Attempted to iterate '%s' whose lifetime has expired", TSubclass::GetTypeName(L, self));
+			return 0;
+		}
+
+		auto cursor = (uint64_t)lua_tointeger(L, lua_upvalueindex(1));
+		auto results = TSubclass::Next(L, self, cursor);
+		push(L, (int64_t)cursor);
+		lua_replace(L, lua_upvalueindex(1));
+		return results;
+	}
+
 	static int NameProxy(lua_State* L)
 	{
 		StackCheck _(L, 1);
@@ -7,6 +7,8 @@ BEGIN_NS(lua)
 struct CppObjectProxyHelpers
 {
 	static int Next(lua_State* L, GenericPropertyMap const& pm, void* object, LifetimeHandle const& lifetime, FixedString const& key);
+	// Cursor: index of the next property in IterableProperties
+	static int Next(lua_State* L, GenericPropertyMap const& pm, void* object, LifetimeHandle const& lifetime, uint64_t& cursor);
 };
 
 
@@ -51,7 +53,8 @@ public:
 	static int NewIndex(lua_State* L, CppObjectMetadata& self);
 	static int ToString(lua_State* L, CppObjectMetadata& self);
 	static bool IsEqual(lua_State* L, CppObjectMetadata& self, CppObjectMetadata& other);
-	static int Next(lua_State* L, CppObjectMetadata& self);
+	static int Pairs(lua_State* L, CppObjectMetadata& self);
+	static int Next(lua_State* L, CppObjectMetadata& self, uint64_t& cursor);
 	static char const* GetTypeName(lua_State* L, CppObjectMetadata& self);
 };
 
@@ -5,33 +5,31 @@ BEGIN_NS(lua)
 
 int CppObjectProxyHelpers::Next(lua_State* L, GenericPropertyMap const& pm, void* object, LifetimeHandle const& lifetime, FixedString const& key)
 {
-	if (!key) {
-		if (!pm.IterableProperties.empty()) {
-			StackCheck _(L, 2);
-			auto it = pm.IterableProperties.begin();
-			push(L, it.Key());
-			auto const& prop = pm.Properties.values()[it.Value()];
-			if (pm.GetRawProperty(L, lifetime, object, prop) != PropertyOperationResult::Success) {
-				push(L, nullptr);
-			}
-
-			return 2;
+	uint64_t cursor{ 0 };
+	if (key) {
+		auto index = pm.IterableProperties.find_index(key);
+		if (index == -1) {
+			return 0;
 		}
-	} else {
-		auto it = pm.IterableProperties.find(key);
-		if (it != pm.IterableProperties.end()) {
-			++it;
-			if (it != pm.IterableProperties.end()) {
-				StackCheck _(L, 2);
-				push(L, it.Key());
-				auto const& prop = pm.Properties.values()[it.Value()];
-				if (pm.GetRawProperty(L, lifetime, object, prop) != PropertyOperationResult::Success) {
-					push(L, nullptr);
-				}
-
-				return 2;
-			}
+
+		cursor = (uint64_t)index + 1;
+	}
+
+	return Next(L, pm, object, lifetime, cursor);
+}
+
+int CppObjectProxyHelpers::Next(lua_State* L, GenericPropertyMap const& pm, void* object, LifetimeHandle const& lifetime, uint64_t& cursor)
+{
+	if (cursor < pm.IterableProperties.size()) {
+		StackCheck _(L, 2);
+		auto index = (uint32_t)cursor++;
+		push(L, pm.IterableProperties.keys()[index]);
+		auto const& prop = pm.Properties.values()[pm.IterableProperties.values()[index]];
+		if (pm.GetRawProperty(L, lifetime, object, prop) != PropertyOperationResult::Success) {
+			push(L, nullptr);
 		}
+
+		return 2;
 	}
 
 	return 0;
@@ -208,15 +206,15 @@ bool LightObjectProxyByRefMetatable::IsEqual(lua_State* L, CppObjectMetadata& se
 	return self.Ptr == other.Ptr && self.PropertyMapTag == other.PropertyMapTag;
 }
 
-int LightObjectProxyByRefMetatable::Next(lua_State* L, CppObjectMetadata& self)
+int LightObjectProxyByRefMetatable::Pairs(lua_State* L, CppObjectMetadata& self)
+{
+	return CursorPairs(L, self);
+}
+
+int LightObjectProxyByRefMetatable::Next(lua_State* L, CppObjectMetadata& self, uint64_t& cursor)
 {
 	auto pm = gStructRegistry.Get(self.PropertyMapTag);
-	if (lua_type(L, 2) == LUA_TNIL) {
-		return CppObjectProxyHelpers::Next(L, *pm, self.Ptr, self.Lifetime, FixedString{});
-	} else {
-		auto key = get<FixedString>(L, 2);
-		return CppObjectProxyHelpers::Next(L, *pm, self.Ptr, self.Lifetime, key);
-	}
+	return CppObjectProxyHelpers::Next(L, *pm, self.Ptr, self.Lifetime, cursor);
 }
 
 char const* LightObjectProxyByRefMetatable::GetTypeName(lua_State* L, CppObjectMetadata& self)
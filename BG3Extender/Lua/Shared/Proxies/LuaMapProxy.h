@@ -14,7 +14,8 @@ public:
 	virtual TypeInformation const& GetValueType() const = 0;
 	virtual bool GetValue(lua_State* L, CppObjectMetadata& self, int luaKeyIndex) = 0;
 	virtual bool SetValue(lua_State* L, CppObjectMetadata& self, int luaKeyIndex, int luaValueIndex) = 0;
-	virtual int Next(lua_State* L, CppObjectMetadata& self, int luaKeyIndex) = 0;
+	// Pushes the key and value at the cursor and advances the cursor; a zero cursor starts from the first element
+	virtual int Next(lua_State* L, CppObjectMetadata& self, uint64_t& cursor) = 0;
 	virtual unsigned Length(CppObjectMetadata& self) = 0;
 	virtual bool Unserialize(lua_State* L, CppObjectMetadata& self, int index) = 0;
 	virtual void Serialize(lua_State* L, CppObjectMetadata& self) = 0;
@@ -90,25 +91,16 @@ public:
 		return obj->keys().size();
 	}
 
-	int Next(lua_State* L, CppObjectMetadata& self, int luaKeyIndex) override
+	// Cursor: index of the next element in the key/value arrays
+	int Next(lua_State* L, CppObjectMetadata& self, uint64_t& cursor) override
 	{
 		auto obj = reinterpret_cast<ContainerType*>(self.Ptr);
-		if (lua_type(L, luaKeyIndex) == LUA_TNIL) {
-			if (!obj->empty()) {
-				// TODO - jank, but const proxies are not supported yet
-				push(L, const_cast<TKey*>(&obj->keys()[0]), self.Lifetime);
-				push(L, &obj->values()[0], self.Lifetime);
-				return 2;
-			}
-		} else {
-			auto key = get<TKey>(L, luaKeyIndex);
-			auto index = obj->find_index(key);
-			if (index != -1 && index < (int)obj->keys().size() - 1) {
-				// TODO - jank, but const proxies are not supported yet
-				push(L, const_cast<TKey*>(&obj->keys()[index + 1]), self.Lifetime);
-				push(L, &obj->values()[index + 1], self.Lifetime);
-				return 2;
-			}
+		if (cursor < obj->keys().size()) {
+			auto index = (uint32_t)cursor++;
+			// TODO - jank, but const proxies are not supported yet
+			push(L, const_cast<TKey*>(&obj->keys()[index]), self.Lifetime);
+			push(L, &obj->values()[index], self.Lifetime);
+			return 2;
 		}
 
 		return 0;
@@ -201,32 +193,31 @@ public:
 		return obj->size();
 	}
 
-	int Next(lua_State* L, CppObjectMetadata& self, int luaKeyIndex) override
+	// Cursor: hash bucket of the next element in the upper 32 bits, position in the bucket chain in the lower 32 bits.
+	// Unlike node pointers, this stays safe to use if the map is modified during iteration.
+	int Next(lua_State* L, CppObjectMetadata& self, uint64_t& cursor) override
 	{
 		auto obj = reinterpret_cast<ContainerType*>(self.Ptr);
-		if (lua_type(L, luaKeyIndex) == LUA_TNIL) {
-			auto it = obj->begin();
-			if (it != obj->end()) {
-				push(L, &it.Key(), self.Lifetime);
-				push(L, &it.Value(), self.Lifetime);
-				return 2;
-			}
-		} else {
-			auto key = get<TKey>(L, luaKeyIndex);
-			auto it = obj->find(key);
-			if (it != obj->end()) {
-				it++;
-				if (it != obj->end()) {
-					push(L, &it.Key(), self.Lifetime);
-					push(L, &it.Value(), self.Lifetime);
-					return 2;
-				}
-			}
+		auto bucket = (uint32_t)(cursor >> 32);
+		auto depth = (uint32_t)(cursor & 0xffffffffull);
+		auto node = obj->seek(bucket, depth, &visitedNodes_);
+		if (node != nullptr) {
+			cursor = ((uint64_t)bucket << 32) | (depth + 1);
+			push(L, &node->Key, self.Lifetime);
+			push(L, &node->Value, self.Lifetime);
+			return 2;
 		}
 
+		cursor = (uint64_t)bucket << 32;
 		return 0;
 	}
 
+	// Number of hash table slots and chain links read by Next() over all maps of this type
+	inline uint64_t GetVisitedNodes() const
+	{
+		return visitedNodes_;
+	}
+
 	bool Unserialize(lua_State* L, CppObjectMetadata& self, int index) override
 	{
 		auto obj = reinterpret_cast<ContainerType*>(self.Ptr);
@@ -243,6 +234,9 @@ public:
 		auto obj = reinterpret_cast<ContainerType*>(self.Ptr);
 		lua::Serialize(L, obj);
 	}
+
+private:
+	uint64_t visitedNodes_{ 0 };
 };
 
 
@@ -299,7 +293,8 @@ public:
 	static int Index(lua_State* L, CppObjectMetadata& self);
 	static int NewIndex(lua_State* L, CppObjectMetadata& self);
 	static int Length(lua_State* L, CppObjectMetadata& self);
-	static int Next(lua_State* L, CppObjectMetadata& self);
+	static int Pairs(lua_State* L, CppObjectMetadata& self);
+	static int Next(lua_State* L, CppObjectMetadata& self, uint64_t& cursor);
 	static int ToString(lua_State* L, CppObjectMetadata& self);
 	static bool IsEqual(lua_State* L, CppObjectMetadata& self, CppObjectMetadata& other);
 	static char const* GetTypeName(lua_State* L, CppObjectMetadata& self);
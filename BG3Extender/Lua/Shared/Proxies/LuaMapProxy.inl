@@ -44,10 +44,15 @@ int MapProxyMetatable::Length(lua_State* L, CppObjectMetadata& self)
 	return 1;
 }
 
-int MapProxyMetatable::Next(lua_State* L, CppObjectMetadata& self)
+int MapProxyMetatable::Pairs(lua_State* L, CppObjectMetadata& self)
+{
+	return CursorPairs(L, self);
+}
+
+int MapProxyMetatable::Next(lua_State* L, CppObjectMetadata& self, uint64_t& cursor)
 {
 	auto impl = gExtender->GetPropertyMapManager().GetMapProxy(self.PropertyMapTag);
-	return impl->Next(L, self, 2);
+	return impl->Next(L, self, cursor);
 }
 
 int MapProxyMetatable::ToString(lua_State* L, CppObjectMetadata& self)
@@ -568,6 +568,12 @@ void InitObjectProxyPropertyMaps()
 	ProcessClassRegistrations(std::span(AllClassDefns));
 	UpdateInheritance();
 
+	for (auto pm : gStructRegistry.StructsById) {
+		if (pm != nullptr) {
+			pm->Freeze();
+		}
+	}
+
 	initialized = true;
 }
 
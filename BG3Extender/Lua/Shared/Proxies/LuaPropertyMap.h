@@ -32,6 +32,58 @@ struct RawPropertyAccessors
 	bool Iterable{ true };
 };
 
+// Minimal perfect hash (hash and displace) of the property names of a finished property map.
+// Lookups are keyed on the GFS index of the name, so unlike MultiHashMap they don't need to fetch the
+// string hash from the global string table, and always take exactly one probe.
+class PropertyLookupTable
+{
+public:
+	bool Build(Array<FixedString> const& keys);
+
+	inline bool IsBuilt() const
+	{
+		return !slots_.empty();
+	}
+
+	// Returns the index of the property in the property map, or -1 if it doesn't exist
+	inline int32_t Find(FixedString const& key) const
+	{
+		auto bucket = BucketHash(key.Index) >> bucketShift_;
+		auto const& slot = slots_[Hash(key.Index, displacements_[bucket]) >> slotShift_];
+		return slot.Key == key.Index ? slot.Index : -1;
+	}
+
+private:
+	struct Slot
+	{
+		uint32_t Key{ FixedString::NullIndex };
+		int32_t Index{ -1 };
+	};
+
+	Array<Slot> slots_;
+	Array<uint16_t> displacements_;
+	uint32_t bucketShift_{ 0 };
+	uint32_t slotShift_{ 0 };
+
+	static inline uint64_t BucketHash(uint32_t key)
+	{
+		return key * 0x9E3779B97F4A7C15ull;
+	}
+
+	static inline uint64_t Hash(uint32_t key, uint32_t seed)
+	{
+		// MurmurHash3 finalizer
+		auto h = ((uint64_t)seed << 32) | key;
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdull;
+		h ^= h >> 33;
+		h *= 0xc4ceb9fe1a85ec53ull;
+		return h ^ (h >> 33);
+	}
+
+	bool TryBuild(Array<FixedString> const& keys, uint32_t bucketBits, uint32_t slotBits);
+};
+
 class GenericPropertyMap : Noncopyable<GenericPropertyMap>
 {
 public:
@@ -62,6 +114,9 @@ public:
 
 	void Init();
 	void Finish();
+	// Builds the property lookup table; no properties can be added afterwards
+	void Freeze();
+	RawPropertyAccessors const* FindProperty(FixedString const& prop) const;
 	bool HasProperty(FixedString const& prop) const;
 	PropertyOperationResult GetRawProperty(lua_State* L, LifetimeHandle const& lifetime, void* object, FixedString const& prop) const;
 	PropertyOperationResult GetRawProperty(lua_State* L, LifetimeHandle const& lifetime, void* object, RawPropertyAccessors const& prop) const;
@@ -81,6 +136,7 @@ public:
 	FixedString Name;
 	MultiHashMap<FixedString, RawPropertyAccessors> Properties;
 	MultiHashMap<FixedString, uint32_t> IterableProperties;
+	PropertyLookupTable Lookup;
 	Array<RawPropertyValidators> Validators;
 	Array<FixedString> Parents;
 	Array<int> ParentRegistryIndices;
@@ -29,14 +29,114 @@ void GenericPropertyMap::Finish()
 	Initialized = true;
 }
 
+bool PropertyLookupTable::Build(Array<FixedString> const& keys)
+{
+	// ~2 keys per bucket, load factor between 0.5 and 1
+	uint32_t bucketBits = 1;
+	while ((1u << bucketBits) < keys.size() / 2) bucketBits++;
+
+	uint32_t slotBits = 1;
+	while ((1u << slotBits) < keys.size()) slotBits++;
+
+	// Give up if the table would get unreasonably sparse; Find() must not be used in that case
+	for (auto maxSlotBits = slotBits + 3; slotBits <= maxSlotBits; slotBits++) {
+		if (TryBuild(keys, bucketBits, slotBits)) {
+			return true;
+		}
+	}
+
+	slots_.clear();
+	displacements_.clear();
+	return false;
+}
+
+bool PropertyLookupTable::TryBuild(Array<FixedString> const& keys, uint32_t bucketBits, uint32_t slotBits)
+{
+	bucketShift_ = 64 - bucketBits;
+	slotShift_ = 64 - slotBits;
+
+	Array<Array<uint32_t>> buckets;
+	buckets.resize(1 << bucketBits);
+	for (uint32_t i = 0; i < keys.size(); i++) {
+		buckets[(uint32_t)(BucketHash(keys[i].Index) >> bucketShift_)].push_back(i);
+	}
+
+	// Place the largest buckets first while the table is still mostly empty
+	Array<uint32_t> order;
+	for (uint32_t i = 0; i < buckets.size(); i++) {
+		order.push_back(i);
+	}
+
+	std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+		return buckets[a].size() > buckets[b].size();
+	});
+
+	slots_.clear();
+	slots_.resize(1 << slotBits);
+	displacements_.clear();
+	displacements_.resize(1 << bucketBits);
+	Array<uint32_t> placed;
+
+	for (auto bucketIndex : order) {
+		auto const& bucket = buckets[bucketIndex];
+		if (bucket.empty()) break;
+
+		bool found{ false };
+		for (uint32_t seed = 1; seed <= 0xffff && !found; seed++) {
+			placed.clear();
+			found = true;
+			for (auto keyIndex : bucket) {
+				auto slot = (uint32_t)(Hash(keys[keyIndex].Index, seed) >> slotShift_);
+				if (slots_[slot].Index != -1 || std::find(placed.begin(), placed.end(), slot) != placed.end()) {
+					found = false;
+					break;
+				}
+
+				placed.push_back(slot);
+			}
+
+			if (found) {
+				displacements_[bucketIndex] = (uint16_t)seed;
+				for (uint32_t i = 0; i < bucket.size(); i++) {
+					slots_[placed[i]] = Slot{ keys[bucket[i]].Index, (int32_t)bucket[i] };
+				}
+			}
+		}
+
+		if (!found) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void GenericPropertyMap::Freeze()
+{
+	assert(Initialized && InheritanceUpdated && !IsInitializing);
+	if (!Properties.empty() && !Lookup.Build(Properties.keys())) {
+		WARN("Couldn't build property lookup table for %s", Name.GetString());
+	}
+}
+
+RawPropertyAccessors const* GenericPropertyMap::FindProperty(FixedString const& prop) const
+{
+	if (Lookup.IsBuilt()) {
+		auto index = Lookup.Find(prop);
+		return index != -1 ? &Properties.values()[index] : nullptr;
+	} else {
+		return Properties.try_get(prop);
+	}
+}
+
 bool GenericPropertyMap::HasProperty(FixedString const& prop) const
 {
-	return Properties.find(prop) != Properties.end();
+	return FindProperty(prop) != nullptr;
 }
 
 PropertyOperationResult GenericPropertyMap::GetRawProperty(lua_State* L, LifetimeHandle const& lifetime, void* object, FixedString const& prop) const
 {
-	auto it = Properties.try_get(prop);
+	auto it = FindProperty(prop);
 	if (it == nullptr) {
 		if (FallbackGetter) {
 			return FallbackGetter(L, lifetime, object, prop);
@@ -55,7 +155,7 @@ PropertyOperationResult GenericPropertyMap::GetRawProperty(lua_State* L, Lifetim
 
 PropertyOperationResult GenericPropertyMap::SetRawProperty(lua_State* L, void* object, FixedString const& prop, int index) const
 {
-	auto it = Properties.try_get(prop);
+	auto it = FindProperty(prop);
 	if (it == nullptr) {
 		if (FallbackSetter) {
 			return FallbackSetter(L, object, prop, index);
@@ -71,7 +171,7 @@ void GenericPropertyMap::AddRawProperty(char const* prop, typename RawPropertyAc
 	typename RawPropertyAccessors::Setter* setter, typename RawPropertyAccessors::Serializer* serialize, 
 	std::size_t offset, uint64_t flag, PropertyNotification notification, char const* newName, bool iterable)
 {
-	assert((!Initialized || !InheritanceUpdated) && IsInitializing);
+	assert((!Initialized || !InheritanceUpdated) && IsInitializing && !Lookup.IsBuilt());
 	FixedString key{ prop };
 	FixedString newNameKey{ newName ? newName : "" };
 	assert(Properties.find(key) == Properties.end());
@@ -1,5 +1,5 @@
 local _I = Ext._Internal
-local SubscribableEvent = Ext.CoreLib("Events/SubscribableEvent")
+local NativeSubscribableEvent = Ext.CoreLib("Events/NativeSubscribableEvent")
 local MissingSubscribableEvent = Ext.CoreLib("Events/MissingSubscribableEvent")
 
 local EventManager = {}
@@ -19,7 +19,7 @@ end
 
 
 function EventManager:RegisterEngineEvent(event)
-	self.Events[event] = SubscribableEvent:New(event)
+	self.Events[event] = NativeSubscribableEvent:New(event)
 end
 
 
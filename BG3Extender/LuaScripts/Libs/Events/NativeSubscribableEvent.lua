@@ -0,0 +1,26 @@
+local _N = Ext._NativeEvents
+
+-- Engine event whose subscriber list is kept in the native event bus.
+-- Events without subscribers are skipped by the engine without calling into Lua.
+local NativeSubscribableEvent = {}
+
+function NativeSubscribableEvent:Instantiate(name)
+	return {
+		Name = name
+	}
+end
+
+function NativeSubscribableEvent:Subscribe(handler, opts)
+	opts = opts or {}
+	return _N.Subscribe(self.Name, handler, opts.Priority or 100, opts.Once or false)
+end
+
+function NativeSubscribableEvent:Unsubscribe(handlerIndex)
+	_N.Unsubscribe(self.Name, handlerIndex)
+end
+
+function NativeSubscribableEvent:Throw(event)
+	_N.Throw(self.Name, event)
+end
+
+return Class.Create(NativeSubscribableEvent)
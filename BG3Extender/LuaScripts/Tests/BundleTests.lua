@@ -0,0 +1,118 @@
+local BundleScripts = {
+    ["Libs/Compressible.lua"] = string.rep("local x = 1\n", 500),
+    ["Libs/Other.lua"] = string.rep("Ext.Utils.Print('SE_BundleTest')\n", 200),
+    ["Tiny.lua"] = "x",
+    ["Empty.lua"] = ""
+}
+
+-- Offsets of the fields in the bundle header and table of contents entries (see LuaBundleFormat.h)
+local HeaderSize = 16
+local EntrySize = 24
+local EntryDataOffset = 8
+local EntryUncompressedSize = 16
+local EntryFlags = 20
+
+local function FindBundleEntry(result, name)
+    for i,entry in ipairs(result.Entries) do
+        if entry.Name == name then
+            return entry
+        end
+    end
+end
+
+function TestLuaBundleRoundTrip()
+    local result = Ext.Debug.LuaBundleRoundTrip(BundleScripts)
+    Assert(result.Loaded)
+    AssertEquals(#result.Entries, 4)
+
+    for name,body in pairs(BundleScripts) do
+        AssertEquals(result.Scripts[name], body)
+    end
+
+    -- Entries must be sorted by name for the binary search
+    for i=2,#result.Entries do
+        Assert(result.Entries[i - 1].Name < result.Entries[i].Name)
+    end
+
+    Assert(FindBundleEntry(result, "Libs/Compressible.lua").Compressed)
+    Assert(FindBundleEntry(result, "Libs/Compressible.lua").DataSize < #BundleScripts["Libs/Compressible.lua"])
+    AssertEquals(FindBundleEntry(result, "Tiny.lua").Compressed, false)
+    AssertEquals(FindBundleEntry(result, "Empty.lua").DataSize, 0)
+
+    for i,entry in ipairs(result.Entries) do
+        AssertEquals(entry.DataOffset % 16, 0)
+    end
+
+    -- Lookups of names that aren't in the bundle, including prefixes of existing names
+    result = Ext.Debug.LuaBundleRoundTrip(BundleScripts, { Lookup = { "Missing.lua", "Libs", "Libs/Compressible.lua2", "" } })
+    Assert(result.Loaded)
+    AssertEquals(next(result.Scripts), nil)
+end
+
+-- Scripts are only decompressed when they're looked up, and only once
+function TestLuaBundleLazyLookup()
+    local result = Ext.Debug.LuaBundleRoundTrip(BundleScripts, { Lookup = {} })
+    AssertEquals(result.Decompressed, 0)
+
+    result = Ext.Debug.LuaBundleRoundTrip(BundleScripts, { Lookup = { "Tiny.lua", "Empty.lua" } })
+    AssertEquals(result.Decompressed, 0)
+
+    result = Ext.Debug.LuaBundleRoundTrip(BundleScripts, { Lookup = { "Libs/Compressible.lua", "Libs/Compressible.lua" } })
+    AssertEquals(result.Decompressed, 1)
+    AssertEquals(result.Scripts["Libs/Compressible.lua"], BundleScripts["Libs/Compressible.lua"])
+    AssertEquals(result.Scripts["Libs/Other.lua"], nil)
+end
+
+function TestLuaBundleTruncated()
+    local result = Ext.Debug.LuaBundleRoundTrip(BundleScripts)
+    local tocSize = HeaderSize + #result.Entries * EntrySize
+    local lastDataEnd = 0
+    for i,entry in ipairs(result.Entries) do
+        lastDataEnd = math.max(lastDataEnd, entry.DataOffset + entry.DataSize)
+    end
+
+    for i,size in ipairs({ 0, 1, HeaderSize - 1, HeaderSize, tocSize - 1, tocSize, lastDataEnd - 1 }) do
+        AssertEquals(Ext.Debug.LuaBundleRoundTrip(BundleScripts, { Truncate = size }).Loaded, false)
+    end
+
+    -- Alignment padding after the last entry isn't needed
+    Assert(Ext.Debug.LuaBundleRoundTrip(BundleScripts, { Truncate = lastDataEnd }).Loaded)
+end
+
+function TestLuaBundleCorrupt()
+    local result = Ext.Debug.LuaBundleRoundTrip(BundleScripts)
+    local compressed = FindBundleEntry(result, "Libs/Compressible.lua")
+
+    -- Damaged header or table of contents must be rejected when loading
+    local rejected = {
+        { 0, 0 }, -- Signature
+        { 4, 2 }, -- Version
+        { 8, 0x10000000 }, -- NumEntries
+        { 12, 0x10000000 }, -- NamesSize
+        { compressed.Offset, 0xffffff00 }, -- NameOffset
+        { compressed.Offset + EntryDataOffset, 0xffffff00 }
+    }
+    for i,patch in ipairs(rejected) do
+        AssertEquals(Ext.Debug.LuaBundleRoundTrip(BundleScripts, { Patch = { patch } }).Loaded, false)
+    end
+
+    -- Damaged entries only fail the lookup of that entry
+    local broken = {
+        { compressed.Offset + EntryUncompressedSize, compressed.UncompressedSize + 1 },
+        { compressed.Offset + EntryFlags, 2 }
+    }
+    for i,patch in ipairs(broken) do
+        result = Ext.Debug.LuaBundleRoundTrip(BundleScripts, { Patch = { patch } })
+        Assert(result.Loaded)
+        AssertEquals(result.Scripts["Libs/Compressible.lua"], nil)
+        AssertEquals(result.Scripts["Libs/Other.lua"], BundleScripts["Libs/Other.lua"])
+        AssertEquals(result.Scripts["Tiny.lua"], BundleScripts["Tiny.lua"])
+    end
+end
+
+RegisterTests("Bundle", {
+    "TestLuaBundleRoundTrip",
+    "TestLuaBundleLazyLookup",
+    "TestLuaBundleTruncated",
+    "TestLuaBundleCorrupt"
+})
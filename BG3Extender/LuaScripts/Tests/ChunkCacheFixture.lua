@@ -0,0 +1,21 @@
+-- Loaded repeatedly by ChunkCacheTests.lua; the result must be identical regardless of
+-- whether the chunk was compiled from source or loaded from the chunk cache
+local function Fib(n)
+    if n < 2 then return n end
+    return Fib(n - 1) + Fib(n - 2)
+end
+
+local function Fail()
+    error("fixture error")
+end
+
+local ok, err = pcall(Fail)
+
+return {
+    Fib = Fib(15),
+    Str = string.rep("ab", 3),
+    Float = 1 / 3,
+    Error = err,
+    Source = debug.getinfo(1, "S").source,
+    Line = debug.getinfo(1, "l").currentline
+}
@@ -0,0 +1,78 @@
+function TestChunkCacheConsistency()
+    local first = Ext.Utils.Include(nil, "builtin://Tests/ChunkCacheFixture.lua")
+    AssertEquals(first.Fib, 610)
+    AssertEquals(first.Line, 20)
+    Assert(string.find(first.Error, ":9: fixture error", 1, true) ~= nil)
+
+    for i=1,20 do
+        local result = Ext.Utils.Include(nil, "builtin://Tests/ChunkCacheFixture.lua")
+        AssertEquals(result, first)
+    end
+end
+
+function TestChunkCacheHits()
+    local stats = Ext.Debug.GetLuaChunkCacheStats()
+    if not stats.Enabled then
+        return
+    end
+
+    -- First load may either compile the fixture or reuse bytecode from a previous test run
+    Ext.Utils.Include(nil, "builtin://Tests/ChunkCacheFixture.lua")
+    local before = Ext.Debug.GetLuaChunkCacheStats()
+    Assert(before.Chunks > 0)
+
+    for i=1,5 do
+        Ext.Utils.Include(nil, "builtin://Tests/ChunkCacheFixture.lua")
+    end
+
+    local after = Ext.Debug.GetLuaChunkCacheStats()
+    AssertEquals(after.Hits - before.Hits, 5)
+    AssertEquals(after.Misses, before.Misses)
+    AssertEquals(after.Chunks, before.Chunks)
+    AssertEquals(after.Bytes, before.Bytes)
+end
+
+function TestChunkCachePerformance()
+    -- Synthetic script for comparing uncached compilation against cached loads; the timestamp makes sure
+    -- that the first cached load is a miss even if the persistent cache has chunks from a previous run
+    local source = { "-- " .. Ext.Utils.MicrosecTime() }
+    for i=1,150 do
+        table.insert(source, "local function F" .. i .. "(a, b) if a > b then return a * " .. i .. " else return { a, b, \"" .. i .. "\" } end end")
+    end
+    table.insert(source, "return 1")
+    local script = table.concat(source, "\n")
+    local name = "=SE_ChunkCachePerformance"
+    local iterations = 20
+
+    local before = Ext.Debug.GetLuaChunkCacheStats()
+    local startTime = Ext.Utils.MicrosecTime()
+    for i=1,iterations do
+        AssertEquals(Ext.Debug.LoadLuaChunk(script, name, false)(), 1)
+    end
+    local compileTime = (Ext.Utils.MicrosecTime() - startTime) / iterations
+
+    -- Uncached loads must bypass the cache
+    local uncached = Ext.Debug.GetLuaChunkCacheStats()
+    AssertEquals(uncached.Hits, before.Hits)
+    AssertEquals(uncached.Misses, before.Misses)
+
+    startTime = Ext.Utils.MicrosecTime()
+    for i=1,iterations do
+        AssertEquals(Ext.Debug.LoadLuaChunk(script, name, true)(), 1)
+    end
+    local cachedTime = (Ext.Utils.MicrosecTime() - startTime) / iterations
+
+    -- Only the first load of the same script compiles it
+    local cached = Ext.Debug.GetLuaChunkCacheStats()
+    AssertEquals(cached.Misses - uncached.Misses, 1)
+    AssertEquals(cached.Hits - uncached.Hits, iterations - 1)
+
+    Ext.Utils.Print(string.format("Chunk cache: compiling %d bytes took %.3f ms, cached load took %.3f ms (%.1fx)",
+        #script, compileTime / 1000, cachedTime / 1000, compileTime / math.max(cachedTime, 1)))
+end
+
+RegisterTests("ChunkCache", {
+    "TestChunkCacheConsistency",
+    "TestChunkCacheHits",
+    "TestChunkCachePerformance"
+})
@@ -1,3 +1,13 @@
 Ext.Utils.Include(nil, "builtin://Tests/TestHelpers.lua")
+Ext.Utils.Include(nil, "builtin://Tests/JsonTests.lua")
+Ext.Utils.Include(nil, "builtin://Tests/TimerTests.lua")
+Ext.Utils.Include(nil, "builtin://Tests/ConsoleTests.lua")
+Ext.Utils.Include(nil, "builtin://Tests/EventTests.lua")
+Ext.Utils.Include(nil, "builtin://Tests/ChunkCacheTests.lua")
+Ext.Utils.Include(nil, "builtin://Tests/BundleTests.lua")
+Ext.Utils.Include(nil, "builtin://Tests/SymbolMapperTests.lua")
+Ext.Utils.Include(nil, "builtin://Tests/MemoryTests.lua")
+Ext.Utils.Include(nil, "builtin://Tests/ProfilerTests.lua")
+Ext.Utils.Include(nil, "builtin://Tests/DebuggerTests.lua")
 Ext.Utils.Include(nil, "builtin://Tests/StatTests.lua")
 Ext.Utils.Include(nil, "builtin://Tests/ResourceTests.lua")
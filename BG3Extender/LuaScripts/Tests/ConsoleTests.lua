@@ -0,0 +1,49 @@
+-- Output from a burst that overflows the async queue must not be lost unless a rate limit is configured
+function TestConsolePrintThroughput()
+    Assert(Ext.Debug.FlushConsole())
+    local before = Ext.Debug.GetConsoleStats()
+
+    -- More messages than the async queue can hold, so the writer has to catch up while we're printing
+    local count = 5000
+    local startTime = Ext.Utils.MicrosecTime()
+    for i=1,count do
+        Ext.Utils.Print("SE_ConsoleTest " .. i)
+    end
+    local elapsed = Ext.Utils.MicrosecTime() - startTime
+
+    Assert(Ext.Debug.FlushConsole())
+    local after = Ext.Debug.GetConsoleStats()
+    if before.RateLimit == 0 then
+        AssertEquals(after.Dropped, before.Dropped)
+        AssertEquals(after.Suppressed, before.Suppressed)
+        -- Other threads may print at the same time, so we can only check a lower bound
+        Assert(after.Written - before.Written >= count)
+    else
+        Assert((after.Written - before.Written) + (after.Dropped - before.Dropped) + (after.Suppressed - before.Suppressed) >= count)
+    end
+
+    Ext.Utils.Print(string.format("Console print: %.0f ns per message (%d messages, %d written synchronously)",
+        elapsed * 1000 / count, count, after.QueueFullWrites - before.QueueFullWrites))
+end
+
+-- Multiple producers pushing to the log queue at the same time
+function TestConsoleQueueProducers()
+    local threads = 8
+    local messages = 50000
+    local result = Ext.Debug.BenchmarkLogQueue(threads, messages)
+    AssertEquals(result.Messages, threads * messages)
+    AssertEquals(result.Missing, 0)
+    AssertEquals(result.OutOfOrder, 0)
+    AssertEquals(result.Invalid, 0)
+
+    local single = Ext.Debug.BenchmarkLogQueue(1, messages)
+    AssertEquals(single.Missing, 0)
+
+    Ext.Utils.Print(string.format("Log queue: %.0f ns per message with %d producers; %.0f ns per message with 1 producer",
+        result.NsPerMessage, threads, single.NsPerMessage))
+end
+
+RegisterTests("Console", {
+    "TestConsolePrintThroughput",
+    "TestConsoleQueueProducers"
+})
@@ -0,0 +1,68 @@
+local function DebuggerHotLoop(n)
+    local sum = 0
+    for i=1,n do
+        sum = sum + i % 7
+    end
+    return sum
+end
+
+local function DebuggerColdFunction()
+    local value = 1
+    value = value + 1
+    return value
+end
+
+local function FunctionLine(fn, offset)
+    local info = debug.getinfo(fn, "S")
+    return info.source, info.linedefined + offset
+end
+
+-- The line hook filter must only enable line hooks inside functions that contain a breakpoint
+function TestDebuggerLineHooksColdBreakpoint()
+    local source, coldLine = FunctionLine(DebuggerColdFunction, 2)
+    local breakpoints = { [source] = { coldLine } }
+    local iterations = 1000
+
+    -- Breakpoint only in a function that isn't called
+    AssertEquals(Ext.Debug.CountLuaLineHooks(function () DebuggerHotLoop(iterations) end, breakpoints, false), 0)
+
+    -- Calling the function with the breakpoint hooks its lines only
+    local coldLines = Ext.Debug.CountLuaLineHooks(function ()
+        DebuggerHotLoop(iterations)
+        DebuggerColdFunction()
+    end, breakpoints, false)
+    Assert(coldLines > 0 and coldLines < 10)
+
+    -- No breakpoints in the file
+    AssertEquals(Ext.Debug.CountLuaLineHooks(function () DebuggerHotLoop(iterations) end, {}, false), 0)
+end
+
+function TestDebuggerLineHooksHotBreakpoint()
+    local source, loopLine = FunctionLine(DebuggerHotLoop, 3)
+    local iterations = 1000
+    local lines = Ext.Debug.CountLuaLineHooks(function () DebuggerHotLoop(iterations) end, { [source] = { loopLine } }, false)
+    Assert(lines >= iterations)
+end
+
+-- Stepping must hook every line, regardless of where the breakpoints are
+function TestDebuggerLineHooksStepping()
+    local iterations = 1000
+    local fn = function ()
+        DebuggerHotLoop(iterations)
+        DebuggerColdFunction()
+    end
+
+    local stepped = Ext.Debug.CountLuaLineHooks(fn, {}, true)
+    Assert(stepped >= iterations)
+
+    local source, loopLine = FunctionLine(DebuggerHotLoop, 3)
+    local coldSource, coldLine = FunctionLine(DebuggerColdFunction, 2)
+    local all = Ext.Debug.CountLuaLineHooks(fn, { [source] = { loopLine, coldLine } }, false)
+    Assert(stepped > all)
+end
+
+RegisterTests("Debugger", {
+    "TestDebuggerLineHooksColdBreakpoint",
+    "TestDebuggerLineHooksHotBreakpoint",
+    "TestDebuggerLineHooksStepping"
+})
@@ -51,9 +51,443 @@ function TestECSFunctions()
     -- GetSalt and GetIndex have no deterministic outputs
 end
 
+function TestECSMapIteration()
+    local mappingEntity = Ext.Entity.GetAllEntitiesWithComponent("UuidToHandleMapping")[1]
+    local mappings = mappingEntity.UuidToHandleMapping.Mappings
+    local total = #mappings
+    Assert(total > 1000)
+
+    -- Each key is visited exactly once, and every entry of the map is visited
+    local seen = {}
+    local order = {}
+    for uuid,entity in pairs(mappings) do
+        AssertEquals(seen[uuid], nil)
+        Assert(mappings[uuid] ~= nil)
+        seen[uuid] = true
+        table.insert(order, uuid)
+    end
+    AssertEquals(#order, total)
+
+    -- Each iterator seeks to its own cursor on every step and ignores the control variable,
+    -- so interleaved iterators must not affect each other
+    local next1, state1 = pairs(mappings)
+    local next2, state2 = pairs(mappings)
+    for i=1,total do
+        AssertEquals(next1(state1, nil), order[i])
+        if i % 2 == 0 then
+            AssertEquals(next2(state2, "not a key"), order[i // 2])
+        end
+    end
+    AssertEquals(next1(state1, nil), nil)
+    for i=total // 2 + 1,total do
+        AssertEquals(next2(state2, nil), order[i])
+    end
+    AssertEquals(next2(state2, nil), nil)
+
+    -- Breaking out of a loop and iterating again restarts from the first entry
+    for uuid in pairs(mappings) do
+        AssertEquals(uuid, order[1])
+        break
+    end
+
+    -- Property iteration on objects
+    local keys = 0
+    for k,v in pairs(Ext.Entity.Get(GUID_LAEZEL).Transform) do
+        keys = keys + 1
+    end
+    Assert(keys > 0)
+end
+
+-- Every pairs() step resumes from its cursor, so the work done by a full pass grows linearly with the map size
+-- (for the same load factor) instead of repeating a lookup of the previous key on each step
+function TestECSMapIterationLinear()
+    local baseline
+    for _,size in ipairs({ 1000, 4000, 16000, 64000 }) do
+        local work = Ext.Debug.CountMapIterationWork(size, size)
+        AssertEquals(work.Entries, size)
+        AssertEquals(work.Steps, size + 1)
+
+        local perEntry = work.VisitedNodes / size
+        Assert(perEntry <= 4)
+        baseline = baseline or perEntry
+        Assert(perEntry <= baseline * 1.1)
+    end
+end
+
+function TestECSQuery()
+    local expected = {}
+    local expectedCount = 0
+    for i,entity in ipairs(Ext.Entity.GetAllEntitiesWithComponent("DisplayName")) do
+        expected[Ext.Utils.HandleToInteger(entity)] = true
+        expectedCount = expectedCount + 1
+    end
+
+    local count = 0
+    for entity, name in Ext.Entity.Query("DisplayName") do
+        Assert(expected[Ext.Utils.HandleToInteger(entity)] == true)
+        AssertEquals(name.Name, entity.DisplayName.Name)
+        count = count + 1
+    end
+    AssertEquals(count, expectedCount)
+
+    -- Multi-component filters only return entities that have all components
+    local laezel = Ext.Entity.Get(GUID_LAEZEL)
+    local found = false
+    count = 0
+    for entity, name, transform in Ext.Entity.Query("DisplayName", "Transform") do
+        Assert(expected[Ext.Utils.HandleToInteger(entity)] == true)
+        AssertType(name, "userdata")
+        AssertType(transform, "userdata")
+        AssertType(entity.Transform, "userdata")
+        if entity == laezel then
+            found = true
+            AssertEquals(name.Name, "Lae'zel")
+        end
+        count = count + 1
+    end
+    Assert(found)
+    Assert(count <= expectedCount)
+end
+
+function TestECSQueryCursor()
+    -- Exhausted queries keep returning nil
+    local iter = Ext.Entity.Query("DisplayName")
+    local count = 0
+    while iter() ~= nil do
+        count = count + 1
+    end
+    Assert(count > 0)
+    AssertEquals(iter(), nil)
+    AssertEquals(iter(), nil)
+
+    -- Interleaved queries over the same storage don't share state
+    local a = Ext.Entity.Query("DisplayName", "Transform")
+    local b = Ext.Entity.Query("DisplayName", "Transform")
+    while true do
+        local entityA = a()
+        local entityB = b()
+        AssertEquals(entityA, entityB)
+        if entityA == nil then break end
+    end
+
+    -- Repeated components resolve to the same component
+    for entity, name, name2 in Ext.Entity.Query("DisplayName", "DisplayName") do
+        AssertEquals(name.Name, name2.Name)
+    end
+
+    AssertEquals(pcall(Ext.Entity.Query), false)
+    AssertEquals(pcall(Ext.Entity.Query, "DisplayName", "DisplayName", "DisplayName", "DisplayName",
+        "DisplayName", "DisplayName", "DisplayName", "DisplayName", "DisplayName"), false)
+
+    -- Entities can be mutated while a query is in progress
+    local laezel = Ext.Entity.Get(GUID_LAEZEL)
+    local seen = 0
+    for entity, name in Ext.Entity.Query("DisplayName") do
+        if entity == laezel then
+            entity:Replicate("DisplayName")
+        end
+        seen = seen + 1
+    end
+    AssertEquals(seen, count)
+
+    local iterations = 10
+    local startTime = Ext.Utils.MicrosecTime()
+    for i=1,iterations do
+        for entity, name in Ext.Entity.Query("DisplayName") do
+            local n = name.Name
+        end
+    end
+    local queryTime = Ext.Utils.MicrosecTime() - startTime
+
+    startTime = Ext.Utils.MicrosecTime()
+    for i=1,iterations do
+        for j,entity in ipairs(Ext.Entity.GetAllEntitiesWithComponent("DisplayName")) do
+            local n = entity.DisplayName.Name
+        end
+    end
+    local listTime = Ext.Utils.MicrosecTime() - startTime
+
+    Ext.Utils.Print(string.format("Entity iteration: %.2f us/entity with Query; %.2f us/entity with GetAllEntitiesWithComponent",
+        queryTime / (iterations * count), listTime / (iterations * count)))
+end
+
+function TestECSQueryLifetime()
+    local iter = Ext.Entity.Query("DisplayName")
+    local entity, name = iter()
+    AssertType(name, "userdata")
+
+    -- The iterator expires together with the proxies created in the same context
+    Ext.Events.Tick:Subscribe(function ()
+        RunTest("TestECSQueryLifetime (deferred)", function ()
+            local proxyOk = pcall(function () return name.Name end)
+            local iterOk, err = pcall(iter)
+            AssertEquals(iterOk, proxyOk)
+            if not iterOk then
+                Assert(string.find(err, "lifetime has expired", 1, true) ~= nil)
+            end
+        end)
+    end, {Once = true})
+end
+
+function TestECSChangeBatching()
+    local ent = Ext.Entity.Get(GUID_LAEZEL)
+    local other
+    for i,entity in ipairs(Ext.Entity.GetAllEntitiesWithComponent("DisplayName")) do
+        if entity ~= ent then
+            other = entity
+            break
+        end
+    end
+
+    local batches = {}
+    local otherCalls = 0
+    local globalSub = Ext.Entity.OnChanged("DisplayName", function (type, entities, flags)
+        table.insert(batches, {Entities = entities, Flags = flags})
+    end)
+    local otherSub = Ext.Entity.OnChanged("DisplayName", function (type, entities, flags)
+        otherCalls = otherCalls + 1
+    end, other)
+
+    -- Nothing is delivered synchronously; repeated changes in the same tick are reported once
+    ent:Replicate("DisplayName")
+    ent:Replicate("DisplayName")
+    AssertEquals(#batches, 0)
+
+    -- Changes are collected during the ECS update, which may run after the next Tick event;
+    -- wait for the batch to arrive, but not indefinitely
+    local ticks = 0
+    local tickHandler
+    tickHandler = Ext.Events.Tick:Subscribe(function ()
+        ticks = ticks + 1
+        if #batches == 0 and ticks < 10 then
+            return
+        end
+
+        Ext.Events.Tick:Unsubscribe(tickHandler)
+        RunTest("TestECSChangeBatching (deferred)", function ()
+            Ext.Entity.Unsubscribe(globalSub)
+            Ext.Entity.Unsubscribe(otherSub)
+
+            AssertEquals(#batches, 1)
+
+            local found = false
+            local otherChanged = 0
+            for i,entity in ipairs(batches[1].Entities) do
+                Assert(batches[1].Flags[i] ~= 0)
+                if entity == ent then
+                    Assert(not found)
+                    found = true
+                    AssertEquals(batches[1].Flags[i], 0xffffffffffffffff)
+                elseif entity == other then
+                    otherChanged = 1
+                end
+            end
+            Assert(found)
+            -- Entity-specific subscriptions only receive changes of their own entity
+            AssertEquals(otherCalls, otherChanged)
+        end)
+    end)
+end
+
+function TestECSSpatialQuery()
+    local positions = {}
+    for entity, transform in Ext.Entity.Query("Transform") do
+        positions[Ext.Utils.HandleToInteger(entity)] = transform.Transform.Translate
+    end
+
+    local function linearScan(center, radius, component)
+        local found = {}
+        local count = 0
+        for entity, pos in Ext.Entity.Query("Transform") do
+            local translate = pos.Transform.Translate
+            if Ext.Math.Distance(translate, center) <= radius and (component == nil or entity[component] ~= nil) then
+                found[Ext.Utils.HandleToInteger(entity)] = true
+                count = count + 1
+            end
+        end
+        return found, count
+    end
+
+    local center = Ext.Entity.Get(GUID_LAEZEL).Transform.Transform.Translate
+    local radius = 20.0
+
+    local expected, expectedCount = linearScan(center, radius)
+    local entities = Ext.Entity.GetEntitiesAroundPosition(center, radius)
+    AssertEquals(#entities, expectedCount)
+    for i,entity in ipairs(entities) do
+        Assert(expected[Ext.Utils.HandleToInteger(entity)] == true)
+    end
+
+    -- Component filters
+    expected, expectedCount = linearScan(center, radius, "DisplayName")
+    entities = Ext.Entity.GetEntitiesAroundPosition(center, radius, "DisplayName")
+    AssertEquals(#entities, expectedCount)
+    for i,entity in ipairs(entities) do
+        Assert(expected[Ext.Utils.HandleToInteger(entity)] == true)
+    end
+
+    -- Boxes are inclusive of their bounds
+    local min = {center[1] - radius, center[2] - radius, center[3] - radius}
+    local max = {center[1] + radius, center[2] + radius, center[3] + radius}
+    for i,entity in ipairs(Ext.Entity.GetEntitiesInBox(min, max)) do
+        local pos = positions[Ext.Utils.HandleToInteger(entity)]
+        for axis=1,3 do
+            Assert(pos[axis] >= min[axis] and pos[axis] <= max[axis])
+        end
+    end
+
+    -- Nearest entities are ordered by distance
+    local nearest = Ext.Entity.GetNearestEntities(center, 5, nil, "DisplayName")
+    Assert(#nearest <= 5)
+    Assert(#nearest > 0)
+    Assert(Ext.Math.Distance(positions[Ext.Utils.HandleToInteger(nearest[1])], center) < 0.001)
+    local lastDistance = 0
+    for i,entity in ipairs(nearest) do
+        local distance = Ext.Math.Distance(positions[Ext.Utils.HandleToInteger(entity)], center)
+        Assert(distance >= lastDistance)
+        lastDistance = distance
+    end
+
+    local iterations = 100
+    local startTime = Ext.Utils.MicrosecTime()
+    for i=1,iterations do
+        linearScan(center, radius)
+    end
+    local linearTime = Ext.Utils.MicrosecTime() - startTime
+
+    startTime = Ext.Utils.MicrosecTime()
+    for i=1,iterations do
+        Ext.Entity.GetEntitiesAroundPosition(center, radius)
+    end
+    local indexedTime = Ext.Utils.MicrosecTime() - startTime
+
+    startTime = Ext.Utils.MicrosecTime()
+    for i=1,iterations do
+        Ext.Entity.GetEntitiesInBox(min, max)
+    end
+    local boxTime = Ext.Utils.MicrosecTime() - startTime
+
+    startTime = Ext.Utils.MicrosecTime()
+    for i=1,iterations do
+        Ext.Entity.GetNearestEntities(center, 5)
+    end
+    local nearestTime = Ext.Utils.MicrosecTime() - startTime
+
+    Ext.Utils.Print(string.format("Radius query: %.1f us/query with linear scan; %.1f us/query with spatial index (%d entities)",
+        linearTime / iterations, indexedTime / iterations, #Ext.Entity.GetAllEntitiesWithComponent("Transform")))
+    Ext.Utils.Print(string.format("Box query: %.1f us/query; nearest 5: %.1f us/query", boxTime / iterations, nearestTime / iterations))
+end
+
+function TestECSUuidResolution()
+    local laezel = Ext.Entity.Get(GUID_LAEZEL)
+    local unknown = "11111111-2222-3333-4444-123412341234"
+
+    -- Cached lookups must return the same entity as the first (uncached) lookup
+    for i=1,3 do
+        AssertEquals(Ext.Entity.UuidToHandle(GUID_LAEZEL), laezel)
+        AssertEquals(Ext.Entity.UuidToHandle(unknown), nil)
+    end
+
+    local uuids = {}
+    local expected = {}
+    for uuid, entity in pairs(Ext.Entity.GetAllEntitiesWithUuid()) do
+        table.insert(uuids, uuid)
+        table.insert(expected, entity)
+        if #uuids >= 1000 then break end
+    end
+    table.insert(uuids, unknown)
+
+    -- The first pass mostly misses the cache, later passes should hit it
+    local startTime = Ext.Utils.MicrosecTime()
+    for j,uuid in ipairs(uuids) do
+        Ext.Entity.UuidToHandle(uuid)
+    end
+    local coldTime = Ext.Utils.MicrosecTime() - startTime
+
+    local resolved = Ext.Entity.UuidsToHandles(uuids)
+    for i,entity in ipairs(expected) do
+        AssertEquals(resolved[i], entity)
+        AssertEquals(Ext.Entity.HandleToUuid(entity), uuids[i])
+    end
+    AssertEquals(resolved[#uuids], nil)
+
+    local iterations = 10
+    startTime = Ext.Utils.MicrosecTime()
+    for i=1,iterations do
+        for j,uuid in ipairs(uuids) do
+            Ext.Entity.UuidToHandle(uuid)
+        end
+    end
+    local singleTime = Ext.Utils.MicrosecTime() - startTime
+
+    startTime = Ext.Utils.MicrosecTime()
+    for i=1,iterations do
+        Ext.Entity.UuidsToHandles(uuids)
+    end
+    local batchTime = Ext.Utils.MicrosecTime() - startTime
+
+    Ext.Utils.Print(string.format("UUID resolution: %.2f us/UUID cold; %.2f us/UUID with UuidToHandle; %.2f us/UUID with UuidsToHandles",
+        coldTime / #uuids, singleTime / (iterations * #uuids), batchTime / (iterations * #uuids)))
+end
+
+-- Cached UUIDs of destroyed entities must be evicted
+function TestECSUuidEviction()
+    local template
+    for i,entity in ipairs(Ext.Entity.GetAllEntitiesWithComponent("ServerItem")) do
+        local uuid = Ext.Entity.HandleToUuid(entity)
+        if uuid ~= nil then
+            template = Osi.GetTemplate(uuid)
+            if template ~= nil then break end
+        end
+    end
+    Assert(template ~= nil)
+
+    local pos = Ext.Entity.Get(GUID_LAEZEL).Transform.Transform.Translate
+    local item = Osi.CreateAt(template, pos[1], pos[2], pos[3], 0, 0, "")
+    Assert(item ~= nil)
+    local uuid = string.sub(item, -36)
+
+    -- Resolve the new entity, so its UUID is cached
+    local entity = Ext.Entity.UuidToHandle(uuid)
+    Assert(entity ~= nil)
+    AssertEquals(Ext.Entity.UuidToHandle(uuid), entity)
+    AssertEquals(Ext.Entity.UuidsToHandles({uuid})[1], entity)
+    AssertEquals(Ext.Entity.HandleToUuid(entity), uuid)
+
+    Osi.RequestDelete(item)
+
+    -- Deletion is deferred to a later tick; wait until the UUID mapping no longer has the entity
+    local ticks = 0
+    local tickHandler
+    tickHandler = Ext.Events.Tick:Subscribe(function ()
+        ticks = ticks + 1
+        local exists = Ext.Entity.GetAllEntitiesWithUuid()[uuid] ~= nil
+        if exists and ticks < 20 then
+            return
+        end
+
+        Ext.Events.Tick:Unsubscribe(tickHandler)
+        RunTest("TestECSUuidEviction (deferred)", function ()
+            Assert(not exists)
+            AssertEquals(Ext.Entity.UuidToHandle(uuid), nil)
+            AssertEquals(Ext.Entity.UuidsToHandles({uuid, GUID_LAEZEL})[1], nil)
+            AssertEquals(Ext.Entity.UuidsToHandles({uuid, GUID_LAEZEL})[2], Ext.Entity.Get(GUID_LAEZEL))
+        end)
+    end)
+end
+
 RegisterTests("ECS", {
     "TestECSFetch",
     "TestECSComponents",
     "TestECSFunctions",
-    "TestECSReplication"
+    "TestECSReplication",
+    "TestECSMapIteration",
+    "TestECSMapIterationLinear",
+    "TestECSQuery",
+    "TestECSQueryCursor",
+    "TestECSQueryLifetime",
+    "TestECSChangeBatching",
+    "TestECSSpatialQuery",
+    "TestECSUuidResolution",
+    "TestECSUuidEviction"
 })
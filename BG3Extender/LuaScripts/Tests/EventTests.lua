@@ -0,0 +1,120 @@
+local _N = Ext._NativeEvents
+
+function TestEventPriorityOrder()
+    local name = "Test.EventPriorityOrder"
+    local calls = {}
+    local handlers = {
+        _N.Subscribe(name, function (e) table.insert(calls, "default1") end),
+        _N.Subscribe(name, function (e) table.insert(calls, "low") end, 50),
+        _N.Subscribe(name, function (e) table.insert(calls, "high") end, 200),
+        _N.Subscribe(name, function (e) table.insert(calls, "default2") end, 100)
+    }
+
+    _N.Throw(name, {})
+    AssertEqualsArray({"high", "default1", "default2", "low"}, calls)
+
+    for i,index in ipairs(handlers) do
+        AssertEquals(_N.Unsubscribe(name, index), true)
+    end
+    AssertEquals(_N.HasSubscribers(name), false)
+end
+
+function TestEventOnce()
+    local name = "Test.EventOnce"
+    local onceCalls = 0
+    local calls = 0
+    _N.Subscribe(name, function (e) onceCalls = onceCalls + 1 end, 100, true)
+    local index = _N.Subscribe(name, function (e) calls = calls + 1 end)
+
+    _N.Throw(name, {})
+    _N.Throw(name, {})
+    AssertEquals(onceCalls, 1)
+    AssertEquals(calls, 2)
+
+    _N.Unsubscribe(name, index)
+    AssertEquals(_N.HasSubscribers(name), false)
+end
+
+function TestEventStopPropagation()
+    local name = "Test.EventStopPropagation"
+    local calls = 0
+    local first = _N.Subscribe(name, function (e) e.Stopped = true end, 200)
+    local second = _N.Subscribe(name, function (e) calls = calls + 1 end)
+
+    _N.Throw(name, {})
+    AssertEquals(calls, 0)
+
+    _N.Unsubscribe(name, first)
+    _N.Unsubscribe(name, second)
+end
+
+function TestEventSubscribeDuringDispatch()
+    local name = "Test.EventSubscribeDuringDispatch"
+    local calls = {}
+    local added = {}
+    local first
+    first = _N.Subscribe(name, function (e)
+        table.insert(calls, "first")
+        if #added == 0 then
+            -- Unsubscribing during dispatch takes effect after the dispatch
+            _N.Unsubscribe(name, first)
+            table.insert(added, _N.Subscribe(name, function (e) table.insert(calls, "before") end, 300))
+            table.insert(added, _N.Subscribe(name, function (e) table.insert(calls, "after") end, 50))
+        end
+    end, 200)
+    local second = _N.Subscribe(name, function (e) table.insert(calls, "second") end)
+
+    _N.Throw(name, {})
+    AssertEqualsArray({"first", "second", "after"}, calls)
+
+    calls = {}
+    _N.Throw(name, {})
+    AssertEqualsArray({"before", "second", "after"}, calls)
+
+    _N.Unsubscribe(name, second)
+    for i,index in ipairs(added) do
+        _N.Unsubscribe(name, index)
+    end
+    AssertEquals(_N.HasSubscribers(name), false)
+end
+
+function TestEventDispatchPerformance()
+    local name = "Test.EventDispatchPerformance"
+    local iterations = 1000000
+    local event = {}
+
+    local startTime = Ext.Utils.MicrosecTime()
+    for i=1,iterations do
+        _N.Throw(name, event)
+    end
+    local emptyTime = Ext.Utils.MicrosecTime() - startTime
+
+    local handlers = {}
+    local subscribers = 10
+    local calls = 0
+    for i=1,subscribers do
+        table.insert(handlers, _N.Subscribe(name, function (e) calls = calls + 1 end, i))
+    end
+
+    startTime = Ext.Utils.MicrosecTime()
+    for i=1,iterations/10 do
+        _N.Throw(name, event)
+    end
+    local subscribedTime = Ext.Utils.MicrosecTime() - startTime
+
+    for i,index in ipairs(handlers) do
+        _N.Unsubscribe(name, index)
+    end
+
+    AssertEquals(calls, iterations/10 * subscribers)
+    Ext.Utils.Print(string.format("Event dispatch: %.1f ns/event with no subscribers; %.1f ns/event with %d subscribers",
+        emptyTime * 1000 / iterations, subscribedTime * 1000 / (iterations/10), subscribers))
+end
+
+RegisterTests("Event", {
+    "TestEventPriorityOrder",
+    "TestEventOnce",
+    "TestEventStopPropagation",
+    "TestEventSubscribeDuringDispatch",
+    "TestEventDispatchPerformance"
+})
@@ -0,0 +1,95 @@
+function TestJsonRoundTrip()
+    local value = {
+        Int = 123,
+        NegativeInt = -9007199254740993,
+        Float = 1.5,
+        SmallFloat = 1e-10,
+        Bool = true,
+        String = "text",
+        Array = {1, 2, "three", {Nested = false}},
+        Object = {A = {}, B = {1}}
+    }
+
+    local parsed = Ext.Json.Parse(Ext.Json.Stringify(value))
+    AssertEquals(parsed, value)
+    AssertEquals(math.type(parsed.Int), "integer")
+    AssertEquals(parsed.NegativeInt, -9007199254740993)
+    AssertEquals(math.type(parsed.Float), "float")
+    AssertEquals(parsed.SmallFloat, 1e-10)
+end
+
+function TestJsonStringifyFormat()
+    AssertEquals(Ext.Json.Stringify({b = 1, a = {2, 3}, c = {}}), '{\n\t"a" : \n\t[\n\t\t2,\n\t\t3\n\t],\n\t"b" : 1,\n\t"c" : []\n}')
+    AssertEquals(Ext.Json.Stringify({b = 1, a = {2, 3}, c = {}}, {Beautify = false}), '{"a":[2,3],"b":1,"c":[]}')
+    AssertEquals(Ext.Json.Stringify({{x = 1}}, {Beautify = false}), '[{"x":1}]')
+    AssertEquals(Ext.Json.Stringify({[1] = "a", [3] = "c"}, {Beautify = false}), '{"1":"a","3":"c"}')
+    AssertEquals(Ext.Json.Stringify(2.0), "2.0")
+    AssertEquals(Ext.Json.Stringify(0.1), "0.10000000000000001")
+    AssertEquals(Ext.Json.Stringify(math.huge), "1e+9999")
+end
+
+function TestJsonStringEscapes()
+    local str = "quote\" backslash\\ tab\t newline\n ctrl\1 utf8 \xc3\xa9 \xf0\x9f\x98\x80"
+    local json = Ext.Json.Stringify(str)
+    AssertEquals(json, '"quote\\" backslash\\\\ tab\\t newline\\n ctrl\\u0001 utf8 \\u00e9 \\ud83d\\ude00"')
+    AssertEquals(Ext.Json.Parse(json), str)
+    AssertEquals(Ext.Json.Parse('"embedded\\u0000nul"'), "embedded\0nul")
+end
+
+function TestJsonParseExtensions()
+    local parsed = Ext.Json.Parse('// comment\n{ /* block */ "a" : [1, 2,], "b" : null, } trailing')
+    AssertEquals(parsed, {a = {1, 2}})
+    AssertEquals(Ext.Json.Parse("18446744073709551615"), -1)
+    AssertEquals(math.type(Ext.Json.Parse("1e400")), "float")
+end
+
+function TestJsonParseErrors()
+    local invalid = {"", "{", "[1 2]", '{"a" 1}', "{1:2}", '"abc', '"\\x"', "tru", "1.", "/* x"}
+    for i,json in ipairs(invalid) do
+        local ok = pcall(Ext.Json.Parse, json)
+        Assert(not ok)
+    end
+end
+
+function TestJsonStringifyLimits()
+    local tbl = {}
+    tbl.Self = tbl
+    AssertEquals(Ext.Json.Stringify(tbl, {AvoidRecursion = true, Beautify = false}), '{"Self":"*RECURSION*"}')
+    AssertEquals(Ext.Json.Stringify({A = {B = {C = 1}}}, {LimitDepth = 1, Beautify = false}), '{"A":{"B":"*DEPTH LIMIT EXCEEDED*"}}')
+    Assert(not pcall(Ext.Json.Stringify, tbl))
+end
+
+function TestJsonPerformance()
+    local doc = {}
+    for i=1,20000 do
+        doc[i] = {Id = i, Name = "Entry " .. i, Value = i * 0.25, Flags = {true, false}, Tags = {A = "x", B = "y"}}
+    end
+
+    local startTime = Ext.Utils.MicrosecTime()
+    local json = Ext.Json.Stringify(doc)
+    local stringifyTime = Ext.Utils.MicrosecTime() - startTime
+
+    startTime = Ext.Utils.MicrosecTime()
+    local parsed = Ext.Json.Parse(json)
+    local parseTime = Ext.Utils.MicrosecTime() - startTime
+
+    AssertEquals(#parsed, #doc)
+
+    -- jsoncpp only parses and writes the document without converting it from/to Lua values,
+    -- so its times are a lower bound for the previous implementation
+    local baseline = Ext.Debug.JsoncppRoundTrip(json)
+    AssertEquals(baseline.Output, json)
+
+    Ext.Utils.Print(string.format("JSON benchmark: %d bytes, stringify %.2f ms (jsoncpp %.2f ms), parse %.2f ms (jsoncpp %.2f ms)",
+        #json, stringifyTime / 1000, baseline.StringifyTime / 1000, parseTime / 1000, baseline.ParseTime / 1000))
+end
+
+RegisterTests("Json", {
+    "TestJsonRoundTrip",
+    "TestJsonStringifyFormat",
+    "TestJsonStringEscapes",
+    "TestJsonParseExtensions",
+    "TestJsonParseErrors",
+    "TestJsonStringifyLimits",
+    "TestJsonPerformance"
+})
@@ -0,0 +1,118 @@
+function TestMemoryStats()
+    local stats = Ext.Debug.GetMemoryStats()
+    Assert(stats.BytesLive > 0)
+    Assert(stats.SlabBytes > 0)
+    Assert(stats.Allocations >= stats.Frees)
+    Assert(stats.Reallocations >= stats.InPlaceReallocations)
+    AssertEquals(#stats.SizeClasses, 16)
+
+    local lastSize = 0
+    for i,sizeClass in ipairs(stats.SizeClasses) do
+        Assert(sizeClass.Size > lastSize)
+        Assert(sizeClass.Allocations >= sizeClass.LiveBlocks)
+        lastSize = sizeClass.Size
+    end
+    AssertEquals(lastSize, 512)
+
+    local tables = {}
+    for i=1,1000 do
+        tables[i] = { i }
+    end
+
+    local after = Ext.Debug.GetMemoryStats()
+    Assert(after.Allocations >= stats.Allocations + 1000)
+    Assert(after.BytesLive > stats.BytesLive)
+end
+
+function TestMemoryAllocatorPerformance()
+    -- Allocation-heavy workload: table growth (realloc), short strings and closures
+    collectgarbage("collect")
+    local before = Ext.Debug.GetMemoryStats()
+    local peakSlabBytes = 0
+    local rounds, itemsPerRound = 20, 5000
+    local startTime = Ext.Utils.MicrosecTime()
+    for round=1,rounds do
+        local items = {}
+        for i=1,itemsPerRound do
+            items[i] = { Name = "Item" .. i, Value = i, Fn = function () return i end }
+        end
+        local str = {}
+        for i=1,2000 do
+            table.insert(str, tostring(i))
+        end
+        table.concat(str, ",")
+        peakSlabBytes = math.max(peakSlabBytes, Ext.Debug.GetMemoryStats().SlabBytes)
+    end
+    local elapsed = Ext.Utils.MicrosecTime() - startTime
+    local after = Ext.Debug.GetMemoryStats()
+
+    Ext.Utils.Print(string.format("Lua allocator: %d allocations, %d reallocations (%d in place) in %.3f ms; %d bytes live, %d bytes in slabs (peak %d)",
+        after.Allocations - before.Allocations, after.Reallocations - before.Reallocations,
+        after.InPlaceReallocations - before.InPlaceReallocations, elapsed / 1000,
+        after.BytesLive, after.SlabBytes, peakSlabBytes))
+
+    -- Each item allocates at least a table, a closure and its upvalue
+    Assert(after.Allocations - before.Allocations >= rounds * itemsPerRound * 3)
+    -- Growing the item and string arrays goes through realloc; some of it must stay in place
+    Assert(after.Reallocations > before.Reallocations)
+    Assert(after.InPlaceReallocations > before.InPlaceReallocations)
+    AssertEquals(after.MismatchedFrees, before.MismatchedFrees)
+
+    -- Once the workload is collected, the slabs it used must be returned to the game allocator
+    collectgarbage("collect")
+    local collected = Ext.Debug.GetMemoryStats()
+    Assert(collected.ReleasedSlabs > before.ReleasedSlabs)
+    Assert(collected.SlabBytes < peakSlabBytes)
+end
+
+function TestLuaGCScheduler()
+    local stats = Ext.Debug.GetLuaGCStats()
+    Assert(type(stats.State) == "string")
+    Assert(stats.Pause > 0)
+    Assert(stats.StepMul > 0)
+
+    local oldBudget = stats.Budget
+    local budget = 500
+    Ext.Debug.SetLuaGCBudget(budget)
+    Ext.Debug.ResetLuaGCStats()
+
+    -- Synthetic allocation-heavy workload: ~1 MB of short-lived tables and strings per tick
+    local ticks = 0
+    local allocated = 0
+    local tickHandler
+    tickHandler = Ext.Events.Tick:Subscribe(function ()
+        ticks = ticks + 1
+        if ticks <= 60 then
+            local garbage = {}
+            for i=1,10000 do
+                garbage[i] = { Name = "Garbage" .. i, Value = i }
+            end
+            allocated = allocated + Ext.Debug.GetLuaGCStats().LastTickAllocated
+            return
+        end
+
+        Ext.Events.Tick:Unsubscribe(tickHandler)
+        RunTest("TestLuaGCScheduler (deferred)", function ()
+            local after = Ext.Debug.GetLuaGCStats()
+            Ext.Debug.SetLuaGCBudget(oldBudget)
+
+            Ext.Utils.Print(string.format("Lua GC: %d ticks (%d idle, %d over budget), %d steps, %d cycles; %d KB allocated; worst tick %.1f us, worst step %.1f us, total %.1f ms",
+                after.Ticks, after.IdleTicks, after.OverBudgetTicks, after.Steps, after.Cycles, allocated // 1024,
+                after.MaxTickUs, after.MaxStepUs, after.TotalUs / 1000))
+
+            Assert(after.Ticks >= 60)
+            Assert(allocated > 60 * 512 * 1024)
+            Assert(after.Steps > 0)
+            Assert(after.Cycles > 0)
+            -- Steps are not interrupted, so the budget can only be exceeded by the last step of a tick
+            Assert(after.MaxTickUs <= budget + after.MaxStepUs)
+            Assert(after.TotalUs >= after.MaxTickUs)
+        end)
+    end)
+end
+
+RegisterTests("Memory", {
+    "TestMemoryStats",
+    "TestMemoryAllocatorPerformance",
+    "TestLuaGCScheduler"
+})
@@ -0,0 +1,153 @@
+function TestNetLoopbackSmallMessage()
+    local result = Ext.Debug.NetLoopback("Hello")
+    AssertEquals(result.Payload, "Hello")
+    AssertEquals(result.Packets, 1)
+    -- Below compression threshold
+    AssertEquals(result.CompressedPackets, 0)
+end
+
+local function CompressiblePayload(count)
+    local items = {}
+    for i=1,count do
+        items[i] = "CompressibleNetworkPayload" .. i
+    end
+    return table.concat(items, ",")
+end
+
+function TestNetLoopbackCompression()
+    local payload = CompressiblePayload(200)
+
+    local result = Ext.Debug.NetLoopback(payload)
+    AssertEquals(result.Payload, payload)
+    AssertEquals(result.Packets, 1)
+    AssertEquals(result.CompressedPackets, 1)
+
+    -- Local peer path; messages are sent as-is
+    result = Ext.Debug.NetLoopback(payload, { Compress = false })
+    AssertEquals(result.Payload, payload)
+    AssertEquals(result.CompressedPackets, 0)
+end
+
+-- Small messages sent during the same tick are batched into a single packet that is large enough to compress
+function TestNetLoopbackBatching()
+    local messages = {}
+    for i=1,50 do
+        messages[i] = "CompressibleBatchedMessage" .. i .. string.rep(",Value", 4)
+    end
+
+    -- Each message on its own is below the compression threshold
+    local separateBytes = 0
+    for i,message in ipairs(messages) do
+        local result = Ext.Debug.NetLoopback(message)
+        AssertEquals(result.Packets, 1)
+        AssertEquals(result.CompressedPackets, 0)
+        separateBytes = separateBytes + result.Bytes
+    end
+
+    local batched = Ext.Debug.NetLoopback(messages, { Compress = false })
+    AssertEquals(batched.Packets, 1)
+    AssertEquals(batched.Payloads, messages)
+
+    local compressed = Ext.Debug.NetLoopback(messages)
+    AssertEquals(compressed.Packets, 1)
+    AssertEquals(compressed.CompressedPackets, 1)
+    AssertEquals(compressed.Payloads, messages)
+    Assert(compressed.Bytes < batched.Bytes)
+    Assert(compressed.Bytes < separateBytes)
+end
+
+local function RandomPayload(size)
+    local chunks = {}
+    for i=1,size // 4 do
+        chunks[i] = string.pack("<I4", math.random(0, 0xffffffff))
+    end
+    return table.concat(chunks)
+end
+
+function TestNetLoopbackFragmentation()
+    -- Random data doesn't compress, so the message is split into 5 fragments
+    local payload = RandomPayload(300000)
+
+    local result = Ext.Debug.NetLoopback(payload)
+    AssertEquals(result.Fragments, 5)
+    AssertEquals(result.Received, 1)
+    Assert(result.Payload == payload)
+
+    result = Ext.Debug.NetLoopback(payload, { Order = "Reverse" })
+    AssertEquals(result.Received, 1)
+    Assert(result.Payload == payload)
+
+    result = Ext.Debug.NetLoopback(payload, { Order = "Shuffle" })
+    AssertEquals(result.Received, 1)
+    Assert(result.Payload == payload)
+
+    -- Duplicates must be ignored, including ones arriving after the message was reassembled
+    result = Ext.Debug.NetLoopback(payload, { Order = "Shuffle", Duplicate = true })
+    AssertEquals(result.Fragments, 10)
+    AssertEquals(result.Received, 1)
+    Assert(result.Payload == payload)
+
+    -- Compressed fragmented payload
+    local compressible = CompressiblePayload(30000)
+    result = Ext.Debug.NetLoopback(compressible)
+    AssertEquals(result.Received, 1)
+    Assert(result.Payload == compressible)
+
+    -- Payloads exceeding the max. compression ratio are sent uncompressed
+    local repetitive = string.rep("A", 60000)
+    result = Ext.Debug.NetLoopback(repetitive)
+    AssertEquals(result.CompressedPackets, 0)
+    Assert(result.Payload == repetitive)
+end
+
+function TestNetLoopbackMalformedFragments()
+    local payload = RandomPayload(300000)
+
+    for _,corrupt in ipairs({"Offset", "Truncate", "Count"}) do
+        local result = Ext.Debug.NetLoopback(payload, { Corrupt = corrupt })
+        AssertEquals(result.Received, 0)
+        AssertEquals(result.Payload, nil)
+    end
+end
+
+-- Messages that never receive all of their fragments must not block later messages, and are
+-- evicted once too many incomplete messages are pending
+function TestNetLoopbackDroppedFragments()
+    -- Two fragments each
+    local large = RandomPayload(100000)
+
+    local result = Ext.Debug.NetLoopback({ large, "After", large }, { Drop = 1 })
+    AssertEquals(result.Received, 2)
+    -- Regular messages are sent ahead of fragments, so the small message arrives first
+    AssertEquals(result.Payloads[1], "After")
+    Assert(result.Payloads[2] == large)
+    AssertEquals(result.PendingTransfers, { 1 })
+
+    -- 20 incomplete messages; only the newest 16 are kept, and completing another one evicts the oldest
+    local payloads = {}
+    for i=1,20 do
+        payloads[i] = large
+    end
+    payloads[21] = "After"
+    payloads[22] = large
+
+    result = Ext.Debug.NetLoopback(payloads, { Drop = 20 })
+    AssertEquals(result.Received, 2)
+    AssertEquals(result.Payloads[1], "After")
+    Assert(result.Payloads[2] == large)
+
+    local expected = {}
+    for id=6,20 do
+        table.insert(expected, id)
+    end
+    AssertEquals(result.PendingTransfers, expected)
+end
+
+RegisterTests("Network", {
+    "TestNetLoopbackSmallMessage",
+    "TestNetLoopbackCompression",
+    "TestNetLoopbackBatching",
+    "TestNetLoopbackFragmentation",
+    "TestNetLoopbackMalformedFragments",
+    "TestNetLoopbackDroppedFragments"
+})
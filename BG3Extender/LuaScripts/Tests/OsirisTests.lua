@@ -55,8 +55,320 @@ function TestOsirisUserQuerySubscribers()
     AssertEquals(regOk2, true)
 end
 
+local function CheckOsirisDBIndex(name, arity, column)
+    local db = Osi[name]
+    local allRows = db:Get(table.unpack({}, 1, arity))
+
+    Assert(Ext.Osiris.CreateIndex(name, arity, column))
+    for i,row in ipairs(allRows) do
+        -- Indexed lookup must return the same rows in the same order as a linear scan
+        local expected = {}
+        for j,candidate in ipairs(allRows) do
+            if candidate[column] == row[column] then
+                table.insert(expected, candidate)
+            end
+        end
+
+        local args = {}
+        args[column] = row[column]
+        AssertEquals(db:Get(table.unpack(args, 1, arity)), expected)
+    end
+    Assert(Ext.Osiris.DropIndex(name, arity, column))
+    AssertEquals(Ext.Osiris.DropIndex(name, arity, column), false)
+end
+
+function TestOsirisDBIndex()
+    local host = Osi.GetHostCharacter()
+    Assert(Ext.Osiris.CreateIndex("DB_Players", 1, 1))
+
+    -- Index must track inserts and deletes done after it was created
+    Osi.DB_Players:Delete(host)
+    AssertEquals(#Osi.DB_Players:Get(host), 0)
+    Osi.DB_Players(host)
+    AssertEquals(#Osi.DB_Players:Get(host), 1)
+    AssertEquals(#Osi.DB_Players:Get("00000000-0000-0000-0000-000000000000"), 0)
+
+    Assert(Ext.Osiris.DropIndex("DB_Players", 1, 1))
+    CheckOsirisDBIndex("DB_Players", 1, 1)
+end
+
+function TestOsirisProfiler()
+    local host = Osi.GetHostCharacter()
+    Assert(Ext.Debug.StartOsirisProfiler(true))
+    Osi.DB_Players:Delete(host)
+    Osi.DB_Players(host)
+    Ext.Debug.StopOsirisProfiler()
+
+    local profile = Ext.Debug.GetOsirisProfile()
+    Assert(profile.ProfiledUs > 0)
+    local players = profile.Functions.DB_Players
+    Assert(players ~= nil and players.Calls >= 2)
+    for i,node in ipairs(profile.Nodes) do
+        Assert(node.Calls > 0)
+        Assert(node.ExclusiveUs <= node.InclusiveUs + 0.001)
+    end
+
+    -- Rule times are the sum of their tree nodes, goal times the sum of their rules
+    local nodeUs = 0
+    for i,node in ipairs(profile.Nodes) do
+        nodeUs = nodeUs + node.ExclusiveUs
+        -- Recursive calls of a node must only count its inclusive time once
+        Assert(node.InclusiveUs <= profile.ProfiledUs + 0.001)
+    end
+    -- Exclusive times never overlap, so they can't add up to more than the profiled interval
+    Assert(nodeUs <= profile.ProfiledUs + 0.001)
+    local ruleUs = 0
+    local goalRuleUs = 0
+    for i,rule in ipairs(profile.Rules) do
+        Assert(rule.ExclusiveUs >= 0)
+        ruleUs = ruleUs + rule.ExclusiveUs
+        if rule.Goal ~= nil then
+            goalRuleUs = goalRuleUs + rule.ExclusiveUs
+        end
+    end
+    local goalUs = 0
+    for name,goal in pairs(profile.Goals) do
+        goalUs = goalUs + goal.ExclusiveUs
+    end
+    Assert(ruleUs <= nodeUs + 0.001)
+    Assert(math.abs(goalUs - goalRuleUs) < 0.001)
+
+    -- Calls made while the profiler is stopped must not be recorded
+    Osi.DB_Players(host)
+    AssertEquals(Ext.Debug.GetOsirisProfile().Functions.DB_Players.Calls, players.Calls)
+
+    Ext.Debug.ResetOsirisProfiler()
+    AssertEquals(#Ext.Debug.GetOsirisProfile().Nodes, 0)
+end
+
+-- Replays node traces with fixed timestamps and checks the exact time attributed to each node
+function TestOsirisProfilerAttribution()
+    local function Check(stats, calls, inclusive, exclusive)
+        AssertEquals(stats.Calls, calls)
+        AssertEquals(stats.InclusiveTicks, inclusive)
+        AssertEquals(stats.ExclusiveTicks, exclusive)
+    end
+
+    -- Nested calls are subtracted from the exclusive time of the caller
+    local nodes = Ext.Debug.ProfileOsirisNodeTrace({
+        { "Enter", 1, 0 },
+            { "Enter", 2, 10 },
+            { "Exit", 40 },
+            { "Enter", 3, 50 },
+            { "Exit", 60 },
+        { "Exit", 100 }
+    })
+    Check(nodes[1], 1, 100, 60)
+    Check(nodes[2], 1, 30, 30)
+    Check(nodes[3], 1, 10, 10)
+
+    -- Recursive calls only count the inclusive time of the outermost call
+    nodes = Ext.Debug.ProfileOsirisNodeTrace({
+        { "Enter", 1, 0 },
+            { "Enter", 1, 10 },
+            { "Exit", 30 },
+        { "Exit", 50 }
+    })
+    Check(nodes[1], 2, 50, 50)
+
+    -- Hook time (including nodes called from hooks) is excluded from every enclosing node
+    nodes = Ext.Debug.ProfileOsirisNodeTrace({
+        { "Enter", 1, 0 },
+            { "Hook", 5 },
+                { "Enter", 2, 6 },
+                { "Exit", 16 },
+            { "EndHook", 25 },
+            { "Enter", 3, 30 },
+                { "Hook", 32 },
+                { "EndHook", 40 },
+            { "Exit", 50 },
+        { "Exit", 100 }
+    })
+    Check(nodes[1], 1, 72, 60)
+    Check(nodes[2], 1, 10, 10)
+    Check(nodes[3], 1, 12, 12)
+end
+
+-- Runs each query with and without an index on the column; the indexed lookup must return
+-- the same rows in the same order as a linear scan
+local function CheckOsirisDBIndexQueries(name, arity, column, queries)
+    local db = Osi[name]
+    local expected = {}
+    for i,args in ipairs(queries) do
+        expected[i] = db:Get(table.unpack(args, 1, arity))
+    end
+
+    Assert(Ext.Osiris.CreateIndex(name, arity, column))
+    for i,args in ipairs(queries) do
+        AssertEquals(db:Get(table.unpack(args, 1, arity)), expected[i])
+    end
+    Assert(Ext.Osiris.DropIndex(name, arity, column))
+end
+
+function TestOsirisDBIndexMultiColumn()
+    local host = Osi.GetHostCharacter()
+    local uuid = string.sub(host, -36)
+    Osi.DB_Dialogs(host, "SE_Test_Index_A")
+    Osi.DB_Dialogs(host, "SE_Test_Index_B")
+
+    local queries = {
+        { host, "SE_Test_Index_A" },
+        { nil, "SE_Test_Index_B" },
+        -- Strings are matched case-insensitively, GUIDs only on their UUID part
+        { nil, "se_test_index_a" },
+        { uuid, nil },
+        { "SomeOtherName_" .. uuid, nil },
+        { string.upper(uuid), "SE_TEST_INDEX_B" },
+        { "too-short-to-be-a-guid", nil },
+        { nil, "SE_Test_Index_Missing" }
+    }
+    CheckOsirisDBIndexQueries("DB_Dialogs", 2, 1, queries)
+    CheckOsirisDBIndexQueries("DB_Dialogs", 2, 2, queries)
+    AssertEquals(#Osi.DB_Dialogs:Get("Prefix_" .. uuid, "SE_Test_Index_A"), 1)
+
+    -- Deletes through an index must keep it in sync with the database
+    Assert(Ext.Osiris.CreateIndex("DB_Dialogs", 2, 2))
+    Osi.DB_Dialogs:Delete(nil, "se_test_index_a")
+    Osi.DB_Dialogs:Delete("Prefix_" .. uuid, "SE_Test_Index_B")
+    AssertEquals(#Osi.DB_Dialogs:Get(nil, "SE_Test_Index_A"), 0)
+    AssertEquals(#Osi.DB_Dialogs:Get(nil, "SE_Test_Index_B"), 0)
+    Assert(Ext.Osiris.DropIndex("DB_Dialogs", 2, 2))
+    AssertEquals(#Osi.DB_Dialogs:Get(nil, "SE_Test_Index_A"), 0)
+    AssertEquals(#Osi.DB_Dialogs:Get(nil, "SE_Test_Index_B"), 0)
+end
+
+-- Random inserts and deletes while an index is active; lookups must match a model of the
+-- database and the rows returned by a linear scan
+function TestOsirisDBIndexRandomized()
+    local host = Osi.GetHostCharacter()
+    local values = {}
+    for i=1,16 do
+        values[i] = "SE_Test_Rand_" .. i
+        Osi.DB_Dialogs:Delete(host, values[i])
+    end
+
+    -- Fixed seed LCG so failures are reproducible
+    local seed = 12345
+    local function Random(n)
+        seed = (seed * 1103515245 + 12345) % 0x80000000
+        return (seed >> 16) % n + 1
+    end
+
+    for column=1,2 do
+        local present = {}
+        Assert(Ext.Osiris.CreateIndex("DB_Dialogs", 2, column))
+        for step=1,500 do
+            local value = values[Random(#values)]
+            local op = Random(3)
+            if op == 1 then
+                Osi.DB_Dialogs(host, value)
+                present[value] = true
+            elseif op == 2 then
+                Osi.DB_Dialogs:Delete(host, value)
+                present[value] = nil
+            end
+
+            local query = values[Random(#values)]
+            local rows = Osi.DB_Dialogs:Get(nil, query)
+            AssertEquals(#rows, present[query] and 1 or 0)
+            AssertEquals(#Osi.DB_Dialogs:Get(host, query), present[query] and 1 or 0)
+        end
+
+        local indexed = {}
+        for i,value in ipairs(values) do
+            indexed[i] = Osi.DB_Dialogs:Get(nil, value)
+        end
+        local indexedHost = Osi.DB_Dialogs:Get(host, nil)
+
+        Assert(Ext.Osiris.DropIndex("DB_Dialogs", 2, column))
+        for i,value in ipairs(values) do
+            AssertEquals(indexed[i], Osi.DB_Dialogs:Get(nil, value))
+            Osi.DB_Dialogs:Delete(host, value)
+        end
+        AssertEquals(indexedHost, Osi.DB_Dialogs:Get(host, nil))
+    end
+end
+
+function TestOsirisDBIndexIntegers()
+    local host = Osi.GetHostCharacter()
+    local combatId = 0x7ff0e1
+    Osi.DB_CombatCharacters(host, combatId)
+
+    CheckOsirisDBIndexQueries("DB_CombatCharacters", 2, 2, {
+        { nil, combatId },
+        { host, combatId },
+        -- Integral floats match integer columns
+        { nil, combatId + 0.0 },
+        -- Integer column values are 32-bit; larger Lua integers must not alias them
+        { nil, combatId + 0x100000000 },
+        { nil, combatId - 0x100000000 },
+        { nil, math.maxinteger },
+        { nil, -1 }
+    })
+
+    Osi.DB_CombatCharacters:Delete(host, combatId)
+    AssertEquals(#Osi.DB_CombatCharacters:Get(host, combatId), 0)
+end
+
+-- Cost of node hooks for databases with and without subscribers
+function TestOsirisSubscriberPerformance()
+    local host = Osi.GetHostCharacter()
+    local iterations = 10000
+
+    local startTime = Ext.Utils.MicrosecTime()
+    for i=1,iterations do
+        Osi.DB_Dialogs(host, "SE_Test_Subscriber_Perf")
+        Osi.DB_Dialogs:Delete(host, "SE_Test_Subscriber_Perf")
+    end
+    local unsubscribedTime = Ext.Utils.MicrosecTime() - startTime
+
+    local combatId = 0x7ff0e2
+    local calls = 0
+    Ext.Osiris.RegisterListener("DB_CombatCharacters", 2, "after", function (character, id)
+        if id == combatId then
+            calls = calls + 1
+        end
+    end)
+
+    startTime = Ext.Utils.MicrosecTime()
+    for i=1,iterations do
+        Osi.DB_CombatCharacters(host, combatId)
+        Osi.DB_CombatCharacters:Delete(host, combatId)
+    end
+    local subscribedTime = Ext.Utils.MicrosecTime() - startTime
+
+    AssertEquals(calls, iterations)
+    AssertEquals(#Osi.DB_Dialogs:Get(host, "SE_Test_Subscriber_Perf"), 0)
+    AssertEquals(#Osi.DB_CombatCharacters:Get(host, combatId), 0)
+
+    Ext.Utils.Print(string.format("Osiris insert+delete: %.2f us without subscribers; %.2f us with a Lua subscriber",
+        unsubscribedTime / iterations, subscribedTime / iterations))
+end
+
+-- The subscriber table on its own, with mock node IDs instead of a loaded story, so the dense lookup path is
+-- measured without the cost of Osiris inserts and Lua callbacks
+function TestOsirisSubscriberTable()
+    local nodes = 30000
+    local result = Ext.Debug.BenchmarkOsirisSubscriberTable(nodes, 2000, 200000)
+    AssertEquals(result.Mismatches, 0)
+    Assert(result.Hits > 0)
+    Assert(result.DenseSize <= nodes + 1)
+    Assert(result.SparseSize > 0)
+
+    Ext.Utils.Print(string.format("Osiris subscriber lookup: %.1f ns with the dense table; %.1f ns with a hash map",
+        result.NsPerLookup, result.BaselineNsPerLookup))
+end
+
 RegisterTests("Stats", {
     "TestOsirisCallSubscribers",
     "TestOsirisDBSubscribers",
-    "TestOsirisUserQuerySubscribers"
+    "TestOsirisUserQuerySubscribers",
+    "TestOsirisSubscriberPerformance",
+    "TestOsirisSubscriberTable",
+    "TestOsirisDBIndex",
+    "TestOsirisDBIndexMultiColumn",
+    "TestOsirisDBIndexIntegers",
+    "TestOsirisDBIndexRandomized",
+    "TestOsirisProfiler",
+    "TestOsirisProfilerAttribution"
 })
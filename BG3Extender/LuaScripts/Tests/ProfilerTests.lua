@@ -0,0 +1,84 @@
+local function ProfilerHotSpot(n)
+    local sum = 0
+    for i=1,n do
+        sum = sum + i % 7
+    end
+    return sum
+end
+
+local function ProfilerColdSpot(n)
+    local sum = 0
+    for i=1,n do
+        sum = sum + i % 3
+    end
+    return sum
+end
+
+local function CountFoldedSamples(folded, frame)
+    local samples = 0
+    for line in folded:gmatch("[^\n]+") do
+        local stack, count = line:match("^(.*) (%d+)$")
+        if stack:find(frame, 1, true) then
+            samples = samples + tonumber(count)
+        end
+    end
+    return samples
+end
+
+function TestLuaProfiler()
+    Ext.Debug.ResetLuaProfiler()
+    Ext.Debug.StartLuaProfiler(100)
+    -- Known hot spot: 9x more work than the cold function
+    for i=1,20 do
+        ProfilerHotSpot(90000)
+        ProfilerColdSpot(10000)
+    end
+    Ext.Debug.StopLuaProfiler()
+
+    local profile = Ext.Debug.GetLuaProfile()
+    AssertEquals(profile.Running, false)
+    AssertEquals(profile.Interval, 100)
+    Assert(profile.Samples > 1000)
+    -- Test scripts are loaded from the builtin bundle
+    AssertEquals(profile.Mods.Builtin, profile.Samples)
+
+    local folded = Ext.Debug.DumpLuaProfile()
+    local hot = CountFoldedSamples(folded, "ProfilerHotSpot")
+    local cold = CountFoldedSamples(folded, "ProfilerColdSpot")
+    Assert(cold > 0)
+    Assert(hot > cold * 5)
+
+    -- No samples are taken while stopped
+    ProfilerHotSpot(10000)
+    AssertEquals(Ext.Debug.GetLuaProfile().Samples, profile.Samples)
+
+    Ext.Debug.ResetLuaProfiler()
+    AssertEquals(Ext.Debug.GetLuaProfile().Samples, 0)
+    AssertEquals(Ext.Debug.DumpLuaProfile(), "")
+end
+
+-- Frames must be identified by their source and name, not by the address of the strings;
+-- chunk names are collected between runs and their memory may be reused by the next chunk
+function TestLuaProfilerCollectedSources()
+    Ext.Debug.ResetLuaProfiler()
+    Ext.Debug.StartLuaProfiler(100)
+    for i=1,10 do
+        local fn = load("local sum = 0 for i=1,50000 do sum = sum + i % 5 end return sum", "=SE_ProfilerChunk_" .. i)
+        fn()
+        fn = nil
+        collectgarbage()
+    end
+    Ext.Debug.StopLuaProfiler()
+
+    local folded = Ext.Debug.DumpLuaProfile()
+    for i=1,10 do
+        Assert(CountFoldedSamples(folded, "SE_ProfilerChunk_" .. i .. ":") > 0)
+    end
+
+    Ext.Debug.ResetLuaProfiler()
+end
+
+RegisterTests("Profiler", {
+    "TestLuaProfiler",
+    "TestLuaProfilerCollectedSources"
+})
@@ -65,9 +65,97 @@ function TestGuidResourceLayout()
     end
 end
 
+function TestPropertyLookup()
+    local res = Ext.StaticData.Get("d21368ac-c776-465c-9dcf-6123dd52734f", "ClassDescription")
+    local keys = 0
+    for k,v in pairs(res) do
+        AssertEquals(type(res[k]), type(v))
+        keys = keys + 1
+    end
+    Assert(keys > 0)
+
+    AssertEquals(pcall(function () return res.NonexistentProperty end), false)
+    AssertEquals(pcall(function () return res[""] end), false)
+end
+
+function TestPropertyReadPerformance()
+    local res = Ext.StaticData.Get("d21368ac-c776-465c-9dcf-6123dd52734f", "ClassDescription")
+    local iterations = 1000000
+
+    -- FixedString property values
+    local startTime = Ext.Utils.MicrosecTime()
+    for i=1,iterations do
+        local name = res.Name
+    end
+    local readTime = Ext.Utils.MicrosecTime() - startTime
+
+    -- FixedString property names
+    local keys = 0
+    startTime = Ext.Utils.MicrosecTime()
+    for i=1,iterations/100 do
+        for k,v in pairs(res) do
+            keys = keys + 1
+        end
+    end
+    local iterateTime = Ext.Utils.MicrosecTime() - startTime
+
+    AssertEquals(res.Name, "LoreCollege")
+    Ext.Utils.Print(string.format("Property reads: %.1f ns/read; pairs(): %.1f ns/key",
+        readTime * 1000 / iterations, iterateTime * 1000 / keys))
+end
+
+-- Looks up every property of resources with differently sized property maps
+function TestPropertyLookupPerformance()
+    local types = { "ClassDescription", "Race", "Progression", "Tag", "Faction", "Feat", "CharacterCreationPreset" }
+    local resources = {}
+    local objects = {}
+    local names = {}
+    for i,type in ipairs(types) do
+        local uuid = Ext.StaticData.GetAll(type)[1]
+        if uuid ~= nil then
+            local res = Ext.StaticData.Get(uuid, type)
+            local keys = {}
+            for k,v in pairs(res) do
+                keys[k] = true
+                table.insert(objects, res)
+                table.insert(names, k)
+            end
+            table.insert(resources, { Object = res, Keys = keys })
+        end
+    end
+    Assert(#names > 0)
+
+    local iterations = 200000
+    local count = #names
+    local startTime = Ext.Utils.MicrosecTime()
+    for i=1,iterations do
+        local j = (i % count) + 1
+        local v = objects[j][names[j]]
+    end
+    local hitTime = Ext.Utils.MicrosecTime() - startTime
+
+    -- Property names of other maps are valid FixedStrings, so they go through the table probe
+    -- and must be rejected by the key compare
+    local misses = 0
+    for i,res in ipairs(resources) do
+        for j,name in ipairs(names) do
+            if not res.Keys[name] then
+                AssertEquals(pcall(function () return res.Object[name] end), false)
+                misses = misses + 1
+            end
+        end
+    end
+
+    Ext.Utils.Print(string.format("Property lookups: %.1f ns/lookup over %d properties of %d types; %d misses checked",
+        hitTime * 1000 / iterations, count, #resources, misses))
+end
+
 RegisterTests("StaticData", {
     "TestGuidResourceEnumeration",
     "TestGuidResourceFetch",
     "TestGuidResourceUpdate",
-    "TestGuidResourceLayout"
+    "TestGuidResourceLayout",
+    "TestPropertyLookup",
+    "TestPropertyReadPerformance",
+    "TestPropertyLookupPerformance"
 })
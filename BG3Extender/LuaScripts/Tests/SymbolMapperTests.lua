@@ -0,0 +1,217 @@
+-- Builds a deterministic pseudo-random buffer from a small alphabet, so short patterns match often
+local function MakeScanBuffer(size, seed)
+    local alphabet = { 0x48, 0x8B, 0x89, 0x0F, 0x00, 0xFF, 0xE8, 0xC3 }
+    local state = seed
+    local bytes = {}
+    for i=1,size do
+        state = (state * 1103515245 + 12345) % 2147483648
+        bytes[i] = string.char(alphabet[(state >> 16) % #alphabet + 1])
+    end
+    return bytes
+end
+
+-- Overwrites the buffer with the bytes of a pattern at a 0-based offset; wildcards are filled with 0xCC
+local function PlantPattern(bytes, offset, pattern)
+    local i = offset + 1
+    for byte in pattern:gmatch("%S+") do
+        bytes[i] = byte == "??" and string.char(0xCC) or string.char(tonumber(byte, 16))
+        i = i + 1
+    end
+end
+
+local ScanPatterns = {
+    -- Two-byte prefixes, including several patterns sharing the same prefix
+    "48 8B 89",
+    "48 8B 89 0F",
+    "48 8B ?? 0F",
+    "48 8B",
+    -- Wildcard as the second byte
+    "E8 ?? ?? ?? ?? 48",
+    "E8 ?? C3",
+    -- Single byte pattern
+    "C3",
+    -- Self-overlapping pattern
+    "FF FF FF",
+    -- Prefix that never occurs in the buffer
+    "90 90 ?? 90",
+    -- Pattern planted at the start and at the end of the buffer
+    "0F 1F 44 00 00 CC CC",
+    -- Duplicate of an earlier pattern
+    "48 8B 89"
+}
+
+-- The single-pass scanner must return the same matches, in the same order, as a separate scan for each pattern
+function TestPatternScannerMatchesSingleScan()
+    for seed=1,5 do
+        local bytes = MakeScanBuffer(16384, seed)
+        PlantPattern(bytes, 0, "0F 1F 44 00 00 CC CC")
+        PlantPattern(bytes, 100, "90 90 ?? 90")
+        -- A match ending on the last byte of the buffer is outside the scan bounds of Pattern::Scan(),
+        -- so the single-pass scanner must skip it as well
+        PlantPattern(bytes, #bytes - 7, "0F 1F 44 00 00 CC CC")
+        PlantPattern(bytes, #bytes - 16, "0F 1F 44 00 00 CC CC")
+
+        local results = Ext.Debug.ScanPatterns(table.concat(bytes), ScanPatterns)
+        AssertEquals(#results, #ScanPatterns)
+        for i,result in ipairs(results) do
+            AssertEquals(result.Matches, result.Expected)
+        end
+
+        -- Sanity check that the buffer actually exercises the lookup tables
+        Assert(#results[1].Matches > 0)
+        Assert(#results[5].Matches > 0)
+        Assert(#results[7].Matches > 0)
+        Assert(#results[8].Matches > 0)
+        AssertEquals(results[9].Matches, {100})
+        AssertEquals(results[10].Matches, {0, #bytes - 16})
+        AssertEquals(results[11].Matches, results[1].Matches)
+    end
+end
+
+-- Short buffers and buffers that contain only a prefix
+function TestPatternScannerEdgeCases()
+    local patterns = { "48 8B 05", "C3" }
+    AssertEquals(Ext.Debug.ScanPatterns("", patterns), {
+        { Matches = {}, Expected = {} },
+        { Matches = {}, Expected = {} }
+    })
+
+    for _,buffer in ipairs({ "\x48", "\x48\x8B", "\x48\x8B\x05", "\x48\x8B\x05\x00", "\xC3\xC3\xC3" }) do
+        local results = Ext.Debug.ScanPatterns(buffer, patterns)
+        for i,result in ipairs(results) do
+            AssertEquals(result.Matches, result.Expected)
+        end
+    end
+
+    local results = Ext.Debug.ScanPatterns("\x48\x8B\x05\x00", patterns)
+    AssertEquals(results[1].Matches, {0})
+end
+
+local CachePatterns = {
+    Call = "E8 ?? ?? ?? ?? 48",
+    Load = "48 8B 89 0F",
+    Ret = "C3 C3",
+    Marker = "0F 1F 44 00 00 CC CC",
+    Missing = "90 90 ?? 90"
+}
+
+local function MakeCacheImage(markerByte)
+    local bytes = MakeScanBuffer(8192, 42)
+    PlantPattern(bytes, 200, "0F 1F 44 00 00 CC CC")
+    if markerByte ~= nil then
+        bytes[201] = string.char(markerByte)
+    end
+    return table.concat(bytes)
+end
+
+local function MapWithCache(image, options, patterns)
+    patterns = patterns or CachePatterns
+    local result = Ext.Debug.MapSymbolsWithCache(image, patterns, options)
+
+    -- Matches must be the same regardless of where they came from
+    local names = {}
+    local list = {}
+    for name,pattern in pairs(patterns) do
+        table.insert(names, name)
+        table.insert(list, pattern)
+    end
+
+    local expected = Ext.Debug.ScanPatterns(image, list)
+    for i,name in ipairs(names) do
+        AssertEquals(result.Matches[name], expected[i].Expected)
+    end
+
+    return result
+end
+
+-- Matches are saved on the first run and reused as long as the module build is the same
+function TestSymbolMatchCacheReuse()
+    local image = MakeCacheImage()
+    local ids = { TimeDateStamp = 0x12345678, CheckSum = 0x1000 }
+
+    local result = MapWithCache(image, { TimeDateStamp = ids.TimeDateStamp, CheckSum = ids.CheckSum, Reset = true })
+    AssertEquals(result.LoadedEntries, 0)
+    AssertEquals(result.CachedMappings, 0)
+    AssertEquals(result.ScannedMappings, 5)
+    Assert(result.Saved)
+    AssertEquals(result.Matches.Marker, {200})
+
+    result = MapWithCache(image, ids)
+    AssertEquals(result.LoadedEntries, 5)
+    AssertEquals(result.CachedMappings, 5)
+    AssertEquals(result.ScannedMappings, 0)
+    AssertEquals(result.StaleMappings, 0)
+    Assert(not result.Saved)
+
+    -- New build identifiers with the same code; the cache is still valid, but has to be rewritten with the new key
+    local rebuilt = { TimeDateStamp = 0x12345679, CheckSum = 0x1001 }
+    result = MapWithCache(image, rebuilt)
+    AssertEquals(result.CachedMappings, 5)
+    AssertEquals(result.ScannedMappings, 0)
+    Assert(result.Saved)
+
+    result = MapWithCache(image, rebuilt)
+    AssertEquals(result.CachedMappings, 5)
+    Assert(not result.Saved)
+end
+
+-- Cached matches are revalidated, and the cache is ignored if the code or the mappings changed
+function TestSymbolMatchCacheFallback()
+    local image = MakeCacheImage()
+    local ids = { TimeDateStamp = 0x12345678, CheckSum = 0x1000 }
+    MapWithCache(image, { TimeDateStamp = ids.TimeDateStamp, CheckSum = ids.CheckSum, Reset = true })
+
+    -- Same build identifiers, but the bytes at a cached match changed (i.e. the code was patched on disk)
+    local patched = MakeCacheImage(0x90)
+    local result = MapWithCache(patched, ids)
+    AssertEquals(result.LoadedEntries, 5)
+    AssertEquals(result.StaleMappings, 1)
+    AssertEquals(result.CachedMappings, 4)
+    AssertEquals(result.ScannedMappings, 1)
+    Assert(result.Saved)
+    AssertEquals(result.Matches.Marker, {})
+
+    -- Different build and different code
+    result = MapWithCache(image, { TimeDateStamp = 0x22222222, CheckSum = 0x2000 })
+    AssertEquals(result.LoadedEntries, 0)
+    AssertEquals(result.CachedMappings, 0)
+    AssertEquals(result.ScannedMappings, 5)
+    Assert(result.Saved)
+
+    -- Same module, different mappings
+    local patterns = {}
+    for name,pattern in pairs(CachePatterns) do
+        patterns[name] = pattern
+    end
+    patterns.Extra = "48 8B"
+    result = MapWithCache(image, { TimeDateStamp = 0x22222222, CheckSum = 0x2000 }, patterns)
+    AssertEquals(result.LoadedEntries, 0)
+    AssertEquals(result.ScannedMappings, 6)
+end
+
+-- Damaged cache files are ignored and replaced
+function TestSymbolMatchCacheCorrupt()
+    local image = MakeCacheImage()
+    local ids = { TimeDateStamp = 0x12345678, CheckSum = 0x1000 }
+
+    for _,corrupt in ipairs({ "Magic", "Truncate" }) do
+        MapWithCache(image, { TimeDateStamp = ids.TimeDateStamp, CheckSum = ids.CheckSum, Reset = true })
+
+        local result = MapWithCache(image, { TimeDateStamp = ids.TimeDateStamp, CheckSum = ids.CheckSum, Corrupt = corrupt })
+        AssertEquals(result.LoadedEntries, 0)
+        AssertEquals(result.CachedMappings, 0)
+        AssertEquals(result.ScannedMappings, 5)
+        Assert(result.Saved)
+
+        result = MapWithCache(image, ids)
+        AssertEquals(result.CachedMappings, 5)
+    end
+end
+
+RegisterTests("SymbolMapper", {
+    "TestPatternScannerMatchesSingleScan",
+    "TestPatternScannerEdgeCases",
+    "TestSymbolMatchCacheReuse",
+    "TestSymbolMatchCacheFallback",
+    "TestSymbolMatchCacheCorrupt"
+})
@@ -0,0 +1,154 @@
+function TestTimerCancel()
+    local handle = Ext.Timer.WaitFor(100000, function () error("Cancelled timer fired") end)
+    AssertEquals(Ext.Timer.Cancel(handle), true)
+    AssertEquals(Ext.Timer.Cancel(handle), false)
+    AssertEquals(Ext.Timer.Pause(handle), false)
+
+    local realtime = Ext.Timer.WaitForRealtime(100000, function () error("Cancelled timer fired") end)
+    AssertEquals(Ext.Timer.Cancel(realtime), true)
+    AssertEquals(Ext.Timer.Cancel(realtime), false)
+end
+
+function TestTimerPauseResume()
+    for i,waitFunc in ipairs({Ext.Timer.WaitFor, Ext.Timer.WaitForRealtime}) do
+        local handle = waitFunc(100000, function () error("Cancelled timer fired") end)
+        AssertEquals(Ext.Timer.IsPaused(handle), false)
+        AssertEquals(Ext.Timer.Resume(handle), false)
+        AssertEquals(Ext.Timer.Pause(handle), true)
+        AssertEquals(Ext.Timer.Pause(handle), false)
+        AssertEquals(Ext.Timer.IsPaused(handle), true)
+        AssertEquals(Ext.Timer.Resume(handle), true)
+        AssertEquals(Ext.Timer.IsPaused(handle), false)
+        AssertEquals(Ext.Timer.Pause(handle), true)
+        AssertEquals(Ext.Timer.Cancel(handle), true)
+        AssertEquals(Ext.Timer.IsPaused(handle), false)
+    end
+end
+
+function TestTimerChurn()
+    local count = 10000
+    local handles = {}
+    local startTime = Ext.Utils.MicrosecTime()
+    for i=1,count do
+        -- Spread delays over every wheel level, including the overflow list
+        handles[i] = Ext.Timer.WaitFor(1000 + i * i * 50, function () error("Cancelled timer fired") end)
+    end
+    local createTime = Ext.Utils.MicrosecTime() - startTime
+
+    startTime = Ext.Utils.MicrosecTime()
+    for i=1,count do
+        Assert(Ext.Timer.Cancel(handles[i]))
+    end
+    local cancelTime = Ext.Utils.MicrosecTime() - startTime
+
+    Ext.Utils.Print(string.format("Timer churn: create %.3f us, cancel %.3f us per timer (%d timers)",
+        createTime / count, cancelTime / count, count))
+end
+
+-- Replays the same operations on the game time and realtime managers; times are in seconds
+local function CheckTimerTrace(ops, expected)
+    for i,kind in ipairs({"Game", "Realtime"}) do
+        AssertEquals(Ext.Debug.RunTimerTrace(kind, ops), expected)
+    end
+end
+
+function TestTimerFiringOrder()
+    CheckTimerTrace({
+        { "Add", 0.03 },
+        { "Add", 0.01 },
+        { "Add", 0.02 },
+        { "Add", 0.01 },
+        { "Add", 1.5 },
+        { "Add", 1.8 },
+        { "Add", 1.7 },
+        { "Update", 0.005 },
+        { "Update", 0.01 },
+        { "Update", 0.025 },
+        { "Update", 0.03 },
+        { "Update", 1.499 },
+        { "Update", 1.5 },
+        -- Timers expiring during the same update fire in deadline order
+        { "Update", 2.0 }
+    }, {
+        { Timer = 2, Time = 0.01 },
+        { Timer = 4, Time = 0.01 },
+        { Timer = 3, Time = 0.025 },
+        { Timer = 1, Time = 0.03 },
+        { Timer = 5, Time = 1.5 },
+        { Timer = 7, Time = 2.0 },
+        { Timer = 6, Time = 2.0 }
+    })
+end
+
+function TestTimerRepeat()
+    CheckTimerTrace({
+        { "Add", 0.125, 0.0625 },
+        { "Update", 0.0625 },
+        { "Update", 0.125 },
+        { "Update", 0.15 },
+        { "Update", 0.25 },
+        -- A late update only fires once; the next deadline is relative to the update time
+        { "Update", 1.0 },
+        { "Update", 1.0 },
+        { "Cancel", 1 },
+        { "Update", 2.0 }
+    }, {
+        { Timer = 1, Time = 0.125 },
+        { Timer = 1, Time = 0.25 },
+        { Timer = 1, Time = 1.0 }
+    })
+end
+
+function TestTimerPauseResumeDelay()
+    CheckTimerTrace({
+        { "Add", 0.25 },
+        { "Add", 0.5 },
+        -- 0.125 remaining when paused
+        { "Pause", 1, 0.125 },
+        { "Update", 0.5 },
+        { "Resume", 1, 1.0 },
+        { "Update", 1.0 },
+        { "Update", 1.0625 },
+        { "Update", 1.125 }
+    }, {
+        { Timer = 2, Time = 0.5 },
+        { Timer = 1, Time = 1.125 }
+    })
+end
+
+-- Timers created through the Lua API fire in deadline order on later ticks
+function TestTimerFiring()
+    local fired = { Game = {}, Realtime = {} }
+    for i,delay in ipairs({ 30, 10, 20 }) do
+        Ext.Timer.WaitFor(delay, function () table.insert(fired.Game, delay) end)
+        Ext.Timer.WaitForRealtime(delay, function () table.insert(fired.Realtime, delay) end)
+    end
+
+    AssertEquals(#fired.Game, 0)
+    AssertEquals(#fired.Realtime, 0)
+
+    local ticks = 0
+    local tickHandler
+    tickHandler = Ext.Events.Tick:Subscribe(function ()
+        ticks = ticks + 1
+        if (#fired.Game < 3 or #fired.Realtime < 3) and ticks < 300 then
+            return
+        end
+
+        Ext.Events.Tick:Unsubscribe(tickHandler)
+        RunTest("TestTimerFiring (deferred)", function ()
+            AssertEquals(fired.Game, { 10, 20, 30 })
+            AssertEquals(fired.Realtime, { 10, 20, 30 })
+        end)
+    end)
+end
+
+RegisterTests("Timer", {
+    "TestTimerCancel",
+    "TestTimerPauseResume",
+    "TestTimerChurn",
+    "TestTimerFiringOrder",
+    "TestTimerRepeat",
+    "TestTimerPauseResumeDelay",
+    "TestTimerFiring"
+})
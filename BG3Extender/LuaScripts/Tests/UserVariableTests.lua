@@ -0,0 +1,145 @@
+local GUID_LAEZEL = "58a69333-40bf-8358-1d17-fff240d7fb12"
+
+-- Uncached variables are serialized on every write and deserialized on every read
+Ext.Vars.RegisterUserVariable("SE_Test_Composite", {
+    Persistent = false,
+    DontCache = true
+})
+
+-- Composite values are injected as JSON text using Ext.Debug.SetJsonUserVariable, the same way composite
+-- variables were stored before binary encoding; not cached, so every read parses the JSON value
+Ext.Vars.RegisterUserVariable("SE_Test_CompositeJson", {
+    Persistent = false,
+    DontCache = true
+})
+
+function TestUserVarCompositeRoundTrip()
+    local ent = Ext.Entity.Get(GUID_LAEZEL)
+    ent.Vars.SE_Test_Composite = {
+        Name = "Test\0Binary\255",
+        Count = 3,
+        Scale = 1.0,
+        List = { 1, 2.5, "three", false },
+        [10] = "int key",
+        [2.5] = "float key",
+        [true] = "bool key",
+        Nested = { { A = -1 }, { B = 1e300 } }
+    }
+
+    local v = ent.Vars.SE_Test_Composite
+    AssertEquals(v.Name, "Test\0Binary\255")
+    AssertEquals(math.type(v.Count), "integer")
+    AssertEquals(math.type(v.Scale), "float")
+    AssertEquals(#v.List, 4)
+    AssertEquals(v.List[3], "three")
+    AssertEquals(v.List[4], false)
+    AssertEquals(v[10], "int key")
+    AssertEquals(v["10"], nil)
+    AssertEquals(v[2.5], "float key")
+    AssertEquals(v[true], "bool key")
+    AssertEquals(v.Nested[1].A, -1)
+    AssertEquals(v.Nested[2].B, 1e300)
+
+    ent.Vars.SE_Test_Composite = nil
+    AssertEquals(ent.Vars.SE_Test_Composite, nil)
+end
+
+-- Integer keys are kept as integers; values stored as JSON (i.e. loaded from older savegames) return them as strings
+function TestUserVarCompositeIntegerKeys()
+    local ent = Ext.Entity.Get(GUID_LAEZEL)
+    ent.Vars.SE_Test_Composite = { [10] = "a", [20] = "b" }
+    AssertEquals(ent.Vars.SE_Test_Composite[10], "a")
+    AssertEquals(ent.Vars.SE_Test_Composite["10"], nil)
+
+    Assert(Ext.Debug.SetJsonUserVariable(ent, "SE_Test_CompositeJson", Ext.Json.Stringify({ [10] = "a", [20] = "b" }, { Beautify = false })))
+    local legacy = ent.Vars.SE_Test_CompositeJson
+    AssertEquals(legacy[10], nil)
+    AssertEquals(legacy["10"], "a")
+
+    ent.Vars.SE_Test_Composite = nil
+    ent.Vars.SE_Test_CompositeJson = nil
+end
+
+-- JSON values stored before binary encoding (older savegames and peers) must still be readable,
+-- and are re-encoded when written back
+function TestUserVarCompositeLegacyJson()
+    local ent = Ext.Entity.Get(GUID_LAEZEL)
+    local json = '{"Count":3,"Scale":1.5,"List":[1,2.5,"three",false],"10":"int key","Nested":{"A":{"B":-1}}}'
+    Assert(Ext.Debug.SetJsonUserVariable(ent, "SE_Test_CompositeJson", json))
+
+    local v = ent.Vars.SE_Test_CompositeJson
+    AssertEquals(v.Count, 3)
+    AssertEquals(math.type(v.Count), "integer")
+    AssertEquals(v.Scale, 1.5)
+    AssertEquals(v.List, { 1, 2.5, "three", false })
+    AssertEquals(v["10"], "int key")
+    AssertEquals(v.Nested.A.B, -1)
+    AssertEquals(v, Ext.Json.Parse(json))
+
+    ent.Vars.SE_Test_CompositeJson = v
+    AssertEquals(ent.Vars.SE_Test_CompositeJson, Ext.Json.Parse(json))
+
+    -- Malformed values are read as nil
+    Assert(Ext.Debug.SetJsonUserVariable(ent, "SE_Test_CompositeJson", '{"Count":'))
+    AssertEquals(ent.Vars.SE_Test_CompositeJson, nil)
+
+    ent.Vars.SE_Test_CompositeJson = nil
+end
+
+-- Returns the best time of several runs to reduce the effect of hitches
+local function MeasureBest(runs, iterations, fn)
+    local best
+    for run=1,runs do
+        local startTime = Ext.Utils.MicrosecTime()
+        for i=1,iterations do
+            fn()
+        end
+        local elapsed = Ext.Utils.MicrosecTime() - startTime
+        if best == nil or elapsed < best then
+            best = elapsed
+        end
+    end
+    return best
+end
+
+function TestUserVarCompositePerformance()
+    local ent = Ext.Entity.Get(GUID_LAEZEL)
+    local value = { Items = {}, Flags = {} }
+    for i=1,200 do
+        value.Items[i] = { Id = i, Name = "Item" .. i, Weight = i * 0.25, Position = { i, i + 0.5, -i } }
+        value.Flags["Flag" .. i] = (i % 2 == 0)
+    end
+
+    local iterations = 50
+    local runs = 3
+
+    -- Binary encoding: encoded on write, decoded on read
+    local binaryTime = MeasureBest(runs, iterations, function ()
+        ent.Vars.SE_Test_Composite = value
+        local v = ent.Vars.SE_Test_Composite
+    end)
+
+    -- Previous path: JSON stringified on write and stored as-is, parsed from the store on read
+    local json = Ext.Json.Stringify(value, { Beautify = false })
+    local jsonTime = MeasureBest(runs, iterations, function ()
+        Ext.Debug.SetJsonUserVariable(ent, "SE_Test_CompositeJson", Ext.Json.Stringify(value, { Beautify = false }))
+        local v = ent.Vars.SE_Test_CompositeJson
+    end)
+
+    -- Both paths must produce the same value
+    AssertEquals(ent.Vars.SE_Test_Composite, value)
+    AssertEquals(ent.Vars.SE_Test_CompositeJson, value)
+
+    ent.Vars.SE_Test_Composite = nil
+    ent.Vars.SE_Test_CompositeJson = nil
+
+    Ext.Utils.Print(string.format("User variable serialization: binary %.3f ms, JSON %.3f ms (%d iterations, JSON size %d bytes)",
+        binaryTime / 1000, jsonTime / 1000, iterations, #json))
+end
+
+RegisterTests("UserVariables", {
+    "TestUserVarCompositeRoundTrip",
+    "TestUserVarCompositeIntegerKeys",
+    "TestUserVarCompositeLegacyJson",
+    "TestUserVarCompositePerformance"
+})
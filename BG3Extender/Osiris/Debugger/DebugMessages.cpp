@@ -459,6 +459,22 @@ namespace bg3se::osidbg
 		}
 	}
 
+	void DebugMessageHandler::HandleProfilerControl(uint32_t seq, DbgProfilerControl const & req)
+	{
+		DEBUG(" --> DbgProfilerControl(%d)", req.action());
+
+		if (debugger_) {
+			auto process = [this, seq] (ResultCode rc) {
+				SendResult(seq, rc);
+			};
+
+			debugger_->ControlProfiler(seq, req.action(), process);
+		} else {
+			WARN("ProfilerControl: Not attached to story debugger!");
+			SendResult(seq, ResultCode::NoDebuggee);
+		}
+	}
+
 	bool DebugMessageHandler::HandleMessage(DebuggerToBackend const * msg)
 	{
 		uint32_t seq = msg->seq_no();
@@ -498,6 +514,10 @@ namespace bg3se::osidbg
 			HandleEvaluate(seq, msg->evaluate());
 			break;
 
+		case DebuggerToBackend::kProfilerControl:
+			HandleProfilerControl(seq, msg->profilercontrol());
+			break;
+
 		default:
 			ERR("Unknown message type received: %d", msg->msg_case());
 			return false;
@@ -616,6 +636,51 @@ namespace bg3se::osidbg
 		Send(msg);
 		DEBUG(" <-- BkEvaluateFinished()");
 	}
+
+	void DebugMessageHandler::SendProfileData(uint32_t seq, OsirisNodeProfiler const& profiler)
+	{
+		BackendToDebugger msg;
+		msg.set_reply_seq_no(seq);
+		auto profileMsg = msg.mutable_profiledata();
+		profileMsg->set_profiled_us(profiler.TicksToMicroseconds(profiler.GetProfiledTicks()));
+
+		auto const& nodes = profiler.GetNodeStats();
+		for (uint32_t id = 0; id < nodes.size(); id++) {
+			auto const& stats = nodes[id];
+			if (stats.Calls == 0) continue;
+
+			auto nodeMsg = profileMsg->add_node();
+			nodeMsg->set_node_id(id);
+			nodeMsg->set_calls(stats.Calls);
+			nodeMsg->set_inclusive_us(profiler.TicksToMicroseconds(stats.InclusiveTicks));
+			nodeMsg->set_exclusive_us(profiler.TicksToMicroseconds(stats.ExclusiveTicks));
+		}
+
+		auto& osiris = gExtender->GetServer().Osiris();
+		auto wrappers = osiris.GetVMTWrappers();
+		if (wrappers != nullptr) {
+			OsirisNodeProfiler::Rollup rollup;
+			profiler.BuildRollup((*osiris.GetGlobals().Nodes)->Db, *wrappers, rollup);
+
+			for (auto const& rule : rollup.Rules) {
+				auto ruleMsg = profileMsg->add_rule();
+				ruleMsg->set_node_id(rule.first);
+				ruleMsg->set_goal_id(rule.second.GoalId);
+				ruleMsg->set_calls(rule.second.Calls);
+				ruleMsg->set_exclusive_us(profiler.TicksToMicroseconds(rule.second.ExclusiveTicks));
+			}
+
+			for (auto const& goal : rollup.Goals) {
+				auto goalMsg = profileMsg->add_goal();
+				goalMsg->set_goal_id(goal.first);
+				goalMsg->set_calls(goal.second.Calls);
+				goalMsg->set_exclusive_us(profiler.TicksToMicroseconds(goal.second.ExclusiveTicks));
+			}
+		}
+
+		Send(msg);
+		DEBUG(" <-- BkProfileData()");
+	}
 }
 
 #endif
@@ -6,6 +6,7 @@
 #include <Osiris/Debugger/osidebug.pb.h>
 #include <GameDefinitions/Osiris.h>
 #include <Osiris/Debugger/DebugInterface.h>
+#include <Osiris/Shared/NodeProfiler.h>
 
 BEGIN_NS(osidbg)
 
@@ -47,7 +48,8 @@ enum class ResultCode
 	EvalEngineNotReady = 14,
 	InvalidParamTupleArity = 15,
 	InvalidParamType = 16,
-	MissingRequiredParam = 17
+	MissingRequiredParam = 17,
+	ProfilerUnavailable = 18
 };
 
 enum class EvalType
@@ -108,6 +110,7 @@ public:
 	void SendEndDatabaseContents(uint32_t databaseId);
 	void SendEvaluateRow(uint32_t seq, VirtTupleLL & row);
 	void SendEvaluateFinished(uint32_t seq, ResultCode rc, bool querySucceeded);
+	void SendProfileData(uint32_t seq, OsirisNodeProfiler const& profiler);
 
 private:
 	OsirisDebugInterface& intf_;
@@ -126,6 +129,7 @@ private:
 	void HandleGetDatabaseContents(uint32_t seq, DbgGetDatabaseContents const & req);
 	void HandleSyncStory(uint32_t seq, DbgSyncStory const & req);
 	void HandleEvaluate(uint32_t seq, DbgEvaluate const & req);
+	void HandleProfilerControl(uint32_t seq, DbgProfilerControl const & req);
 
 	void Send(BackendToDebugger & msg);
 	void SendVersionInfo(uint32_t seq);
@@ -514,6 +514,16 @@ namespace bg3se::osidbg
 		breakpointCv_.notify_one();
 	}
 
+	void Debugger::ControlProfiler(uint32_t seq, DbgProfilerControl_Action action,
+		std::function<void(ResultCode)> completionCallback)
+	{
+		pendingActions_.push([=]() {
+			auto rc = this->ControlProfilerInServerThread(seq, action);
+			completionCallback(rc);
+		});
+		breakpointCv_.notify_one();
+	}
+
 	void MsgToValue(MsgTypedValue const & msg, TypedValue & tv, void * tvVmt)
 	{
 		tv.VMT = tvVmt;
@@ -707,6 +717,38 @@ namespace bg3se::osidbg
 		return ResultCode::Success;
 	}
 
+	ResultCode Debugger::ControlProfilerInServerThread(uint32_t seq, DbgProfilerControl_Action action)
+	{
+		auto& osiris = gExtender->GetServer().Osiris();
+		auto& profiler = osiris.GetNodeProfiler();
+
+		switch (action) {
+		case DbgProfilerControl_Action_START:
+			if (!osiris.StartNodeProfiler()) {
+				return ResultCode::ProfilerUnavailable;
+			}
+			break;
+
+		case DbgProfilerControl_Action_STOP:
+			osiris.StopNodeProfiler();
+			break;
+
+		case DbgProfilerControl_Action_RESET:
+			profiler.Reset();
+			break;
+
+		case DbgProfilerControl_Action_DUMP:
+			messageHandler_.SendProfileData(seq, profiler);
+			break;
+
+		default:
+			WARN("Debugger::ControlProfilerInServerThread(): Unknown action %d", action);
+			return ResultCode::InvalidParameters;
+		}
+
+		return ResultCode::Success;
+	}
+
 	void Debugger::ServerThreadReentry()
 	{
 		// Called when the debugger is entered from any of the server thread hooks
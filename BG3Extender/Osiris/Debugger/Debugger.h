@@ -180,6 +180,8 @@ public:
 	void SyncStory();
 	void Evaluate(uint32_t seq, EvalType type, uint32_t nodeId, MsgTuple const & params, 
 		std::function<void (ResultCode, bool)> completionCallback);
+	void ControlProfiler(uint32_t seq, DbgProfilerControl_Action action,
+		std::function<void (ResultCode)> completionCallback);
 
 	void GameInitHook();
 	void DeleteAllDataHook();
@@ -233,6 +235,7 @@ private:
 
 	ResultCode EvaluateInServerThread(uint32_t seq, EvalType type, uint32_t nodeId, MsgTuple const & params,
 		bool & querySucceeded);
+	ResultCode ControlProfilerInServerThread(uint32_t seq, DbgProfilerControl_Action action);
 
 	void PushFrame(CallStackFrame const & frame);
 	void PopFrame(CallStackFrame const & frame);
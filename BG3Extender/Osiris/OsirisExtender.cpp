@@ -82,9 +82,34 @@ void OsirisExtender::HookNodeVMTs()
 	if (wrappers_.ResolveNodeVMTs()) {
 		nodeVmtWrappers_.reset();
 		nodeVmtWrappers_ = std::make_unique<NodeVMTWrappers>(wrappers_.VMTs);
+		nodeVmtWrappers_->OsirisCallbacksAttachment = osirisCallbacksAttachment_;
+		nodeVmtWrappers_->ProfilerAttachment = &nodeProfiler_;
 	}
 }
 
+bool OsirisExtender::StartNodeProfiler()
+{
+	if (!nodeVmtWrappers_) {
+		if (!storyLoaded_) {
+			OsiErrorS("Cannot start Osiris profiler: Story not loaded");
+			return false;
+		}
+
+		HookNodeVMTs();
+		if (!nodeVmtWrappers_) {
+			return false;
+		}
+	}
+
+	nodeProfiler_.Start();
+	return true;
+}
+
+void OsirisExtender::StopNodeProfiler()
+{
+	nodeProfiler_.Stop();
+}
+
 void OsirisExtender::LogError(std::string_view msg)
 {
 	if (storyLoaded_) {
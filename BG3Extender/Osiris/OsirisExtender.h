@@ -33,6 +33,9 @@ public:
 	void InitRuntimeLogging();
 
 	void BindCallbackManager(esv::lua::OsirisCallbackManager* mgr);
+	// Starts recording node timings; hooks the node VMTs if they weren't hooked yet
+	bool StartNodeProfiler();
+	void StopNodeProfiler();
 
 	void LogError(std::string_view msg);
 	void LogWarning(std::string_view msg);
@@ -88,6 +91,11 @@ public:
 		return storyLoaded_;
 	}
 
+	inline OsirisNodeProfiler& GetNodeProfiler()
+	{
+		return nodeProfiler_;
+	}
+
 private:
 	ExtenderConfig& config_;
 	std::unique_ptr<NodeVMTWrappers> nodeVmtWrappers_;
@@ -97,6 +105,7 @@ private:
 	CustomFunctionInjector injector_;
 	esv::CustomFunctionLibrary functionLibrary_;
 	esv::lua::OsirisCallbackManager* osirisCallbacksAttachment_{ nullptr };
+	OsirisNodeProfiler nodeProfiler_;
 	bool initialized_{ false };
 
 	void OnRegisterDIVFunctions(void *, DivFunctions *);
@@ -174,15 +174,22 @@ namespace bg3se
 	bool NodeVMTWrappers::WrappedIsValid(Node * node, VirtTupleLL * tuple, uint32_t adapter)
 	{
 		auto & wrapper = GetWrapper(node);
+		NodeProfilerScope _p(ProfilerAttachment, node);
 
-		if (DebuggerAttachment) {
-			DebuggerAttachment->IsValidPreHook(node, tuple, adapter);
+		{
+			NodeProfilerHookScope _h(_p);
+			if (DebuggerAttachment) {
+				DebuggerAttachment->IsValidPreHook(node, tuple, adapter);
+			}
 		}
 
 		bool succeeded = wrapper.WrappedIsValid(node, tuple, adapter);
 
-		if (DebuggerAttachment) {
-			DebuggerAttachment->IsValidPostHook(node, tuple, adapter, succeeded);
+		{
+			NodeProfilerHookScope _h(_p);
+			if (DebuggerAttachment) {
+				DebuggerAttachment->IsValidPostHook(node, tuple, adapter, succeeded);
+			}
 		}
 
 		return succeeded;
@@ -191,99 +198,134 @@ namespace bg3se
 	void NodeVMTWrappers::WrappedPushDownTuple(Node * node, VirtTupleLL * tuple, uint32_t adapter, EntryPoint which)
 	{
 		auto & wrapper = GetWrapper(node);
+		NodeProfilerScope _p(ProfilerAttachment, node);
 
-		if (DebuggerAttachment) {
-			DebuggerAttachment->PushDownPreHook(node, tuple, adapter, which, false);
+		{
+			NodeProfilerHookScope _h(_p);
+			if (DebuggerAttachment) {
+				DebuggerAttachment->PushDownPreHook(node, tuple, adapter, which, false);
+			}
 		}
 
 		wrapper.WrappedPushDownTuple(node, tuple, adapter, which);
 
-		if (DebuggerAttachment) {
-			DebuggerAttachment->PushDownPostHook(node, tuple, adapter, which, false);
+		{
+			NodeProfilerHookScope _h(_p);
+			if (DebuggerAttachment) {
+				DebuggerAttachment->PushDownPostHook(node, tuple, adapter, which, false);
+			}
 		}
 	}
 
 	void NodeVMTWrappers::WrappedPushDownTupleDelete(Node * node, VirtTupleLL * tuple, uint32_t adapter, EntryPoint which)
 	{
 		auto & wrapper = GetWrapper(node);
+		NodeProfilerScope _p(ProfilerAttachment, node);
 
-		if (DebuggerAttachment) {
-			DebuggerAttachment->PushDownPreHook(node, tuple, adapter, which, true);
+		{
+			NodeProfilerHookScope _h(_p);
+			if (DebuggerAttachment) {
+				DebuggerAttachment->PushDownPreHook(node, tuple, adapter, which, true);
+			}
 		}
 
 		wrapper.WrappedPushDownTupleDelete(node, tuple, adapter, which);
 
-		if (DebuggerAttachment) {
-			DebuggerAttachment->PushDownPostHook(node, tuple, adapter, which, true);
+		{
+			NodeProfilerHookScope _h(_p);
+			if (DebuggerAttachment) {
+				DebuggerAttachment->PushDownPostHook(node, tuple, adapter, which, true);
+			}
 		}
 	}
 
 	void NodeVMTWrappers::WrappedInsertTuple(Node * node, TuplePtrLL * tuple)
 	{
 		auto & wrapper = GetWrapper(node);
+		NodeProfilerScope _p(ProfilerAttachment, node);
 
-		if (DebuggerAttachment) {
-			DebuggerAttachment->InsertPreHook(node, tuple, false);
-		}
-
-		if (OsirisCallbacksAttachment) {
-			OsirisCallbacksAttachment->InsertPreHook(node, tuple, false);
+		{
+			NodeProfilerHookScope _h(_p);
+			if (DebuggerAttachment) {
+				DebuggerAttachment->InsertPreHook(node, tuple, false);
+			}
+
+			if (OsirisCallbacksAttachment) {
+				OsirisCallbacksAttachment->InsertPreHook(node, tuple, false);
+			}
 		}
 
 		wrapper.WrappedInsertTuple(node, tuple);
 
-		if (DebuggerAttachment) {
-			DebuggerAttachment->InsertPostHook(node, tuple, false);
-		}
-
-		if (OsirisCallbacksAttachment) {
-			OsirisCallbacksAttachment->InsertPostHook(node, tuple, false);
+		{
+			NodeProfilerHookScope _h(_p);
+			if (DebuggerAttachment) {
+				DebuggerAttachment->InsertPostHook(node, tuple, false);
+			}
+
+			if (OsirisCallbacksAttachment) {
+				OsirisCallbacksAttachment->InsertPostHook(node, tuple, false);
+			}
 		}
 	}
 
 	void NodeVMTWrappers::WrappedDeleteTuple(Node * node, TuplePtrLL * tuple)
 	{
 		auto & wrapper = GetWrapper(node);
+		NodeProfilerScope _p(ProfilerAttachment, node);
 
-		if (DebuggerAttachment) {
-			DebuggerAttachment->InsertPreHook(node, tuple, true);
-		}
-
-		if (OsirisCallbacksAttachment) {
-			OsirisCallbacksAttachment->InsertPreHook(node, tuple, true);
+		{
+			NodeProfilerHookScope _h(_p);
+			if (DebuggerAttachment) {
+				DebuggerAttachment->InsertPreHook(node, tuple, true);
+			}
+
+			if (OsirisCallbacksAttachment) {
+				OsirisCallbacksAttachment->InsertPreHook(node, tuple, true);
+			}
 		}
 
 		wrapper.WrappedDeleteTuple(node, tuple);
 
-		if (DebuggerAttachment) {
-			DebuggerAttachment->InsertPostHook(node, tuple, true);
-		}
-
-		if (OsirisCallbacksAttachment) {
-			OsirisCallbacksAttachment->InsertPostHook(node, tuple, true);
+		{
+			NodeProfilerHookScope _h(_p);
+			if (DebuggerAttachment) {
+				DebuggerAttachment->InsertPostHook(node, tuple, true);
+			}
+
+			if (OsirisCallbacksAttachment) {
+				OsirisCallbacksAttachment->InsertPostHook(node, tuple, true);
+			}
 		}
 	}
 
 	bool NodeVMTWrappers::WrappedCallQuery(Node * node, OsiArgumentDesc * args)
 	{
 		auto & wrapper = GetWrapper(node);
+		NodeProfilerScope _p(ProfilerAttachment, node);
 
-		if (DebuggerAttachment) {
-			DebuggerAttachment->CallQueryPreHook(node, args);
-		}
-
-		if (OsirisCallbacksAttachment) {
-			OsirisCallbacksAttachment->CallQueryPreHook(node, args);
+		{
+			NodeProfilerHookScope _h(_p);
+			if (DebuggerAttachment) {
+				DebuggerAttachment->CallQueryPreHook(node, args);
+			}
+
+			if (OsirisCallbacksAttachment) {
+				OsirisCallbacksAttachment->CallQueryPreHook(node, args);
+			}
 		}
 
 		bool succeeded = wrapper.WrappedCallQuery(node, args);
 
-		if (DebuggerAttachment) {
-			DebuggerAttachment->CallQueryPostHook(node, args, succeeded);
-		}
-
-		if (OsirisCallbacksAttachment) {
-			OsirisCallbacksAttachment->CallQueryPostHook(node, args, succeeded);
+		{
+			NodeProfilerHookScope _h(_p);
+			if (DebuggerAttachment) {
+				DebuggerAttachment->CallQueryPostHook(node, args, succeeded);
+			}
+
+			if (OsirisCallbacksAttachment) {
+				OsirisCallbacksAttachment->CallQueryPostHook(node, args, succeeded);
+			}
 		}
 
 		return succeeded;
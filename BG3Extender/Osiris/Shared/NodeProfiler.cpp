@@ -0,0 +1,183 @@
+#include "stdafx.h"
+#include <Osiris/Shared/NodeProfiler.h>
+#include <Osiris/Shared/NodeHooks.h>
+
+namespace bg3se
+{
+	void OsirisNodeProfiler::Start()
+	{
+		if (enabled_) return;
+
+		enabled_ = true;
+		startTicks_ = __rdtsc();
+		startTime_ = std::chrono::steady_clock::now();
+	}
+
+	void OsirisNodeProfiler::Stop()
+	{
+		if (!enabled_) return;
+
+		enabled_ = false;
+		profiledTicks_ += __rdtsc() - startTicks_;
+		profiledTime_ += std::chrono::steady_clock::now() - startTime_;
+	}
+
+	void OsirisNodeProfiler::Reset()
+	{
+		nodes_.clear();
+		activeFrames_.clear();
+		stack_.clear();
+		profiledTicks_ = 0;
+		profiledTime_ = std::chrono::steady_clock::duration{ 0 };
+		startTicks_ = __rdtsc();
+		startTime_ = std::chrono::steady_clock::now();
+	}
+
+	void OsirisNodeProfiler::Enter(uint32_t nodeId, uint64_t timestamp)
+	{
+		if (nodes_.size() <= nodeId) {
+			nodes_.resize(nodeId + 1);
+			activeFrames_.resize(nodeId + 1);
+		}
+
+		activeFrames_[nodeId]++;
+		stack_.push_back(Frame{ nodeId, timestamp, 0, 0 });
+	}
+
+	void OsirisNodeProfiler::Exit(uint64_t timestamp)
+	{
+		// The stack may have been cleared by a Reset() call from a nested call
+		if (stack_.empty() || stack_.back().NodeId == HookFrameId) return;
+
+		PopFrame(timestamp);
+	}
+
+	void OsirisNodeProfiler::EnterHook(uint64_t timestamp)
+	{
+		stack_.push_back(Frame{ HookFrameId, timestamp, 0, 0 });
+	}
+
+	void OsirisNodeProfiler::ExitHook(uint64_t timestamp)
+	{
+		if (stack_.empty() || stack_.back().NodeId != HookFrameId) return;
+
+		PopFrame(timestamp);
+	}
+
+	void OsirisNodeProfiler::PopFrame(uint64_t timestamp)
+	{
+		auto frame = stack_.back();
+		stack_.pop_back();
+
+		auto elapsed = timestamp - std::min(frame.StartTicks, timestamp);
+		if (frame.NodeId == HookFrameId) {
+			// The whole hook call, including the nodes it called, is excluded from the enclosing nodes
+			if (!stack_.empty()) {
+				stack_.back().HookTicks += elapsed;
+			}
+			return;
+		}
+
+		elapsed -= std::min(frame.HookTicks, elapsed);
+		auto& stats = nodes_[frame.NodeId];
+		stats.Calls++;
+		stats.ExclusiveTicks += elapsed - std::min(frame.ChildTicks, elapsed);
+		if (--activeFrames_[frame.NodeId] == 0) {
+			stats.InclusiveTicks += elapsed;
+		}
+
+		if (!stack_.empty()) {
+			stack_.back().ChildTicks += elapsed;
+			stack_.back().HookTicks += frame.HookTicks;
+		}
+	}
+
+	uint64_t OsirisNodeProfiler::GetProfiledTicks() const
+	{
+		if (enabled_) {
+			return profiledTicks_ + (__rdtsc() - startTicks_);
+		} else {
+			return profiledTicks_;
+		}
+	}
+
+	double OsirisNodeProfiler::TicksToMicroseconds(uint64_t ticks) const
+	{
+		auto totalTicks = GetProfiledTicks();
+		auto totalTime = profiledTime_;
+		if (enabled_) {
+			totalTime += std::chrono::steady_clock::now() - startTime_;
+		}
+
+		auto totalUs = std::chrono::duration<double, std::micro>(totalTime).count();
+		if (totalTicks == 0 || totalUs <= 0.0) {
+			return 0.0;
+		}
+
+		return ticks * (totalUs / totalTicks);
+	}
+
+	void OsirisNodeProfiler::BuildRollup(NodeDb const& nodeDb, NodeVMTWrappers& wrappers, Rollup& rollup) const
+	{
+		auto getNode = [&](uint32_t id) -> Node* {
+			return (id > 0 && id <= nodeDb.Size) ? nodeDb.Elements[id - 1] : nullptr;
+		};
+
+		auto isTreeNode = [](NodeType type) {
+			return type == NodeType::And || type == NodeType::NotAnd || type == NodeType::RelOp || type == NodeType::Rule;
+		};
+
+		// Returns the node ID and goal ID of the rule that the node feeds into
+		auto findOwner = [&](Node* node) -> std::pair<uint32_t, uint32_t> {
+			uint32_t goalId{ 0 };
+			// Tree nodes only point downstream, so the chain ends at the rule; the limit guards against malformed stories
+			for (uint32_t depth = 0; node != nullptr && depth < 1024; depth++) {
+				auto type = wrappers.GetType(node);
+				if (type == NodeType::Rule) {
+					if (goalId == 0) {
+						// The goal is stored on the link from the parent node to the rule
+						auto parent = getNode(static_cast<RuleNode*>(node)->Parent.Id);
+						if (parent != nullptr && isTreeNode(wrappers.GetType(parent))) {
+							goalId = static_cast<TreeNode*>(parent)->Next.GoalId;
+						}
+					}
+
+					return { node->Id, goalId };
+				}
+
+				if (!isTreeNode(type)) break;
+
+				auto const& next = static_cast<TreeNode*>(node)->Next;
+				goalId = next.GoalId;
+				node = getNode(next.Node.Id);
+			}
+
+			return { 0, 0 };
+		};
+
+		for (uint32_t id = 1; id < nodes_.size() && id <= nodeDb.Size; id++) {
+			auto const& stats = nodes_[id];
+			if (stats.Calls == 0) continue;
+
+			auto node = nodeDb.Elements[id - 1];
+			auto type = wrappers.GetType(node);
+			if (!isTreeNode(type)) continue;
+
+			auto owner = findOwner(node);
+			if (owner.first == 0) continue;
+
+			auto& rule = rollup.Rules[owner.first];
+			rule.GoalId = owner.second;
+			rule.ExclusiveTicks += stats.ExclusiveTicks;
+			if (type == NodeType::Rule) {
+				rule.Calls += stats.Calls;
+			}
+		}
+
+		for (auto const& rule : rollup.Rules) {
+			auto& goal = rollup.Goals[rule.second.GoalId];
+			goal.Calls += rule.second.Calls;
+			goal.ExclusiveTicks += rule.second.ExclusiveTicks;
+		}
+	}
+}
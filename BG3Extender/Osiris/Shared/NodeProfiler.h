@@ -0,0 +1,158 @@
+#pragma once
+
+#include <GameDefinitions/Osiris.h>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <intrin.h>
+
+namespace bg3se
+{
+	class NodeVMTWrappers;
+
+	// Records the number of invocations and the time spent in each story node while enabled.
+	// Timestamps are read from the TSC on entry/exit of the wrapped node VMT functions.
+	// Inclusive time contains nested node calls (pushdowns to child nodes, inserts and queries
+	// made by rule actions, etc.); exclusive time only contains the time spent in the node itself.
+	// Time spent in debugger and Lua listener hooks is excluded from both, including the time of
+	// nodes called by the hooks (those nodes are still profiled on their own).
+	class OsirisNodeProfiler : Noncopyable<OsirisNodeProfiler>
+	{
+	public:
+		struct NodeStats
+		{
+			uint64_t Calls{ 0 };
+			uint64_t InclusiveTicks{ 0 };
+			uint64_t ExclusiveTicks{ 0 };
+		};
+
+		struct RuleStats
+		{
+			uint32_t GoalId{ 0 };
+			// Number of tuples that reached the rule node
+			uint64_t Calls{ 0 };
+			// Exclusive time of the rule node and of the join/comparison nodes feeding into it
+			uint64_t ExclusiveTicks{ 0 };
+		};
+
+		struct GoalStats
+		{
+			uint64_t Calls{ 0 };
+			uint64_t ExclusiveTicks{ 0 };
+		};
+
+		struct Rollup
+		{
+			// Indexed by the node ID of the rule
+			std::unordered_map<uint32_t, RuleStats> Rules;
+			std::unordered_map<uint32_t, GoalStats> Goals;
+		};
+
+		void Start();
+		void Stop();
+		void Reset();
+
+		inline bool IsEnabled() const
+		{
+			return enabled_;
+		}
+
+		void Enter(uint32_t nodeId, uint64_t timestamp);
+		void Exit(uint64_t timestamp);
+		// Marks the start and end of a hook call made while executing the current node
+		void EnterHook(uint64_t timestamp);
+		void ExitHook(uint64_t timestamp);
+
+		inline std::vector<NodeStats> const& GetNodeStats() const
+		{
+			return nodes_;
+		}
+
+		// Total time spent with the profiler enabled, in TSC ticks
+		uint64_t GetProfiledTicks() const;
+		double TicksToMicroseconds(uint64_t ticks) const;
+
+		// Aggregates node statistics per rule and goal by following tree nodes to the rule they feed into.
+		// Data nodes (databases, procs, queries) may be shared by several rules, so they're not attributed.
+		void BuildRollup(NodeDb const& nodeDb, NodeVMTWrappers& wrappers, Rollup& rollup) const;
+
+	private:
+		static constexpr uint32_t HookFrameId = 0xffffffff;
+
+		struct Frame
+		{
+			// Node ID, or HookFrameId for hook calls
+			uint32_t NodeId;
+			uint64_t StartTicks;
+			// Time spent in nested nodes (excluding hooks)
+			uint64_t ChildTicks;
+			// Time spent in hooks of this node and of nested nodes
+			uint64_t HookTicks;
+		};
+
+		void PopFrame(uint64_t timestamp);
+
+		bool enabled_{ false };
+		std::vector<NodeStats> nodes_;
+		// Number of active frames of each node; inclusive time is only added by the outermost frame
+		// so that recursive rules don't count the same time multiple times
+		std::vector<uint32_t> activeFrames_;
+		std::vector<Frame> stack_;
+		uint64_t profiledTicks_{ 0 };
+		uint64_t startTicks_{ 0 };
+		// Wall clock time matching profiledTicks_, used for calibrating the TSC frequency
+		std::chrono::steady_clock::duration profiledTime_{ 0 };
+		std::chrono::steady_clock::time_point startTime_;
+	};
+
+	// Measures the duration of a node VMT call if the profiler is enabled
+	class NodeProfilerScope
+	{
+	public:
+		inline NodeProfilerScope(OsirisNodeProfiler* profiler, Node* node)
+			: profiler_((profiler != nullptr && profiler->IsEnabled()) ? profiler : nullptr)
+		{
+			if (profiler_) {
+				profiler_->Enter(node->Id, __rdtsc());
+			}
+		}
+
+		inline ~NodeProfilerScope()
+		{
+			if (profiler_) {
+				profiler_->Exit(__rdtsc());
+			}
+		}
+
+		inline OsirisNodeProfiler* GetProfiler() const
+		{
+			return profiler_;
+		}
+
+	private:
+		OsirisNodeProfiler* profiler_;
+	};
+
+	// Excludes the duration of node pre/post hooks from the enclosing node scope
+	class NodeProfilerHookScope
+	{
+	public:
+		inline NodeProfilerHookScope(NodeProfilerScope const& scope)
+			: profiler_(scope.GetProfiler())
+		{
+			if (profiler_) {
+				profiler_->EnterHook(__rdtsc());
+			}
+		}
+
+		inline ~NodeProfilerHookScope()
+		{
+			if (profiler_) {
+				profiler_->ExitHook(__rdtsc());
+			}
+		}
+
+	private:
+		OsirisNodeProfiler* profiler_;
+	};
+}
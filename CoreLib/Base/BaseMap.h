@@ -538,6 +538,34 @@ public:
 		}
 	}
 
+	// Returns the node at the specified position (hash bucket and position in the bucket chain), or the first
+	// node after it; the position is updated to the position of the returned node.
+	// Used for resumable iteration, as positions remain safe to use if the map is modified.
+	// If visitedNodes is specified, the number of hash table slots and chain links read is added to it.
+	Node* seek(uint32_t& bucket, uint32_t& depth, uint64_t* visitedNodes = nullptr) const
+	{
+		while (bucket < this->HashSize) {
+			auto node = this->HashTable[bucket];
+			uint32_t i = 0;
+			for (; node != nullptr && i < depth; i++) {
+				node = node->Next;
+			}
+
+			if (visitedNodes != nullptr) {
+				*visitedNodes += i + 1;
+			}
+
+			if (node != nullptr) {
+				return node;
+			}
+
+			bucket++;
+			depth = 0;
+		}
+
+		return nullptr;
+	}
+
 	Iterator begin()
 	{
 		return Iterator(*this);
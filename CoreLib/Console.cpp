@@ -4,9 +4,130 @@
 
 BEGIN_SE()
 
+namespace
+{
+	// Rate limiting state of a log source (a thread logging messages of a specific type)
+	struct RateLimitState
+	{
+		uint64_t WindowStart{ 0 };
+		uint32_t Count{ 0 };
+	};
+
+	thread_local RateLimitState RateLimits[(unsigned)DebugMessageType::Error + 1];
+
+	// Debuggers may truncate longer OutputDebugString() messages
+	constexpr std::size_t MaxDebugOutputBatch = 3072;
+}
+
+LogMessageQueue::LogMessageQueue()
+	: slots_(std::make_unique<Slot[]>(Capacity))
+{
+	static_assert((Capacity & (Capacity - 1)) == 0, "Queue capacity must be a power of 2");
+	for (std::size_t i = 0; i < Capacity; i++) {
+		slots_[i].Sequence.store(i, std::memory_order_relaxed);
+	}
+}
+
+bool LogMessageQueue::TryPush(DebugMessageType type, char const* msg)
+{
+	auto pos = enqueuePos_.load(std::memory_order_relaxed);
+	for (;;) {
+		auto& slot = slots_[pos & (Capacity - 1)];
+		auto seq = slot.Sequence.load(std::memory_order_acquire);
+		auto diff = (intptr_t)seq - (intptr_t)pos;
+		if (diff == 0) {
+			if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+				slot.Type = type;
+				slot.Message.assign(msg);
+				slot.Sequence.store(pos + 1, std::memory_order_release);
+				return true;
+			}
+		} else if (diff < 0) {
+			// Queue is full
+			return false;
+		} else {
+			pos = enqueuePos_.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+bool LogMessageQueue::TryPop(DebugMessageType& type, std::string& msg)
+{
+	auto pos = dequeuePos_.load(std::memory_order_relaxed);
+	for (;;) {
+		auto& slot = slots_[pos & (Capacity - 1)];
+		auto seq = slot.Sequence.load(std::memory_order_acquire);
+		auto diff = (intptr_t)seq - (intptr_t)(pos + 1);
+		if (diff == 0) {
+			if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+				type = slot.Type;
+				// Copy instead of moving so the slot keeps its buffer for the next message
+				msg.assign(slot.Message);
+				slot.Sequence.store(pos + Capacity, std::memory_order_release);
+				return true;
+			}
+		} else if (diff < 0) {
+			// Queue is empty
+			return false;
+		} else {
+			pos = dequeuePos_.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+
+// Holds writeMutex_ and records the owning thread, so that a crash handler running on a thread
+// that crashed while writing output doesn't try to acquire the lock again
+class Console::OutputLock
+{
+public:
+	inline OutputLock(Console& console, bool lock = true)
+		: console_(console)
+	{
+		if (lock) {
+			Lock();
+		}
+	}
+
+	inline ~OutputLock()
+	{
+		if (locked_) {
+			console_.writeOwner_.store(std::thread::id());
+			console_.writeMutex_.unlock();
+		}
+	}
+
+	inline void Lock()
+	{
+		console_.writeMutex_.lock();
+		OnLocked();
+	}
+
+	inline bool TryLockFor(uint32_t timeoutMs)
+	{
+		if (!console_.writeMutex_.try_lock_for(std::chrono::milliseconds(timeoutMs))) {
+			return false;
+		}
+
+		OnLocked();
+		return true;
+	}
+
+private:
+	Console& console_;
+	bool locked_{ false };
+
+	inline void OnLocked()
+	{
+		console_.writeOwner_.store(std::this_thread::get_id());
+		locked_ = true;
+	}
+};
+
 
 Console::~Console()
 {
+	StopAsyncOutput();
 	Destroy();
 }
 
@@ -42,28 +163,227 @@ void Console::SetColor(DebugMessageType type)
 
 void Console::Print(DebugMessageType type, char const* msg)
 {
-	if (enabled_ && (!inputEnabled_ || !silence_)) {
-		SetColor(type);
-		OutputDebugStringA(msg);
-		OutputDebugStringA("\r\n");
-		std::cout << msg << std::endl;
-		std::cout.flush();
-		SetColor(DebugMessageType::Debug);
-	}
-
 	if (logCallback_) {
 		logCallback_(msg);
 	}
 
+	if (!CheckRateLimit(type)) {
+		return;
+	}
+
+	if (writerRunning_) {
+		Enqueue(type, msg);
+	} else {
+		OutputLock _(*this);
+		WriteSuppressedSummaries();
+		WriteOutput(type, msg);
+		FlushOutput();
+		totalWritten_++;
+	}
+}
+
+bool Console::CheckRateLimit(DebugMessageType type)
+{
+	if (rateLimit_ == 0) {
+		return true;
+	}
+
+	auto& state = RateLimits[(unsigned)type];
+	auto now = GetTickCount64();
+	if (now - state.WindowStart >= 1000) {
+		state = RateLimitState{ now, 0 };
+	}
+
+	if (state.Count >= rateLimit_) {
+		// Summarized by the writer, or by the next synchronous print or flush
+		suppressedMessages_[(unsigned)type].fetch_add(1, std::memory_order_relaxed);
+		totalSuppressed_.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	state.Count++;
+	return true;
+}
+
+void Console::Enqueue(DebugMessageType type, char const* msg)
+{
+	if (!queue_.TryPush(type, msg)) {
+		// Messages are only dropped if the user opted into losing output by setting a rate limit;
+		// otherwise (and for errors) the backlog and the message are written synchronously.
+		// A thread that is already writing output (eg. a crash handler) can't take the lock again.
+		if ((rateLimit_ == 0 || type == DebugMessageType::Error)
+			&& writeOwner_.load() != std::this_thread::get_id()) {
+			OutputLock _(*this);
+			DrainQueueLocked();
+			WriteOutput(type, msg);
+			FlushOutput();
+			totalWritten_++;
+			queueFullWrites_++;
+		} else {
+			droppedMessages_++;
+			totalDropped_++;
+		}
+		return;
+	}
+
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (writerIdle_.load(std::memory_order_relaxed)) {
+		wakeup_.notify_one();
+	}
+}
+
+void Console::EnableAsyncOutput()
+{
+	if (writerThread_) return;
+
+	writerRunning_ = true;
+	writerThread_ = std::make_unique<std::thread>(&Console::WriterThread, this);
+}
+
+void Console::StopAsyncOutput()
+{
+	if (!writerThread_) return;
+
+	writerRunning_ = false;
+	wakeup_.notify_one();
+	writerThread_->join();
+	writerThread_.reset();
+	DrainQueue();
+}
+
+void Console::WriterThread()
+{
+	while (writerRunning_) {
+		DrainQueue();
+
+		// Producers only signal the writer when it is idle; the timeout bounds the latency
+		// of a wakeup that was missed, and lets messages accumulate into larger batches.
+		std::unique_lock<std::mutex> lock(wakeupMutex_);
+		writerIdle_.store(true);
+		wakeup_.wait_for(lock, std::chrono::milliseconds(10));
+		writerIdle_.store(false);
+	}
+}
+
+bool Console::Flush(uint32_t timeoutMs)
+{
+	// Flushing from a crash handler on a thread that crashed while writing; the lock is not
+	// recursive and the output state may be inconsistent
+	if (writeOwner_.load() == std::this_thread::get_id()) {
+		return false;
+	}
+
+	OutputLock lock(*this, false);
+	if (timeoutMs > 0) {
+		// The writer may be stuck (eg. when flushing from a crash handler)
+		if (!lock.TryLockFor(timeoutMs)) {
+			return false;
+		}
+	} else {
+		lock.Lock();
+	}
+
+	DrainQueueLocked();
+	return true;
+}
+
+void Console::DrainQueue()
+{
+	OutputLock _(*this);
+	DrainQueueLocked();
+}
+
+void Console::DrainQueueLocked()
+{
+	DebugMessageType type;
+	bool written{ false };
+	while (queue_.TryPop(type, pendingMessage_)) {
+		WriteOutput(type, pendingMessage_.c_str());
+		totalWritten_++;
+		written = true;
+	}
+
+	if (WriteSuppressedSummaries()) {
+		written = true;
+	}
+
+	auto dropped = droppedMessages_.exchange(0);
+	if (dropped > 0) {
+		char summary[128];
+		sprintf_s(summary, "%u messages dropped (log queue full)", dropped);
+		WriteOutput(DebugMessageType::Warning, summary);
+		written = true;
+	}
+
+	if (written) {
+		FlushOutput();
+	}
+}
+
+bool Console::WriteSuppressedSummaries()
+{
+	bool written{ false };
+	for (unsigned i = 0; i < std::size(suppressedMessages_); i++) {
+		if (suppressedMessages_[i].load(std::memory_order_relaxed) == 0) continue;
+
+		auto suppressed = suppressedMessages_[i].exchange(0, std::memory_order_relaxed);
+		if (suppressed > 0) {
+			char summary[128];
+			sprintf_s(summary, "%u messages suppressed (more than %u messages per second)", suppressed, rateLimit_);
+			WriteOutput((DebugMessageType)i, summary);
+			written = true;
+		}
+	}
+
+	return written;
+}
+
+void Console::WriteOutput(DebugMessageType type, char const* msg)
+{
+	if (enabled_ && (!inputEnabled_ || !silence_)) {
+		if (type != outputColor_) {
+			std::cout.flush();
+			SetColor(type);
+			outputColor_ = type;
+		}
+
+		std::cout << msg << '\n';
+
+		debugOutput_ += msg;
+		debugOutput_ += "\r\n";
+		if (debugOutput_.size() > MaxDebugOutputBatch) {
+			OutputDebugStringA(debugOutput_.c_str());
+			debugOutput_.clear();
+		}
+	}
+
 	if (logToFile_) {
 		logFile_.write(msg, strlen(msg));
 		logFile_.write("\r\n", 2);
+	}
+}
+
+void Console::FlushOutput()
+{
+	if (!debugOutput_.empty()) {
+		OutputDebugStringA(debugOutput_.c_str());
+		debugOutput_.clear();
+	}
+
+	std::cout.flush();
+	if (outputColor_ != DebugMessageType::Debug) {
+		SetColor(DebugMessageType::Debug);
+		outputColor_ = DebugMessageType::Debug;
+	}
+
+	if (logToFile_) {
 		logFile_.flush();
 	}
 }
 
 void Console::Clear()
 {
+	Flush();
 	// Clear screen, move cursor to top-left and clear scrollback
 	std::cout << "\x1b[2J" "\x1b[H" "\x1b[3J";
 }
@@ -78,6 +398,21 @@ void Console::SetLogCallback(LogCallbackProc* callback)
 	logCallback_ = callback;
 }
 
+void Console::SetRateLimit(uint32_t messagesPerSecond)
+{
+	rateLimit_ = messagesPerSecond;
+}
+
+Console::Stats Console::GetStats() const
+{
+	return Stats{
+		totalWritten_.load(),
+		totalDropped_.load(),
+		totalSuppressed_.load(),
+		queueFullWrites_.load()
+	};
+}
+
 void Console::Create()
 {
 	if (created_) return;
@@ -127,21 +462,30 @@ void Console::Destroy()
 
 void Console::OpenLogFile(std::wstring const& path)
 {
-	if (logToFile_) {
-		CloseLogFile();
+	bool opened;
+	{
+		OutputLock _(*this);
+		if (logToFile_) {
+			logFile_.close();
+			logToFile_ = false;
+		}
+
+		// Log file writes are flushed once per batch by the writer
+		logFile_.open(path.c_str(), std::ios::binary | std::ios::out | std::ios::app);
+		opened = logFile_.good();
+		logToFile_ = opened;
 	}
 
-	logFile_.rdbuf()->pubsetbuf(0, 0);
-	logFile_.open(path.c_str(), std::ios::binary | std::ios::out | std::ios::app);
-	if (!logFile_.good()) {
+	if (!opened) {
 		ERR("Failed to open log file '%s'", ToStdUTF8(path).c_str());
-	} else {
-		logToFile_ = true;
 	}
 }
 
 void Console::CloseLogFile()
 {
+	Flush();
+
+	OutputLock _(*this);
 	if (!logToFile_) return;
 
 	logFile_.close();
@@ -3,14 +3,59 @@
 #include <CoreLib/Base/Base.h>
 #include <functional>
 #include <fstream>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 BEGIN_SE()
 
+// Bounded multi-producer queue of log messages (Vyukov-style ring buffer).
+// Producers never block each other; the queue is drained by a single consumer at a time.
+class LogMessageQueue
+{
+public:
+	static constexpr std::size_t Capacity = 4096;
+
+	LogMessageQueue();
+
+	bool TryPush(DebugMessageType type, char const* msg);
+	bool TryPop(DebugMessageType& type, std::string& msg);
+
+private:
+	struct Slot
+	{
+		std::atomic<std::size_t> Sequence;
+		DebugMessageType Type;
+		std::string Message;
+	};
+
+	std::unique_ptr<Slot[]> slots_;
+	alignas(64) std::atomic<std::size_t> enqueuePos_{ 0 };
+	alignas(64) std::atomic<std::size_t> dequeuePos_{ 0 };
+};
+
 class Console
 {
 public:
 	using LogCallbackProc = void (char const* message);
 
+	struct Stats
+	{
+		// Messages written to the output (excluding suppressed/dropped message summaries)
+		uint64_t Written{ 0 };
+		// Messages dropped because the async queue was full
+		uint64_t Dropped{ 0 };
+		// Messages suppressed by the rate limit
+		uint64_t Suppressed{ 0 };
+		// Messages written synchronously because the async queue was full
+		uint64_t QueueFullWrites{ 0 };
+	};
+
+	// Max. number of messages of the same type a thread can log per second; 0 = unlimited
+	static constexpr uint32_t DefaultRateLimit = 0;
+	static constexpr uint32_t CrashFlushTimeoutMs = 1000;
+
 	virtual ~Console();
 	virtual void Create();
 	void Destroy();
@@ -23,6 +68,19 @@ public:
 	void Clear();
 	void EnableOutput(bool enabled);
 	void SetLogCallback(LogCallbackProc* callback);
+	void SetRateLimit(uint32_t messagesPerSecond);
+	Stats GetStats() const;
+
+	inline uint32_t GetRateLimit() const
+	{
+		return rateLimit_;
+	}
+
+	// Moves console and log file output to a background writer thread
+	void EnableAsyncOutput();
+	// Writes all pending messages; returns false if the writer couldn't be locked in time,
+	// or if the calling thread is in the middle of writing output (eg. it crashed while writing)
+	bool Flush(uint32_t timeoutMs = 0);
 
 	inline bool WasCreated() const
 	{
@@ -37,6 +95,42 @@ protected:
 	bool logToFile_{ false };
 	LogCallbackProc* logCallback_{ nullptr };
 	std::ofstream logFile_;
+
+private:
+	class OutputLock;
+
+	uint32_t rateLimit_{ DefaultRateLimit };
+	// Number of rate limited messages per message type that weren't reported yet
+	std::atomic<uint32_t> suppressedMessages_[(unsigned)DebugMessageType::Error + 1]{};
+
+	LogMessageQueue queue_;
+	std::atomic<uint32_t> droppedMessages_{ 0 };
+	std::atomic<uint64_t> totalWritten_{ 0 };
+	std::atomic<uint64_t> totalDropped_{ 0 };
+	std::atomic<uint64_t> totalSuppressed_{ 0 };
+	std::atomic<uint64_t> queueFullWrites_{ 0 };
+	// Held by whoever is writing output (the writer thread or a synchronous print/flush)
+	std::timed_mutex writeMutex_;
+	std::atomic<std::thread::id> writeOwner_;
+	std::unique_ptr<std::thread> writerThread_;
+	std::atomic<bool> writerRunning_{ false };
+	std::atomic<bool> writerIdle_{ false };
+	std::mutex wakeupMutex_;
+	std::condition_variable wakeup_;
+	// Output state; only accessed while holding writeMutex_
+	std::string pendingMessage_;
+	std::string debugOutput_;
+	DebugMessageType outputColor_{ DebugMessageType::Debug };
+
+	bool CheckRateLimit(DebugMessageType type);
+	void Enqueue(DebugMessageType type, char const* msg);
+	void WriterThread();
+	void StopAsyncOutput();
+	void DrainQueue();
+	void DrainQueueLocked();
+	bool WriteSuppressedSummaries();
+	void WriteOutput(DebugMessageType type, char const* msg);
+	void FlushOutput();
 };
 
 END_SE()
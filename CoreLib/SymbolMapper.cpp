@@ -212,6 +212,91 @@ std::optional<uint32_t> Pattern::GetAnchor(char const* anchor) const
 	}
 }
 
+std::size_t MultiPatternScanner::Add(Pattern const* pattern)
+{
+	patterns_.push_back(PatternInfo{ pattern });
+	return patterns_.size() - 1;
+}
+
+void MultiPatternScanner::Build()
+{
+	for (auto& prefixes : singleBytePrefixes_) {
+		prefixes.clear();
+	}
+
+	firstBytes_.fill(false);
+	twoBytePrefixStart_.clear();
+	twoBytePrefixes_.clear();
+	twoBytePrefixBitmap_.clear();
+	twoBytePrefixBitmap_.resize(0x10000 / 64, 0);
+
+	std::vector<uint32_t> prefixCounts(0x10000 + 1, 0);
+	for (uint32_t i = 0; i < patterns_.size(); i++) {
+		auto const& pat = patterns_[i].Pat->pattern_;
+		firstBytes_[pat[0].pattern] = true;
+		if (pat.size() >= 2 && pat[1].mask == 0xff) {
+			uint16_t prefix = pat[0].pattern | (pat[1].pattern << 8);
+			prefixCounts[prefix]++;
+			twoBytePrefixBitmap_[prefix >> 6] |= (1ull << (prefix & 63));
+		} else {
+			singleBytePrefixes_[pat[0].pattern].push_back(i);
+		}
+	}
+
+	twoBytePrefixStart_.resize(0x10000 + 1);
+	uint32_t offset = 0;
+	for (uint32_t prefix = 0; prefix <= 0x10000; prefix++) {
+		twoBytePrefixStart_[prefix] = offset;
+		offset += prefixCounts[prefix];
+	}
+
+	twoBytePrefixes_.resize(offset);
+	for (uint32_t i = 0; i < patterns_.size(); i++) {
+		auto const& pat = patterns_[i].Pat->pattern_;
+		if (pat.size() >= 2 && pat[1].mask == 0xff) {
+			uint16_t prefix = pat[0].pattern | (pat[1].pattern << 8);
+			auto slot = twoBytePrefixStart_[prefix + 1] - prefixCounts[prefix]--;
+			twoBytePrefixes_[slot] = i;
+		}
+	}
+}
+
+void MultiPatternScanner::TryMatch(uint32_t index, uint8_t const* p, uint8_t const* end)
+{
+	auto& info = patterns_[index];
+	// Keep the same scan bounds as Pattern::Scan()
+	if ((std::size_t)(end - p) > info.Pat->pattern_.size() && info.Pat->MatchPattern(p)) {
+		info.Matches.push_back(p);
+	}
+}
+
+void MultiPatternScanner::Scan(uint8_t const * start, size_t length)
+{
+	Build();
+
+	for (auto& info : patterns_) {
+		info.Matches.clear();
+	}
+
+	auto end = start + length;
+	for (auto p = start; p < end; p++) {
+		if (!firstBytes_[*p]) continue;
+
+		for (auto index : singleBytePrefixes_[*p]) {
+			TryMatch(index, p, end);
+		}
+
+		if (p + 1 < end) {
+			uint16_t prefix = *reinterpret_cast<uint16_t const *>(p);
+			if (twoBytePrefixBitmap_[prefix >> 6] & (1ull << (prefix & 63))) {
+				for (auto i = twoBytePrefixStart_[prefix]; i < twoBytePrefixStart_[prefix + 1]; i++) {
+					TryMatch(twoBytePrefixes_[i], p, end);
+				}
+			}
+		}
+	}
+}
+
 std::optional<int> GetIntAttribute(tinyxml2::XMLElement* ele, char const* name)
 {
 	char const* value{ nullptr };
@@ -291,6 +376,7 @@ bool SymbolMappingLoader::LoadBuiltinMappings(int resourceId)
 		return false;
 	}
 
+	MurmurHash3_x64_128(xml->data(), (int)xml->size(), 0, mappings_.SourceHash.data());
 	return LoadMappings(&doc);
 }
 
@@ -833,25 +919,24 @@ bool SymbolMapper::MapSymbol(std::string const& mappingName, uint8_t const* cust
 	return MapSymbol(mapping->second, customStart, customSize);
 }
 
-bool SymbolMapper::MapSymbol(SymbolMappings::Mapping & mapping, uint8_t const * customStart, std::size_t customSize)
+bool SymbolMapper::IsVersionSupported(SymbolMappings::Mapping const& mapping) const
 {
-	if (mapping.Version.Type != SymbolMappings::SymbolVersion::None) {
-		bool passed;
-		if (mapping.Version.Type == SymbolMappings::SymbolVersion::Below) {
-			passed = gameRevision_ < mapping.Version.Revision;
-		} else {
-			passed = gameRevision_ >= mapping.Version.Revision;
-		}
+	switch (mapping.Version.Type) {
+	case SymbolMappings::SymbolVersion::Below:
+		return gameRevision_ < mapping.Version.Revision;
 
-		if (!passed) {
-			// Ignore mappings that aren't supported by the current game version
-			return true;
-		}
-	}
+	case SymbolMappings::SymbolVersion::AboveOrEqual:
+		return gameRevision_ >= mapping.Version.Revision;
 
-	uint8_t const * memStart;
-	std::size_t memSize;
+	case SymbolMappings::SymbolVersion::None:
+	default:
+		return true;
+	}
+}
 
+bool SymbolMapper::GetMappingScope(SymbolMappings::Mapping const& mapping, uint8_t const* customStart, std::size_t customSize,
+	uint8_t const*& memStart, std::size_t& memSize) const
+{
 	if (mapping.Scope == SymbolMappings::MatchScope::kBinary || mapping.Scope == SymbolMappings::MatchScope::kText) {
 		auto modIt = modules_.find(mapping.Module);
 		if (modIt == modules_.end()) {
@@ -879,59 +964,362 @@ bool SymbolMapper::MapSymbol(SymbolMappings::Mapping & mapping, uint8_t const *
 		return false;
 	}
 
-#if defined(DEBUG_MAPPINGS)
-	DEBUG("Try mapping: %s [%p -> %p]", mapping.Name.c_str(), memStart, memStart + memSize);
-#endif
+	return true;
+}
 
-	bool mapped = false,
-		hasMatches = false,
-		hasCallbacks = false;
-	mapping.Pattern.Scan(memStart, memSize, [this, &mapping, &mapped, &hasMatches, &hasCallbacks](const uint8_t * match) -> Pattern::ScanAction {
-		bool matching{ true };
-		for (auto const& condition : mapping.Conditions) {
-			if (!EvaluateSymbolCondition(condition, match)) {
-				matching = false;
-				break;
+void SymbolMapper::PrescanMappings(std::vector<SymbolMappings::Mapping*> const& mappings)
+{
+	struct ScanRegion
+	{
+		MultiPatternScanner Scanner;
+		std::vector<std::pair<SymbolMappings::Mapping*, std::size_t>> Mappings;
+	};
+
+	// Group mappings by the memory region they scan, so each region is only walked once
+	std::map<std::pair<uint8_t const*, std::size_t>, ScanRegion> regions;
+	for (auto mapping : mappings) {
+		uint8_t const* memStart;
+		std::size_t memSize;
+		if (mapping->Scope != SymbolMappings::MatchScope::kCustom 
+			&& IsVersionSupported(*mapping)
+			&& GetMappingScope(*mapping, nullptr, 0, memStart, memSize)) {
+			if (ApplyCachedMatches(*mapping, memStart, memSize)) {
+				matchCacheStats_.CachedMappings++;
+			} else {
+				matchCacheStats_.ScannedMappings++;
+				auto& region = regions[std::make_pair(memStart, memSize)];
+				region.Mappings.push_back(std::make_pair(mapping, region.Scanner.Add(&mapping->Pattern)));
 			}
 		}
+	}
+
+	for (auto& region : regions) {
+		if (region.second.Mappings.empty()) continue;
+
+		region.second.Scanner.Scan(region.first.first, region.first.second);
+
+		for (auto const& mapping : region.second.Mappings) {
+			auto& matches = region.second.Scanner.GetMatches(mapping.second);
+
+			if (verifyScan_) {
+				std::vector<uint8_t const*> expectedMatches;
+				mapping.first->Pattern.Scan(region.first.first, region.first.second, [&expectedMatches](uint8_t const* match) {
+					expectedMatches.push_back(match);
+					return Pattern::ScanAction::Continue;
+				});
+
+				if (expectedMatches != matches) {
+					ERR("Prescan mismatch for mapping '%s': %zu matches, expected %zu", mapping.first->Name.c_str(),
+						matches.size(), expectedMatches.size());
+				}
+			}
+
+			UpdateCachedMatches(*mapping.first, region.first.first, matches);
+			prescannedMatches_.insert(std::make_pair(mapping.first, std::move(matches)));
+		}
+	}
+}
+
+namespace
+{
+	// Same value as the MSVC multi-character literal 'SMC1' used by older builds
+	constexpr uint32_t MatchCacheMagic = ((uint32_t)'S' << 24) | ((uint32_t)'M' << 16) | ((uint32_t)'C' << 8) | (uint32_t)'1';
+	constexpr uint32_t MatchCacheVersion = 2;
+
+	class MatchCacheReader
+	{
+	public:
+		inline MatchCacheReader(std::vector<uint8_t> const& buf)
+			: buf_(buf)
+		{}
+
+		template <class T>
+		bool Read(T& value)
+		{
+			if (pos_ + sizeof(T) > buf_.size()) return false;
+			memcpy(&value, buf_.data() + pos_, sizeof(T));
+			pos_ += sizeof(T);
+			return true;
+		}
+
+		bool Read(void* data, std::size_t size)
+		{
+			if (pos_ + size > buf_.size()) return false;
+			memcpy(data, buf_.data() + pos_, size);
+			pos_ += size;
+			return true;
+		}
+
+	private:
+		std::vector<uint8_t> const& buf_;
+		std::size_t pos_{ 0 };
+	};
+
+	template <class T>
+	void WriteCacheValue(std::vector<uint8_t>& buf, T const& value)
+	{
+		auto pos = buf.size();
+		buf.resize(pos + sizeof(T));
+		memcpy(buf.data() + pos, &value, sizeof(T));
+	}
+}
+
+void SymbolMapper::EnableMatchCache(std::wstring const& path)
+{
+	matchCachePath_ = path;
+}
+
+void SymbolMapper::EnableScanVerification()
+{
+	verifyScan_ = true;
+}
+
+void SymbolMapper::LoadMatchCache()
+{
+	if (matchCacheLoaded_) return;
+	matchCacheLoaded_ = true;
+
+	if (matchCachePath_.empty()) return;
+
+	std::array<uint8_t, 16> zeroHash{};
+	if (mappings_.SourceHash == zeroHash) {
+		// Mappings weren't loaded from a known source; don't cache
+		matchCachePath_.clear();
+		return;
+	}
+
+	CalculateMatchCacheIdentityKey();
+
+	std::vector<uint8_t> buf;
+	if (!LoadFile(matchCachePath_, buf)) {
+		CalculateMatchCacheContentKey();
+		return;
+	}
+
+	MatchCacheReader reader(buf);
+	uint32_t magic, version, numEntries;
+	std::array<uint8_t, 16> identityKey, contentKey;
+	if (!reader.Read(magic) || !reader.Read(version)
+		|| !reader.Read(identityKey.data(), identityKey.size()) || !reader.Read(contentKey.data(), contentKey.size())
+		|| !reader.Read(numEntries)
+		|| magic != MatchCacheMagic || version != MatchCacheVersion) {
+		WARN("Symbol match cache is corrupted or has unsupported format; ignoring");
+		CalculateMatchCacheContentKey();
+		return;
+	}
+
+	if (identityKey == matchCacheIdentityKey_) {
+		matchCacheContentKey_ = contentKey;
+	} else {
+		// Module headers changed (i.e. the executable was rebuilt or re-signed); the cache is still usable
+		// if the code is the same
+		CalculateMatchCacheContentKey();
+		if (contentKey != matchCacheContentKey_) {
+			DEBUG("Symbol match cache was created for a different game or mapping version; ignoring");
+			return;
+		}
+
+		matchCacheDirty_ = true;
+	}
+
+	std::unordered_map<std::string, std::vector<uint32_t>> entries;
+	for (uint32_t i = 0; i < numEntries; i++) {
+		uint32_t nameLength, numOffsets;
+		std::string name;
+		std::vector<uint32_t> offsets;
+		if (!reader.Read(nameLength) || nameLength > 0x1000) break;
+		name.resize(nameLength);
+		if (!reader.Read(name.data(), nameLength) || !reader.Read(numOffsets) || numOffsets > 0x100000) break;
+		offsets.resize(numOffsets);
+		if (!reader.Read(offsets.data(), numOffsets * sizeof(uint32_t))) break;
+
+		entries.insert(std::make_pair(std::move(name), std::move(offsets)));
+	}
+
+	if (entries.size() != numEntries) {
+		WARN("Symbol match cache is truncated; ignoring");
+		return;
+	}
+
+	matchCache_ = std::move(entries);
+	matchCacheStats_.LoadedEntries = numEntries;
+}
+
+void SymbolMapper::CalculateMatchCacheIdentityKey()
+{
+	// Identity key covers the mapping XML and the build identifiers of every scanned module
+	std::vector<uint8_t> keyData(mappings_.SourceHash.begin(), mappings_.SourceHash.end());
+	std::map<std::string, ModuleInfo> modules(modules_.begin(), modules_.end());
+	for (auto const& mod : modules) {
+		keyData.insert(keyData.end(), mod.first.begin(), mod.first.end());
+		WriteCacheValue(keyData, mod.second.TimeDateStamp);
+		WriteCacheValue(keyData, mod.second.CheckSum);
+		WriteCacheValue(keyData, (uint64_t)mod.second.ModuleSize);
+		WriteCacheValue(keyData, (uint64_t)mod.second.ModuleTextSize);
+	}
+
+	MurmurHash3_x64_128(keyData.data(), (int)keyData.size(), 0, matchCacheIdentityKey_.data());
+}
+
+void SymbolMapper::CalculateMatchCacheContentKey()
+{
+	// Content key covers the mapping XML and the code of every scanned module.
+	// This must be calculated before any code patches are applied.
+	std::vector<uint8_t> keyData(mappings_.SourceHash.begin(), mappings_.SourceHash.end());
+	std::map<std::string, ModuleInfo> modules(modules_.begin(), modules_.end());
+	for (auto const& mod : modules) {
+		std::array<uint8_t, 16> moduleHash;
+		MurmurHash3_x64_128(mod.second.ModuleTextStart, (int)mod.second.ModuleTextSize, 0, moduleHash.data());
+		keyData.insert(keyData.end(), mod.first.begin(), mod.first.end());
+		keyData.insert(keyData.end(), moduleHash.begin(), moduleHash.end());
+	}
+
+	MurmurHash3_x64_128(keyData.data(), (int)keyData.size(), 0, matchCacheContentKey_.data());
+}
+
+void SymbolMapper::SaveMatchCache()
+{
+	if (matchCachePath_.empty() || !matchCacheDirty_) return;
+
+	if (matchCacheStats_.StaleMappings > 0) {
+		// The content key loaded from the cache describes code that no longer matches the module
+		CalculateMatchCacheContentKey();
+	}
+
+	std::vector<uint8_t> buf;
+	WriteCacheValue(buf, MatchCacheMagic);
+	WriteCacheValue(buf, MatchCacheVersion);
+	buf.insert(buf.end(), matchCacheIdentityKey_.begin(), matchCacheIdentityKey_.end());
+	buf.insert(buf.end(), matchCacheContentKey_.begin(), matchCacheContentKey_.end());
+	WriteCacheValue(buf, (uint32_t)matchCache_.size());
+
+	for (auto const& entry : matchCache_) {
+		WriteCacheValue(buf, (uint32_t)entry.first.size());
+		buf.insert(buf.end(), entry.first.begin(), entry.first.end());
+		WriteCacheValue(buf, (uint32_t)entry.second.size());
+		auto pos = buf.size();
+		buf.resize(pos + entry.second.size() * sizeof(uint32_t));
+		memcpy(buf.data() + pos, entry.second.data(), entry.second.size() * sizeof(uint32_t));
+	}
+
+	if (SaveFile(matchCachePath_, buf)) {
+		matchCacheDirty_ = false;
+		matchCacheStats_.Saved = true;
+	} else {
+		WARN("Failed to write symbol match cache to '%s'", ToStdUTF8(matchCachePath_).c_str());
+	}
+}
+
+bool SymbolMapper::ApplyCachedMatches(SymbolMappings::Mapping const& mapping, uint8_t const* memStart, std::size_t memSize)
+{
+	auto it = matchCache_.find(mapping.Name);
+	if (it == matchCache_.end()) return false;
+
+	std::vector<uint8_t const*> matches;
+	matches.reserve(it->second.size());
+	for (auto offset : it->second) {
+		// Cheap revalidation; fall back to scanning if the bytes at the cached location don't match
+		if (offset + mapping.Pattern.pattern_.size() >= memSize || !mapping.Pattern.MatchPattern(memStart + offset)) {
+			WARN("Cached match for mapping '%s' at offset %x is stale", mapping.Name.c_str(), offset);
+			matchCache_.erase(it);
+			matchCacheDirty_ = true;
+			matchCacheStats_.StaleMappings++;
+			return false;
+		}
+
+		matches.push_back(memStart + offset);
+	}
+
+	prescannedMatches_.insert(std::make_pair(&mapping, std::move(matches)));
+	return true;
+}
+
+void SymbolMapper::UpdateCachedMatches(SymbolMappings::Mapping const& mapping, uint8_t const* memStart, std::vector<uint8_t const*> const& matches)
+{
+	if (matchCachePath_.empty()) return;
+
+	std::vector<uint32_t> offsets;
+	offsets.reserve(matches.size());
+	for (auto match : matches) {
+		offsets.push_back((uint32_t)(match - memStart));
+	}
+
+	matchCache_[mapping.Name] = std::move(offsets);
+	matchCacheDirty_ = true;
+}
+
+Pattern::ScanAction SymbolMapper::ProcessMatch(SymbolMappings::Mapping& mapping, uint8_t const* match, MappingState& state)
+{
+	for (auto const& condition : mapping.Conditions) {
+		if (!EvaluateSymbolCondition(condition, match)) {
+			return Pattern::ScanAction::Continue;
+		}
+	}
 
-		if (matching) {
 #if defined(DEBUG_MAPPINGS)
-			DEBUG("\tMatch: [%p]", match);
+	DEBUG("\tMatch: [%p]", match);
 #endif
 
-			hasMatches = true;
-			auto patternAction{ Pattern::ScanAction::Finish };
-			for (auto const& target : mapping.Targets) {
-				auto action = ExecSymbolMappingAction(target, match);
+	state.HasMatches = true;
+	auto patternAction{ Pattern::ScanAction::Finish };
+	for (auto const& target : mapping.Targets) {
+		auto action = ExecSymbolMappingAction(target, match);
 #if defined(DEBUG_MAPPINGS)
-				DEBUG("\tAction: %s", (action == MappingResult::Success) ? "Success"
-					: ((action == MappingResult::TryNext) ? "TryNext" : "Fail"));
+		DEBUG("\tAction: %s", (action == MappingResult::Success) ? "Success"
+			: ((action == MappingResult::TryNext) ? "TryNext" : "Fail"));
 #endif
 
-				hasCallbacks = hasCallbacks || (action == MappingResult::Success) || (action == MappingResult::TryNext);
-				if (!mapped) {
-					mapped = (action == MappingResult::Success);
-				}
-				if (action == MappingResult::TryNext) {
-					patternAction = Pattern::ScanAction::Continue;
-				}
-			}
+		state.HasCallbacks = state.HasCallbacks || (action == MappingResult::Success) || (action == MappingResult::TryNext);
+		if (!state.Mapped) {
+			state.Mapped = (action == MappingResult::Success);
+		}
+		if (action == MappingResult::TryNext) {
+			patternAction = Pattern::ScanAction::Continue;
+		}
+	}
 
-			for (auto& patch : mapping.Patches) {
-				if (UpdatePatchReference(patch, match)) {
-					mapped = true;
-				}
-			}
+	for (auto& patch : mapping.Patches) {
+		if (UpdatePatchReference(patch, match)) {
+			state.Mapped = true;
+		}
+	}
 
-			return patternAction;
-		} else {
-			return {};
+	return patternAction;
+}
+
+bool SymbolMapper::MapSymbol(SymbolMappings::Mapping & mapping, uint8_t const * customStart, std::size_t customSize)
+{
+	if (!IsVersionSupported(mapping)) {
+		// Ignore mappings that aren't supported by the current game version
+		return true;
+	}
+
+	uint8_t const * memStart;
+	std::size_t memSize;
+	if (!GetMappingScope(mapping, customStart, customSize, memStart, memSize)) {
+		return false;
+	}
+
+#if defined(DEBUG_MAPPINGS)
+	DEBUG("Try mapping: %s [%p -> %p]", mapping.Name.c_str(), memStart, memStart + memSize);
+#endif
+
+	MappingState state;
+	auto prescanned = prescannedMatches_.find(&mapping);
+	if (mapping.Scope != SymbolMappings::MatchScope::kCustom && prescanned != prescannedMatches_.end()) {
+		for (auto match : prescanned->second) {
+			if (ProcessMatch(mapping, match, state) == Pattern::ScanAction::Finish) {
+				break;
+			}
 		}
-	});
+	} else {
+		mapping.Pattern.Scan(memStart, memSize, [this, &mapping, &state](const uint8_t * match) {
+			return ProcessMatch(mapping, match, state);
+		});
+	}
 
-	if (!mapped) {
-		if (!hasMatches) {
+	if (!state.Mapped) {
+		if (!state.HasMatches) {
 			if (mapping.Flag & SymbolMappings::Mapping::kAllowFail) {
 				WARN("No match found for mapping '%s' %s", mapping.Name.c_str(),
 					(mapping.Flag& SymbolMappings::Mapping::kCritical) ? "[CRITICAL]" : "");
@@ -939,7 +1327,7 @@ bool SymbolMapper::MapSymbol(SymbolMappings::Mapping & mapping, uint8_t const *
 				ERR("No match found for mapping '%s' %s", mapping.Name.c_str(),
 					(mapping.Flag & SymbolMappings::Mapping::kCritical) ? "[CRITICAL]" : "");
 			}
-		} else if (!hasCallbacks || !(mapping.Flag & SymbolMappings::Mapping::kAllowFail)) {
+		} else if (!state.HasCallbacks || !(mapping.Flag & SymbolMappings::Mapping::kAllowFail)) {
 			ERR("Target mapping action did not succeed for mapping '%s' %s", mapping.Name.c_str(),
 				(mapping.Flag & SymbolMappings::Mapping::kCritical) ? "[CRITICAL]" : "");
 		}
@@ -952,7 +1340,7 @@ bool SymbolMapper::MapSymbol(SymbolMappings::Mapping & mapping, uint8_t const *
 		}
 	}
 
-	return mapped;
+	return state.Mapped;
 }
 
 bool SymbolMapper::MapDllImport(SymbolMappings::DllImport const & imp)
@@ -1069,6 +1457,8 @@ bool SymbolMapper::AddModule(std::string const& name, std::wstring const& modNam
 
 	auto pNtHdr = ImageNtHeader(const_cast<uint8_t*>(modInfo.ModuleStart));
 	auto pSectionHdr = (IMAGE_SECTION_HEADER*)(pNtHdr + 1);
+	modInfo.TimeDateStamp = pNtHdr->FileHeader.TimeDateStamp;
+	modInfo.CheckSum = pNtHdr->OptionalHeader.CheckSum;
 
 	for (std::size_t i = 0; i < pNtHdr->FileHeader.NumberOfSections; i++) {
 		if (memcmp(pSectionHdr->Name, ".text", 6) == 0) {
@@ -1082,6 +1472,11 @@ bool SymbolMapper::AddModule(std::string const& name, std::wstring const& modNam
 	return true;
 }
 
+void SymbolMapper::AddModule(std::string const& name, ModuleInfo const& info)
+{
+	modules_.insert(std::make_pair(name, info));
+}
+
 void SymbolMapper::AddEngineCallback(std::string const& name, std::function<MappingResult(uint8_t const*)> const& cb)
 {
 	engineCallbacks_.insert(std::make_pair(name, cb));
@@ -1089,13 +1484,24 @@ void SymbolMapper::AddEngineCallback(std::string const& name, std::function<Mapp
 
 void SymbolMapper::MapAllSymbols(bool deferred)
 {
+	std::vector<SymbolMappings::Mapping*> mappings;
 	for (auto mapping : mappings_.OrderedMappings) {
 		if (mapping->Scope != SymbolMappings::MatchScope::kCustom
 			&& deferred == ((mapping->Flag & SymbolMappings::Mapping::kDeferred) != 0)) {
-			MapSymbol(*mapping, nullptr, 0);
+			mappings.push_back(mapping);
 		}
 	}
 
+	// Collect matches for all patterns in one pass over each module (or from the match cache),
+	// then process mappings in their original order
+	LoadMatchCache();
+	PrescanMappings(mappings);
+	SaveMatchCache();
+	for (auto mapping : mappings) {
+		MapSymbol(*mapping, nullptr, 0);
+	}
+	prescannedMatches_.clear();
+
 	if (!deferred) {
 		for (auto const& imp : mappings_.DllImports) {
 			MapDllImport(imp.second);
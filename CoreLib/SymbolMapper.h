@@ -62,12 +62,50 @@ private:
 	std::vector<PatternByte> pattern_;
 	std::unordered_map<std::string, uint32_t> anchors_;
 
+	friend class MultiPatternScanner;
+	friend class SymbolMapper;
+
 	bool MatchPattern(uint8_t const * start) const;
 	void ScanPrefix1(uint8_t const * start, uint8_t const * end, std::function<ScanAction (uint8_t const *)> callback) const;
 	void ScanPrefix2(uint8_t const * start, uint8_t const * end, std::function<ScanAction (uint8_t const *)> callback) const;
 	void ScanPrefix4(uint8_t const * start, uint8_t const * end, std::function<ScanAction (uint8_t const *)> callback) const;
 };
 
+// Scans a memory region for a set of patterns in a single pass.
+// Candidate locations are selected using a lookup table built from the first two bytes
+// of each pattern; only candidates that pass the prefix filter are checked using MatchPattern().
+class MultiPatternScanner
+{
+public:
+	std::size_t Add(Pattern const* pattern);
+	void Scan(uint8_t const * start, size_t length);
+
+	inline std::vector<uint8_t const*>& GetMatches(std::size_t index)
+	{
+		return patterns_[index].Matches;
+	}
+
+private:
+	struct PatternInfo
+	{
+		Pattern const* Pat;
+		std::vector<uint8_t const*> Matches;
+	};
+
+	std::vector<PatternInfo> patterns_;
+	// Patterns whose second byte is a wildcard, indexed by first byte
+	std::array<std::vector<uint32_t>, 0x100> singleBytePrefixes_;
+	// Patterns indexed by their first two bytes;
+	// patterns for prefix P are stored in twoBytePrefixes_[twoBytePrefixStart_[P] .. twoBytePrefixStart_[P + 1]]
+	std::vector<uint32_t> twoBytePrefixStart_;
+	std::vector<uint32_t> twoBytePrefixes_;
+	std::vector<uint64_t> twoBytePrefixBitmap_;
+	std::array<bool, 0x100> firstBytes_{};
+
+	void Build();
+	void TryMatch(uint32_t index, uint8_t const* p, uint8_t const* end);
+};
+
 uint8_t const * AsmResolveInstructionRef(uint8_t const * code);
 
 struct StaticSymbolRef
@@ -207,6 +245,8 @@ struct SymbolMappings
 	std::vector<Mapping*> OrderedMappings;
 	std::unordered_map<std::string, DllImport> DllImports;
 	std::unordered_map<std::string, StaticSymbol> StaticSymbols;
+	// Hash of the mapping XML these mappings were loaded from (zero if unknown)
+	std::array<uint8_t, 16> SourceHash{};
 };
 
 class SymbolMappingLoader
@@ -250,6 +290,22 @@ public:
 		size_t ModuleSize{ 0 };
 		uint8_t const* ModuleTextStart{ nullptr };
 		size_t ModuleTextSize{ 0 };
+		// PE header fields identifying the module build
+		uint32_t TimeDateStamp{ 0 };
+		uint32_t CheckSum{ 0 };
+	};
+
+	struct MatchCacheStats
+	{
+		// Number of entries read from the cache file (zero if the cache was missing or rejected)
+		uint32_t LoadedEntries{ 0 };
+		// Mappings whose matches were taken from the cache
+		uint32_t CachedMappings{ 0 };
+		// Mappings that were matched by the prescan
+		uint32_t ScannedMappings{ 0 };
+		// Cache entries that failed revalidation and were replaced by a prescan
+		uint32_t StaleMappings{ 0 };
+		bool Saved{ false };
 	};
 
 	inline SymbolMapper(SymbolMappings& mappings)
@@ -257,6 +313,11 @@ public:
 	{}
 
 	bool AddModule(std::string const& name, std::wstring const& modName);
+	// Registers a module that was already located in memory (i.e. a test image)
+	void AddModule(std::string const& name, ModuleInfo const& info);
+	void EnableMatchCache(std::wstring const& path);
+	// Cross-checks every prescan result against a per-pattern scan of the same region
+	void EnableScanVerification();
 	void AddEngineCallback(std::string const& name, std::function<MappingResult (uint8_t const *)> const& cb);
 	void MapAllSymbols(bool deferred);
 	bool MapSymbol(std::string const& mappingName, uint8_t const* customStart, std::size_t customSize);
@@ -278,10 +339,28 @@ public:
 		return modules_;
 	}
 
+	inline MatchCacheStats const& GetMatchCacheStats() const
+	{
+		return matchCacheStats_;
+	}
+
 private:
 	SymbolMappings& mappings_;
 	std::unordered_map<std::string, ModuleInfo> modules_;
 	std::unordered_map<std::string, std::function<MappingResult(uint8_t const*)>> engineCallbacks_;
+	// Matches for each mapping collected by the single-pass prescan in MapAllSymbols()
+	std::unordered_map<SymbolMappings::Mapping const*, std::vector<uint8_t const*>> prescannedMatches_;
+	// Persistent pattern match offsets, keyed by mapping name
+	std::unordered_map<std::string, std::vector<uint32_t>> matchCache_;
+	std::wstring matchCachePath_;
+	// Key calculated from the PE headers of the modules; cheap to check on every launch
+	std::array<uint8_t, 16> matchCacheIdentityKey_{};
+	// Key calculated from the code of the modules; only checked if the identity key doesn't match
+	std::array<uint8_t, 16> matchCacheContentKey_{};
+	bool matchCacheLoaded_{ false };
+	bool matchCacheDirty_{ false };
+	bool verifyScan_{ false };
+	MatchCacheStats matchCacheStats_;
 	uint32_t gameRevision_;
 	bool hasFailedMappings_{ false };
 	bool hasFailedCriticalMappings_{ false };
@@ -292,6 +371,24 @@ private:
 	bool IsFixedStringRef(uint8_t const* ref, char const* str) const;
 	bool IsIndirectFixedStringRef(uint8_t const* ref, char const* str) const;
 
+	struct MappingState
+	{
+		bool Mapped{ false };
+		bool HasMatches{ false };
+		bool HasCallbacks{ false };
+	};
+
+	bool IsVersionSupported(SymbolMappings::Mapping const& mapping) const;
+	bool GetMappingScope(SymbolMappings::Mapping const& mapping, uint8_t const* customStart, std::size_t customSize,
+		uint8_t const*& memStart, std::size_t& memSize) const;
+	void PrescanMappings(std::vector<SymbolMappings::Mapping*> const& mappings);
+	void LoadMatchCache();
+	void CalculateMatchCacheIdentityKey();
+	void CalculateMatchCacheContentKey();
+	void SaveMatchCache();
+	bool ApplyCachedMatches(SymbolMappings::Mapping const& mapping, uint8_t const* memStart, std::size_t memSize);
+	void UpdateCachedMatches(SymbolMappings::Mapping const& mapping, uint8_t const* memStart, std::vector<uint8_t const*> const& matches);
+	Pattern::ScanAction ProcessMatch(SymbolMappings::Mapping& mapping, uint8_t const* match, MappingState& state);
 	std::optional<uint8_t const*> ResolveRef(SymbolMappings::Reference const& ref, uint8_t const* match);
 	bool EvaluateSymbolCondition(SymbolMappings::Condition const& cond, uint8_t const* match);
 	MappingResult ExecSymbolMappingAction(SymbolMappings::Target const& target, uint8_t const* match);
@@ -1,6 +1,7 @@
 #include "stdafx.h"
 #include <CoreLib/Base/Base.h>
 #include <Shlwapi.h>
+#include <ShlObj.h>
 
 BEGIN_SE()
 
@@ -41,6 +42,16 @@ std::wstring FromStdUTF8(std::string_view s)
 }
 
 std::optional<std::string> GetExeResource(int resourceId)
+{
+	auto view = GetExeResourceView(resourceId);
+	if (view) {
+		return std::string(reinterpret_cast<char const*>(view->data()), view->size());
+	} else {
+		return {};
+	}
+}
+
+std::optional<std::span<uint8_t const>> GetExeResourceView(int resourceId)
 {
 	auto hResource = FindResource(gCoreLibPlatformInterface.ThisModule, MAKEINTRESOURCE(resourceId), L"SCRIPT_EXTENDER");
 
@@ -50,10 +61,7 @@ std::optional<std::string> GetExeResource(int resourceId)
 			auto resourceData = LockResource(hGlobal);
 			if (resourceData) {
 				DWORD resourceSize = SizeofResource(gCoreLibPlatformInterface.ThisModule, hResource);
-				std::string contents;
-				contents.resize(resourceSize);
-				memcpy(contents.data(), resourceData, resourceSize);
-				return contents;
+				return std::span(reinterpret_cast<uint8_t const*>(resourceData), resourceSize);
 			}
 		}
 	}
@@ -89,6 +97,21 @@ bool TryCreateDirectory(std::wstring const& path)
 	}
 }
 
+std::wstring GetCacheFilePath(std::wstring const& fileName)
+{
+	wchar_t appDataPath[MAX_PATH];
+	if (!SUCCEEDED(SHGetFolderPathW(NULL, CSIDL_LOCAL_APPDATA, NULL, 0, appDataPath))) {
+		return L"";
+	}
+
+	std::wstring cacheDir = std::wstring(appDataPath) + L"\\BG3ScriptExtender";
+	if (!TryCreateDirectory(cacheDir)) {
+		return L"";
+	}
+
+	return cacheDir + L"\\" + fileName;
+}
+
 bool SaveFile(std::wstring const& path, std::vector<uint8_t> const& body)
 {
 	std::ofstream f(path, std::ios::binary | std::ios::out);
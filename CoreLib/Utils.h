@@ -26,11 +26,16 @@ void TryDebugBreak();
 void Fail(char const * reason);
 
 bool TryCreateDirectory(std::wstring const& path);
+// Returns the path of a file in the extender cache directory (%LOCALAPPDATA%\BG3ScriptExtender),
+// or an empty string if the directory is not available
+std::wstring GetCacheFilePath(std::wstring const& fileName);
 bool SaveFile(std::wstring const& path, std::vector<uint8_t> const& body);
 bool SaveFile(std::wstring const& path, std::string const& body);
 bool LoadFile(std::wstring const& path, std::vector<uint8_t>& body);
 bool LoadFile(std::wstring const& path, std::string& body);
 
 std::optional<std::string> GetExeResource(int resourceId);
+// Returns the resource data in the mapped module image without copying it; valid while the module is loaded
+std::optional<std::span<uint8_t const>> GetExeResourceView(int resourceId);
 
 END_SE()
@@ -128,6 +128,9 @@ namespace NSE.DebuggerFrontend
         public delegate void GetVariablesFinishedDelegate(UInt32 seq, BkGetVariablesResponse msg);
         public GetVariablesFinishedDelegate OnGetVariablesFinished = delegate { };
 
+        public delegate void ProfileDataDelegate(UInt32 seq, BkProfileData msg);
+        public ProfileDataDelegate OnProfileData = delegate { };
+
         public DebuggerClient(AsyncProtobufClient client)
         {
             Client = client;
@@ -295,6 +298,20 @@ namespace NSE.DebuggerFrontend
             Send(msg);
         }
 
+        public UInt32 SendProfilerControl(DbgContext context, DbgProfilerControl.Types.Action action, UInt32 interval = 0)
+        {
+            var msg = new DebuggerToBackend
+            {
+                ProfilerControl = new DbgProfilerControl
+                {
+                    Context = context,
+                    Action = action,
+                    Interval = interval
+                }
+            };
+            return Send(msg);
+        }
+
         private void BreakpointTriggered(BkBreakpointTriggered message)
         {
             OnBreakpointTriggered(message);
@@ -353,6 +370,10 @@ namespace NSE.DebuggerFrontend
                     OnGetVariablesFinished(message.ReplySeqNo, message.GetVariablesResponse);
                     break;
 
+                case BackendToDebugger.MsgOneofCase.ProfileData:
+                    OnProfileData(message.ReplySeqNo, message.ProfileData);
+                    break;
+
                 default:
                     throw new InvalidOperationException($"Unknown message from NSE: {message.MsgCase}");
             }
@@ -1,6 +1,15 @@
 #include <iostream>
 #include <fstream>
 #include <filesystem>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <Windows.h>
+#include <compressapi.h>
+#include <Lua/Shared/LuaBundleFormat.h>
+
+using namespace bg3se::lua;
 
 class LuaBundler
 {
@@ -18,63 +27,166 @@ public:
 				paths_.push_back(res);
 			}
 		}
+
+		// The loader looks up entries using a binary search on the table of contents
+		std::sort(paths_.begin(), paths_.end(), [](ResourceInfo const& a, ResourceInfo const& b) {
+			return a.BundlePath < b.BundlePath;
+		});
 	}
 
 	std::vector<uint8_t> Pack()
 	{
+		COMPRESSOR_HANDLE compressor;
+		if (!CreateCompressor(COMPRESS_ALGORITHM_XPRESS, NULL, &compressor)) {
+			std::cout << "CreateCompressor() failed: " << GetLastError() << std::endl;
+			exit(1);
+		}
+
+		std::string names;
+		for (auto& res : paths_) {
+			res.Entry.NameOffset = (uint32_t)names.size();
+			res.Entry.NameSize = (uint32_t)res.BundlePath.size();
+			names += res.BundlePath;
+		}
+
 		std::vector<uint8_t> bundle;
+		bundle.resize(Align(sizeof(LuaBundleHeader) + paths_.size() * sizeof(LuaBundleEntry) + names.size()));
 
-		for (auto const& res : paths_) {
-			std::ifstream f(res.FilesystemPath.c_str(), std::ios::in | std::ios::binary);
-			if (!f.good()) {
-				std::cout << "Couldn't read file: " << res.BundlePath << std::endl;
-				exit(1);
+		for (auto& res : paths_) {
+			auto contents = ReadFile(res);
+			auto data = Compress(compressor, contents);
+			res.Entry.Flags = data.empty() ? LuaBundleEntryFlags::None : LuaBundleEntryFlags::CompressedXpress;
+			if (data.empty()) {
+				data = contents;
 			}
 
-			std::size_t len;
-			f.seekg(0, std::ifstream::end);
-			len = f.tellg();
-			f.seekg(0, std::ifstream::beg);
-			std::vector<uint8_t> fbuf;
-			fbuf.resize(len);
-			f.read((char*)fbuf.data(), len);
-
-			auto offset = bundle.size();
-			bundle.resize(offset + sizeof(HeaderInfo) + fbuf.size() + res.BundlePath.size());
-			auto phdr = bundle.data() + offset;
-
-			HeaderInfo hdr;
-			hdr.FileNameSize = (uint32_t)res.BundlePath.size();
-			hdr.FileSize = (uint32_t)fbuf.size();
-			memcpy(phdr, &hdr, sizeof(hdr));
-			memcpy(phdr + sizeof(hdr), res.BundlePath.c_str(), res.BundlePath.size());
-			memcpy(phdr + sizeof(hdr) + res.BundlePath.size(), fbuf.data(), fbuf.size());
+			res.Entry.DataOffset = (uint32_t)bundle.size();
+			res.Entry.DataSize = (uint32_t)data.size();
+			res.Entry.UncompressedSize = (uint32_t)contents.size();
+			bundle.insert(bundle.end(), data.begin(), data.end());
+			bundle.resize(Align(bundle.size()));
+		}
+
+		CloseCompressor(compressor);
+
+		LuaBundleHeader hdr;
+		hdr.Signature = LuaBundleSignature;
+		hdr.Version = LuaBundleVersion;
+		hdr.NumEntries = (uint32_t)paths_.size();
+		hdr.NamesSize = (uint32_t)names.size();
+		memcpy(bundle.data(), &hdr, sizeof(hdr));
+
+		auto toc = bundle.data() + sizeof(hdr);
+		for (auto const& res : paths_) {
+			memcpy(toc, &res.Entry, sizeof(res.Entry));
+			toc += sizeof(res.Entry);
 		}
 
+		memcpy(toc, names.data(), names.size());
 		return bundle;
 	}
 
+	// Unpacks every entry of the bundle and compares it to the source file
+	bool Verify(std::vector<uint8_t> const& bundle)
+	{
+		DECOMPRESSOR_HANDLE decompressor;
+		if (!CreateDecompressor(COMPRESS_ALGORITHM_XPRESS, NULL, &decompressor)) {
+			std::cout << "CreateDecompressor() failed: " << GetLastError() << std::endl;
+			return false;
+		}
+
+		auto hdr = reinterpret_cast<LuaBundleHeader const*>(bundle.data());
+		auto entries = reinterpret_cast<LuaBundleEntry const*>(bundle.data() + sizeof(LuaBundleHeader));
+		auto names = reinterpret_cast<char const*>(entries + hdr->NumEntries);
+
+		bool ok = hdr->NumEntries == paths_.size();
+		for (uint32_t i = 0; ok && i < hdr->NumEntries; i++) {
+			auto const& entry = entries[i];
+			auto const& res = paths_[i];
+			std::string name(names + entry.NameOffset, entry.NameSize);
+			std::string body(entry.UncompressedSize, '\0');
+			auto data = bundle.data() + entry.DataOffset;
+
+			if (entry.Flags == LuaBundleEntryFlags::CompressedXpress) {
+				SIZE_T uncompressedSize{ 0 };
+				ok = Decompress(decompressor, data, entry.DataSize, body.data(), body.size(), &uncompressedSize)
+					&& uncompressedSize == body.size();
+			} else {
+				memcpy(body.data(), data, entry.DataSize);
+			}
+
+			if (!ok || name != res.BundlePath || body != ReadFile(res)) {
+				std::cout << "Bundle verification failed: " << res.BundlePath << std::endl;
+				ok = false;
+			}
+		}
+
+		CloseDecompressor(decompressor);
+		return ok;
+	}
+
 private:
 	struct ResourceInfo
 	{
 		std::wstring FilesystemPath;
 		std::string BundlePath;
+		LuaBundleEntry Entry{};
 	};
 
-	struct HeaderInfo
+	std::vector<ResourceInfo> paths_;
+
+	static std::size_t Align(std::size_t size)
 	{
-		uint32_t FileNameSize;
-		uint32_t FileSize;
-	};
+		return (size + LuaBundleDataAlignment - 1) & ~(std::size_t)(LuaBundleDataAlignment - 1);
+	}
 
-	std::vector<ResourceInfo> paths_;
+	static std::string ReadFile(ResourceInfo const& res)
+	{
+		std::ifstream f(res.FilesystemPath.c_str(), std::ios::in | std::ios::binary);
+		if (!f.good()) {
+			std::cout << "Couldn't read file: " << res.BundlePath << std::endl;
+			exit(1);
+		}
+
+		std::size_t len;
+		f.seekg(0, std::ifstream::end);
+		len = f.tellg();
+		f.seekg(0, std::ifstream::beg);
+		std::string fbuf;
+		fbuf.resize(len);
+		f.read(fbuf.data(), len);
+		return fbuf;
+	}
+
+	// Returns an empty buffer if compression wouldn't make the entry smaller
+	static std::string Compress(COMPRESSOR_HANDLE compressor, std::string const& contents)
+	{
+		std::string compressed;
+		compressed.resize(contents.size());
+		SIZE_T compressedSize{ 0 };
+		// Compress() fails with ERROR_INSUFFICIENT_BUFFER if the output wouldn't be smaller than the input
+		if (contents.empty() || !::Compress(compressor, contents.data(), contents.size(), compressed.data(), compressed.size(), &compressedSize)) {
+			return {};
+		}
+
+		compressed.resize(compressedSize);
+		return compressed;
+	}
 };
 
 int main(int argc, char const ** argv)
 {
+	if (argc < 3) {
+		std::cout << "Usage: ResourceBundler <script directory> <bundle path>" << std::endl;
+		return 1;
+	}
+
 	LuaBundler bundler;
 	bundler.AddResources(argv[1]);
 	auto pack = bundler.Pack();
+	if (!bundler.Verify(pack)) {
+		return 1;
+	}
 
 	std::ofstream f(argv[2], std::ios::out | std::ios::binary);
 	if (!f.good()) {